@@ -0,0 +1,145 @@
+/*
+ * Poly1305 authenticator algorithm, RFC7539, ARM64 NEON glue code
+ *
+ * Based on:
+ * Poly1305 authenticator algorithm, RFC7539, SIMD glue code
+ *
+ * Copyright (C) 2015 Martin Willi
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <crypto/algapi.h>
+#include <crypto/internal/hash.h>
+#include <crypto/internal/poly1305.h>
+#include <linux/crypto.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+
+#include <asm/hwcap.h>
+#include <asm/neon.h>
+#include <asm/simd.h>
+
+struct poly1305_neon_desc_ctx {
+	struct poly1305_desc_ctx base;
+	/* derived key u set? */
+	bool uset;
+	/* derived Poly1305 key r^2 */
+	u32 u[5];
+};
+
+asmlinkage void poly1305_2block_neon(u32 *h, const u8 *src, const u32 *r,
+				     unsigned int blocks, const u32 *u);
+
+static int poly1305_neon_init(struct shash_desc *desc)
+{
+	struct poly1305_neon_desc_ctx *sctx = shash_desc_ctx(desc);
+
+	sctx->uset = false;
+
+	return crypto_poly1305_init(desc);
+}
+
+static void poly1305_neon_setu(struct poly1305_neon_desc_ctx *sctx)
+{
+	static const u8 zero[POLY1305_BLOCK_SIZE];
+	struct poly1305_state state;
+	struct poly1305_key key;
+
+	/* The Poly1305 block function adds a hi-bit to the accumulator which
+	 * we don't need for key multiplication; compensate for it. */
+	memcpy(key.r, sctx->base.r, sizeof(key.r));
+	memcpy(state.h, sctx->base.r, sizeof(state.h));
+	state.h[4] -= 1 << 24;
+	poly1305_core_blocks(&state, &key, zero, 1);
+
+	memcpy(sctx->u, state.h, sizeof(sctx->u));
+	sctx->uset = true;
+}
+
+static int poly1305_neon_update(struct shash_desc *desc,
+				const u8 *src, unsigned int srclen)
+{
+	struct poly1305_neon_desc_ctx *sctx = shash_desc_ctx(desc);
+	struct poly1305_desc_ctx *dctx = &sctx->base;
+	unsigned int bytes;
+
+	BUILD_BUG_ON(offsetof(struct poly1305_neon_desc_ctx, base));
+
+	/* kernel_neon_begin/end is costly, use fallback for small updates */
+	if (srclen <= 288 || !may_use_simd())
+		return crypto_poly1305_update(desc, src, srclen);
+
+	/* complete a partial block, and the key it may be part of, first */
+	if (unlikely(dctx->buflen)) {
+		bytes = min(srclen, POLY1305_BLOCK_SIZE - dctx->buflen);
+		crypto_poly1305_update(desc, src, bytes);
+		src += bytes;
+		srclen -= bytes;
+	}
+
+	if (unlikely(!dctx->sset)) {
+		bytes = crypto_poly1305_setdesckey(dctx, src, srclen);
+		src += srclen - bytes;
+		srclen = bytes;
+	}
+
+	while (srclen >= POLY1305_BLOCK_SIZE * 2) {
+		unsigned int blocks = min_t(unsigned int, srclen, PAGE_SIZE) /
+				      (POLY1305_BLOCK_SIZE * 2);
+
+		if (unlikely(!sctx->uset))
+			poly1305_neon_setu(sctx);
+
+		kernel_neon_begin();
+		poly1305_2block_neon(dctx->h, src, dctx->r, blocks, sctx->u);
+		kernel_neon_end();
+
+		src += POLY1305_BLOCK_SIZE * 2 * blocks;
+		srclen -= POLY1305_BLOCK_SIZE * 2 * blocks;
+	}
+
+	/* at most a single block to process and a partial one to buffer */
+	return crypto_poly1305_update(desc, src, srclen);
+}
+
+static struct shash_alg alg = {
+	.digestsize	= POLY1305_DIGEST_SIZE,
+	.init		= poly1305_neon_init,
+	.update		= poly1305_neon_update,
+	.final		= crypto_poly1305_final,
+	.descsize	= sizeof(struct poly1305_neon_desc_ctx),
+	.base		= {
+		.cra_name		= "poly1305",
+		.cra_driver_name	= "poly1305-neon",
+		.cra_priority		= 200,
+		.cra_flags		= CRYPTO_ALG_TYPE_SHASH,
+		.cra_alignmask		= sizeof(u32) - 1,
+		.cra_blocksize		= POLY1305_BLOCK_SIZE,
+		.cra_module		= THIS_MODULE,
+	},
+};
+
+static int __init poly1305_neon_mod_init(void)
+{
+	if (!(elf_hwcap & HWCAP_ASIMD))
+		return -ENODEV;
+
+	return crypto_register_shash(&alg);
+}
+
+static void __exit poly1305_neon_mod_exit(void)
+{
+	crypto_unregister_shash(&alg);
+}
+
+module_init(poly1305_neon_mod_init);
+module_exit(poly1305_neon_mod_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("Poly1305 authenticator (NEON accelerated)");
+MODULE_ALIAS_CRYPTO("poly1305");
+MODULE_ALIAS_CRYPTO("poly1305-neon");
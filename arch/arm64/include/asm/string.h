@@ -37,6 +37,10 @@ extern __kernel_size_t strnlen(const char *, __kernel_size_t);
 #define __HAVE_ARCH_MEMCPY
 extern void *memcpy(void *, const void *, __kernel_size_t);
 extern void *__memcpy(void *, const void *, __kernel_size_t);
+/* Per-microarchitecture variants, __memcpy() branches to the right one */
+extern void *__memcpy_generic(void *, const void *, __kernel_size_t);
+extern void *__memcpy_inorder(void *, const void *, __kernel_size_t);
+extern void *__memcpy_wide(void *, const void *, __kernel_size_t);
 
 #define __HAVE_ARCH_MEMMOVE
 extern void *memmove(void *, const void *, __kernel_size_t);
@@ -48,6 +52,8 @@ extern void *memchr(const void *, int, __kernel_size_t);
 #define __HAVE_ARCH_MEMSET
 extern void *memset(void *, int, __kernel_size_t);
 extern void *__memset(void *, int, __kernel_size_t);
+extern void *__memset_generic(void *, int, __kernel_size_t);
+extern void *__memset_wide(void *, int, __kernel_size_t);
 
 #define __HAVE_ARCH_MEMCMP
 extern int memcmp(const void *, const void *, size_t);
@@ -397,6 +397,9 @@ extern unsigned long __must_check __arch_copy_from_user(void *to, const void __u
 })
 
 extern unsigned long __must_check __arch_copy_to_user(void __user *to, const void *from, unsigned long n);
+extern unsigned long __must_check __arch_copy_to_user_generic(void __user *to, const void *from, unsigned long n);
+extern unsigned long __must_check __arch_copy_to_user_inorder(void __user *to, const void *from, unsigned long n);
+extern unsigned long __must_check __arch_copy_to_user_wide(void __user *to, const void *from, unsigned long n);
 #define raw_copy_to_user(to, from, n)					\
 ({									\
 	__arch_copy_to_user(__uaccess_mask_ptr(to), (from), (n));	\
@@ -0,0 +1,163 @@
+/*
+ * arch/arm64/include/asm/xor.h
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <asm-generic/xor.h>
+#include <asm/hwcap.h>
+#include <asm/neon.h>
+#include <asm/simd.h>
+
+#ifdef CONFIG_KERNEL_MODE_NEON
+
+extern struct xor_block_template const xor_block_inner_neon;
+
+/*
+ * NEON may not be used from hardirq context, or with the NEON unit already
+ * claimed by the interrupted task, so fall back to the integer routines.
+ */
+static void
+xor_neon_2(unsigned long bytes, unsigned long *p1, unsigned long *p2)
+{
+	if (!may_use_simd()) {
+		xor_32regs_2(bytes, p1, p2);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon.do_2(bytes, p1, p2);
+		kernel_neon_end();
+	}
+}
+
+static void
+xor_neon_3(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3)
+{
+	if (!may_use_simd()) {
+		xor_32regs_3(bytes, p1, p2, p3);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon.do_3(bytes, p1, p2, p3);
+		kernel_neon_end();
+	}
+}
+
+static void
+xor_neon_4(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3, unsigned long *p4)
+{
+	if (!may_use_simd()) {
+		xor_32regs_4(bytes, p1, p2, p3, p4);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon.do_4(bytes, p1, p2, p3, p4);
+		kernel_neon_end();
+	}
+}
+
+static void
+xor_neon_5(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3, unsigned long *p4, unsigned long *p5)
+{
+	if (!may_use_simd()) {
+		xor_32regs_5(bytes, p1, p2, p3, p4, p5);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon.do_5(bytes, p1, p2, p3, p4, p5);
+		kernel_neon_end();
+	}
+}
+
+static struct xor_block_template xor_block_arm64 = {
+	.name	= "arm64_neon",
+	.do_2	= xor_neon_2,
+	.do_3	= xor_neon_3,
+	.do_4	= xor_neon_4,
+	.do_5	= xor_neon_5
+};
+
+#ifdef CONFIG_AS_SHA3
+
+extern struct xor_block_template const xor_block_inner_neon_eor3;
+
+/*
+ * Only the 3 to 5 source routines use EOR3, the 2 source one is shared with
+ * the plain NEON template.
+ */
+static void
+xor_eor3_3(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3)
+{
+	if (!may_use_simd()) {
+		xor_32regs_3(bytes, p1, p2, p3);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon_eor3.do_3(bytes, p1, p2, p3);
+		kernel_neon_end();
+	}
+}
+
+static void
+xor_eor3_4(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3, unsigned long *p4)
+{
+	if (!may_use_simd()) {
+		xor_32regs_4(bytes, p1, p2, p3, p4);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon_eor3.do_4(bytes, p1, p2, p3, p4);
+		kernel_neon_end();
+	}
+}
+
+static void
+xor_eor3_5(unsigned long bytes, unsigned long *p1, unsigned long *p2,
+		unsigned long *p3, unsigned long *p4, unsigned long *p5)
+{
+	if (!may_use_simd()) {
+		xor_32regs_5(bytes, p1, p2, p3, p4, p5);
+	} else {
+		kernel_neon_begin();
+		xor_block_inner_neon_eor3.do_5(bytes, p1, p2, p3, p4, p5);
+		kernel_neon_end();
+	}
+}
+
+static struct xor_block_template xor_block_arm64_eor3 = {
+	.name	= "arm64_eor3",
+	.do_2	= xor_neon_2,
+	.do_3	= xor_eor3_3,
+	.do_4	= xor_eor3_4,
+	.do_5	= xor_eor3_5
+};
+
+/*
+ * xor_speed() only benchmarks the 2 source routine, which is identical in
+ * both templates, so offer the EOR3 one instead of the plain NEON one when
+ * the CPU implements it.
+ */
+#define NEON_TEMPLATES							\
+	do {								\
+		if (elf_hwcap & HWCAP_SHA3)				\
+			xor_speed(&xor_block_arm64_eor3);		\
+		else if (cpu_has_neon())				\
+			xor_speed(&xor_block_arm64);			\
+	} while (0)
+#else
+#define NEON_TEMPLATES							\
+	do { if (cpu_has_neon()) xor_speed(&xor_block_arm64); } while (0)
+#endif /* CONFIG_AS_SHA3 */
+
+#else
+#define NEON_TEMPLATES
+#endif /* CONFIG_KERNEL_MODE_NEON */
+
+#undef XOR_TRY_TEMPLATES
+#define XOR_TRY_TEMPLATES			\
+	do {					\
+		xor_speed(&xor_block_8regs);	\
+		xor_speed(&xor_block_32regs);	\
+		NEON_TEMPLATES;			\
+	} while (0)
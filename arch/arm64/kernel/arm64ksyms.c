@@ -59,6 +59,21 @@ EXPORT_SYMBOL(__memmove);
 EXPORT_SYMBOL(memchr);
 EXPORT_SYMBOL(memcmp);
 
+#if IS_ENABLED(CONFIG_ARM64_MEMOPS_TEST)
+	/* per-microarchitecture variants, for benchmarking */
+EXPORT_SYMBOL_GPL(__copy_page_generic);
+EXPORT_SYMBOL_GPL(__copy_page_inorder);
+EXPORT_SYMBOL_GPL(__copy_page_wide);
+EXPORT_SYMBOL_GPL(__arch_copy_to_user_generic);
+EXPORT_SYMBOL_GPL(__arch_copy_to_user_inorder);
+EXPORT_SYMBOL_GPL(__arch_copy_to_user_wide);
+EXPORT_SYMBOL_GPL(__memcpy_generic);
+EXPORT_SYMBOL_GPL(__memcpy_inorder);
+EXPORT_SYMBOL_GPL(__memcpy_wide);
+EXPORT_SYMBOL_GPL(__memset_generic);
+EXPORT_SYMBOL_GPL(__memset_wide);
+#endif
+
 	/* atomic bitops */
 EXPORT_SYMBOL(set_bit);
 EXPORT_SYMBOL(test_and_set_bit);
@@ -107,6 +107,7 @@ cpufeature_pan_not_uao(const struct arm64_cpu_capabilities *entry, int __unused)
  * sync with the documentation of the CPU feature register ABI.
  */
 static const struct arm64_ftr_bits ftr_id_aa64isar0[] = {
+	ARM64_FTR_BITS(FTR_VISIBLE, FTR_STRICT, FTR_LOWER_SAFE, ID_AA64ISAR0_SHA3_SHIFT, 4, 0),
 	ARM64_FTR_BITS(FTR_VISIBLE, FTR_STRICT, FTR_EXACT, ID_AA64ISAR0_RDM_SHIFT, 4, 0),
 	ARM64_FTR_BITS(FTR_VISIBLE, FTR_STRICT, FTR_LOWER_SAFE, ID_AA64ISAR0_ATOMICS_SHIFT, 4, 0),
 	ARM64_FTR_BITS(FTR_VISIBLE, FTR_STRICT, FTR_LOWER_SAFE, ID_AA64ISAR0_CRC32_SHIFT, 4, 0),
@@ -774,6 +775,62 @@ static bool has_no_hw_prefetch(const struct arm64_cpu_capabilities *entry, int _
 		MIDR_CPU_VAR_REV(1, MIDR_REVISION_MASK));
 }
 
+/*
+ * The memory routine variants below are only performance tuning: every one of
+ * them is correct on any CPU. A variant is selected when all the CPUs brought
+ * up at boot belong to its class, and a CPU onlined later is never refused
+ * because it doesn't.
+ */
+static bool all_cpus_midr_in(const u32 *models, int scope)
+{
+	const u32 *model;
+	int cpu;
+
+	if (scope == SCOPE_LOCAL_CPU)
+		return true;
+
+	for_each_online_cpu(cpu) {
+		u32 midr = per_cpu(cpu_data, cpu).reg_midr & MIDR_CPU_MODEL_MASK;
+
+		for (model = models; *model; model++)
+			if (midr == *model)
+				break;
+		if (!*model)
+			return false;
+	}
+
+	return true;
+}
+
+/* In-order cores: prefetch ahead and keep the destination cached */
+static const u32 inorder_memops_cpus[] = {
+	MIDR_CORTEX_A53,
+	MIDR_CORTEX_A55,
+	0,
+};
+
+/* Wide out-of-order cores: unroll to 128 bytes, no non-temporal stores */
+static const u32 wide_memops_cpus[] = {
+	MIDR_CORTEX_A72,
+	MIDR_CORTEX_A73,
+	MIDR_CORTEX_A75,
+	MIDR_CORTEX_A76,
+	MIDR_NEOVERSE_N1,
+	MIDR_CAVIUM_THUNDERX2,
+	MIDR_BRCM_VULCAN,
+	0,
+};
+
+static bool has_inorder_memops(const struct arm64_cpu_capabilities *entry, int scope)
+{
+	return all_cpus_midr_in(inorder_memops_cpus, scope);
+}
+
+static bool has_wide_memops(const struct arm64_cpu_capabilities *entry, int scope)
+{
+	return all_cpus_midr_in(wide_memops_cpus, scope);
+}
+
 static bool runs_at_el2(const struct arm64_cpu_capabilities *entry, int __unused)
 {
 	return is_kernel_in_hyp_mode();
@@ -938,6 +995,18 @@ static const struct arm64_cpu_capabilities arm64_features[] = {
 		.def_scope = SCOPE_SYSTEM,
 		.matches = has_no_hw_prefetch,
 	},
+	{
+		.desc = "In-order memory copy and fill routines",
+		.capability = ARM64_INORDER_MEMOPS,
+		.def_scope = SCOPE_SYSTEM,
+		.matches = has_inorder_memops,
+	},
+	{
+		.desc = "Wide memory copy and fill routines",
+		.capability = ARM64_WIDE_MEMOPS,
+		.def_scope = SCOPE_SYSTEM,
+		.matches = has_wide_memops,
+	},
 #ifdef CONFIG_ARM64_UAO
 	{
 		.desc = "User Access Override",
@@ -1031,6 +1100,7 @@ static const struct arm64_cpu_capabilities arm64_elf_hwcaps[] = {
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_AES_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_AES),
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_SHA1_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_SHA1),
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_SHA2_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_SHA2),
+	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_SHA3_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_SHA3),
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_CRC32_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_CRC32),
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_ATOMICS_SHIFT, FTR_UNSIGNED, 2, CAP_HWCAP, HWCAP_ATOMICS),
 	HWCAP_CAP(SYS_ID_AA64ISAR0_EL1, ID_AA64ISAR0_RDM_SHIFT, FTR_UNSIGNED, 1, CAP_HWCAP, HWCAP_ASIMDRDM),
@@ -28,6 +28,7 @@
 #include <linux/of.h>
 #include <linux/perf/arm_pmu.h>
 #include <linux/platform_device.h>
+#include <linux/sysctl.h>
 
 /*
  * ARMv8 PMUv3 Performance Events handling code.
@@ -452,9 +453,11 @@ static struct attribute_group armv8_pmuv3_events_attr_group = {
 };
 
 PMU_FORMAT_ATTR(event, "config:0-15");
+PMU_FORMAT_ATTR(rdpmc, "config1:1");
 
 static struct attribute *armv8_pmuv3_format_attrs[] = {
 	&format_attr_event.attr,
+	&format_attr_rdpmc.attr,
 	NULL,
 };
 
@@ -471,6 +474,22 @@ static struct attribute_group armv8_pmuv3_format_attr_group = {
 #define	ARMV8_IDX_COUNTER_LAST(cpu_pmu) \
 	(ARMV8_IDX_CYCLE_COUNTER + cpu_pmu->num_events - 1)
 
+/*
+ * Index of the cycle counter as seen by user space through
+ * perf_event_mmap_page::index, which is the counter number plus one for
+ * the event counters. PMCCNTR_EL0 is reported as counter 31.
+ */
+#define	ARMV8_IDX_CYCLE_COUNTER_USER	32
+
+/* config1 bit requesting direct EL0 reads of the counter */
+#define	ARMV8_PMU_ATTR_RDPMC		BIT(1)
+
+/*
+ * Allow tasks to read their own counters from EL0, for events created
+ * with the rdpmc format bit set. Off by default.
+ */
+static int sysctl_perf_user_access __read_mostly;
+
 /*
  * ARMv8 low level PMU access
  */
@@ -738,12 +757,67 @@ static irqreturn_t armv8pmu_handle_irq(int irq_num, void *dev)
 	return IRQ_HANDLED;
 }
 
+static inline bool armv8pmu_event_has_user_read(struct perf_event *event)
+{
+	return event->hw.flags & ARMPMU_EL0_RD_CNTR;
+}
+
+/*
+ * EL0 access is only granted while the current task has one of its own
+ * user readable events on the PMU. The perf core reprograms the PMU
+ * (stop, then start) whenever a task context is switched in or out, and
+ * armpmu_sched_task() does the same when a cloned context is swapped to
+ * the next task instead, so this is re-evaluated on every context switch.
+ */
+static bool armv8pmu_want_user_access(struct arm_pmu *cpu_pmu,
+				      struct pmu_hw_events *cpuc)
+{
+	struct perf_event *event;
+	int idx;
+
+	if (!sysctl_perf_user_access)
+		return false;
+
+	for_each_set_bit(idx, cpuc->used_mask, cpu_pmu->num_events) {
+		event = cpuc->events[idx];
+		if (event && armv8pmu_event_has_user_read(event) &&
+		    event->hw.target == current)
+			return true;
+	}
+
+	return false;
+}
+
+static void armv8pmu_enable_user_access(struct arm_pmu *cpu_pmu,
+					struct pmu_hw_events *cpuc)
+{
+	int idx;
+
+	/* Clear any unused counters to avoid leaking their contents */
+	for_each_clear_bit(idx, cpuc->used_mask, cpu_pmu->num_events) {
+		if (idx == ARMV8_IDX_CYCLE_COUNTER)
+			write_sysreg(0, pmccntr_el0);
+		else if (armv8pmu_select_counter(idx) == idx)
+			write_sysreg(0, pmxevcntr_el0);
+	}
+
+	write_sysreg(ARMV8_PMU_USERENR_ER | ARMV8_PMU_USERENR_CR,
+		     pmuserenr_el0);
+}
+
+static inline void armv8pmu_disable_user_access(void)
+{
+	write_sysreg(0, pmuserenr_el0);
+}
+
 static void armv8pmu_start(struct arm_pmu *cpu_pmu)
 {
 	unsigned long flags;
 	struct pmu_hw_events *events = this_cpu_ptr(cpu_pmu->hw_events);
 
 	raw_spin_lock_irqsave(&events->pmu_lock, flags);
+	if (armv8pmu_want_user_access(cpu_pmu, events))
+		armv8pmu_enable_user_access(cpu_pmu, events);
 	/* Enable all counters */
 	armv8pmu_pmcr_write(armv8pmu_pmcr_read() | ARMV8_PMU_PMCR_E);
 	raw_spin_unlock_irqrestore(&events->pmu_lock, flags);
@@ -755,11 +829,56 @@ static void armv8pmu_stop(struct arm_pmu *cpu_pmu)
 	struct pmu_hw_events *events = this_cpu_ptr(cpu_pmu->hw_events);
 
 	raw_spin_lock_irqsave(&events->pmu_lock, flags);
+	armv8pmu_disable_user_access();
 	/* Disable all counters */
 	armv8pmu_pmcr_write(armv8pmu_pmcr_read() & ~ARMV8_PMU_PMCR_E);
 	raw_spin_unlock_irqrestore(&events->pmu_lock, flags);
 }
 
+static int armv8pmu_user_event_idx(struct perf_event *event)
+{
+	if (!sysctl_perf_user_access || !armv8pmu_event_has_user_read(event))
+		return 0;
+
+	/* Not on a counter: user space must fall back to read() */
+	if (event->hw.state & PERF_HES_STOPPED)
+		return 0;
+
+	if (event->hw.idx == ARMV8_IDX_CYCLE_COUNTER)
+		return ARMV8_IDX_CYCLE_COUNTER_USER;
+
+	return event->hw.idx;
+}
+
+void arch_perf_update_userpage(struct perf_event *event,
+			       struct perf_event_mmap_page *userpg, u64 now)
+{
+	u64 prev;
+
+	/* Only our own events carry ARMPMU_* flags in hw_perf_event */
+	if (event->pmu->event_idx != armv8pmu_user_event_idx)
+		return;
+
+	userpg->cap_user_rdpmc = armv8pmu_event_has_user_read(event);
+	if (!userpg->cap_user_rdpmc)
+		return;
+
+	/* We only count using the lower 32bits, even for PMCCNTR_EL0 */
+	userpg->pmc_width = 32;
+
+	/*
+	 * User space sign extends the counter it reads to pmc_width and
+	 * adds it to offset. prev_count is either the sign extended value
+	 * programmed by armpmu_event_set_period() or a raw, zero extended
+	 * value read back by armpmu_event_update(), so rebase offset on
+	 * the sign extended form of it.
+	 */
+	if (userpg->index) {
+		prev = local64_read(&event->hw.prev_count);
+		userpg->offset += prev - (u64)(s64)(s32)prev;
+	}
+}
+
 static int armv8pmu_get_event_idx(struct pmu_hw_events *cpuc,
 				  struct perf_event *event)
 {
@@ -860,6 +979,14 @@ static int __armv8_pmuv3_map_event(struct perf_event *event,
 	int hw_event_id;
 	struct arm_pmu *armpmu = to_arm_pmu(event->pmu);
 
+	if (event->attr.config1 & ARMV8_PMU_ATTR_RDPMC) {
+		/* Only a task can read its own counters */
+		if (!(event->attach_state & PERF_ATTACH_TASK))
+			return -EINVAL;
+		if (sysctl_perf_user_access)
+			event->hw.flags |= ARMPMU_EL0_RD_CNTR;
+	}
+
 	hw_event_id = armpmu_map_event(event, &armv8_pmuv3_perf_map,
 				       &armv8_pmuv3_perf_cache_map,
 				       ARMV8_PMU_EVTYPE_EVENT);
@@ -978,6 +1105,8 @@ static int armv8_pmu_init(struct arm_pmu *cpu_pmu)
 	cpu_pmu->set_event_filter	= armv8pmu_set_event_filter;
 	cpu_pmu->filter_match		= armv8pmu_filter_match;
 
+	cpu_pmu->pmu.event_idx		= armv8pmu_user_event_idx;
+
 	return 0;
 }
 
@@ -1135,8 +1264,26 @@ static struct platform_driver armv8_pmu_driver = {
 	.probe		= armv8_pmu_device_probe,
 };
 
+static int zero;
+static int one = 1;
+
+static struct ctl_table armv8_pmu_sysctl_table[] = {
+	{
+		.procname	= "perf_user_access",
+		.data		= &sysctl_perf_user_access,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &zero,
+		.extra2		= &one,
+	},
+	{ }
+};
+
 static int __init armv8_pmu_driver_init(void)
 {
+	register_sysctl("kernel", armv8_pmu_sysctl_table);
+
 	if (acpi_disabled)
 		return platform_driver_register(&armv8_pmu_driver);
 	else
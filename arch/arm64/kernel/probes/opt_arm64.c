@@ -0,0 +1,251 @@
+/*
+ * arch/arm64/kernel/probes/opt_arm64.c
+ *
+ * Kernel Probes Jump Optimization (Optprobes) for ARM64
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * Based on arch/arm/probes/kprobes/opt-arm.c
+ */
+
+#include <linux/kprobes.h>
+#include <linux/sizes.h>
+#include <linux/string.h>
+#include <asm/cacheflush.h>
+#include <asm/cpufeature.h>
+#include <asm/insn.h>
+#include <asm/kprobes.h>
+#include <asm/sysreg.h>
+
+#define TMPL_IDX(sym) \
+	((kprobe_opcode_t *)&(sym) - (kprobe_opcode_t *)&optprobe_template_entry)
+
+#define TMPL_RESTORE_ORIG_INSN	TMPL_IDX(optprobe_template_restore_orig_insn)
+#define TMPL_RESTORE_END	TMPL_IDX(optprobe_template_restore_end)
+#define TMPL_VAL_IDX		TMPL_IDX(optprobe_template_val)
+#define TMPL_CALL_IDX		TMPL_IDX(optprobe_template_call)
+#define TMPL_END_IDX		TMPL_IDX(optprobe_template_end)
+
+#define SYS_PSTATE_PAN		sys_reg(3, 0, 4, 2, 3)
+#define SYS_PSTATE_UAO		sys_reg(3, 0, 4, 2, 4)
+
+int arch_prepared_optinsn(struct arch_optimized_insn *optinsn)
+{
+	return optinsn->insn != NULL;
+}
+
+/*
+ * On ARM64, kprobe opt always replaces one instruction (4 bytes aligned
+ * and 4 bytes long). It is impossible to encounter another kprobe in the
+ * address range. So always return 0.
+ */
+int arch_check_optimized_kprobe(struct optimized_kprobe *op)
+{
+	return 0;
+}
+
+/*
+ * Only instructions which are executed out of line by a normal kprobe can
+ * be copied into the detour buffer and run there directly. Instructions
+ * that need simulation (branches, PC-relative loads and address
+ * generation) depend on the value of the PC and would need the trampoline
+ * to return to a computed address, so keep using the BRK based probe for
+ * them.
+ */
+static bool can_optimize(struct kprobe *kp)
+{
+	return kp->ainsn.api.insn != NULL;
+}
+
+/* 'b' reaches +/-128MiB */
+static bool in_branch_range(unsigned long pc, unsigned long addr)
+{
+	long offset = (long)addr - (long)pc;
+
+	return offset >= -SZ_128M && offset < SZ_128M;
+}
+
+/*
+ * The PSTATE the detour buffer builds lacks PAN and UAO, which the
+ * exception return of a redirected probe would otherwise clear.
+ */
+static void optprobe_fixup_pstate(struct pt_regs *regs)
+{
+	if (cpus_have_const_cap(ARM64_HAS_PAN))
+		regs->pstate |= read_sysreg_s(SYS_PSTATE_PAN) & PSR_PAN_BIT;
+	if (cpus_have_const_cap(ARM64_HAS_UAO))
+		regs->pstate |= read_sysreg_s(SYS_PSTATE_UAO) & PSR_UAO_BIT;
+}
+
+/*
+ * Returns non-zero when a pre_handler changed regs->pc: the detour buffer
+ * then resumes there instead of running the probed instruction.
+ */
+static int
+optimized_callback(struct optimized_kprobe *op, struct pt_regs *regs)
+{
+	unsigned long flags;
+	struct kprobe_ctlblk *kcb;
+	unsigned long orig_pc = (unsigned long)op->kp.addr;
+
+	/* This is possible if op is under delayed unoptimizing */
+	if (kprobe_disabled(&op->kp))
+		return 0;
+
+	/* Save skipped registers */
+	regs->pc = orig_pc;
+	regs->orig_x0 = ~0UL;
+
+	local_irq_save(flags);
+	kcb = get_kprobe_ctlblk();
+
+	if (kprobe_running()) {
+		kprobes_inc_nmissed_count(&op->kp);
+	} else {
+		__this_cpu_write(current_kprobe, &op->kp);
+		kcb->kprobe_status = KPROBE_HIT_ACTIVE;
+		opt_pre_handler(&op->kp, regs);
+		__this_cpu_write(current_kprobe, NULL);
+	}
+
+	local_irq_restore(flags);
+
+	if (regs->pc == orig_pc)
+		return 0;
+
+	optprobe_fixup_pstate(regs);
+	return 1;
+}
+NOKPROBE_SYMBOL(optimized_callback)
+
+int arch_prepare_optimized_kprobe(struct optimized_kprobe *op,
+				  struct kprobe *orig)
+{
+	kprobe_opcode_t *code;
+	unsigned long orig_addr = (unsigned long)orig->addr;
+	u32 insn;
+
+	if (!can_optimize(orig))
+		return -EILSEQ;
+
+	code = get_optinsn_slot();
+	if (!code)
+		return -ENOMEM;
+
+	/*
+	 * The probed instruction is replaced by a single 'b' to the detour
+	 * buffer and the buffer ends with a 'b' back, so both directions
+	 * must be within the +/-128MiB range of an imm26 branch. Slots come
+	 * from module_alloc(), which normally keeps this true, but a fully
+	 * randomized module region may put them out of reach.
+	 */
+	if (!in_branch_range(orig_addr, (unsigned long)code) ||
+	    !in_branch_range((unsigned long)&code[TMPL_RESTORE_END],
+			     orig_addr + sizeof(kprobe_opcode_t))) {
+		free_optinsn_slot(code, 0);
+		return -ERANGE;
+	}
+
+	/* Copy arch-dep-instance from template. */
+	memcpy(code, &optprobe_template_entry,
+	       TMPL_END_IDX * sizeof(kprobe_opcode_t));
+
+	/* The original probed instruction, executed after the handlers */
+	code[TMPL_RESTORE_ORIG_INSN] = cpu_to_le32(orig->opcode);
+
+	/* Jump back to next instruction */
+	insn = aarch64_insn_gen_branch_imm(
+			(unsigned long)&code[TMPL_RESTORE_END],
+			orig_addr + sizeof(kprobe_opcode_t),
+			AARCH64_INSN_BRANCH_NOLINK);
+	code[TMPL_RESTORE_END] = cpu_to_le32(insn);
+
+	/* Set probe information and probe function call */
+	*(unsigned long *)&code[TMPL_VAL_IDX] = (unsigned long)op;
+	*(unsigned long *)&code[TMPL_CALL_IDX] =
+		(unsigned long)optimized_callback;
+
+	flush_icache_range((unsigned long)code,
+			   (unsigned long)&code[TMPL_END_IDX]);
+
+	/* Set op->optinsn.insn means prepared. */
+	op->optinsn.insn = code;
+	return 0;
+}
+
+void __kprobes arch_optimize_kprobes(struct list_head *oplist)
+{
+	struct optimized_kprobe *op, *tmp;
+
+	list_for_each_entry_safe(op, tmp, oplist, list) {
+		void *addrs[1];
+		u32 insns[1];
+
+		WARN_ON(kprobe_disabled(&op->kp));
+
+		/*
+		 * Backup the instruction which will be replaced by the jump.
+		 * The text holds the BRK of the armed kprobe by now, the
+		 * original instruction is the one saved at prepare time.
+		 */
+		op->optinsn.copied_insn[0] = op->kp.opcode;
+
+		addrs[0] = op->kp.addr;
+		insns[0] = aarch64_insn_gen_branch_imm(
+				(unsigned long)op->kp.addr,
+				(unsigned long)op->optinsn.insn,
+				AARCH64_INSN_BRANCH_NOLINK);
+		BUG_ON(insns[0] == AARCH64_BREAK_FAULT);
+
+		/*
+		 * Replacing the BRK by a 'b' is a single aligned word write
+		 * of an instruction the architecture allows to be patched
+		 * concurrently, see aarch64_insn_hotpatch_safe().
+		 */
+		aarch64_insn_patch_text(addrs, insns, 1);
+
+		list_del_init(&op->list);
+	}
+}
+
+void arch_unoptimize_kprobe(struct optimized_kprobe *op)
+{
+	arch_arm_kprobe(&op->kp);
+}
+
+/*
+ * Recover original instructions and breakpoints from relative jumps.
+ * Caller must call with locking kprobe_mutex.
+ */
+void arch_unoptimize_kprobes(struct list_head *oplist,
+			    struct list_head *done_list)
+{
+	struct optimized_kprobe *op, *tmp;
+
+	list_for_each_entry_safe(op, tmp, oplist, list) {
+		arch_unoptimize_kprobe(op);
+		list_move(&op->list, done_list);
+	}
+}
+
+int arch_within_optimized_kprobe(struct optimized_kprobe *op,
+				 unsigned long addr)
+{
+	return ((unsigned long)op->kp.addr <= addr &&
+		(unsigned long)op->kp.addr + RELATIVEJUMP_SIZE > addr);
+}
+
+void arch_remove_optimized_kprobe(struct optimized_kprobe *op)
+{
+	if (op->optinsn.insn) {
+		free_optinsn_slot(op->optinsn.insn, 1);
+		op->optinsn.insn = NULL;
+	}
+}
@@ -0,0 +1,360 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Benchmark of the per-microarchitecture variants of the arm64 memory copy
+ * and fill routines.
+ *
+ * get_cycles() reads the architected timer on arm64, which usually runs
+ * much slower than the CPU, so the bytes/cycle figures are meant to compare
+ * the variants on one machine rather than machines with each other.
+ *
+ * Before being timed, every variant is checked at odd sizes and at all the
+ * misalignments of the source and destination, against a poisoned
+ * destination: the module fails to load on the first wrong byte.
+ */
+#include <linux/mm.h>
+#include <linux/mman.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/sizes.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+#include <asm/cpufeature.h>
+#include <asm/timex.h>
+
+#define __param(type, name, init, msg)		\
+	static type name = init;		\
+	module_param(name, type, 0444);		\
+	MODULE_PARM_DESC(name, msg);
+
+__param(int, loops, 1000, "Number of iterations per size class");
+
+#define MAX_SIZE	SZ_256K
+/* Room for the misaligned checks and their guard bytes on both sides */
+#define BUF_SIZE	(MAX_SIZE + 2 * PAGE_SIZE)
+
+static const size_t sizes[] = {
+	16, 64, 256, SZ_1K, SZ_4K, SZ_16K, SZ_64K, MAX_SIZE,
+};
+
+/* Head and tail bytes around the 16, 64 and 128 byte loops */
+static const size_t check_sizes[] = {
+	0, 1, 7, 15, 17, 31, 63, 65, 127, 129, 191, 255, 257, 4095,
+};
+
+#define CHECK_ALIGN	16
+#define CHECK_GUARD	64
+#define CHECK_POISON	0x6b
+#define MEMSET_BYTE	0x5a
+
+struct memops_variant {
+	const char *name;
+	void *(*memcpy)(void *, const void *, size_t);
+	void *(*memset)(void *, int, size_t);
+	void (*copy_page)(void *, const void *);
+	unsigned long (*copy_to_user)(void __user *, const void *,
+				      unsigned long);
+};
+
+/* In-order cores use the generic memset(), it has no loads to schedule */
+static const struct memops_variant variants[] = {
+	{
+		.name		= "generic",
+		.memcpy		= __memcpy_generic,
+		.memset		= __memset_generic,
+		.copy_page	= __copy_page_generic,
+		.copy_to_user	= __arch_copy_to_user_generic,
+	},
+	{
+		.name		= "inorder",
+		.memcpy		= __memcpy_inorder,
+		.copy_page	= __copy_page_inorder,
+		.copy_to_user	= __arch_copy_to_user_inorder,
+	},
+	{
+		.name		= "wide",
+		.memcpy		= __memcpy_wide,
+		.memset		= __memset_wide,
+		.copy_page	= __copy_page_wide,
+		.copy_to_user	= __arch_copy_to_user_wide,
+	},
+};
+
+enum memops_op {
+	OP_MEMCPY,
+	OP_MEMSET,
+	OP_MEMZERO,
+	OP_COPY_PAGE,
+	OP_COPY_TO_USER,
+};
+
+static const char * const op_names[] = {
+	[OP_MEMCPY]		= "memcpy",
+	[OP_MEMSET]		= "memset",
+	[OP_MEMZERO]		= "memset(0)",
+	[OP_COPY_PAGE]		= "copy_page",
+	[OP_COPY_TO_USER]	= "copy_to_user",
+};
+
+static char *src, *dst;
+static char __user *usermem;
+
+static int bench(const struct memops_variant *v, enum memops_op op,
+		 size_t size, cycles_t *time)
+{
+	unsigned long off;
+	cycles_t time1;
+	int i;
+
+	time1 = get_cycles();
+
+	switch (op) {
+	case OP_MEMCPY:
+		for (i = 0; i < loops; i++)
+			v->memcpy(dst, src, size);
+		break;
+	case OP_MEMSET:
+		for (i = 0; i < loops; i++)
+			v->memset(dst, MEMSET_BYTE, size);
+		break;
+	case OP_MEMZERO:
+		for (i = 0; i < loops; i++)
+			v->memset(dst, 0, size);
+		break;
+	case OP_COPY_PAGE:
+		/* Walk the whole buffer, as copying one page over is unlikely */
+		for (i = 0, off = 0; i < loops; i++) {
+			v->copy_page(dst + off, src + off);
+			off = (off + PAGE_SIZE) % MAX_SIZE;
+		}
+		break;
+	case OP_COPY_TO_USER:
+		for (i = 0; i < loops; i++)
+			if (v->copy_to_user(usermem, src, size))
+				return -EFAULT;
+		break;
+	}
+
+	*time = get_cycles() - time1;
+	return 0;
+}
+
+static u8 pattern(size_t i)
+{
+	return i * 7 + (i >> 9);
+}
+
+/*
+ * Run @op once on @size bytes at @soff and @doff bytes past a page
+ * boundary, with CHECK_GUARD bytes of poison around the destination, then
+ * compare every byte of the window with what it should hold. The poison is
+ * written and the user memory read back one byte at a time, so that none
+ * of the routines under test is relied upon.
+ */
+static int check(const struct memops_variant *v, enum memops_op op,
+		 size_t size, unsigned int soff, unsigned int doff)
+{
+	size_t i, start = CHECK_GUARD + doff, len = start + size + CHECK_GUARD;
+	char __user *uwin = usermem + PAGE_SIZE - CHECK_GUARD;
+	char *win = dst + PAGE_SIZE - CHECK_GUARD;
+	const char *s = src + PAGE_SIZE + soff;
+	u8 got, want;
+
+	for (i = 0; i < len; i++) {
+		if (op != OP_COPY_TO_USER)
+			WRITE_ONCE(win[i], CHECK_POISON);
+		else if (put_user(CHECK_POISON, uwin + i))
+			return -EFAULT;
+	}
+
+	switch (op) {
+	case OP_MEMCPY:
+		v->memcpy(win + start, s, size);
+		break;
+	case OP_MEMSET:
+		v->memset(win + start, MEMSET_BYTE, size);
+		break;
+	case OP_MEMZERO:
+		v->memset(win + start, 0, size);
+		break;
+	case OP_COPY_PAGE:
+		v->copy_page(win + start, s);
+		break;
+	case OP_COPY_TO_USER:
+		if (v->copy_to_user(uwin + start, s, size))
+			return -EFAULT;
+		break;
+	}
+
+	for (i = 0; i < len; i++) {
+		if (op != OP_COPY_TO_USER)
+			got = READ_ONCE(win[i]);
+		else if (get_user(got, uwin + i))
+			return -EFAULT;
+
+		if (i < start || i >= start + size)
+			want = CHECK_POISON;
+		else if (op == OP_MEMSET)
+			want = MEMSET_BYTE;
+		else if (op == OP_MEMZERO)
+			want = 0;
+		else
+			want = s[i - start];
+
+		if (got != want) {
+			printk(KERN_ERR "%s %s %zu bytes, src+%u dst+%u: byte %zd is %#x instead of %#x\n",
+			       op_names[op], v->name, size, soff, doff,
+			       (ssize_t)(i - start), got, want);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int check_op(const struct memops_variant *v, enum memops_op op)
+{
+	unsigned int soff, doff;
+	int i, err;
+
+	if (op == OP_COPY_PAGE)
+		return check(v, op, PAGE_SIZE, 0, 0);
+
+	for (i = 0; i < ARRAY_SIZE(check_sizes); i++) {
+		for (doff = 0; doff < CHECK_ALIGN; doff++) {
+			for (soff = 0; soff < CHECK_ALIGN; soff++) {
+				err = check(v, op, check_sizes[i], soff, doff);
+				if (err)
+					return err;
+
+				/* memset() has no source */
+				if (op == OP_MEMSET || op == OP_MEMZERO)
+					break;
+			}
+		}
+	}
+
+	/* and the sizes that get timed */
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		err = check(v, op, sizes[i], 0, 0);
+		if (err)
+			return err;
+	}
+
+	return 0;
+}
+
+static bool has_op(const struct memops_variant *v, enum memops_op op)
+{
+	switch (op) {
+	case OP_MEMCPY:
+		return v->memcpy;
+	case OP_MEMSET:
+	case OP_MEMZERO:
+		return v->memset;
+	case OP_COPY_PAGE:
+		return v->copy_page;
+	case OP_COPY_TO_USER:
+		return v->copy_to_user;
+	}
+	return false;
+}
+
+static int bench_op(enum memops_op op)
+{
+	const struct memops_variant *v;
+	u64 bytes, bpc;
+	cycles_t time;
+	int i, err;
+
+	for (v = variants; v < variants + ARRAY_SIZE(variants); v++) {
+		if (!has_op(v, op))
+			continue;
+
+		err = check_op(v, op);
+		if (err)
+			return err;
+
+		for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+			size_t size = op == OP_COPY_PAGE ? PAGE_SIZE : sizes[i];
+
+			/* Warm up the caches and fault in the user pages */
+			err = bench(v, op, size, &time);
+			if (!err)
+				err = bench(v, op, size, &time);
+			if (err)
+				return err;
+
+			/* Hundredths of a byte per cycle */
+			bytes = (u64)size * loops;
+			bpc = time ? div64_u64(bytes * 100, time) : 0;
+			printk(KERN_ALERT "%s %s %zu bytes -> %llu.%02llu bytes/cycle\n",
+			       op_names[op], v->name, size, bpc / 100, bpc % 100);
+
+			if (op == OP_COPY_PAGE)
+				break;
+		}
+	}
+
+	return 0;
+}
+
+static const char *selected_variant(void)
+{
+	if (cpus_have_const_cap(ARM64_INORDER_MEMOPS))
+		return "inorder";
+	if (cpus_have_const_cap(ARM64_WIDE_MEMOPS))
+		return "wide";
+	if (cpus_have_const_cap(ARM64_HAS_NO_HW_PREFETCH))
+		return "generic, with software prefetching";
+	return "generic";
+}
+
+static int memops_test_init(void)
+{
+	unsigned long user_addr;
+	int op, err = 0;
+	size_t i;
+
+	src = vmalloc(BUF_SIZE);
+	dst = vmalloc(BUF_SIZE);
+	if (!src || !dst) {
+		err = -ENOMEM;
+		goto out;
+	}
+	for (i = 0; i < BUF_SIZE; i++)
+		src[i] = pattern(i);
+
+	user_addr = vm_mmap(NULL, 0, BUF_SIZE, PROT_READ | PROT_WRITE,
+			    MAP_ANONYMOUS | MAP_PRIVATE, 0);
+	if (user_addr >= TASK_SIZE) {
+		err = -ENOMEM;
+		goto out;
+	}
+	usermem = (char __user *)user_addr;
+
+	printk(KERN_ALERT "memops variant selected at boot: %s\n",
+	       selected_variant());
+
+	for (op = OP_MEMCPY; op <= OP_COPY_TO_USER && !err; op++)
+		err = bench_op(op);
+
+	vm_munmap(user_addr, BUF_SIZE);
+out:
+	vfree(dst);
+	vfree(src);
+
+	if (err)
+		return err;
+	return -EAGAIN; /* Fail will directly unload the module */
+}
+
+static void memops_test_exit(void)
+{
+	printk(KERN_ALERT "test exit\n");
+}
+
+module_init(memops_test_init)
+module_exit(memops_test_exit)
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("arm64 memory copy and fill routines benchmark");
@@ -15,7 +15,6 @@
 #include <linux/compiler.h>
 #include <linux/sched.h>
 #include <linux/mm.h>
-#include <linux/vmacache.h>
 #include <linux/io.h>
 
 #include <asm/cacheflush.h>
@@ -74,8 +73,7 @@ do { \
 			high_vma->vm_prev->vm_next = NULL; \
 		else \
 			mm->mmap = NULL; \
-		rb_erase(&high_vma->vm_rb, &mm->mm_rb); \
-		vmacache_invalidate(mm); \
+		range_tree_erase(&mm->mm_rt, high_vma->vm_start); \
 		mm->map_count--; \
 		remove_vma(high_vma); \
 	} \
@@ -13,17 +13,16 @@
 #include <crypto/internal/hash.h>
 #include <crypto/internal/skcipher.h>
 #include <crypto/scatterwalk.h>
-#include <crypto/chacha20.h>
+#include <crypto/chacha20poly1305.h>
 #include <crypto/poly1305.h>
 #include <linux/err.h>
 #include <linux/init.h>
 #include <linux/kernel.h>
 #include <linux/module.h>
+#include <asm/unaligned.h>
 
 #include "internal.h"
 
-#define CHACHAPOLY_IV_SIZE	12
-
 struct chachapoly_instance_ctx {
 	struct crypto_skcipher_spawn chacha;
 	struct crypto_ahash_spawn poly;
@@ -703,6 +702,236 @@ static int rfc7539esp_create(struct crypto_template *tmpl, struct rtattr **tb)
 	return chachapoly_create(tmpl, tb, "rfc7539esp", 8);
 }
 
+/*
+ * Single pass ChaCha20-Poly1305 for drivers that only accelerate ChaCha20:
+ * each chunk of the skcipher walk is authenticated right after it has been
+ * encrypted, or right before it gets decrypted, while it is still hot in the
+ * cache.  Poly1305 goes through the best "poly1305" shash available.
+ */
+
+static void chachapoly_xor_generic(u32 *state, u8 *dst, const u8 *src,
+				   unsigned int bytes)
+{
+	u8 stream[CHACHA_BLOCK_SIZE];
+
+	while (bytes > 0) {
+		unsigned int n = min_t(unsigned int, bytes, CHACHA_BLOCK_SIZE);
+
+		chacha_block(state, stream, 20);
+		crypto_xor_cpy(dst, src, stream, n);
+		bytes -= n;
+		src += n;
+		dst += n;
+	}
+	memzero_explicit(stream, sizeof(stream));
+}
+
+static int chachapoly_shash_pad(struct shash_desc *desc, unsigned int len)
+{
+	static const u8 zero[POLY1305_BLOCK_SIZE];
+	unsigned int padlen, bs = POLY1305_BLOCK_SIZE;
+
+	padlen = (bs - (len % bs)) % bs;
+
+	return padlen ? crypto_shash_update(desc, zero, padlen) : 0;
+}
+
+static int chachapoly_shash_ad(struct shash_desc *desc,
+			       struct aead_request *req, unsigned int len)
+{
+	unsigned int assoclen = len;
+	struct scatter_walk walk;
+	int err = 0;
+
+	if (!len)
+		return 0;
+
+	scatterwalk_start(&walk, req->src);
+
+	do {
+		unsigned int n = scatterwalk_clamp(&walk, len);
+		u8 *p;
+
+		if (!n) {
+			scatterwalk_start(&walk, sg_next(walk.sg));
+			n = scatterwalk_clamp(&walk, len);
+		}
+		p = scatterwalk_map(&walk);
+
+		err = crypto_shash_update(desc, p, n);
+		len -= n;
+
+		scatterwalk_unmap(p);
+		scatterwalk_advance(&walk, n);
+		scatterwalk_done(&walk, 0, len);
+	} while (len && !err);
+
+	return err ?: chachapoly_shash_pad(desc, assoclen);
+}
+
+/*
+ * @xor_fn may be NULL, e.g. when the caller cannot use SIMD in the current
+ * context, in which case the generic ChaCha20 block function is used.
+ */
+int crypto_chachapoly_crypt_helper(struct aead_request *req, bool encrypt,
+				   chachapoly_xor_t xor_fn)
+{
+	struct crypto_aead *tfm = crypto_aead_reqtfm(req);
+	struct chachapoly_simd_ctx *ctx = crypto_aead_ctx(tfm);
+	SHASH_DESC_ON_STACK(desc, ctx->poly);
+	unsigned int assoclen = req->assoclen;
+	unsigned int cryptlen = req->cryptlen;
+	struct skcipher_walk walk;
+	struct {
+		__le64 assoclen;
+		__le64 cryptlen;
+	} tail;
+	u8 block[CHACHA_BLOCK_SIZE];
+	u8 tag[POLY1305_DIGEST_SIZE];
+	u8 iv[CHACHA_IV_SIZE];
+	u32 state[16];
+	int err;
+
+	if (!xor_fn)
+		xor_fn = chachapoly_xor_generic;
+
+	if (ctx->saltlen) {
+		/* the IV trails the AD, but is not authenticated */
+		if (assoclen < 8)
+			return -EINVAL;
+		assoclen -= 8;
+	}
+	if (!encrypt)
+		cryptlen -= POLY1305_DIGEST_SIZE;
+
+	memset(iv, 0, sizeof(__le32));
+	memcpy(iv + sizeof(__le32), ctx->salt, ctx->saltlen);
+	memcpy(iv + sizeof(__le32) + ctx->saltlen, req->iv,
+	       CHACHAPOLY_IV_SIZE - ctx->saltlen);
+	crypto_chacha_init(state, &ctx->chacha, iv);
+
+	/* the Poly1305 key is the start of the keystream block 0 */
+	chacha_block(state, block, 20);
+
+	desc->tfm = ctx->poly;
+	desc->flags = req->base.flags & CRYPTO_TFM_REQ_MAY_SLEEP;
+
+	err = crypto_shash_init(desc) ?:
+	      crypto_shash_update(desc, block, POLY1305_KEY_SIZE) ?:
+	      chachapoly_shash_ad(desc, req, assoclen);
+	memzero_explicit(block, sizeof(block));
+	if (err)
+		goto out;
+
+	if (encrypt)
+		err = skcipher_walk_aead_encrypt(&walk, req, false);
+	else
+		err = skcipher_walk_aead_decrypt(&walk, req, false);
+
+	while (walk.nbytes > 0) {
+		unsigned int nbytes = walk.nbytes;
+
+		if (nbytes < walk.total)
+			nbytes = round_down(nbytes, walk.stride);
+
+		if (!encrypt)
+			err = crypto_shash_update(desc, walk.src.virt.addr,
+						  nbytes);
+		if (!err) {
+			xor_fn(state, walk.dst.virt.addr, walk.src.virt.addr,
+			       nbytes);
+			if (encrypt)
+				err = crypto_shash_update(desc,
+							  walk.dst.virt.addr,
+							  nbytes);
+		}
+		if (err) {
+			/* a negative error ends the walk */
+			skcipher_walk_done(&walk, err);
+			break;
+		}
+
+		err = skcipher_walk_done(&walk, walk.nbytes - nbytes);
+	}
+	if (err)
+		goto out;
+
+	tail.assoclen = cpu_to_le64(assoclen);
+	tail.cryptlen = cpu_to_le64(cryptlen);
+
+	err = chachapoly_shash_pad(desc, cryptlen) ?:
+	      crypto_shash_finup(desc, (u8 *)&tail, sizeof(tail), tag);
+	if (err)
+		goto out;
+
+	if (encrypt) {
+		scatterwalk_map_and_copy(tag, req->dst,
+					 req->assoclen + cryptlen,
+					 sizeof(tag), 1);
+	} else {
+		scatterwalk_map_and_copy(block, req->src,
+					 req->assoclen + cryptlen,
+					 sizeof(tag), 0);
+		if (crypto_memneq(tag, block, sizeof(tag)))
+			err = -EBADMSG;
+	}
+
+out:
+	shash_desc_zero(desc);
+	memzero_explicit(state, sizeof(state));
+	return err;
+}
+EXPORT_SYMBOL_GPL(crypto_chachapoly_crypt_helper);
+
+int crypto_chachapoly_setkey(struct crypto_aead *tfm, const u8 *key,
+			     unsigned int keylen)
+{
+	struct chachapoly_simd_ctx *ctx = crypto_aead_ctx(tfm);
+	int i;
+
+	if (keylen != CHACHA_KEY_SIZE + ctx->saltlen)
+		return -EINVAL;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->chacha.key); i++)
+		ctx->chacha.key[i] = get_unaligned_le32(key + i * sizeof(u32));
+	ctx->chacha.nrounds = 20;
+
+	memcpy(ctx->salt, key + CHACHA_KEY_SIZE, ctx->saltlen);
+	return 0;
+}
+EXPORT_SYMBOL_GPL(crypto_chachapoly_setkey);
+
+int crypto_chachapoly_setauthsize(struct crypto_aead *tfm,
+				  unsigned int authsize)
+{
+	return chachapoly_setauthsize(tfm, authsize);
+}
+EXPORT_SYMBOL_GPL(crypto_chachapoly_setauthsize);
+
+int crypto_chachapoly_init_tfm(struct crypto_aead *tfm)
+{
+	struct chachapoly_simd_ctx *ctx = crypto_aead_ctx(tfm);
+	struct crypto_shash *poly;
+
+	poly = crypto_alloc_shash("poly1305", 0, 0);
+	if (IS_ERR(poly))
+		return PTR_ERR(poly);
+
+	ctx->poly = poly;
+	ctx->saltlen = CHACHAPOLY_IV_SIZE - crypto_aead_ivsize(tfm);
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(crypto_chachapoly_init_tfm);
+
+void crypto_chachapoly_exit_tfm(struct crypto_aead *tfm)
+{
+	struct chachapoly_simd_ctx *ctx = crypto_aead_ctx(tfm);
+
+	crypto_free_shash(ctx->poly);
+}
+EXPORT_SYMBOL_GPL(crypto_chachapoly_exit_tfm);
+
 static struct crypto_template rfc7539_tmpl = {
 	.name = "rfc7539",
 	.create = rfc7539_create,
@@ -1271,6 +1271,26 @@ static int do_test(const char *alg, u32 type, u32 mask, int m)
 		ret += tcrypt_test("sha3-512");
 		break;
 
+	case 52:
+		ret += tcrypt_test("xchacha20");
+		break;
+
+	case 53:
+		ret += tcrypt_test("xchacha12");
+		break;
+
+	case 54:
+		ret += tcrypt_test("nhpoly1305");
+		break;
+
+	case 55:
+		ret += tcrypt_test("adiantum(xchacha12,aes)");
+		break;
+
+	case 56:
+		ret += tcrypt_test("adiantum(xchacha20,aes)");
+		break;
+
 	case 100:
 		ret += tcrypt_test("hmac(md5)");
 		break;
@@ -1594,6 +1614,8 @@ static int do_test(const char *alg, u32 type, u32 mask, int m)
 	case 213:
 		test_aead_speed("rfc7539esp(chacha20,poly1305)", ENCRYPT, sec,
 				NULL, 0, 16, 8, aead_speed_template_36);
+		test_aead_speed("rfc7539(chacha20,poly1305)", ENCRYPT, sec,
+				NULL, 0, 16, 16, speed_template_32);
 		break;
 
 	case 214:
@@ -1601,6 +1623,24 @@ static int do_test(const char *alg, u32 type, u32 mask, int m)
 				  speed_template_32);
 		break;
 
+	case 215:
+		test_cipher_speed("xchacha20", ENCRYPT, sec, NULL, 0,
+				  speed_template_32);
+		test_cipher_speed("xchacha12", ENCRYPT, sec, NULL, 0,
+				  speed_template_32);
+		break;
+
+	case 216:
+		test_cipher_speed("adiantum(xchacha12,aes)", ENCRYPT, sec, NULL,
+				  0, speed_template_32);
+		test_cipher_speed("adiantum(xchacha12,aes)", DECRYPT, sec, NULL,
+				  0, speed_template_32);
+		test_cipher_speed("adiantum(xchacha20,aes)", ENCRYPT, sec, NULL,
+				  0, speed_template_32);
+		test_cipher_speed("adiantum(xchacha20,aes)", DECRYPT, sec, NULL,
+				  0, speed_template_32);
+		break;
+
 
 	case 300:
 		if (alg) {
@@ -1710,6 +1750,10 @@ static int do_test(const char *alg, u32 type, u32 mask, int m)
 		test_hash_speed("sha3-512", sec, generic_hash_speed_template);
 		if (mode > 300 && mode < 400) break;
 
+	case 326:
+		test_hash_speed("nhpoly1305", sec, nhpoly1305_speed_template);
+		if (mode > 300 && mode < 400) break;
+
 	case 399:
 		break;
 
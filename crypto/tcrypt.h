@@ -147,4 +147,16 @@ static struct hash_speed poly1305_speed_template[] = {
 	{  .blen = 0,	.plen = 0, }
 };
 
+/* NHPoly1305 takes a 1088-byte key, the per-update lengths are Adiantum's */
+static struct hash_speed nhpoly1305_speed_template[] = {
+	{ .blen = 16,	.plen = 16,	.klen = 1088, },
+	{ .blen = 496,	.plen = 496,	.klen = 1088, },
+	{ .blen = 1024,	.plen = 1024,	.klen = 1088, },
+	{ .blen = 4080,	.plen = 4080,	.klen = 1088, },
+	{ .blen = 4096,	.plen = 1024,	.klen = 1088, },
+
+	/* End marker */
+	{  .blen = 0,	.plen = 0,	.klen = 0, }
+};
+
 #endif	/* _CRYPTO_TCRYPT_H */
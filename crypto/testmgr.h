@@ -27,7 +27,7 @@
 #define MAX_DIGEST_SIZE		64
 #define MAX_TAP			8
 
-#define MAX_KEYLEN		160
+#define MAX_KEYLEN		1088
 #define MAX_IVLEN		32
 
 struct hash_testvec {
@@ -38,7 +38,7 @@ struct hash_testvec {
 	unsigned char tap[MAX_TAP];
 	unsigned short psize;
 	unsigned char np;
-	unsigned char ksize;
+	unsigned short ksize;
 };
 
 /*
@@ -4661,6 +4661,825 @@ static const struct hash_testvec poly1305_tv_template[] = {
 	},
 };
 
+/*
+ * NHPoly1305 test vectors, generated with an independent implementation of
+ * the NH and Poly1305 based hash function of Adiantum.
+ */
+static const struct hash_testvec nhpoly1305_tv_template[] = {
+	{
+		.key		= "\xc8\x13\xfa\x98\xe9\x2d\xe5\x18"
+				  "\x1c\x5a\xef\x1c\xb6\x66\x9d\xaa"
+				  "\xef\x15\xec\x31\x57\xac\x01\xe1"
+				  "\x1a\xd5\xab\xda\x2d\xa5\x85\x48"
+				  "\xb2\xb8\x35\x73\xf8\xfb\xc1\x52"
+				  "\xaa\x27\x35\x3e\x7a\x6e\xd2\x23"
+				  "\xc3\x6f\x58\x13\x09\x94\x91\xdc"
+				  "\x25\xda\x6f\xd1\x3e\xea\x6d\xb2"
+				  "\x99\x2a\x43\x74\xff\xa7\x8a\xcf"
+				  "\x76\x2a\xe9\x19\x0f\x23\x55\x92"
+				  "\x3a\x72\xa7\x1f\x02\x7b\xc5\x12"
+				  "\x93\x92\x68\xff\x5e\xa3\xc0\x84"
+				  "\x97\x5c\xf6\xdb\x30\x8a\x32\x6e"
+				  "\xc8\xe3\x2d\x1b\x2b\xa8\xc2\x74"
+				  "\x57\x4d\x20\x71\x80\x67\x5d\x38"
+				  "\x28\xc5\x72\x22\x57\xe9\x4a\xc0"
+				  "\xce\x29\x79\x9a\x4e\x6e\x7c\x5a"
+				  "\x2e\x4a\xe9\x86\x3b\xb5\x9f\x63"
+				  "\xfd\x94\x9c\xb4\x29\x72\x02\x24"
+				  "\x7a\x68\xdb\x56\xa0\xff\x41\xa2"
+				  "\xaa\x86\xc9\x94\x6a\x80\x65\xe4"
+				  "\x8b\x7d\x79\xb0\xec\x8e\x9c\x00"
+				  "\x7b\x1a\x4a\x42\x3e\x53\x7a\x7c"
+				  "\x42\xb8\xe6\x14\xd1\x0b\x9c\xe6"
+				  "\x3e\x20\x4e\x4e\xfe\xbb\x25\xfc"
+				  "\x9f\x21\x6d\x79\x11\xf1\x5f\x53"
+				  "\x52\xdd\xe8\x50\x49\x44\xad\x89"
+				  "\xaa\x77\xc8\x69\xd7\xda\x28\x16"
+				  "\x36\x57\xa1\x79\x5c\xf1\x84\xc2"
+				  "\xcd\xf7\x30\xcf\xdd\xfc\xe5\x46"
+				  "\x71\x1a\x87\x4f\xd8\xc6\xed\x79"
+				  "\x4f\x02\xa4\xe6\x35\x89\x38\xb9"
+				  "\x96\x69\x60\xf7\x6f\x52\xe8\x4c"
+				  "\x6c\x21\xdd\x38\x36\x29\x6b\x8a"
+				  "\x3f\xf8\xd2\x5c\xfb\x76\x00\xed"
+				  "\xeb\x1c\xaa\x42\xbe\x8b\xca\x5b"
+				  "\x1a\x27\x1f\x2d\x4d\xbd\xbe\xdc"
+				  "\x6d\x7f\xf1\xb6\x0b\x0f\x88\xff"
+				  "\x61\xce\x20\x61\x66\xf4\xd8\x06"
+				  "\xe7\x4d\xfa\xca\x48\xdf\xe1\x7d"
+				  "\x9e\x6a\xe0\x76\xe9\x04\xdd\x16"
+				  "\x7e\x0b\x8e\x40\x24\xee\xaa\x20"
+				  "\x0e\x1c\xd0\x5c\x7f\x8f\xe2\x5e"
+				  "\xc2\xb7\xa8\x59\xc1\xae\xaa\x22"
+				  "\x79\xbf\xe9\x2a\x7e\xbc\xa1\x98"
+				  "\x8b\xaf\x60\xd8\xf5\x56\xda\x1e"
+				  "\x84\x91\xaa\x84\x6c\xdd\x77\xc9"
+				  "\x30\x60\x30\xa0\xb8\xd4\xe5\x8c"
+				  "\x3d\xf6\xd9\xcd\xb6\x91\xd7\xc6"
+				  "\x4b\x25\xa6\xb1\x3b\xee\x1b\x19"
+				  "\xf1\xe4\x1b\xb8\x44\x57\xcf\x1a"
+				  "\xd3\x55\xad\x46\xd5\x31\xee\x59"
+				  "\x87\xa8\xd1\xce\xcf\x13\x9a\x74"
+				  "\xa4\x6a\x5f\x4c\x90\x15\xc8\xd2"
+				  "\x2e\x41\xc5\x4d\xd3\xc1\x55\x48"
+				  "\x3e\x7c\xf6\x85\xcd\x81\x07\xdf"
+				  "\x84\x1c\x8a\xbc\xc0\x47\xc0\x4c"
+				  "\xd0\x0b\xa7\xd0\xa6\xbc\xbb\xf3"
+				  "\x7e\xa2\xd1\x60\xb2\x99\xa8\x46"
+				  "\x99\xef\x3f\x00\x83\x65\x19\x12"
+				  "\x18\x63\x8f\xc7\x9e\x0b\x71\xc3"
+				  "\xa7\x23\xbb\xfa\xde\x43\xf1\xfa"
+				  "\x57\x98\xdb\x0b\x31\x35\xc1\x9b"
+				  "\xc6\x4e\xf0\x0a\xf3\x75\x44\xf3"
+				  "\x5b\x7c\xab\x56\x23\xc1\xbb\xec"
+				  "\x7e\x85\x0b\x6a\x88\x06\x85\xd1"
+				  "\x11\xe6\x8d\xc6\xf6\x07\x4e\x36"
+				  "\xf8\xf8\x49\xf5\x4a\xd5\xd1\xb4"
+				  "\x2a\xa6\x7c\x49\x01\x39\x07\x91"
+				  "\xe2\xfd\x53\x73\xef\x91\x4a\xab"
+				  "\x4f\xfb\x65\x91\x7f\xd8\xd5\x21"
+				  "\x79\x2d\x33\xc0\x5f\x81\x69\xfb"
+				  "\x36\x9c\x62\x34\xb3\x24\x7a\xc2"
+				  "\x4b\x4f\x71\xc1\x47\x7d\x8d\x39"
+				  "\x3d\x9f\xc1\x1f\x6a\xaa\x49\x74"
+				  "\xd9\x00\xe0\x5b\xb9\x8c\xcc\xee"
+				  "\x65\x60\x20\x17\xdf\xbf\x02\x2e"
+				  "\x46\x86\x26\xe1\xbe\xe3\xa0\x44"
+				  "\xbb\x6f\xfe\x47\x4b\x8c\xf5\xea"
+				  "\x7a\x55\x17\x90\x59\xde\x47\xa9"
+				  "\x58\x5e\xcc\x62\x90\xcb\x65\x6c"
+				  "\xf9\x8a\x94\xc0\x35\x72\x0c\xad"
+				  "\x8f\xa9\x13\xb3\xea\xa7\xd8\xd1"
+				  "\x60\xe2\x34\xca\xea\x2d\x4b\xdb"
+				  "\x55\xad\x1a\x36\x3f\x99\x0a\x3e"
+				  "\x70\x4c\x59\xf5\x0b\x9d\xbf\x38"
+				  "\x12\x8b\x9f\x00\x5a\xa0\xde\x90"
+				  "\x5f\x55\x47\x03\xa2\xb4\x7e\xdd"
+				  "\xb1\x05\x1b\x17\x8b\xd9\x1e\x3b"
+				  "\xb1\x24\x2e\x41\x24\xc7\x71\x9c"
+				  "\x5f\x33\xaf\x60\x77\x68\x51\xe3"
+				  "\xb3\xc2\x92\x34\x70\x7b\x99\x02"
+				  "\x11\xba\x2d\x26\xde\xb0\xa5\xdc"
+				  "\x6c\x4c\x02\xf0\x7c\x96\x4b\xc9"
+				  "\x2b\x1c\x15\x5e\x74\x32\x0c\x6d"
+				  "\xe7\xe7\xc1\x12\x08\xb4\x45\xd9"
+				  "\xb6\xe1\xac\xbf\x4a\x8b\x0e\x3c"
+				  "\xd8\xad\x12\xcd\xae\x99\xf6\xa5"
+				  "\x95\x7e\xe8\xe4\x53\x1a\x4c\x68"
+				  "\xf6\xe9\x25\x85\x64\x71\x4e\x3d"
+				  "\xcd\x14\x22\x9b\x2c\x96\x30\x9c"
+				  "\x24\xf0\xbd\xff\xf2\xfe\xeb\xeb"
+				  "\xa2\x6c\xb9\xc5\x1f\x16\x79\x3d"
+				  "\x4e\xb9\x08\x30\x18\x27\xa0\xfa"
+				  "\xfe\x46\x62\x7d\xa5\xc0\x6e\xef"
+				  "\xe6\xa0\x74\xee\xae\xd5\x72\xf6"
+				  "\x89\x28\xaf\xac\x24\x72\x2c\xba"
+				  "\xa1\x5c\x07\x84\xf1\xc9\x7b\xf5"
+				  "\xe6\x74\x3d\x5d\x0f\x43\xfc\x7f"
+				  "\xd2\xc6\x7d\x90\x20\x27\x8e\xce"
+				  "\xaa\x66\x23\xf8\xab\xab\xc3\x96"
+				  "\x22\x0a\x65\x79\xde\xa6\x1d\x5b"
+				  "\x50\xd5\x3d\x77\x5c\x74\x85\x3f"
+				  "\xe8\xed\x26\x92\xf5\xe7\x91\x79"
+				  "\x88\x4a\x2d\x18\xb7\x78\x51\xd0"
+				  "\xd7\x55\xa8\x6b\x74\xeb\xc5\x3d"
+				  "\x53\x3f\xcc\xaf\xcc\xfd\x3f\x53"
+				  "\x12\x32\x3b\x32\x1e\x5f\x73\x67"
+				  "\xd7\x8e\xc4\xf8\x4a\xa9\xb1\xd7"
+				  "\xb5\x5e\x73\xf6\xf8\x35\xd7\x17"
+				  "\xa2\xa8\x51\xc7\x6f\x17\xbb\x72"
+				  "\xd4\x86\x68\xa0\x5a\xc4\x92\x9d"
+				  "\x9c\xbc\x27\xb6\x49\xd4\x14\xd3"
+				  "\xa4\xc0\x19\x7c\x09\x0b\x80\xb6"
+				  "\xac\x7c\xd1\x47\xec\xa0\x44\xa4"
+				  "\x93\x72\x69\x2b\xae\x71\xe9\x70"
+				  "\x87\x16\xf6\x45\xc5\xec\xd5\x78"
+				  "\xef\xd2\xde\x36\x9a\x42\xec\x39"
+				  "\xe5\x3a\x95\xf8\x5e\xc3\x45\xd6"
+				  "\xf5\xdc\xa6\x38\x3c\x57\xf3\x08"
+				  "\x6e\x14\xe1\xac\x5c\xfc\x06\x5c"
+				  "\x54\x32\x90\xc6\x27\x2f\xfe\xa5"
+				  "\xc4\xf3\xc2\x0e\x9e\xf4\x97\x54"
+				  "\xff\xc2\x13\xf4\x08\x16\xff\x29"
+				  "\x16\x0c\xb6\x6c\xa5\x16\x43\x79"
+				  "\xe4\x47\xa6\x69\x66\x65\x59\x61",
+		.ksize		= 1088,
+		.plaintext	= "",
+		.psize		= 0,
+		.digest		= "\x00\x00\x00\x00\x00\x00\x00\x00"
+				  "\x00\x00\x00\x00\x00\x00\x00\x00",
+	}, {
+		.key		= "\xc8\x13\xfa\x98\xe9\x2d\xe5\x18"
+				  "\x1c\x5a\xef\x1c\xb6\x66\x9d\xaa"
+				  "\xef\x15\xec\x31\x57\xac\x01\xe1"
+				  "\x1a\xd5\xab\xda\x2d\xa5\x85\x48"
+				  "\xb2\xb8\x35\x73\xf8\xfb\xc1\x52"
+				  "\xaa\x27\x35\x3e\x7a\x6e\xd2\x23"
+				  "\xc3\x6f\x58\x13\x09\x94\x91\xdc"
+				  "\x25\xda\x6f\xd1\x3e\xea\x6d\xb2"
+				  "\x99\x2a\x43\x74\xff\xa7\x8a\xcf"
+				  "\x76\x2a\xe9\x19\x0f\x23\x55\x92"
+				  "\x3a\x72\xa7\x1f\x02\x7b\xc5\x12"
+				  "\x93\x92\x68\xff\x5e\xa3\xc0\x84"
+				  "\x97\x5c\xf6\xdb\x30\x8a\x32\x6e"
+				  "\xc8\xe3\x2d\x1b\x2b\xa8\xc2\x74"
+				  "\x57\x4d\x20\x71\x80\x67\x5d\x38"
+				  "\x28\xc5\x72\x22\x57\xe9\x4a\xc0"
+				  "\xce\x29\x79\x9a\x4e\x6e\x7c\x5a"
+				  "\x2e\x4a\xe9\x86\x3b\xb5\x9f\x63"
+				  "\xfd\x94\x9c\xb4\x29\x72\x02\x24"
+				  "\x7a\x68\xdb\x56\xa0\xff\x41\xa2"
+				  "\xaa\x86\xc9\x94\x6a\x80\x65\xe4"
+				  "\x8b\x7d\x79\xb0\xec\x8e\x9c\x00"
+				  "\x7b\x1a\x4a\x42\x3e\x53\x7a\x7c"
+				  "\x42\xb8\xe6\x14\xd1\x0b\x9c\xe6"
+				  "\x3e\x20\x4e\x4e\xfe\xbb\x25\xfc"
+				  "\x9f\x21\x6d\x79\x11\xf1\x5f\x53"
+				  "\x52\xdd\xe8\x50\x49\x44\xad\x89"
+				  "\xaa\x77\xc8\x69\xd7\xda\x28\x16"
+				  "\x36\x57\xa1\x79\x5c\xf1\x84\xc2"
+				  "\xcd\xf7\x30\xcf\xdd\xfc\xe5\x46"
+				  "\x71\x1a\x87\x4f\xd8\xc6\xed\x79"
+				  "\x4f\x02\xa4\xe6\x35\x89\x38\xb9"
+				  "\x96\x69\x60\xf7\x6f\x52\xe8\x4c"
+				  "\x6c\x21\xdd\x38\x36\x29\x6b\x8a"
+				  "\x3f\xf8\xd2\x5c\xfb\x76\x00\xed"
+				  "\xeb\x1c\xaa\x42\xbe\x8b\xca\x5b"
+				  "\x1a\x27\x1f\x2d\x4d\xbd\xbe\xdc"
+				  "\x6d\x7f\xf1\xb6\x0b\x0f\x88\xff"
+				  "\x61\xce\x20\x61\x66\xf4\xd8\x06"
+				  "\xe7\x4d\xfa\xca\x48\xdf\xe1\x7d"
+				  "\x9e\x6a\xe0\x76\xe9\x04\xdd\x16"
+				  "\x7e\x0b\x8e\x40\x24\xee\xaa\x20"
+				  "\x0e\x1c\xd0\x5c\x7f\x8f\xe2\x5e"
+				  "\xc2\xb7\xa8\x59\xc1\xae\xaa\x22"
+				  "\x79\xbf\xe9\x2a\x7e\xbc\xa1\x98"
+				  "\x8b\xaf\x60\xd8\xf5\x56\xda\x1e"
+				  "\x84\x91\xaa\x84\x6c\xdd\x77\xc9"
+				  "\x30\x60\x30\xa0\xb8\xd4\xe5\x8c"
+				  "\x3d\xf6\xd9\xcd\xb6\x91\xd7\xc6"
+				  "\x4b\x25\xa6\xb1\x3b\xee\x1b\x19"
+				  "\xf1\xe4\x1b\xb8\x44\x57\xcf\x1a"
+				  "\xd3\x55\xad\x46\xd5\x31\xee\x59"
+				  "\x87\xa8\xd1\xce\xcf\x13\x9a\x74"
+				  "\xa4\x6a\x5f\x4c\x90\x15\xc8\xd2"
+				  "\x2e\x41\xc5\x4d\xd3\xc1\x55\x48"
+				  "\x3e\x7c\xf6\x85\xcd\x81\x07\xdf"
+				  "\x84\x1c\x8a\xbc\xc0\x47\xc0\x4c"
+				  "\xd0\x0b\xa7\xd0\xa6\xbc\xbb\xf3"
+				  "\x7e\xa2\xd1\x60\xb2\x99\xa8\x46"
+				  "\x99\xef\x3f\x00\x83\x65\x19\x12"
+				  "\x18\x63\x8f\xc7\x9e\x0b\x71\xc3"
+				  "\xa7\x23\xbb\xfa\xde\x43\xf1\xfa"
+				  "\x57\x98\xdb\x0b\x31\x35\xc1\x9b"
+				  "\xc6\x4e\xf0\x0a\xf3\x75\x44\xf3"
+				  "\x5b\x7c\xab\x56\x23\xc1\xbb\xec"
+				  "\x7e\x85\x0b\x6a\x88\x06\x85\xd1"
+				  "\x11\xe6\x8d\xc6\xf6\x07\x4e\x36"
+				  "\xf8\xf8\x49\xf5\x4a\xd5\xd1\xb4"
+				  "\x2a\xa6\x7c\x49\x01\x39\x07\x91"
+				  "\xe2\xfd\x53\x73\xef\x91\x4a\xab"
+				  "\x4f\xfb\x65\x91\x7f\xd8\xd5\x21"
+				  "\x79\x2d\x33\xc0\x5f\x81\x69\xfb"
+				  "\x36\x9c\x62\x34\xb3\x24\x7a\xc2"
+				  "\x4b\x4f\x71\xc1\x47\x7d\x8d\x39"
+				  "\x3d\x9f\xc1\x1f\x6a\xaa\x49\x74"
+				  "\xd9\x00\xe0\x5b\xb9\x8c\xcc\xee"
+				  "\x65\x60\x20\x17\xdf\xbf\x02\x2e"
+				  "\x46\x86\x26\xe1\xbe\xe3\xa0\x44"
+				  "\xbb\x6f\xfe\x47\x4b\x8c\xf5\xea"
+				  "\x7a\x55\x17\x90\x59\xde\x47\xa9"
+				  "\x58\x5e\xcc\x62\x90\xcb\x65\x6c"
+				  "\xf9\x8a\x94\xc0\x35\x72\x0c\xad"
+				  "\x8f\xa9\x13\xb3\xea\xa7\xd8\xd1"
+				  "\x60\xe2\x34\xca\xea\x2d\x4b\xdb"
+				  "\x55\xad\x1a\x36\x3f\x99\x0a\x3e"
+				  "\x70\x4c\x59\xf5\x0b\x9d\xbf\x38"
+				  "\x12\x8b\x9f\x00\x5a\xa0\xde\x90"
+				  "\x5f\x55\x47\x03\xa2\xb4\x7e\xdd"
+				  "\xb1\x05\x1b\x17\x8b\xd9\x1e\x3b"
+				  "\xb1\x24\x2e\x41\x24\xc7\x71\x9c"
+				  "\x5f\x33\xaf\x60\x77\x68\x51\xe3"
+				  "\xb3\xc2\x92\x34\x70\x7b\x99\x02"
+				  "\x11\xba\x2d\x26\xde\xb0\xa5\xdc"
+				  "\x6c\x4c\x02\xf0\x7c\x96\x4b\xc9"
+				  "\x2b\x1c\x15\x5e\x74\x32\x0c\x6d"
+				  "\xe7\xe7\xc1\x12\x08\xb4\x45\xd9"
+				  "\xb6\xe1\xac\xbf\x4a\x8b\x0e\x3c"
+				  "\xd8\xad\x12\xcd\xae\x99\xf6\xa5"
+				  "\x95\x7e\xe8\xe4\x53\x1a\x4c\x68"
+				  "\xf6\xe9\x25\x85\x64\x71\x4e\x3d"
+				  "\xcd\x14\x22\x9b\x2c\x96\x30\x9c"
+				  "\x24\xf0\xbd\xff\xf2\xfe\xeb\xeb"
+				  "\xa2\x6c\xb9\xc5\x1f\x16\x79\x3d"
+				  "\x4e\xb9\x08\x30\x18\x27\xa0\xfa"
+				  "\xfe\x46\x62\x7d\xa5\xc0\x6e\xef"
+				  "\xe6\xa0\x74\xee\xae\xd5\x72\xf6"
+				  "\x89\x28\xaf\xac\x24\x72\x2c\xba"
+				  "\xa1\x5c\x07\x84\xf1\xc9\x7b\xf5"
+				  "\xe6\x74\x3d\x5d\x0f\x43\xfc\x7f"
+				  "\xd2\xc6\x7d\x90\x20\x27\x8e\xce"
+				  "\xaa\x66\x23\xf8\xab\xab\xc3\x96"
+				  "\x22\x0a\x65\x79\xde\xa6\x1d\x5b"
+				  "\x50\xd5\x3d\x77\x5c\x74\x85\x3f"
+				  "\xe8\xed\x26\x92\xf5\xe7\x91\x79"
+				  "\x88\x4a\x2d\x18\xb7\x78\x51\xd0"
+				  "\xd7\x55\xa8\x6b\x74\xeb\xc5\x3d"
+				  "\x53\x3f\xcc\xaf\xcc\xfd\x3f\x53"
+				  "\x12\x32\x3b\x32\x1e\x5f\x73\x67"
+				  "\xd7\x8e\xc4\xf8\x4a\xa9\xb1\xd7"
+				  "\xb5\x5e\x73\xf6\xf8\x35\xd7\x17"
+				  "\xa2\xa8\x51\xc7\x6f\x17\xbb\x72"
+				  "\xd4\x86\x68\xa0\x5a\xc4\x92\x9d"
+				  "\x9c\xbc\x27\xb6\x49\xd4\x14\xd3"
+				  "\xa4\xc0\x19\x7c\x09\x0b\x80\xb6"
+				  "\xac\x7c\xd1\x47\xec\xa0\x44\xa4"
+				  "\x93\x72\x69\x2b\xae\x71\xe9\x70"
+				  "\x87\x16\xf6\x45\xc5\xec\xd5\x78"
+				  "\xef\xd2\xde\x36\x9a\x42\xec\x39"
+				  "\xe5\x3a\x95\xf8\x5e\xc3\x45\xd6"
+				  "\xf5\xdc\xa6\x38\x3c\x57\xf3\x08"
+				  "\x6e\x14\xe1\xac\x5c\xfc\x06\x5c"
+				  "\x54\x32\x90\xc6\x27\x2f\xfe\xa5"
+				  "\xc4\xf3\xc2\x0e\x9e\xf4\x97\x54"
+				  "\xff\xc2\x13\xf4\x08\x16\xff\x29"
+				  "\x16\x0c\xb6\x6c\xa5\x16\x43\x79"
+				  "\xe4\x47\xa6\x69\x66\x65\x59\x61",
+		.ksize		= 1088,
+		.plaintext	= "\x54\x5a\x1b\x8a\x34\xea\x83\x0c"
+				  "\xc0\x1f\x12\x1e\x7d\xbe\xbd\xe6"
+				  "\x12",
+		.psize		= 17,
+		.digest		= "\xa5\x08\x6f\x67\x01\xb5\xc1\x1c"
+				  "\x68\xd4\x9e\x36\xb3\xf4\xf5\x94",
+		.np		= 2,
+		.tap		= { 1, 16 },
+	}, {
+		.key		= "\x6e\xc3\x93\x19\x47\x2f\x28\xc5"
+				  "\x3d\x0f\x61\xb3\xc0\xe3\x9e\xd5"
+				  "\xf2\xa5\xec\xb1\x78\x69\x69\x23"
+				  "\xb5\x3a\xdb\x50\x9a\x21\x99\xd7"
+				  "\x7e\x1b\x9d\xdb\xb2\xc9\x13\xdc"
+				  "\x27\x91\xb7\x44\xac\x84\xe3\x7f"
+				  "\xad\x15\xcd\xa7\x6c\xf3\x6c\x63"
+				  "\xc3\x0c\x0d\x93\x26\xf5\x65\xb7"
+				  "\xf8\xbb\x05\xba\xd2\xfb\xdb\x3a"
+				  "\xc5\x7c\xd1\xa0\x54\x7c\x5a\xba"
+				  "\xa0\xf8\x0b\x59\x50\xde\xee\x81"
+				  "\xa6\xff\xea\x84\x98\xed\x5c\xef"
+				  "\x60\x0b\xa0\x0a\x36\x25\x9a\xdc"
+				  "\x85\x61\x3d\xaa\xfd\x8c\x84\x28"
+				  "\x29\xa9\x8c\x32\xec\xc9\xbc\x22"
+				  "\xc9\xc7\x59\x5e\x1f\x84\x09\xd3"
+				  "\x27\x6e\x18\xef\x16\x6b\xcd\xaa"
+				  "\xe4\x4b\x66\x07\xa9\x14\x05\xf6"
+				  "\xd9\xbc\x46\xc8\xd1\xd0\xea\x20"
+				  "\x87\xfd\xc3\x7d\x29\x5a\xfe\x21"
+				  "\x2c\x1c\x48\x14\xdb\xc8\x13\x59"
+				  "\x1b\x59\x96\xf5\x6f\xfc\xb4\xb5"
+				  "\x13\xb8\xa4\xce\x1b\x7f\x37\xea"
+				  "\x77\x51\xce\xe5\x8a\xb3\x54\x5c"
+				  "\x7e\xce\x26\xaf\x59\x1f\xc6\x15"
+				  "\x25\xb4\x74\x5f\x00\xbd\xe6\xee"
+				  "\x75\x30\x85\x60\x94\xf7\x40\x2f"
+				  "\x9e\xbf\x64\x04\x8d\xf1\x23\x34"
+				  "\x10\x5f\xd9\xc9\x2b\xce\x9a\x7f"
+				  "\x37\xee\x0d\xed\xd8\xa2\x04\x56"
+				  "\x2f\x40\x0b\x0e\xcd\xa0\x80\x1b"
+				  "\xc9\x4d\x5a\xb0\xbc\x5b\x44\x38"
+				  "\x62\x51\x6f\xd5\x0c\x69\xf0\x59"
+				  "\x99\x45\x70\x33\x69\xa4\x56\x12"
+				  "\xa9\x68\xc6\xde\xd9\x8d\x1d\xda"
+				  "\xc9\x35\xa2\x70\x58\x32\xd1\xd7"
+				  "\x6f\xf3\xca\x88\x6a\x68\x61\x8b"
+				  "\x51\x83\x91\x48\x70\x2f\x4a\x32"
+				  "\x8d\x40\xa5\x18\x1a\x33\x20\xcb"
+				  "\x3a\x19\x92\x88\xfb\xd9\x67\x83"
+				  "\x4a\x0c\x5e\xd4\x17\x20\x53\xb3"
+				  "\x66\xbf\x6f\x95\x9e\x06\x8e\xb2"
+				  "\x34\xc2\x16\x6d\x81\xcc\x3e\xd8"
+				  "\xe5\x4e\x54\x3c\x5f\x48\xfe\xfb"
+				  "\x14\xdc\x7d\x1d\x2e\xa8\x6c\xe3"
+				  "\x6a\xda\x40\x4d\x47\x47\x5a\x2e"
+				  "\x5a\xc4\xb0\x9d\xa6\xcc\x84\x09"
+				  "\x5d\xfc\x87\x5a\x92\x6b\x20\xe5"
+				  "\x22\x41\x0b\x4b\x7c\x0f\x19\x03"
+				  "\x45\x45\x22\x15\x5a\x2f\xb2\x1e"
+				  "\x6c\xf3\x26\xee\x0c\x9d\x8a\x13"
+				  "\xff\x2f\xce\x56\xfb\xa0\xb3\xfa"
+				  "\x83\x4b\x78\xe0\xa6\x9d\xc5\x3a"
+				  "\x21\x79\xe9\x68\xd5\x57\x47\xf2"
+				  "\xc4\x33\x97\x26\xae\x6b\x14\x47"
+				  "\xb1\xf8\xc6\x86\xf6\xf8\x6d\xba"
+				  "\x1b\x2b\xd0\x62\xdd\xa9\x96\x76"
+				  "\x05\x0f\xde\x49\x0b\x4f\xf8\x0d"
+				  "\x52\xed\x20\x0b\x3b\x76\x32\xc4"
+				  "\x5a\x4a\xb6\xd8\x5b\xa4\x4f\x24"
+				  "\x66\x5d\x3f\xa9\x87\xd9\x96\xe8"
+				  "\x8e\x40\x05\x59\x0f\xdb\x70\xc0"
+				  "\xa4\x59\x4b\x95\x43\xfd\xa0\xa3"
+				  "\x94\xbc\xa2\x97\x97\xf9\xa2\x50"
+				  "\xac\x6f\x06\xa3\x17\x80\x27\x73"
+				  "\x3b\xfe\x3f\x26\xe9\x58\xba\xe0"
+				  "\x4d\x43\xf5\x4c\x51\xb5\x2b\x15"
+				  "\x61\x26\x76\x02\xa8\xce\x72\x68"
+				  "\x37\x79\xd5\x81\xc3\xd3\xef\x94"
+				  "\xab\x52\x93\xea\x66\xb0\xad\x0e"
+				  "\x12\xae\x9b\xaa\x2f\x19\x44\x1b"
+				  "\xae\xc6\x1e\x81\x20\xfd\x69\x80"
+				  "\x78\x2a\xa4\x4a\xd7\x9e\xc6\xb2"
+				  "\x22\x5b\x8c\x76\x03\x55\xbb\x2f"
+				  "\xf2\x9a\x8c\xad\xcb\xe8\x17\x1d"
+				  "\x95\xb1\x0b\x54\xd5\x83\x29\x8c"
+				  "\xe2\x2c\xb8\x0d\xec\xdd\x30\xd5"
+				  "\x38\xdc\x9e\x4f\x25\x38\x74\xae"
+				  "\x83\x9e\xc6\x0b\x94\x2d\x36\xff"
+				  "\xbd\xfb\xbe\x51\x91\x8a\x27\x9e"
+				  "\x25\x20\xee\xf9\x3d\x59\x43\x56"
+				  "\xe0\x96\x9e\xc0\x82\x51\xa9\x4f"
+				  "\xae\x08\xbf\x20\xb4\x92\xb9\x18"
+				  "\xc1\x6d\x76\xc0\x0b\x30\xb7\xc6"
+				  "\x45\xef\xe0\xa9\xac\x2a\x88\x9f"
+				  "\xc4\x23\x0d\x69\xc4\x2a\x41\x05"
+				  "\xb4\x4a\x42\x07\x66\x14\x7c\x7c"
+				  "\xe4\x31\xe1\x58\x37\xe3\x22\xb3"
+				  "\x4f\x8a\x27\xf8\x4e\x16\xfa\x1a"
+				  "\xb5\x60\x91\x5a\x74\xa8\x0b\x42"
+				  "\x2a\x63\x14\xc2\x44\x35\x83\x21"
+				  "\x55\x8d\x0c\x0c\x84\xc4\xea\xbd"
+				  "\xf5\x9a\x48\x82\xfa\x2f\xac\x3c"
+				  "\x24\xe4\xbc\xec\xc2\xa6\xbc\xff"
+				  "\x20\x62\x87\x9c\x80\x36\x9e\x92"
+				  "\xdc\x90\x20\x87\x99\x8b\x4b\x2c"
+				  "\x2e\x91\x74\x8b\x17\xbb\x23\xfd"
+				  "\xcc\x42\xaa\xfd\xf0\x3c\xff\xf9"
+				  "\x91\xcf\x01\x96\xfa\x04\x53\x80"
+				  "\xfd\xcc\xe6\xbd\xae\x08\x2f\x15"
+				  "\x30\xda\xc3\x56\x21\x3b\x2d\xa6"
+				  "\x85\x56\x08\x8d\x9a\x1d\x22\x17"
+				  "\xd1\x3b\xf9\x34\xd8\x7f\xd1\xc5"
+				  "\x12\x71\x82\x8f\x55\x87\x8c\x92"
+				  "\x71\x0e\xab\x8a\xf4\x40\x5d\x31"
+				  "\x53\x93\x53\x6c\xea\xbb\x7a\x00"
+				  "\xff\x1b\xb4\x58\xf2\x9a\xfb\xb4"
+				  "\x37\x4f\x3f\x45\x4d\x48\x63\x9f"
+				  "\x3a\x01\x44\x0c\x39\x81\xf8\xdb"
+				  "\xd4\x6e\xbd\x14\x06\x77\x2a\xff"
+				  "\x68\x3b\xcf\x7a\xf0\xe3\x2c\xcc"
+				  "\x63\x1a\xc1\x63\x15\xd9\x70\xd9"
+				  "\x8b\x17\x4d\xbb\x5e\x2d\xb2\x16"
+				  "\x50\x45\xad\xf1\x8c\x45\xa4\x6b"
+				  "\x26\x92\x56\x95\x0b\xca\x00\xb6"
+				  "\x6f\xc6\xda\x0a\x7d\x62\x14\x66"
+				  "\xfd\xfa\xea\x86\x55\x60\xe8\x47"
+				  "\x6f\x25\xe8\xc6\xf2\xa8\x0b\x7b"
+				  "\xed\x1a\x6f\x44\x5d\x69\x0a\xf2"
+				  "\x5c\x0b\xc5\x0e\x0a\x37\x1c\x93"
+				  "\x2b\x70\xb8\x6b\x35\xd2\xa2\x1c"
+				  "\xd3\x6e\xcc\x62\xa0\x94\x8d\x08"
+				  "\xee\xc6\xb5\x38\xcf\xf6\x49\x46"
+				  "\x91\x43\x03\x1d\xdf\x1e\x59\x67"
+				  "\x3d\xc1\x9a\x69\x1d\x29\x60\x46"
+				  "\x03\x22\xe5\x93\x16\x3e\x8e\xf5"
+				  "\x68\xf5\x82\x51\x47\x2e\xed\xb9"
+				  "\x3d\x12\x18\x79\x5f\x58\x87\x13"
+				  "\xaa\xc4\x41\x27\x5c\x60\x29\xd8"
+				  "\x8f\x0e\xaf\xaf\x3f\x71\x76\x16"
+				  "\x6b\x78\xd6\x38\x36\x83\xe7\x20"
+				  "\x7d\xfa\x74\xe5\x78\x7f\xe5\xc8"
+				  "\xdd\x7a\xea\xc6\xd7\x84\xb3\xf3"
+				  "\x3f\x2f\xe5\x47\x42\x10\xcd\xd1"
+				  "\x86\xc1\x97\xc8\x6c\x1a\xb4\xc5"
+				  "\x9c\x95\x27\x7a\x99\x25\xe2\xfb",
+		.ksize		= 1088,
+		.plaintext	= "\x4a\xab\x2f\x4e\x1d\xa2\xd9\x62"
+				  "\x1a\x68\x31\x46\x08\x2f\xff\x15"
+				  "\xc6\xc8\xc1\xbe\xb3\x4c\x27\x8e"
+				  "\xd6\x28\xcd\x75\xb9\x55\x84\x09"
+				  "\x84\x46\x57\x50\x6e\x42\xc2\x4d"
+				  "\x4c\x7a\x72\x74\xe3\x28\x1a\x58"
+				  "\xdc\xf5\x18\xf3\x94\x2e\x91\x3a"
+				  "\xd0\xba\x5f\x5f\x71\xeb\x3d\x13"
+				  "\x7f\x0d\x72\x13\x4e\x7a\x18\x3a"
+				  "\xc2\x20\x49\x80\xe5\xe3\x23\x81"
+				  "\x43\x6f\x0f\xa3\x8b\x1c\x74\x8f"
+				  "\xe9\x41\x80\xf6\x49\x87\x66\x32"
+				  "\x35\x0c\x73\x9c\xe8\x49\x7c\x70"
+				  "\x98\x01\x6f\x49\xcc\x5f\x2f\x44"
+				  "\xcd\xc5\x5a\x6b\xfc\xa4\x0b\xf8"
+				  "\x34\x36\x32\xd1\x43\xa4\xce\x3b"
+				  "\x8d\xdb\x8d\xfb\x8c\x38\x6a\x1d"
+				  "\xd2\xf9\x93\x49\xac\xe4\xf3\x79"
+				  "\x60\xe6\xd8\xda\x06\x86\x8d\x68"
+				  "\xd9\x63\x59\x5d\xa1\x88\xdb\xec"
+				  "\x84\x8d\x48\xe3\x67\x18\x04\x6a"
+				  "\xff\x8b\x3c\x3c\xf5\x04\x69\xa5"
+				  "\x31\xdc\x97\xca\x8b\xc8\x0f\xf1"
+				  "\xea\xfe\x82\x72\xe5\x85\x17\xfe"
+				  "\xd8\xc0\xdf\xc6\x7a\x2b\xdd\x40"
+				  "\x60\x6e\x39\x13\x44\x50\xcd\xc8"
+				  "\xcd\xc7\xbe\x2f\x4e\xe0\xfd\xba"
+				  "\x2a\xa9\x53\x06\x60\xa4\x31\x25"
+				  "\xfe\x9a\x99\x47\xe4\xf4\x00\xcc"
+				  "\x35\xa1\x42\x1a\xfd\x04\xcb\x71"
+				  "\x20\x22\x47\x19\x83\xb9\x1a\x84"
+				  "\xc2\x7b\xcc\x95\x28\xcc\x78\x2b"
+				  "\x23\x22\x38\xe6\xb7\x71\x3c\x55"
+				  "\xb1\xb4\x97\x1a\x4d\xef\xce\x2e"
+				  "\xde\xa0\xd1\x80\x1f\x21\xd1\x57"
+				  "\x6c\xfb\x8e\x37\x76\x38\x0a\x34"
+				  "\xdd\x78\x1e\xbe\xe4\xa7\xf6\xc6"
+				  "\x23\x5c\x7a\x28\xd5\xc0\x78\xda"
+				  "\xfb\x0b\x98\xe3\x32\x2a\xcd\x48"
+				  "\x78\x52\x4e\xff\xdc\x97\x21\x12"
+				  "\x0e\x7e\xef\xfe\xc2\xe4\x36\x01"
+				  "\x45\x9f\x89\x04\x56\xa3\x9c\x0d"
+				  "\xd7\x77\xd4\x21\x80\xd0\xbb\x27"
+				  "\xe4\x50\xbe\x61\xb6\x7e\x68\x4d"
+				  "\xbb\x9e\x40\x1c\xf5\xaf\x18\x76"
+				  "\x87\x43\x4b\x65\x9f\xbf\x05\x41"
+				  "\xed\xf3\x84\x7e\x88\xff\x29\xd9"
+				  "\x8f\x86\x93\x44\xf0\x3c\xd9\xb4"
+				  "\xdc\x24\x33\x79\x26\xf6\x30\x68"
+				  "\x08\xc0\x08\x15\x02\x26\xbf\x35"
+				  "\x1f\x43\x48\x10\xee\x9f\x0e\x8f"
+				  "\x53\x6a\xfd\x8b\x01\x9d\xa8\xbd"
+				  "\x81\x70\x9e\x15\x9c\xd7\x9b\x95"
+				  "\x51\xa5\xfe\x90\xc1\xdd\x4e\x15"
+				  "\x67\xa8\x24\xb8\x2f\x16\xa7\x9f"
+				  "\x32\xb7\x5a\xc6\xc0\x96\x11\x27"
+				  "\x28\xaa\xa5\x3a\x6e\xf8\xc7\x3b"
+				  "\x7c\xf9\x13\x36\xdd\xb6\x55\xaf"
+				  "\x81\x9d\xa0\x25\x69\xf6\x9e\x4d"
+				  "\x1c\xa5\x8e\xe4\xad\x76\x51\xb3"
+				  "\xb7\x9e\x21\x5c\x35\xa5\x76\xd6"
+				  "\x66\x43\x42\x85\xd6\xc2\x59\x05"
+				  "\x78\x8a\x17\x8b\xea\x70\x44\x61"
+				  "\xdb\x95\xda\x8d\xd3\x40\xc7\xbc"
+				  "\xd5\x2d\x04\x51\x50\x6c\x6f\x34"
+				  "\x4a\xc9\x77\x84\xb4\xfc\x17\x35"
+				  "\xdf\xd1\xdd\xe0\x89\x94\xa1\x04"
+				  "\xf6\x62\x23\xf5\xa1\x0d\x08\x7c"
+				  "\x85\x37\xd8\xcf\x4f\xc3\x66\xf9"
+				  "\xb0\xe6\x77\x43\xb1\x5b\x35\x3e"
+				  "\x8e\xc1\x29\x3f\xf3\x7a\x70\x9a"
+				  "\xcb\x3a\xc2\x73\x6c\xec\xe0\xa4"
+				  "\xb3\x6b\xbf\x2c\x90\x22\x17\x03"
+				  "\xa6\x7d\x8c\xf5\x3c\xe8\x0c\xe7"
+				  "\x72\xd9\xe1\x48\x8e\x1c\xf9\xac"
+				  "\xc8\x14\x20\x0a\xb7\x74\x63\x81"
+				  "\x78\x20\x90\x69\xe0\xee\xf3\x92"
+				  "\xd9\x5a\xfe\xf1\x27\x16\x53\xf6"
+				  "\xd9\xe4\x3a\xef\x5e\x0c\xf7\x97"
+				  "\x68\xf6\xd2\x49\xcc\x64\xca\x33"
+				  "\x59\x48\x04\x0f\xbd\x85\x7c\xf0"
+				  "\x9e\x87\x1f\x56\x81\x18\x42\xd1"
+				  "\x28\x18\xd0\x26\x89\x87\xb5\xb0"
+				  "\x23\x1d\x37\x08\x62\x0d\x23\x0e"
+				  "\x11\x7e\x55\x9a\x93\x21\x76\xc1"
+				  "\x2b\x8e\x62\x00\x8f\x8b\x3c\x6c"
+				  "\x9c\x35\x2a\x56\xd1\x20\x46\xda"
+				  "\xba\xba\xa3\x98\x43\x63\x59\x4c"
+				  "\x8d\xf0\xb7\xb3\x32\x98\x45\x16"
+				  "\x29\x38\x16\x75\x52\x0a\xc7\xe4"
+				  "\xd5\xcf\xbc\x42\x23\xa6\x0d\xf2"
+				  "\xc6\x19\x59\xac\xa2\x8f\xfb\xe0"
+				  "\x1a\xc6\x44\xf2\x43\xa0\xff\x92"
+				  "\x34\xd9\x98\x9a\x72\xb9\x1b\xdc"
+				  "\x85\xcb\xff\x78\x24\x14\x1f\x72"
+				  "\x8d\xfb\xa5\xda\x35\x1d\xee\x00"
+				  "\xf3\xfa\x59\xdf\x86\x10\x38\x4b"
+				  "\xa9\x8b\x98\x06\xe7\x3b\x74\x5a"
+				  "\x7b\x02\x3e\x49\x55\x8d\xd9\x7c"
+				  "\x03\xe9\xc1\x56\x94\x4b\xc0\xd9"
+				  "\x1a\x4a\xdd\x94\x64\x75\x47\xf3"
+				  "\xf4\xd5\x74\x14\xa3\x22\x95\xb9"
+				  "\x95\x5c\x70\x6e\xb0\xcb\x8e\x38"
+				  "\xf2\x20\x3c\xe7\xd2\x0e\x14\x5d"
+				  "\x38\xa6\xcf\x5c\xc9\x0f\x55\xce"
+				  "\xfa\xb3\x6f\xc1\x9c\xed\xd6\xa6"
+				  "\x6a\x77\xfb\x81\x13\xf0\xf6\x0e"
+				  "\xd2\x4a\x3b\x46\x03\x67\x66\x32"
+				  "\xe0\xa6\x63\xd9\x39\x96\x66\x35"
+				  "\x04\xea\x0e\x6d\xe8\xcb\x29\xac"
+				  "\x6e\x63\x22\x70\x15\x0e\xab\x83"
+				  "\x80\x6b\x8d\x65\xeb\x42\x75\x45"
+				  "\x58\x65\x6d\xd8\x17\xf2\xff\x8e"
+				  "\x9e\x8c\x84\xf4\x7e\x9f\xb2\xef"
+				  "\x61\xe4\x4a\x21\x6c\x89\xac\xe7"
+				  "\x36\x31\x49\x9b\x3d\x83\xdf\x22"
+				  "\xd0\x3f\x61\x8d\x85\xd2\x1c\xfe"
+				  "\x12\x22\x39\x3d\x8b\x0c\x97\xc9"
+				  "\x67\x9b\x65\x4a\x44\x51\x25\x2c"
+				  "\xbc\xd0\x30\x43\xf5\xb1\x74\x4c"
+				  "\xa4\x87\x3f\xef\x73\xf1\x41\x5e"
+				  "\xe9\x82\x16\xe9\x72\x89\xee\xd8"
+				  "\xca\x1a\xa7\x4d\xd4\x57\x22\xcc"
+				  "\xb4\x50\x0e\x24\x03\xa6\x53\x79"
+				  "\xcf\x7b\xd3\x3c\xda\x36\x1c\x36"
+				  "\xd8\xe2\xf2\x22\xc1\xa6\x32\x48"
+				  "\x68\x50\x8a\xa3\x43\xc0\x60\x7b"
+				  "\x6f\xda\x3e\x97\xe3\x5f\x7c\xe5"
+				  "\x36\x46\x36\x52\xdd\xd8\x60\x08"
+				  "\x33\xe7\x7e\x27\xd0\x0f\x0a\x91",
+		.psize		= 1040,
+		.digest		= "\x01\x87\x7d\xea\xd1\x08\xdb\x50"
+				  "\x77\xdc\x9f\x9d\x43\x1e\x45\x81",
+	}, {
+		.key		= "\x6e\xc3\x93\x19\x47\x2f\x28\xc5"
+				  "\x3d\x0f\x61\xb3\xc0\xe3\x9e\xd5"
+				  "\xf2\xa5\xec\xb1\x78\x69\x69\x23"
+				  "\xb5\x3a\xdb\x50\x9a\x21\x99\xd7"
+				  "\x7e\x1b\x9d\xdb\xb2\xc9\x13\xdc"
+				  "\x27\x91\xb7\x44\xac\x84\xe3\x7f"
+				  "\xad\x15\xcd\xa7\x6c\xf3\x6c\x63"
+				  "\xc3\x0c\x0d\x93\x26\xf5\x65\xb7"
+				  "\xf8\xbb\x05\xba\xd2\xfb\xdb\x3a"
+				  "\xc5\x7c\xd1\xa0\x54\x7c\x5a\xba"
+				  "\xa0\xf8\x0b\x59\x50\xde\xee\x81"
+				  "\xa6\xff\xea\x84\x98\xed\x5c\xef"
+				  "\x60\x0b\xa0\x0a\x36\x25\x9a\xdc"
+				  "\x85\x61\x3d\xaa\xfd\x8c\x84\x28"
+				  "\x29\xa9\x8c\x32\xec\xc9\xbc\x22"
+				  "\xc9\xc7\x59\x5e\x1f\x84\x09\xd3"
+				  "\x27\x6e\x18\xef\x16\x6b\xcd\xaa"
+				  "\xe4\x4b\x66\x07\xa9\x14\x05\xf6"
+				  "\xd9\xbc\x46\xc8\xd1\xd0\xea\x20"
+				  "\x87\xfd\xc3\x7d\x29\x5a\xfe\x21"
+				  "\x2c\x1c\x48\x14\xdb\xc8\x13\x59"
+				  "\x1b\x59\x96\xf5\x6f\xfc\xb4\xb5"
+				  "\x13\xb8\xa4\xce\x1b\x7f\x37\xea"
+				  "\x77\x51\xce\xe5\x8a\xb3\x54\x5c"
+				  "\x7e\xce\x26\xaf\x59\x1f\xc6\x15"
+				  "\x25\xb4\x74\x5f\x00\xbd\xe6\xee"
+				  "\x75\x30\x85\x60\x94\xf7\x40\x2f"
+				  "\x9e\xbf\x64\x04\x8d\xf1\x23\x34"
+				  "\x10\x5f\xd9\xc9\x2b\xce\x9a\x7f"
+				  "\x37\xee\x0d\xed\xd8\xa2\x04\x56"
+				  "\x2f\x40\x0b\x0e\xcd\xa0\x80\x1b"
+				  "\xc9\x4d\x5a\xb0\xbc\x5b\x44\x38"
+				  "\x62\x51\x6f\xd5\x0c\x69\xf0\x59"
+				  "\x99\x45\x70\x33\x69\xa4\x56\x12"
+				  "\xa9\x68\xc6\xde\xd9\x8d\x1d\xda"
+				  "\xc9\x35\xa2\x70\x58\x32\xd1\xd7"
+				  "\x6f\xf3\xca\x88\x6a\x68\x61\x8b"
+				  "\x51\x83\x91\x48\x70\x2f\x4a\x32"
+				  "\x8d\x40\xa5\x18\x1a\x33\x20\xcb"
+				  "\x3a\x19\x92\x88\xfb\xd9\x67\x83"
+				  "\x4a\x0c\x5e\xd4\x17\x20\x53\xb3"
+				  "\x66\xbf\x6f\x95\x9e\x06\x8e\xb2"
+				  "\x34\xc2\x16\x6d\x81\xcc\x3e\xd8"
+				  "\xe5\x4e\x54\x3c\x5f\x48\xfe\xfb"
+				  "\x14\xdc\x7d\x1d\x2e\xa8\x6c\xe3"
+				  "\x6a\xda\x40\x4d\x47\x47\x5a\x2e"
+				  "\x5a\xc4\xb0\x9d\xa6\xcc\x84\x09"
+				  "\x5d\xfc\x87\x5a\x92\x6b\x20\xe5"
+				  "\x22\x41\x0b\x4b\x7c\x0f\x19\x03"
+				  "\x45\x45\x22\x15\x5a\x2f\xb2\x1e"
+				  "\x6c\xf3\x26\xee\x0c\x9d\x8a\x13"
+				  "\xff\x2f\xce\x56\xfb\xa0\xb3\xfa"
+				  "\x83\x4b\x78\xe0\xa6\x9d\xc5\x3a"
+				  "\x21\x79\xe9\x68\xd5\x57\x47\xf2"
+				  "\xc4\x33\x97\x26\xae\x6b\x14\x47"
+				  "\xb1\xf8\xc6\x86\xf6\xf8\x6d\xba"
+				  "\x1b\x2b\xd0\x62\xdd\xa9\x96\x76"
+				  "\x05\x0f\xde\x49\x0b\x4f\xf8\x0d"
+				  "\x52\xed\x20\x0b\x3b\x76\x32\xc4"
+				  "\x5a\x4a\xb6\xd8\x5b\xa4\x4f\x24"
+				  "\x66\x5d\x3f\xa9\x87\xd9\x96\xe8"
+				  "\x8e\x40\x05\x59\x0f\xdb\x70\xc0"
+				  "\xa4\x59\x4b\x95\x43\xfd\xa0\xa3"
+				  "\x94\xbc\xa2\x97\x97\xf9\xa2\x50"
+				  "\xac\x6f\x06\xa3\x17\x80\x27\x73"
+				  "\x3b\xfe\x3f\x26\xe9\x58\xba\xe0"
+				  "\x4d\x43\xf5\x4c\x51\xb5\x2b\x15"
+				  "\x61\x26\x76\x02\xa8\xce\x72\x68"
+				  "\x37\x79\xd5\x81\xc3\xd3\xef\x94"
+				  "\xab\x52\x93\xea\x66\xb0\xad\x0e"
+				  "\x12\xae\x9b\xaa\x2f\x19\x44\x1b"
+				  "\xae\xc6\x1e\x81\x20\xfd\x69\x80"
+				  "\x78\x2a\xa4\x4a\xd7\x9e\xc6\xb2"
+				  "\x22\x5b\x8c\x76\x03\x55\xbb\x2f"
+				  "\xf2\x9a\x8c\xad\xcb\xe8\x17\x1d"
+				  "\x95\xb1\x0b\x54\xd5\x83\x29\x8c"
+				  "\xe2\x2c\xb8\x0d\xec\xdd\x30\xd5"
+				  "\x38\xdc\x9e\x4f\x25\x38\x74\xae"
+				  "\x83\x9e\xc6\x0b\x94\x2d\x36\xff"
+				  "\xbd\xfb\xbe\x51\x91\x8a\x27\x9e"
+				  "\x25\x20\xee\xf9\x3d\x59\x43\x56"
+				  "\xe0\x96\x9e\xc0\x82\x51\xa9\x4f"
+				  "\xae\x08\xbf\x20\xb4\x92\xb9\x18"
+				  "\xc1\x6d\x76\xc0\x0b\x30\xb7\xc6"
+				  "\x45\xef\xe0\xa9\xac\x2a\x88\x9f"
+				  "\xc4\x23\x0d\x69\xc4\x2a\x41\x05"
+				  "\xb4\x4a\x42\x07\x66\x14\x7c\x7c"
+				  "\xe4\x31\xe1\x58\x37\xe3\x22\xb3"
+				  "\x4f\x8a\x27\xf8\x4e\x16\xfa\x1a"
+				  "\xb5\x60\x91\x5a\x74\xa8\x0b\x42"
+				  "\x2a\x63\x14\xc2\x44\x35\x83\x21"
+				  "\x55\x8d\x0c\x0c\x84\xc4\xea\xbd"
+				  "\xf5\x9a\x48\x82\xfa\x2f\xac\x3c"
+				  "\x24\xe4\xbc\xec\xc2\xa6\xbc\xff"
+				  "\x20\x62\x87\x9c\x80\x36\x9e\x92"
+				  "\xdc\x90\x20\x87\x99\x8b\x4b\x2c"
+				  "\x2e\x91\x74\x8b\x17\xbb\x23\xfd"
+				  "\xcc\x42\xaa\xfd\xf0\x3c\xff\xf9"
+				  "\x91\xcf\x01\x96\xfa\x04\x53\x80"
+				  "\xfd\xcc\xe6\xbd\xae\x08\x2f\x15"
+				  "\x30\xda\xc3\x56\x21\x3b\x2d\xa6"
+				  "\x85\x56\x08\x8d\x9a\x1d\x22\x17"
+				  "\xd1\x3b\xf9\x34\xd8\x7f\xd1\xc5"
+				  "\x12\x71\x82\x8f\x55\x87\x8c\x92"
+				  "\x71\x0e\xab\x8a\xf4\x40\x5d\x31"
+				  "\x53\x93\x53\x6c\xea\xbb\x7a\x00"
+				  "\xff\x1b\xb4\x58\xf2\x9a\xfb\xb4"
+				  "\x37\x4f\x3f\x45\x4d\x48\x63\x9f"
+				  "\x3a\x01\x44\x0c\x39\x81\xf8\xdb"
+				  "\xd4\x6e\xbd\x14\x06\x77\x2a\xff"
+				  "\x68\x3b\xcf\x7a\xf0\xe3\x2c\xcc"
+				  "\x63\x1a\xc1\x63\x15\xd9\x70\xd9"
+				  "\x8b\x17\x4d\xbb\x5e\x2d\xb2\x16"
+				  "\x50\x45\xad\xf1\x8c\x45\xa4\x6b"
+				  "\x26\x92\x56\x95\x0b\xca\x00\xb6"
+				  "\x6f\xc6\xda\x0a\x7d\x62\x14\x66"
+				  "\xfd\xfa\xea\x86\x55\x60\xe8\x47"
+				  "\x6f\x25\xe8\xc6\xf2\xa8\x0b\x7b"
+				  "\xed\x1a\x6f\x44\x5d\x69\x0a\xf2"
+				  "\x5c\x0b\xc5\x0e\x0a\x37\x1c\x93"
+				  "\x2b\x70\xb8\x6b\x35\xd2\xa2\x1c"
+				  "\xd3\x6e\xcc\x62\xa0\x94\x8d\x08"
+				  "\xee\xc6\xb5\x38\xcf\xf6\x49\x46"
+				  "\x91\x43\x03\x1d\xdf\x1e\x59\x67"
+				  "\x3d\xc1\x9a\x69\x1d\x29\x60\x46"
+				  "\x03\x22\xe5\x93\x16\x3e\x8e\xf5"
+				  "\x68\xf5\x82\x51\x47\x2e\xed\xb9"
+				  "\x3d\x12\x18\x79\x5f\x58\x87\x13"
+				  "\xaa\xc4\x41\x27\x5c\x60\x29\xd8"
+				  "\x8f\x0e\xaf\xaf\x3f\x71\x76\x16"
+				  "\x6b\x78\xd6\x38\x36\x83\xe7\x20"
+				  "\x7d\xfa\x74\xe5\x78\x7f\xe5\xc8"
+				  "\xdd\x7a\xea\xc6\xd7\x84\xb3\xf3"
+				  "\x3f\x2f\xe5\x47\x42\x10\xcd\xd1"
+				  "\x86\xc1\x97\xc8\x6c\x1a\xb4\xc5"
+				  "\x9c\x95\x27\x7a\x99\x25\xe2\xfb",
+		.ksize		= 1088,
+		.plaintext	= "\xf3\x24\xc9\x68\x4a\x12\x60\xbf"
+				  "\x3e\x52\x9b\x09\xf9\xd2\x50\x95"
+				  "\x3f\x9a\x4e\x48\x46\x5c\xfb\xae"
+				  "\x23\x6b\x16\x31\xf5\xd2\x5f\x01"
+				  "\xab\x16\x2b\xc7\xf2\xa9\xd2\x11"
+				  "\xeb\x35\x70\x8f\xb8\xa5\x47\x66"
+				  "\xd7\x40\x4a\x9b\x60\xf6\x14\xf0"
+				  "\x0e\xe8\x2f\x39\xff\xdd\x7d\x72"
+				  "\x6b\xde\x8d\x6d\x30\x3d\xc6\x76"
+				  "\x4e\xd9\xfb\xfb\xcb\xd1\x5b\xf5"
+				  "\x92\x3c\x1c\x4c\xfd\xc9\xad\x6e"
+				  "\x5b\x5f\x39\xde\xac\x58\x0c\xf2"
+				  "\xe2\xb3\xb0\x84\xbe\xc6\x47\x2f"
+				  "\xae\xa3\x2d\x59\xb0\x17\xcd\xc5"
+				  "\x21\xd5\x5d\x1e\xf0\x88\x09\x6d"
+				  "\x04\x2c\x3b\xdd\xad\xd7\xa3\xa2"
+				  "\xc2\xd6\x97\x85\x03\x10\xa8\x72"
+				  "\xc7\xd5\x42\xe1\x6a\xab\x6d\x44"
+				  "\x48\x21\x08\x33\x57\xa3\xb4\x05"
+				  "\x71\x23\x7d\xf7\xf5\xb6\x20\x88"
+				  "\x56\xe2\xaf\xb9\xb7\x6f\x93\x09"
+				  "\x48\xe4\x81\xda\xce\xc6\x21\x81"
+				  "\x77\x51\x88\x13\xa1\x4d\xf7\xb1"
+				  "\xe6\xe9\x40\x82\x50\x46\x7c\x69"
+				  "\xe1\xa1\x48\x51\xc0\xd7\x32\x16"
+				  "\xde\x4e\xe3\xcc\xf9\x7d\xdc\x9f"
+				  "\x2e\x8a\x06\xe1\x25\x78\xdb\xef"
+				  "\xff\xa8\xc4\xb2\x10\xae\x4a\xd3"
+				  "\xa0\x27\x75\x87\xb3\xfd\xb6\x98"
+				  "\x8b\x70\x62\x1f\x1a\x1a\xce\x2f"
+				  "\x42\xee\x52\xb0\x13\x9f\x37\x07"
+				  "\x02\xc2\x92\xfa\x73\xa8\x93\xd6"
+				  "\x0b\x30\xa7\x9e\x20\x22\xd7\x2e"
+				  "\x63\xad\x5a\x67\xe0\x54\x15\x0d"
+				  "\x3c\x61\xa1\x16\x9d\x7c\xc8\x58"
+				  "\xbb\x59\x0e\x88\xcc\x77\x51\x22"
+				  "\xd7\x7a\x43\x2d\xe9\x84\xa7\xa1"
+				  "\xe8\x90\x60\x4c\x24\x5b\xf7\xe6"
+				  "\xd6\xf0\xbd\xea\x03\xf1\x6b\x84"
+				  "\xd8\xf5\x05\xce\xa3\x1e\xc1\xff"
+				  "\xee\xf3\x4a\x0e\x8e\x75\xd3\xba"
+				  "\xc3\xa9\x59\x2c\xc6\x21\x9c\x99"
+				  "\x46\x95\x3f\xd5\xa8\x09\x53\x57"
+				  "\x46\x5e\xc4\x9a\x8d\x44\x96\x31"
+				  "\x31\x75\x63\x5b\x0d\xa0\x5f\x13"
+				  "\x20\x4f\x93\x70\x8a\x65\xa1\x86"
+				  "\x89\x95\x1b\x24\x53\x2f\x3e\x91"
+				  "\x2d\x35\xf7\x9b\x34\x70\x5d\x62"
+				  "\x87\xce\x3a\xfd\xa3\x2d\x00\x9f"
+				  "\x78\x5a\x99\x34\x9b\x23\x83\x51"
+				  "\x5d\xc3\x8b\x0b\x6d\x37\xb9\xc0"
+				  "\x2c\x97\x20\x87\xac\x1a\xe4\x69"
+				  "\x28\x9e\xb2\xa2\xfa\x3d\x34\xd2"
+				  "\x2d\x2e\xa2\xc3\x88\x4d\xaa\x8a"
+				  "\xd3\x76\xfc\x06\x8e\x69\x81\x5a"
+				  "\xbd\x65\x29\x74\x87\xa1\xe9\xcc"
+				  "\xeb\x28\x9d\xda\xca\x40\x5f\xb5"
+				  "\x74\x7f\xc1\x6c\xa6\x0d\xba\xb6"
+				  "\x82\xdf\xa0\x12\x73\x59\x52\x00"
+				  "\xf0\x81\x76\x72\x9d\x4b\xfd\x8f"
+				  "\xfb\xf7\x16\xef\x88\xd7\x4f\x72"
+				  "\xf5\x01\xd5\xd1\xa6\x0c\x8a\xf1"
+				  "\xea\xf0\x81\x44\xa0\x5e\xf4\x41"
+				  "\x1b\x86\x52\x12\x09\x20\x20\x98"
+				  "\x95\x96\xc4\x63\x90\x0c\x2f\x3b"
+				  "\xcc\xe4\x5c\x24\x2b\xdd\x87\x19"
+				  "\x08\x3e\x5c\xb5\xbb\xe5\x60\x06"
+				  "\xc7\x1c\xbf\x8d\xf7\xae\x20\x8e"
+				  "\xfb\x53\xa0\x13\x4f\x0e\xd3\x53"
+				  "\xb2\xff\xb8\x8c\x5c\x7a\xa6\xbb"
+				  "\x8b\x4d\x28\xf9\x6d\x9d\xa7\x92"
+				  "\x78\x7e\x62\xd0\xcc\x73\x12\x3c"
+				  "\xc9\x4c\xd6\xae\xc6\x1b\xba\x66"
+				  "\x56\xc3\xe2\xa4\xb7\x9a\x23\x1b"
+				  "\x83\xa7\x8b\xd5\xb3\x88\xb2\xd1"
+				  "\x29\xa8\x57\xc5\xe7\xce\x88\xbf"
+				  "\x7b\x24\x4c\x41\x09\xb4\x13\xa5"
+				  "\x9d\xd6\xf4\xaa\x58\x45\xbf\x30"
+				  "\x70\xac\x6f\x6a\x97\x5c\x1f\x75"
+				  "\x36\x64\xf4\xbd\x4f\x62\xfa\x98"
+				  "\x73\x84\x82\xd3\xfb\xc6\x9e\x9c"
+				  "\xc2\x65\x13\x61\x1e\x2d\x7a\x53"
+				  "\xb0\xfc\xb4\x2a\x2e\x4a\xbf\x9d"
+				  "\x6c\x88\x03\x32\x27\xf8\xe5\x6b"
+				  "\x10\xbb\x21\xac\xdb\x3c\xd0\x31"
+				  "\xbf\x26\x31\x04\x6a\x47\x5f\x7a"
+				  "\x6e\x08\xbd\x29\x66\x7c\x87\xfd"
+				  "\x51\xbd\xaf\x2f\x71\xce\x0c\x86"
+				  "\x39\x3f\xdc\x21\x65\x62\x9d\xe1"
+				  "\x03\xdb\x6d\x3d\x13\x3d\xa8\x4e"
+				  "\xb0\xe8\xd5\xa3\xbc\x20\x1b\x9e"
+				  "\x20\x67\x3f\xcf\xc6\xb7\x20\x18"
+				  "\xf5\x22\x9b\x75\xb6\xea\x84\xba"
+				  "\x3f\xba\x34\x86\x65\x40\xf5\x38"
+				  "\x20\xdb\xb6\x5e\xd4\x05\xa2\x4f"
+				  "\xed\x95\x06\x85\x7e\x3e\xc6\x51"
+				  "\x0c\xd4\x78\xd8\x70\x3d\x14\x4a"
+				  "\xa4\xcf\x71\x72\x7f\x15\x2f\x2c"
+				  "\x8c\x7d\x74\x19\x6e\x83\x25\x71"
+				  "\xcd\x0d\x03\xa6\xd0\x53\xb4\x2e"
+				  "\x6a\xc7\xba\x95\xe8\x23\xc5\xc9"
+				  "\x57\x99\x72\x5d\x82\x58\x23\xf9"
+				  "\x52\x95\x11\xd6\xf3\xae\xb9\xa2"
+				  "\xfd\x3e\x30\x7d\xfc\xe4\xd9\x84"
+				  "\xa2\xb6\x8c\x03\x8a\x5b\x89\x12"
+				  "\x68\x18\x39\x45\x6d\x2f\xa8\x63"
+				  "\x81\x5f\x7e\xe5\xd3\x35\x87\xbe"
+				  "\xf6\x3c\x4e\xee\xde\xdf\x1c\x55"
+				  "\xb1",
+		.psize		= 865,
+		.digest		= "\x9e\x24\xa1\x5e\xe8\x5a\x5f\xde"
+				  "\x78\xeb\xb1\xdc\x35\xac\x57\x5c",
+		.np		= 4,
+		.tap		= { 255, 255, 255, 100 },
+	},
+};
+
 /*
  * DES test vectors.
  */
@@ -33057,6 +33876,1986 @@ static const struct cipher_testvec chacha20_enc_tv_template[] = {
 	},
 };
 
+/*
+ * XChaCha20 and XChaCha12 test vectors.  The first one uses the key and nonce
+ * of the XChaCha specification, the others were generated with an independent
+ * implementation.
+ */
+static const struct cipher_testvec xchacha20_tv_template[] = {
+	{ /* Key and nonce from draft-arciszewski-xchacha-02, section A.3.2 */
+		.key	= "\x80\x81\x82\x83\x84\x85\x86\x87"
+			  "\x88\x89\x8a\x8b\x8c\x8d\x8e\x8f"
+			  "\x90\x91\x92\x93\x94\x95\x96\x97"
+			  "\x98\x99\x9a\x9b\x9c\x9d\x9e\x9f",
+		.klen	= 32,
+		.iv	= "\x40\x41\x42\x43\x44\x45\x46\x47"
+			  "\x48\x49\x4a\x4b\x4c\x4d\x4e\x4f"
+			  "\x50\x51\x52\x53\x54\x55\x56\x58"
+			  "\x01\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\x54\x68\x65\x20\x64\x68\x6f\x6c"
+			  "\x65\x20\x28\x70\x72\x6f\x6e\x6f"
+			  "\x75\x6e\x63\x65\x64\x20\x22\x64"
+			  "\x6f\x6c\x65\x22\x29\x20\x69\x73"
+			  "\x20\x61\x6c\x73\x6f\x20\x6b\x6e"
+			  "\x6f\x77\x6e\x20\x61\x73\x20\x74"
+			  "\x68\x65\x20\x41\x73\x69\x61\x74"
+			  "\x69\x63\x20\x77\x69\x6c\x64\x20"
+			  "\x64\x6f\x67\x2c\x20\x72\x65\x64"
+			  "\x20\x64\x6f\x67\x2c\x20\x61\x6e"
+			  "\x64\x20\x77\x68\x69\x73\x74\x6c"
+			  "\x69\x6e\x67\x20\x64\x6f\x67\x2e",
+		.ilen	= 96,
+		.result	= "\x7d\x0a\x2e\x6b\x7f\x7c\x65\xa2"
+			  "\x36\x54\x26\x30\x29\x4e\x06\x3b"
+			  "\x7a\xb9\xb5\x55\xa5\xd5\x14\x9a"
+			  "\xa2\x1e\x4a\xe1\xe4\xfb\xce\x87"
+			  "\xec\xc8\xe0\x8a\x8b\x5e\x35\x0a"
+			  "\xbe\x62\x2b\x2f\xfa\x61\x7b\x20"
+			  "\x2c\xfa\xd7\x20\x32\xa3\x03\x7e"
+			  "\x76\xff\xdc\xdc\x43\x76\xee\x05"
+			  "\x3a\x19\x0d\x7e\x46\xca\x1d\xe0"
+			  "\x41\x44\x85\x03\x81\xb9\xcb\x29"
+			  "\xf0\x51\x91\x53\x86\xb8\xa7\x10"
+			  "\xb8\xac\x4d\x02\x7b\x8b\x05\x0f",
+		.rlen	= 96,
+	}, {
+		.key	= "\xfc\x76\xc5\x94\xe6\xfe\xc8\x5c"
+			  "\x14\xb4\x74\x13\xc4\x4e\xd4\x0d"
+			  "\x9d\xdb\x5b\xa9\x10\x02\x77\x82"
+			  "\x1a\xaf\x96\xf6\x46\x46\x94\x11",
+		.klen	= 32,
+		.iv	= "\x60\x32\x48\xc5\x6d\x7d\xb1\xad"
+			  "\xf9\xea\x5b\xcb\x37\xab\x8c\x71"
+			  "\xd9\xb2\x41\x46\x33\x72\x99\xc6"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\x66\x93\xb5\x0d\x06\x53\x5a\xc5"
+			  "\xd4\x8c\x32\x9e\x53\xc5\xbf\x01"
+			  "\xb0\x14\xb5\x7a\x22\x7a\x94\x5c"
+			  "\x40\xf8\x18\xec\x40\x14\x67\x4b"
+			  "\x1a\x98\x31\xca\x32\x09\x1e\xbe"
+			  "\x55\x61\xec\x62\x06\xa7\xf4\x77"
+			  "\x87\xbc\xe7\x9b\x7d\x11\x43\x99"
+			  "\xd4\xae\xb0\xdf\x1c\xca\xc0\x0c",
+		.ilen	= 64,
+		.result	= "\x59\x2f\x88\xbd\x3b\x6e\xd9\x1f"
+			  "\x3c\x25\xdc\x38\xb6\xf6\xb2\xba"
+			  "\xae\x2f\x46\xdd\x80\x2d\x1b\x56"
+			  "\x0a\xf3\x4d\xd8\x7f\xce\xfc\x7a"
+			  "\xa7\x3c\x3d\xc2\x93\x6c\xb5\x11"
+			  "\x7d\xb4\x52\x70\xfb\xf8\x7b\x37"
+			  "\x30\xa7\x84\x06\x54\xb0\x99\x42"
+			  "\xc6\x17\x87\xd1\x7f\xea\xb9\x87",
+		.rlen	= 64,
+	}, {
+		.key	= "\x77\x33\x4c\xa2\x44\xdb\x37\x72"
+			  "\x02\xb4\xb9\x01\x32\xf8\x8a\xba"
+			  "\xd1\x0e\x53\x5e\x71\xf4\x0a\x3b"
+			  "\x9e\xb6\xaf\x00\x91\xa4\x56\xbe",
+		.klen	= 32,
+		.iv	= "\xc9\x25\xe3\x7d\x53\xb4\x4a\xbb"
+			  "\xc8\x50\x19\x4d\x83\x14\xa1\x31"
+			  "\x91\xb2\x9c\x6e\xc6\x69\xab\x6e"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\xbc\xec\x1a\x4f\xeb\x55\x1d\x72"
+			  "\x51\xa9\xf0\x58\x89\x42\xfc\x59"
+			  "\x1c\x14\x7d\xc1\x3c\xb4\x01\xbc"
+			  "\x48\xd9\x63\xe5\x64\x4c\xfa\xc4"
+			  "\x8e\x8c\x4a\xb6\x17\x94\x43\xe3"
+			  "\x32\x96\xd7\xeb\x2d\x07\x8e\x0d"
+			  "\xcf\xfc\x77\x2b\xb9\x1e\xd4\xac"
+			  "\x88\xd6\xa0\x40\x4f\x59\x4b\xb8"
+			  "\xaf\xd3\xb4\x99\xcf\xee\x4a\x0c"
+			  "\x74\x75\x60\x61\xeb\x6b\x50\xf8"
+			  "\x1a\x85\x28\x09\xa9\xf6\x8a\xad"
+			  "\x6e\x5b\x38\x3b\x96\xe1\xf1\x79"
+			  "\xa5\xe0\xff\xed\x78\xb0\x47\x25"
+			  "\x91\x14\x03\x53\x61\xff\x07\xa3"
+			  "\x5e\x18\x28\xbb\x86\x9b\xdb\xb4"
+			  "\xb4\x3f\x1e\x9c\x86\xa7\xa7\xc5"
+			  "\x81\xef\x07\x95\x47\x21\x1f\x6a"
+			  "\x58\x81\x9d\x02\x65\x3d\xb9\xa0"
+			  "\xd0\xf2\x04\xe6\x5a\x16\xd5\x40"
+			  "\xac\xb0\xcd\xa6\x97\x44\xc1\x8b"
+			  "\x35\x01\x8d\x69\x95\x6e\x05\x53"
+			  "\x61\xed\x53\x5a\x57\x10\xbc\x59"
+			  "\xc8\x5f\x80\xbf\x7c\xb8\xe6\x36"
+			  "\x93\x10\x27\x75\x1b\x80\x78\x4b"
+			  "\x43\xc2\x82\x6d\xc4\xcc\x66\xac"
+			  "\xd6\x61\xd4\x82\x8a\xbb\x03\xee"
+			  "\x84\x99\x9c\x37\xec\xc7\xc6\xde"
+			  "\x20\xb0\xc4\xb5\xa1\xe9\x4e\x4c"
+			  "\x0c\x14\x0b\xb9\x3b\x55\xf9\xe5"
+			  "\x47\x85\x67\x54\xa8\x73\x80\x32"
+			  "\x17\xa4\xe6\x12\x81\x9e\xe6\xba"
+			  "\xa1\x25\x6c\x08\x31\xb0\xfe\x69"
+			  "\x2b\x16\x7b\x5d\x1b\xa6\xc2\x47"
+			  "\x18\x57\x1c\xde\x62\x18\xa4\x5d"
+			  "\xc9\x3f\x2e\x3a\xd0\x2f\x8e\x89"
+			  "\xee\xb3\x9f\xc6\x27\xa5\x2d\x12"
+			  "\x45\x91\x81\xfd\x76\x77\x2f\x61"
+			  "\xe1\x34\x61\xeb\x50\xe3\x1d\x71"
+			  "\x24\x4d\x78\xd1\x67\xb5\xe5\x24"
+			  "\x2a\xb6\xff\xfb\x3b\xbb\x93\xc9"
+			  "\xb1\x87\x91\xbb\xfa\x8d\xb7\x41"
+			  "\xae\xf9\xa1\x25\x95\x23\x54\x98"
+			  "\x0a\x08\xf2\xbd\x24\x15\x5e\x0d"
+			  "\xd9\x05\x9e\xf7\x21\xf4\x20\xad"
+			  "\x96\xd8\x0b\xe9\x72\xd1\x28\x8e"
+			  "\x3c\x89\x8c\x74\x37\xa7\xc4\xa5"
+			  "\x89\xef\xc2\x67\xd7\x65\x6b",
+		.ilen	= 375,
+		.result	= "\x00\x0d\xda\x13\xb3\x45\xcb\x5a"
+			  "\x2d\xa0\x99\x70\xd1\xaa\x21\x2d"
+			  "\xb6\x0e\x14\x74\xfe\x98\x0b\x23"
+			  "\x04\x23\xd7\xc4\x30\xad\xd5\x4a"
+			  "\x2b\xc3\x50\xee\x6e\x6f\x19\xc6"
+			  "\x59\x03\x19\x00\x4e\x40\x69\x5c"
+			  "\x58\xfc\x4c\xde\xf4\x56\x8b\xfa"
+			  "\x65\x35\x1e\xdd\xf6\x9c\xc4\xfe"
+			  "\xd7\x09\xed\xb3\xfd\x92\x1a\x27"
+			  "\xca\xbb\x50\x2a\xfe\xfe\x45\x64"
+			  "\xa7\xf2\xa3\x42\x6d\x73\xaf\xa2"
+			  "\x99\x8a\x35\x48\x3e\x5c\x2a\x3d"
+			  "\xfe\x97\xa3\x23\xa0\xb6\xcd\x52"
+			  "\xbd\xf3\xfc\x63\xbb\xb0\xba\x37"
+			  "\xf9\xec\x07\x79\xc2\x3b\x75\xba"
+			  "\x57\x67\x93\x78\x87\x43\xe8\xde"
+			  "\xb3\x4e\x9b\x07\x47\x9b\x8f\x2f"
+			  "\xcd\x9a\x1a\xba\x73\x54\x07\x6c"
+			  "\xc4\xe7\xda\xf8\x56\x7f\x21\x5f"
+			  "\x39\xbc\x4a\x1b\x3b\x98\x2a\x30"
+			  "\xd2\xee\x27\x5c\x6a\xd3\xa0\xbc"
+			  "\x21\xa7\xe1\x8a\x82\x4a\x98\x19"
+			  "\xa6\x07\x6f\xa4\xf3\x7c\x1d\xea"
+			  "\xc0\xb8\xa3\xb1\x86\x2f\x6e\x31"
+			  "\x19\x34\x29\xbd\x8a\x0c\x25\x68"
+			  "\x9a\xc3\xff\x54\xdf\x7b\xb4\xce"
+			  "\x65\x23\x55\x80\x3b\x61\x5f\xe8"
+			  "\x1f\xe0\x61\x96\x7e\x90\xb0\xf5"
+			  "\x2f\xa2\xe2\xaf\x9a\x3d\x01\x69"
+			  "\x8e\xe7\x0f\x65\x18\xd4\x88\xfd"
+			  "\x06\x99\x7e\x5d\x2c\xf1\x74\xe8"
+			  "\xe1\x85\x9f\xd5\x9f\x3f\xb3\x06"
+			  "\x9e\xd7\xb7\x7b\x04\x8c\xc2\xc6"
+			  "\x64\xeb\xe4\xed\x2a\x57\xf3\x99"
+			  "\xd7\xb9\x75\x09\xab\x3e\xfc\xfc"
+			  "\xdb\xac\x56\xa8\x67\x43\x2c\x74"
+			  "\x89\x0f\x91\x4c\x15\x6b\x16\xc8"
+			  "\xb4\x2c\xb0\xd5\xe3\x4e\xcb\xfa"
+			  "\x68\x21\x34\xd0\x64\xdc\xf7\x7c"
+			  "\xea\x30\x1b\xda\x07\xe1\xcd\x64"
+			  "\x11\xfe\x9d\xea\xc0\xca\xcc\x32"
+			  "\x0d\x9b\xc4\x25\xc5\x88\xbe\x3b"
+			  "\x96\xae\x8a\xd4\xa5\x68\xc9\x33"
+			  "\xb3\x51\x43\x86\x22\x37\xda\x4e"
+			  "\x13\x39\xb0\xa3\x23\xd7\xa4\xdf"
+			  "\x91\x72\x3c\x2c\x44\x4c\xec\xf9"
+			  "\x3a\x09\x98\x43\x6a\x77\x78",
+		.rlen	= 375,
+		.also_non_np = 1,
+		.np	= 3,
+		.tap	= { 355, 4, 16 },
+	}, {
+		.key	= "\x0d\x28\x60\xd1\x3e\x69\xca\x28"
+			  "\x50\x07\x84\x69\x97\x34\xaa\x06"
+			  "\x12\x9b\xdf\x37\x92\x30\x6f\x6f"
+			  "\x0e\x68\x23\xbe\x5d\x17\x4d\xfa",
+		.klen	= 32,
+		.iv	= "\x02\xf7\x07\xa7\xf1\xb7\x00\x68"
+			  "\xe8\x96\xef\xa0\x43\x3f\x2f\xb1"
+			  "\x87\x65\xcc\x5c\x16\xb0\x75\x76"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\x7b\xf1\x2e\xcd\x18\x0f\x69\xa8"
+			  "\xa6\x07\x92\x55\x4e\x38\x54\xa5"
+			  "\x50\xef\x28\xd2\x83\x85\x47\x87"
+			  "\x83\x2c\x5f\x23\xd5\x32\x19\xa3"
+			  "\x54\x89\xea\x8f\x44\x6e\xb1\xb6"
+			  "\xb4\x0e\xf7\xd2\x99\x81\x2f\x94"
+			  "\x45\xc7\x0e\x1a\xc9\x11\x68\xd3"
+			  "\xdf\x40\xb5\x20\x27\xb8\x89\xb5"
+			  "\x4c\xfe\x9e\x14\x78\x62\xbe\x11"
+			  "\x71\x8d\x88\xf2\x9b\xd8\xff\x16"
+			  "\xe5\x57\x62\xf0\xaa\x0b\xe0\x3b"
+			  "\x86\x94\x36\xb8\x34\x55\xeb\x96"
+			  "\x58\x6d\x74\x5a\x0c\xe5\xaf\xf9"
+			  "\xfe\x71\x9a\x2a\xf7\x99\xbc\x79"
+			  "\xdb\x6c\x49\x53\x07\xfd\x30\x18"
+			  "\x71\xa3\x2b\x71\xdb\xe6\x0b\xee"
+			  "\x5a\xd5\x4f\xf9\xad\xf4\xe7\x3b"
+			  "\xe7\xca\xcd\xed\xb2\xb3\x47\x79"
+			  "\x0a\xb0\x70\x7e\x5d\xa6\x18\xe8"
+			  "\x28\x5e\xb0\x5f\x40\x16\xb2\x64"
+			  "\x3d\xf1\x33\x1b\xee\xc3\x88\xf1"
+			  "\xac\xf6\xe3\xf9\x57\x6d\x7c\x78"
+			  "\xc2\x16\x78\x07\xb3\x96\x15\x32"
+			  "\x19\x88\xf4\x34\xd4\x78\xd8\x31"
+			  "\xf3\x5f\x02\xaf\xf8\xfc\xb2\x2a"
+			  "\x87\xce\x84\x81\x7f\x97\x6c\xfc"
+			  "\x16\x07\x43\x99\x86\xba\x5c\xe2"
+			  "\x4c\x32\x21\xbc\x60\xa4\xeb\x57"
+			  "\x80\xff\xb5\x52\xae\x57\xa3\x6c"
+			  "\x7b\x09\x16\x05\x42\xb7\xf3\xbe"
+			  "\x00\xcc\xb4\xa7\x02\xf5\xae\xb4"
+			  "\xb9\x4d\xa2\x80\xf4\xad\x8a\x62"
+			  "\xee\x0d\x60\xc4\xe5\x89\xb5\xbe"
+			  "\xa1\x12\x5a\x8e\x0b\x95\x1f\x79"
+			  "\x0d\x08\xe7\x5a\x95\xd5\x21\x0c"
+			  "\x21\xb1\x20\x12\x2d\x3f\xd9\xc5"
+			  "\x96\xa7\x74\x7e\x28\x89\x78\xae"
+			  "\x0f\x37\x98\x76\x9b\xf0\xad\x02"
+			  "\xfd\xcb\x65\xa0\x95\x4b\x04\xfd"
+			  "\xff\xe1\xca\xc1\x77\x1e\x28\x96"
+			  "\x1d\xdd\x49\x05\x5a\x1b\x68\x8e"
+			  "\x8e\xff\x89\x6c\xba\x6f\x15\x43"
+			  "\x88\x23\xe8\xed\x8d\x6c\x6f\xc6"
+			  "\x0d\xa9\x09\x72\x3c\x9f\xeb\x15"
+			  "\x62\x23\x77\xa2\xf6\xd0\xa9\x20"
+			  "\x32\x17\x07\x0b\x5c\xb0\xff\x0f"
+			  "\x7e\x90\xc7\x9a\x6d\xcc\x82\xc3"
+			  "\x50\x34\xfa\x5d\xad\xf2\x56\x7d"
+			  "\x9b\xd4\xaa\x46\x90\x73\x1c\xfb"
+			  "\x52\x8a\x57\x6b\xb3\xb9\x44\x21"
+			  "\x08\x6a\xa6\x99\x99\xb8\x17\x42"
+			  "\xe6\x2a\x54\x50\xa2\x21\x32\x82"
+			  "\xe4\xc7\x67\xd9\x45\xc8\xd5\xb1"
+			  "\x24\xd9\x2a\x55\xe7\xf7\xe9\xb1"
+			  "\x41\x18\xd8\x41\x3d\x8a\x2c\xeb"
+			  "\x7c\x2d\x0f\xfe\x0f\x5a\x6b\xdc"
+			  "\x30\x0f\xfc\x17\x6a\xb6\x7e\xf6"
+			  "\x52\x33\xbc\x7b\x3c\xe6\xdc\x19"
+			  "\x38\x42\x93\x3d\xda\x40\x4e\xce"
+			  "\x1c\x16\xa8\xc8\xaf\x5e\xdc\xac"
+			  "\x7b\x8f\x10\xf0\x5b\xfe\x30\xdc"
+			  "\xcf\x84\x5c\x2d\xce\xbd\x04\x34"
+			  "\xea\x16\xf1\x7e\x62\x18\xf1\x75"
+			  "\xea\xf2\xe1\xe0\xce\xf2\xf0\x4d"
+			  "\xe6\xaa\xca\x04\x6a\xb7\xf4\x5e"
+			  "\x23\xe9\x0f\x92\xc6\x19\x17\x1b"
+			  "\xf4\xe4\x73\x17\x43\x0f\xfb\x63"
+			  "\x26\x8d\xc1\x9d\xa3\xb8\xe5\x25"
+			  "\xc8\x03\x3f\x52\xb8\x03\xb5\x30"
+			  "\x65\xda\x14\xa4\x61\x9d\x57\x6c"
+			  "\x90\x26\x95\xac\x3a\x15\x13\xae"
+			  "\x03\x13\xc7\x34\x4c\x45\x37\x0a"
+			  "\x1b\xc6\xa9\x61\x71\x48\x68\x70"
+			  "\x89\x16\xe6\xb0\xa8\xd5\x39\xa0"
+			  "\x60\xbc\x69\x3e\xf7\x23\x89\x1c"
+			  "\xee\xa4\x9f\x1e\x79\xf9\x2d\x7b"
+			  "\x1e\x4d\x0d\x69\xdc\xbb\xca\x37"
+			  "\xf2\x78\xb7\x03\xca\x31\x48\xf9"
+			  "\xb6\xd9\x29\x0e\x9f\xf5\xd3\x76"
+			  "\xad\x2b\xf1\xca\x6f\xe7\x3c\x5b"
+			  "\xa3\xe3\xdc\x99\xf3\xf6\x45\x73"
+			  "\x3c\xc2\x1b\x0f\x7d\x43\x0e\x2c"
+			  "\x28\xff\x8e\x64\x45\x2f\x51\xd5"
+			  "\xe3\x50\x04\xc2\xa2\xe7\x92\x32"
+			  "\x83\xdf\x60\x0c\xaa\x75\xf6\x61"
+			  "\x85\x64\xa4\x21\x66\x01\xc8\xb0"
+			  "\x64\x57\x32\x5e\xd3\xb2\xf3\xb3"
+			  "\x2b\x90\x33\x7e\xef\xf0\x0e\xe2"
+			  "\x4a\x5e\x09\xa9\x79\x16\xab\xba"
+			  "\xec\xd9\xfb\x6b\xe8\x0a\x59\x3e"
+			  "\xc3\x90\x7b\x9c\xb1\x9d\xd0\x7d"
+			  "\x2d\x11\x13\xde\xb8\xda\xdd\x7c"
+			  "\x62\x8a\xe5\x82\x0c\x19\x54\x57"
+			  "\xa6\x00\xae\x66\x12\xdd\x20\x68"
+			  "\x32\x0c\xa9\x27\x3a\xa2\x80\x7d"
+			  "\x63\x39\xc2\x17\x91\xf6\xb3\x42"
+			  "\xbb\x33\x99\x89\x58\x00\xe7\x4e"
+			  "\xdc\x81\xa8\x2a\x97\x1a\x59\x21"
+			  "\x66\x66\x62\x53\x54\x6e\x4f\xa5"
+			  "\x16\x78\x97\x17\x02\x25\x2f\x2e"
+			  "\xfb\xd2\x11\x4b\xf7\x0f\xb1\x64"
+			  "\x38\x05\xc7\x90\xef\x52\xbc\x06"
+			  "\x5a\x5e\x2a\x59\x7d\x28\x9f\x1e"
+			  "\xb6\xb8\xe4\x7f\x89\xb6\x7b\x17"
+			  "\x19\xfe\x7a\x4d\xf9\xa7\xc7\x21"
+			  "\xce\x4d\xbd\x57\xac\x24\x9d\x9b"
+			  "\x0a\x79\x86\x30\x60\x60\x4c\xaf"
+			  "\xb7\x7d\x4b\x07\x38\x3f\x7b\x14"
+			  "\x0d\x15\x7e\x04\xfb\x8b\x12\xda"
+			  "\xf0\x01\xc9\x8f\x95\xd2\xb4\x49"
+			  "\xaf\x2d\xe6\xc3\xa7\xcb\xf0\xe7"
+			  "\xb2\xc5\xca\x32\x5d\x94\x12\x0b"
+			  "\x03\x97\x3a\x39\x97\x48\x1e\x37"
+			  "\x5d\x4b\x41\x76\xc5\x60\x53\xe3"
+			  "\xa8\xe9\xc3\xd1\x28\x20\xb9\x1b"
+			  "\x46\xe3\xfa\xb7\xd5\x0b\xf5\xd9"
+			  "\x00\x0e\x2a\x8e\x5e\x03\xf5\x67"
+			  "\x36\x52\x58\x8b\xed\xd0\xe2\xf0"
+			  "\xb8\x6a\x42\x89\x7a\x77\xd6\x39"
+			  "\x29\xbd\x76\x70\x44\x27\x1a\xef"
+			  "\x31\xfc\x30\xac\x6c\x46\x93\x93"
+			  "\x61\x56\xed\x65\xd6\x16\x53\xbf"
+			  "\xfa\xa6\x33\x72\x97\x75\x29\x77"
+			  "\x5b\x6c\xeb\x9a\x21\xb4\xd9\x9e"
+			  "\xba\x5b\xe4\xb5\x5e\xe7\x13\xf8"
+			  "\xf7\x4b\x95\x96\x63\xc2\x0d\xc2"
+			  "\xea\xcc\x1a\x80\xc7\x9a\x43\x86"
+			  "\x75\x03\x43\x37\x6e\x18\x63\xba"
+			  "\x87\x05\x4a\x44\xe0\x9d\x42\x93"
+			  "\x21\x77\x5a\x88\x74\x61\xab\x62"
+			  "\x6d\x24\x51\x37\xa6\xac\xdb\x68"
+			  "\xb2\x77\xaa\xb1\x40\xb2\x11\x31"
+			  "\x2c\x40\x8e\x01\x27\xe9\x64\xfa"
+			  "\x4c\x7e\x4d\x87\xc0\x21\xc2\xad"
+			  "\xae\x5f\x3b\xf1\xe3\x71\xd5\x5b"
+			  "\x95\x45\xda\x8b\xe3\xe0\x62\x81"
+			  "\x6e\xd4\x2e\xa7\x9e\x55\xd8\x09"
+			  "\x64\x00\x87\x82\x2c\x59\x52\x19"
+			  "\xb7\x67\xfd\x07\xd3\x75\x5d\xa9"
+			  "\xf4\x52\xff\xf0\xce\x98\x34\x1d"
+			  "\x2f\xc6\x66\xf5\xba\x57\x35\xe9"
+			  "\x30\xb2\xbd\xd8\x68\x1f\x8a\xed"
+			  "\xd1\x64\xfb\xcf\x9a\x4c\xd5\xce"
+			  "\x8c\xd3\x6b\x8b\x5d\x7f\x2a\xeb"
+			  "\x57\xce\xa0\x07\x1b\xb1\x2d\x0b"
+			  "\xc1\x13\xbe\xa1\x40\xd1\xe5\xe7"
+			  "\x9d\xaf\x66\x81\xf9\x6b\x55\x8b"
+			  "\x31\x64\x78\xac\x8b\x5b\x96\x6a"
+			  "\x4c\x7e\x43\xca\x21\x7f\x9a\xab"
+			  "\xd8\xf5\x3f\xce\xee\xf5\x53\xf8"
+			  "\x19\xe0\x80\x2a\xb7\x65\x8a\xf9"
+			  "\x85\x49\x1d\x2b\x0a\xed\xcc\x68"
+			  "\xd6\x46\x19\xc8\x52\xf4\xe9\x47"
+			  "\x6e\xf4\xaa\xe5\xb9\xfe\x3f\xb9"
+			  "\xe8\x91\x43\x4f\xbd\x1f\xe7\x30"
+			  "\xe3\x0b\x8f\xb3\x96\xab\x93\x35"
+			  "\x75\x2e\xaa\x49\x05\xc8\xac\x8b"
+			  "\x07\x99\x89\x3d\xe9\xf1\x88\xaf"
+			  "\xeb\x86\x02\x5a\xd3\x67\x58\xd0"
+			  "\x80\x40\x82\x04\xab\x92\x2c\x55"
+			  "\x84",
+		.ilen	= 1281,
+		.result	= "\x44\x92\xaa\x16\x91\x91\x58\x05"
+			  "\x01\x56\x8e\x58\x8b\xfa\xf2\x62"
+			  "\x93\x3f\x51\xa2\xe1\x9f\x45\x90"
+			  "\xda\xb6\xde\x85\x84\x7a\x00\x54"
+			  "\xce\x34\x2a\xcd\xba\xbf\x27\xbf"
+			  "\x48\x32\xfb\x1d\xb9\x8b\xde\x87"
+			  "\x77\x14\x7a\x61\x33\x0c\xbc\x26"
+			  "\x3d\x30\x1e\x68\x0f\x36\x99\x00"
+			  "\x79\xe7\xd9\x77\x6e\x47\x4c\x01"
+			  "\x58\x6b\x63\xb3\x2a\x70\x73\x26"
+			  "\x48\x04\xe0\x49\xf8\x21\x8e\x65"
+			  "\x0f\x2d\xf6\xa1\x04\x35\x78\x9d"
+			  "\x22\x8b\xb7\xa4\x50\x30\x00\x63"
+			  "\xd4\x52\x76\xe4\xe1\x8c\x2a\x08"
+			  "\x5e\x6c\x0a\x8c\x30\xea\x1a\xac"
+			  "\x9e\x2d\x27\x23\x24\xd9\xdb\xcb"
+			  "\x33\x5b\x1e\xa7\xa3\x69\xc7\x98"
+			  "\x9d\xd7\xa7\x66\x8c\x2a\x31\xf5"
+			  "\xf9\xe8\x18\xe9\x87\x61\xae\x7b"
+			  "\x09\xae\x88\xcd\x57\x2e\xca\x9d"
+			  "\xcf\x38\x2c\x5f\x3f\x34\xb4\x48"
+			  "\xf0\x6b\xf3\x23\x12\x89\x11\xaa"
+			  "\xe3\x04\xb7\x79\x55\xfb\xd9\x18"
+			  "\xdf\x17\x18\x39\xe7\x31\x7f\xc9"
+			  "\xce\x4f\x96\x06\x73\xfd\x73\xf7"
+			  "\x18\x9a\x18\xbf\x5c\x69\x72\xd8"
+			  "\x77\x69\x05\xc7\xcf\x40\xd6\xa6"
+			  "\x03\x8c\xfb\x27\xb4\xc4\xba\xb6"
+			  "\x27\x4e\xc2\xfa\x66\xbd\xdc\xa1"
+			  "\x23\x69\xff\x24\xc0\x1e\x5a\x22"
+			  "\x4b\xdf\x3d\x5c\x84\xc5\x81\xf0"
+			  "\x5d\x2f\xf5\x11\xa4\xce\x58\xa0"
+			  "\xcb\xcc\xb2\x06\x4e\x45\x68\xe7"
+			  "\x9c\xa2\x20\x11\xc7\x43\x4d\xe1"
+			  "\x7d\x34\xcf\xba\x9a\x5f\x3e\xf9"
+			  "\x45\xab\xf3\x6a\xa8\xa0\xef\x97"
+			  "\x6a\x05\x51\x6c\xb3\x76\x7a\xa1"
+			  "\x53\xb3\xaa\x86\xa3\x25\x29\xf1"
+			  "\x48\x97\x7b\xa7\xed\x99\x87\xef"
+			  "\x72\x52\x6d\xc0\x16\xd5\xd6\x7e"
+			  "\xfe\xff\xff\x76\xe7\x81\xf0\xfb"
+			  "\x72\x04\x60\xaf\xe7\xa8\xbe\x21"
+			  "\x69\xb3\x3e\x81\xe0\x7a\x57\x05"
+			  "\x1c\x50\x03\x99\x04\x6e\xca\xee"
+			  "\x18\xd1\x38\x33\x9f\xd4\xca\xe7"
+			  "\x46\x85\x4a\x50\x6c\x3a\x66\xdc"
+			  "\x50\x97\x48\x0a\x7a\xc2\x63\xbe"
+			  "\x49\x81\x1b\xbc\x9a\x4c\xb2\x3f"
+			  "\xbf\x25\xe0\x93\x55\x88\x6e\xe8"
+			  "\xcd\x1c\x85\x76\x52\x9b\x08\x25"
+			  "\xaf\x94\xd2\x5a\xeb\xfd\xaa\x05"
+			  "\xec\xa8\xdd\x2d\xc4\x4b\x85\xa6"
+			  "\x7f\xfc\xca\x93\x37\x48\x76\x7f"
+			  "\x3a\x26\x79\xdc\x0a\xa4\x6c\x86"
+			  "\x8c\x72\xb7\xe8\xb7\x0a\x83\x05"
+			  "\x80\xf8\xbe\x03\x9d\xe4\x28\xe0"
+			  "\x03\x17\x1b\x14\x8e\xce\x0b\x59"
+			  "\xd4\x96\x06\x5b\x56\xf6\x0c\xe6"
+			  "\x2d\x58\x6b\x0e\xee\x10\x4b\xc2"
+			  "\x27\xb1\xdc\x15\xf7\x98\x67\xf6"
+			  "\xe5\x28\x68\x88\x3b\x40\x9a\x2e"
+			  "\x92\x5d\x6e\xf6\x3e\xc3\x85\x31"
+			  "\x24\xcd\x7b\x8f\x52\x2c\x2f\x59"
+			  "\xba\x39\x00\xc0\x6d\x62\x31\xa4"
+			  "\x79\x5d\x3a\x3b\xf2\x10\xd4\x5a"
+			  "\xed\xc1\x12\xb7\xc7\x7f\xb5\x63"
+			  "\x63\xd4\x1d\xdb\xa4\x6e\xb7\xc4"
+			  "\x9c\x46\xa5\x41\x90\x7a\xde\x82"
+			  "\xc6\x71\xf7\xaa\x97\x21\x2a\x31"
+			  "\x85\x1b\x74\xb7\xd4\x67\x32\xe4"
+			  "\xc3\x98\x72\x32\x22\x47\xf8\xae"
+			  "\xc4\x36\x48\x67\x27\x0d\x45\x39"
+			  "\x49\x0e\x32\x13\xa7\x50\xb3\x45"
+			  "\xc1\x68\xd7\x31\xdb\x4f\x62\xf9"
+			  "\x24\xc1\x7d\xfd\x48\x53\xbc\x89"
+			  "\x17\x55\xa0\xed\xc9\x2d\x0f\x33"
+			  "\xb7\x58\xfa\x05\x98\x95\xd5\x7d"
+			  "\x80\x21\x8b\xbd\xa5\xf7\x51\xde"
+			  "\x48\xa1\xb2\x38\xed\x09\x98\x33"
+			  "\x43\x88\x5d\x0e\xe0\x4e\x02\xad"
+			  "\x7d\x92\x17\x26\x38\x12\xb8\x5f"
+			  "\x83\x3f\xe2\xdf\x60\x63\x60\x6d"
+			  "\xa3\xba\x67\xbd\xa0\xdf\xb1\xf5"
+			  "\x4a\xb4\x24\x95\xd6\xa7\x7b\xa3"
+			  "\x16\x00\x06\x26\xe8\xcc\x37\x4d"
+			  "\xcc\x94\xf4\x08\x75\xe2\xad\x74"
+			  "\x8a\x27\xac\x78\x7e\xca\x85\x86"
+			  "\xc0\x1f\x94\xd7\xc8\xb3\xee\xd1"
+			  "\xba\xcf\xeb\x74\x63\xbf\x5a\x36"
+			  "\x25\x8b\x36\xe2\x11\x89\xbb\xb7"
+			  "\xf8\x93\x64\x84\x16\x4d\xe0\xa5"
+			  "\xa8\x74\x47\x76\xc1\x09\xcb\x1a"
+			  "\x60\x0f\x65\xa8\x3f\xa1\x11\x67"
+			  "\x7e\x56\x87\xab\xcd\x72\x20\x6f"
+			  "\x99\x04\x13\x9a\x7a\xb1\xcc\xd0"
+			  "\x3a\x22\xb8\xc0\xdb\x51\x60\x69"
+			  "\x0a\xb8\x13\x17\xeb\x19\xbd\xc8"
+			  "\x8c\x38\xd3\xf9\xd4\x84\x78\x27"
+			  "\xea\x2f\xee\x47\x8a\x4e\x3a\x1a"
+			  "\xa8\xb4\xa2\xf2\x71\x18\x6a\x08"
+			  "\x50\xb3\x1f\x71\x63\x1b\x95\x01"
+			  "\x17\xb8\x3b\x28\x5f\x96\xd1\xd2"
+			  "\x42\x2a\xf4\xd5\xa4\x52\x95\x3c"
+			  "\x4e\x64\xb3\xe4\x7a\x74\x90\x21"
+			  "\x2f\x38\x5f\x55\xf5\xe4\xe3\x14"
+			  "\xdc\x00\x2d\x76\x15\x2d\xe8\x01"
+			  "\xba\x86\x81\x24\x54\x44\x1b\xaa"
+			  "\x14\xad\x89\x38\x0d\x3d\xcf\x22"
+			  "\xc7\x7c\x7a\x1a\xe6\x5b\xcb\x9c"
+			  "\xd9\x27\xb4\x43\x7f\x6c\x2d\x23"
+			  "\xd2\x21\x0c\x70\xda\x33\x21\x58"
+			  "\x39\x3d\x3e\xdc\x7d\x39\x92\x49"
+			  "\xe8\xa2\xfc\x0e\x02\x4b\x7f\x02"
+			  "\x9b\xf0\x20\xf3\x58\x8e\x6a\xfb"
+			  "\x67\xaa\x7c\x4d\x7e\x8b\x8a\x35"
+			  "\xcb\x7b\x8e\xbb\x6b\xb4\x18\xd3"
+			  "\xb6\x01\xf0\xe2\xe5\x2f\xfc\xd3"
+			  "\xf4\xaf\x4f\x5d\xa9\x0a\x19\x06"
+			  "\x77\x72\x05\xa6\xad\xcf\x26\xd8"
+			  "\x20\xb0\xcb\x81\x48\x78\x44\xec"
+			  "\xa7\x55\x77\x52\x1b\x01\xe6\xf3"
+			  "\xa1\x08\x09\xb6\xb7\x1c\xd1\xde"
+			  "\x11\xef\xde\x97\xd5\x04\xb1\xa6"
+			  "\x34\x05\x2e\xe2\x0b\x67\x09\x1b"
+			  "\x16\x51\x2a\x52\x5e\xcc\x47\xf1"
+			  "\x58\x22\x3a\x17\x86\x4f\x4a\xdf"
+			  "\x9f\x7e\x7d\x8b\x4d\x51\xd8\x96"
+			  "\xc2\x0f\xd6\x87\x09\xf5\x38\xf7"
+			  "\x2c\xd2\x51\x69\xe0\xf7\x08\x92"
+			  "\x90\x61\x34\xd3\x12\x96\x21\x96"
+			  "\xe2\x9d\xfc\xf7\x95\xeb\x9d\x50"
+			  "\x40\xaa\xf9\xa4\x01\x87\x76\x55"
+			  "\xf2\xcd\x89\xa2\xf8\xa9\xcc\x6e"
+			  "\x81\xd7\x1c\xb9\xbd\xd2\xe6\x03"
+			  "\xeb\x9e\x5c\xd9\x6d\x99\x20\xd9"
+			  "\xdd\xe2\x35\x64\x92\xcf\x5a\xa1"
+			  "\x85\xa2\xad\x78\xce\x91\x4c\xc6"
+			  "\x03\x77\x06\x6f\x77\xd5\x63\x56"
+			  "\x97\x7c\xf8\xc0\x68\xd9\x44\x75"
+			  "\xb4\x2c\x82\xa1\x8d\xa5\x8a\x11"
+			  "\x23\x90\xee\x58\xf7\x97\x7a\xad"
+			  "\x8d\x99\xf5\x3c\x58\xc4\x15\x14"
+			  "\x0c\x6a\x9e\x41\x0e\x84\x7f\x1e"
+			  "\x04\x16\xc4\xf4\xc7\xb6\x33\x0e"
+			  "\x63\x37\x13\x30\x20\x69\xa0\x7a"
+			  "\x16\xbf\x83\xed\xa0\x64\x6e\x9f"
+			  "\xcd\x8d\x87\x11\xd2\xa3\x1c\x4b"
+			  "\x3c\x2b\xfd\x51\x32\xe2\x18\xe7"
+			  "\x53\x10\x52\x56\x2c\x33\x2b\x68"
+			  "\x3d\xb1\x1e\x18\xe7\x8e\x16\x37"
+			  "\x1c\x56\x40\xfa\x5d\xa6\xa7\xfc"
+			  "\xaf\x0e\x05\x81\x00\x5a\xdb\x1c"
+			  "\x7d\x19\x50\x9f\xa9\xd5\x6c\xef"
+			  "\x89\x33\xb8\x4b\xbf\xb3\x25\x27"
+			  "\xa1\xd2\xed\x7d\xa7\x6b\x13\x81"
+			  "\x44\x22\x4e\xbd\x7b\x68\xba\xc2"
+			  "\xe9\x77\x91\x3b\xd5\x5b\x7c\xc6"
+			  "\x9d\xe8\x3f\xff\x2d\xa9\x5f\x83"
+			  "\xf7\x12\x02\xcf\x72\x27\xcd\xbd"
+			  "\xf6\xa5\xe2\x6a\x6a\xfd\x25\xfc"
+			  "\xae",
+		.rlen	= 1281,
+		.also_non_np = 1,
+		.np	= 3,
+		.tap	= { 1200, 1, 80 },
+	}, { /* stream position 1 */
+		.key	= "\x48\x31\x36\x31\x0e\xf8\x30\x0c"
+			  "\x6f\x68\xc7\x90\x08\xa2\x72\x3c"
+			  "\xbe\x34\xd4\xe2\x49\x89\x4c\x41"
+			  "\x90\xaf\x72\x64\x8f\x4f\xfd\xfd",
+		.klen	= 32,
+		.iv	= "\xba\x22\x02\xb8\x52\xcb\x10\x41"
+			  "\xa3\x62\x2d\x57\x81\x97\xbc\xcf"
+			  "\x3d\xf4\xc3\x78\xfe\xda\xc0\x07"
+			  "\x01\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\x88\xb0\xeb\x7b\xf8\xf1\x18\x85"
+			  "\x9b\x51\x9c\xe7\x61\x88\xe5\x7d"
+			  "\xfc\x08\xfb\xd5\xfd\x43\x35\xa4"
+			  "\x4b\x02\xce\x82\xac\x84\xf2\xeb"
+			  "\x75\xec\x5e\x5b\x8b\x76\x13\xb7"
+			  "\xfa\x56\xd6\x52\x8d\xb3\x18\x2c"
+			  "\xbf\xfb\xbd\x91\xe8\x6e\x7c\xd7"
+			  "\xc7\x1a\x9b\xbb\xb4\xf0\x61\x6c"
+			  "\xb2",
+		.ilen	= 65,
+		.result	= "\x6a\xf5\x6b\x6f\x5a\xe8\x6f\xc9"
+			  "\x34\xed\x50\x92\x69\x18\xc5\xc8"
+			  "\xdf\xde\x46\x12\x86\x27\x09\x37"
+			  "\xce\x0a\x61\x53\xc1\x7a\x1e\x92"
+			  "\xde\xf4\xa6\x88\x41\x4b\x74\xcd"
+			  "\x7e\x1b\x0f\xcc\x7e\xad\x8c\xec"
+			  "\x40\x43\x5c\x0e\x87\xd9\x2c\x5d"
+			  "\x66\x42\x89\x4e\x46\xff\xb3\x1a"
+			  "\x87",
+		.rlen	= 65,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 33, 32 },
+	},
+};
+
+static const struct cipher_testvec xchacha12_tv_template[] = {
+	{
+		.key	= "\x88\xab\x70\x96\x81\xaa\xdc\x03"
+			  "\xf1\x25\x18\xf7\x35\x4c\x64\xc8"
+			  "\x64\x42\x56\xb5\x2c\xf3\x83\xc4"
+			  "\xa7\x1f\xd2\x61\xf2\x7a\xdf\xda",
+		.klen	= 32,
+		.iv	= "\x9d\x56\xb0\xd5\x3d\x75\xa1\xaf"
+			  "\x67\xc6\xbd\xc3\x30\x0b\xc8\x1b"
+			  "\x99\x21\xe6\x7a\x85\x9a\x8e\x03"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\xf2\x6d\xfd\x13\x03\x4e\xf5\xae"
+			  "\x8d\xe0\xa6\xe0\x76\xd4\x9a\xf4"
+			  "\xb8\x78\xf7\xe1\xa4\x69\x99\xe8"
+			  "\x06\x57\x16\x7c\x0f\xd8\xee\x55"
+			  "\x0e\xe6\xd9\xac\xa9\xa1\x99\x31"
+			  "\x2f\xd9\xd3\xe8\xe5\x02\x91\x29"
+			  "\xa4\xaf\x6c\xdb\x11\xf7\xb4\xf9"
+			  "\x11\xa0\xca\xdf\x97\xae\x6f\x24",
+		.ilen	= 64,
+		.result	= "\x9c\xd5\xea\xa3\xf7\x44\x1f\x54"
+			  "\xd5\x54\xcb\x83\x8e\x4d\x03\xc1"
+			  "\x9b\xbb\xc8\xa2\xa5\xe3\xe0\x88"
+			  "\x47\x3d\xfc\x16\x08\x89\xf0\x90"
+			  "\x32\x2a\x8a\x40\xf1\x00\x4b\xbc"
+			  "\xb5\x11\x15\x81\x57\xc9\x14\x9d"
+			  "\x23\x01\xc0\x95\x1f\x85\x3b\xbe"
+			  "\x8f\x57\x1b\xb2\x2f\x91\x8c\x88",
+		.rlen	= 64,
+	}, {
+		.key	= "\x64\x7c\xf9\x76\x8e\xe6\x51\xdc"
+			  "\x94\x03\xb6\x03\xda\xc6\x75\x36"
+			  "\x5b\xc9\x1f\xca\x25\x57\x97\x27"
+			  "\x1e\x4c\x91\x0a\x07\xad\x0e\x68",
+		.klen	= 32,
+		.iv	= "\xce\xb7\x64\x94\x68\x41\xae\xc1"
+			  "\xf6\xef\xb1\xc6\x9e\x74\xcb\x0f"
+			  "\x4c\xba\x7d\x22\xa8\x89\x49\xd8"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\x16\x48\xfa\xbf\xee\x20\x41\x81"
+			  "\x0a\x87\x95\xd0\x7a\x8a\x49\xdf"
+			  "\x90\x84\xbc\x70\x4e\xac\x9b\xdf"
+			  "\x48\x72\x34\x28\xa0\x24\x76\x41"
+			  "\xc5\x86\x46\x7d\x72\x1a\xf6\xbb"
+			  "\xc5\x29\x77\xe9\xbe\x1b\xb7\x32"
+			  "\xe0\x5c\xe7\x54\xf3\x32\x96\x41"
+			  "\x4a\xd0\x87\x69\x03\x6e\xf3\x49"
+			  "\x87\xe2\x1b\xb8\x0f\x56\x75\x16"
+			  "\x6b\x67\x7a\x28\xba\xfc\x2c\xb3"
+			  "\xb3\x79\xee\xca\xe6\xcd\xb4\xb1"
+			  "\x75\x03\x31\x83\x39\x80\xd8\xaa"
+			  "\x13\x4d\x54\x49\xe8\x5a\x1b\x2c"
+			  "\x73\xfb\x5c\x77\xdf\x14\x07\x82"
+			  "\xf3\x97\x11\x12\xeb\x97\xeb\xce"
+			  "\x18\x19\x7e\xf2\x2d\x40\xa0\x83"
+			  "\xf2\x2d\x5e\x11\xb4\xe8\x99\x4f"
+			  "\x12\xcc\x62\x91\x2c\x66\x33\xee"
+			  "\xc0\x4c\x4b\xc3\xb5\xbb\xe9\x9d"
+			  "\xa4\xee\x78\xe6\x96\x77\xd7\xb2"
+			  "\xa7\x11\x4e\xf1\x5a\xbe\xfb\xe7"
+			  "\xcd\x81\x72\x27\xe4\xcc\xdf\xc4"
+			  "\x1d\x4a\xa4\xdb\x03\xed\x9e\x3d"
+			  "\xf9\x6a\xe2\xe2\xcc\xe6\x47\x64"
+			  "\x09\x27\x04\xdb\xa9\xb2\x2b\x83"
+			  "\x92\x42\x37\x7f\x0c\xba\xd9\x20"
+			  "\xf0\xd6\x29\xbb\x74\x01\xd4\xc0"
+			  "\xff\x39\x7e\x12\x27\x89\xeb\xff"
+			  "\xd8\x43\xc6\x79\x15\x15\x7b\x54"
+			  "\x06\x12\x95\x80\x54\x39\x21\xca"
+			  "\xb1\x8b\x57\x87\xab\x24\xa0\xd5"
+			  "\xd0\x40\xe6\x46\xd1\x14\xc9\x1b"
+			  "\xd5\x5a\x40\x32\x5e\x94\x97\xb1"
+			  "\x3a\x0a\xb9\x21\x16\xce\xf0\xb1"
+			  "\x74\x56\x32\x59\x6e\x08\x94\xa0"
+			  "\x01\xd0\x48\x3c\x82\x9c\x4f\xfe"
+			  "\x38\x7d\xae\xbc\x18\x28\x88\x08"
+			  "\x5e\x77\x4e\xe7\x0a\x80\x35\xca"
+			  "\xa7\x83\xad\x60\xb2\x0f\xe5\xa1"
+			  "\xb9\x63\xf8\xb0\xdc\xc7\x35\x15"
+			  "\x23\x3c\x50\x0a\xa1\x7b\x9b\x97"
+			  "\xbf\x6b\xc5\x79\x6b\x22\x86\x5d"
+			  "\x9b\x35\xc8\xbf\x07\x54\x95\x64"
+			  "\xb9\x3b\xed\x5d\x24\xd9\xf8\x6b"
+			  "\x75\xec\xd1\xb2\x39\x73\xb3\xd1"
+			  "\x07\xf4\xc7\xd1\x12\x7c\x82\xd8"
+			  "\x89\x8e\xf2\x85\x9f\x41\x17",
+		.ilen	= 375,
+		.result	= "\x2a\xc9\xaf\x85\xe2\xce\x6d\xbe"
+			  "\x34\x5f\xf8\x21\x81\x28\xa1\x9c"
+			  "\x24\x1c\x8e\xe9\xc1\xba\x4b\x83"
+			  "\x0d\xea\x52\x9f\x9a\x1c\x37\x57"
+			  "\x50\x26\xf2\x36\x67\x22\xf7\x91"
+			  "\x63\xff\xf1\xe7\xb8\x0c\x71\x54"
+			  "\x57\xe7\xcf\xd0\xc3\x93\x57\xc8"
+			  "\x95\xbc\xbd\xa8\x93\x7a\x5a\x21"
+			  "\x1c\xcc\x9f\x32\x0a\x37\x94\x26"
+			  "\x6f\xe2\x70\x26\x08\x4c\x59\xaa"
+			  "\x8a\xdc\xe3\x65\xcc\x57\x58\xb5"
+			  "\x65\x07\x7a\xde\x63\xdf\xeb\x91"
+			  "\xe7\x6e\x5d\xe1\x73\x11\x5b\x36"
+			  "\xa9\x0a\x3b\x0c\xf5\xc0\xab\xd5"
+			  "\xc8\xb4\xc3\xae\xdc\xbe\x45\x28"
+			  "\xb4\x51\xf5\x3f\xb5\x89\x53\x56"
+			  "\xbd\x33\xf4\xaf\xd1\x61\x2c\xf6"
+			  "\x78\xfa\x56\x06\xfc\xa3\x8d\xd7"
+			  "\xba\xd4\x98\x07\x89\xd7\x96\x43"
+			  "\x8f\x9b\x69\xf3\x81\xed\xa1\xb7"
+			  "\x00\x57\xbd\x6b\xbf\x5c\x3b\x2f"
+			  "\x11\x42\x66\x55\x78\x45\x26\x1c"
+			  "\x5f\xf0\x7f\xa2\xfc\xed\x94\xb2"
+			  "\xf2\x2e\x71\x00\xe3\xe9\x96\x76"
+			  "\x2d\x03\xda\x33\x24\xaa\xcf\x51"
+			  "\x6e\x1a\x7b\x02\xd3\x72\x57\x37"
+			  "\xa0\xb8\xec\xa0\x7a\xd1\x3e\x13"
+			  "\x90\xee\xca\x7b\x15\x10\xc3\x3b"
+			  "\x6c\x8b\xe1\x81\xc7\xc4\x5d\x06"
+			  "\x55\x24\xf8\xd0\xf6\x09\x6e\xf4"
+			  "\xb4\xe5\x85\xce\x42\xc7\xc6\x41"
+			  "\x65\x43\x22\x34\x4d\xc5\x74\xbc"
+			  "\xf0\x24\x7b\xc7\x0c\x8b\x6f\x81"
+			  "\x2f\xdd\xc7\x52\x05\x6a\xc2\x35"
+			  "\xf3\x36\xb3\x3e\x99\x7a\x59\xf0"
+			  "\x64\xd1\xb3\xa5\x68\xba\xbd\x98"
+			  "\xfa\x1b\x26\xd0\x8d\xd1\xe1\x71"
+			  "\x11\xe8\xc9\x38\x21\x26\xd7\x5a"
+			  "\x86\xd9\xd5\x92\x16\x49\x80\x57"
+			  "\xd4\x13\x43\x89\x63\xf0\xd4\x12"
+			  "\x2d\xdf\x23\xd1\x79\xfc\xdd\x75"
+			  "\x0a\x22\xea\x48\xd3\x63\xae\xed"
+			  "\x65\xdc\x50\x1b\x2e\xbc\x03\xe2"
+			  "\x07\xb0\x04\x2d\x5e\xd8\xca\xbd"
+			  "\x1b\x97\x35\x8b\x30\xc5\x24\xda"
+			  "\x04\x9f\xa3\xb4\xc3\xf5\x21\xa2"
+			  "\xa5\x07\xe9\xb1\x06\x11\x54",
+		.rlen	= 375,
+		.also_non_np = 1,
+		.np	= 3,
+		.tap	= { 355, 4, 16 },
+	}, {
+		.key	= "\x58\x8e\xc4\x21\xd4\x66\x25\x17"
+			  "\x74\xb2\xc7\x10\xb9\x23\x98\xcc"
+			  "\x9f\xd8\xd2\xbf\x59\x22\xbf\x73"
+			  "\x22\xad\x12\xf1\x0f\x3f\x3b\x6b",
+		.klen	= 32,
+		.iv	= "\x61\x0e\xcc\x3b\x2c\x6a\xad\x04"
+			  "\x71\xc0\xe0\x7e\x84\xec\x85\xb1"
+			  "\x70\xf3\xa7\xe7\xfb\xe9\xca\xe2"
+			  "\x00\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\xec\xe3\xee\x8c\x1c\xcb\x6c\x33"
+			  "\x80\x15\xfa\x01\x73\xf2\x41\xc7"
+			  "\x39\xf2\x0b\x9c\xd2\xf6\xd1\x2d"
+			  "\x33\x76\x84\x06\x78\x62\xc7\xe3"
+			  "\x77\x91\x46\xf7\x58\x7c\x27\x57"
+			  "\x89\x6d\x1b\xad\xd5\xf9\x49\xe0"
+			  "\x6e\x2f\x41\xb0\xa9\x2c\x6a\x01"
+			  "\x1e\xe5\x7d\x21\x4c\x9b\x7a\x6a"
+			  "\x6d\x7f\x3c\x12\xb5\xa2\xb2\x3b"
+			  "\x58\x5d\xa4\xa1\x6e\x06\x48\x10"
+			  "\xac\x96\x73\x5d\x45\x48\xc8\xe1"
+			  "\x4e\x79\x66\x5e\xb1\xae\xb2\xe1"
+			  "\x05\xf4\x62\x39\xf3\xd1\xe6\xf7"
+			  "\x7e\x44\x0c\x95\x13\x20\x07\x24"
+			  "\xd3\x5c\x85\xdb\x0e\xc2\xff\x5d"
+			  "\x0f\xbf\xbd\x46\x6c\x96\x1d\x05"
+			  "\x02\xc6\x10\x32\xec\x13\x8c\x77"
+			  "\xd3\x2a\x31\xf6\xe8\x13\xc7\x31"
+			  "\x73\x39\x1d\xf1\x1a\x59\x60\x4c"
+			  "\x4a\xc3\x89\xc4\x98\xb7\x63\x6c"
+			  "\x8c\x80\xf1\xe5\x4a\x77\x98\x3c"
+			  "\xc3\xf1\xff\xd9\xb2\x69\xf7\xd6"
+			  "\x39\x6e\x24\x37\x4d\xe8\x5c\x09"
+			  "\x0d\xeb\x77\x48\xc9\xbc\x9b\x1b"
+			  "\xa8\x84\x1b\x03\x2c\x3e\xe1\xdb"
+			  "\x2c\x68\x99\x51\x8d\x7c\x8d\x5a"
+			  "\xca\x75\xb3\x75\xed\x15\x9c\x13"
+			  "\x61\x33\xc2\x4a\xe4\x0b\x3c\x0d"
+			  "\x1f\xbd\x64\xdf\xc4\x06\x17\x7b"
+			  "\xd7\xf8\x5c\x51\xf2\x37\x17\x23"
+			  "\x2a\x1d\x61\x2e\xdf\xdf\x8b\xcc"
+			  "\xb0\x67\x63\x02\x8d\xbe\x20\xd5"
+			  "\x40\xd4\xa1\x76\x1e\xdc\x9d\xac"
+			  "\x9d\x0a\x82\x88\xc7\x6c\x7d\x6e"
+			  "\xf8\xcf\x9e\x8b\x19\x32\x00\x0a"
+			  "\x7f\x0a\xb2\x29\xae\x27\x87\x2c"
+			  "\x2b\x0a\x54\x12\x28\x54\x90\xfa"
+			  "\xee\x8e\xdb\x11\x61\x35\x4f\xd5"
+			  "\xd5\x87\xfc\x9d\x6e\xef\x7d\x50"
+			  "\xa1\x68\xc8\x68\x65\x3b\x22\xd9"
+			  "\x33\x60\x06\x63\x2f\x3c\xe5\x68"
+			  "\x95\x0a\x2b\x6c\x13\x34\x59\x43"
+			  "\x14\x84\x39\xf0\x40\xcd\xab\x11"
+			  "\x1d\x56\x00\xb3\x30\xd2\x92\x13"
+			  "\x15\xa9\xb9\x1d\x70\x84\xfc\xa0"
+			  "\xd2\x08\x1f\x29\x68\x44\x48\xaa"
+			  "\x1e\x6f\xbd\xdc\xd0\x47\x9c\xb9"
+			  "\x33\x0c\xb7\xb8\xac\x2b\xd7\x53"
+			  "\xf7\x2d\xb2\xf9\xe1\xa3\xce\x00"
+			  "\xe0\xb5\xba\xd0\x53\x7a\x77\xd4"
+			  "\x6d\x7a\x66\xfe\x93\x62\x82\x24"
+			  "\x9e\xcc\x89\x7e\x20\x7b\xb2\xec"
+			  "\xeb\x24\xdf\xa4\x4a\x38\xc8\x1d"
+			  "\x04\x21\x19\xfd\xa8\xa9\x84\x8d"
+			  "\xf5\x87\x45\x4a\x8d\xdb\x13\xc8"
+			  "\x8c\x21\x51\x7f\xf5\xf8\xf2\xa1"
+			  "\x06\x14\xee\xd1\xaa\x1c\x0d\x0c"
+			  "\x79\xde\x98\xb7\xf6\x45\xad\x47"
+			  "\x5a\xb3\x9e\xac\xe0\x6b\xe8\x6f"
+			  "\x8c\xe5\x38\xcd\x22\x83\xe5\xe2"
+			  "\xa2\x48\x9c\xc8\x9e\x0e\x7e\x7d"
+			  "\xf5\x2b\xe1\xee\x1b\x4f\x9d\x02"
+			  "\x68\xe7\x5b\xc8\xcd\x46\x8c\x3c"
+			  "\xc5\xc7\x36\x34\x26\xb2\x2a\xff"
+			  "\xae\x49\x40\xb6\xd8\x79\x79\xd1"
+			  "\x89\xf7\x8a\xa7\x7c\xf8\xbd\x6e"
+			  "\xc9\x2f\xd1\xdf\x98\xda\x25\xa4"
+			  "\x99\x71\xdc\xd7\xdf\xde\xd5\xb4"
+			  "\x93\x64\x19\x5a\x06\x7a\x0b\x01"
+			  "\x57\x06\xef\xed\xc5\x34\x31\xa7"
+			  "\x9f\x3d\x64\x4d\x66\xb8\xbc\x3f"
+			  "\xd5\xf7\x2b\x42\xd7\x63\x23\x92"
+			  "\x8a\x07\x8d\x71\x83\xe1\xc5\x55"
+			  "\x07\x23\x61\xb3\xc1\xb1\x63\x54"
+			  "\x3b\xa9\x25\x9c\xd3\x9b\x8e\x23"
+			  "\x9c\x68\x07\xfc\xf9\xb6\xcb\xb8"
+			  "\xa5\x6e\x6c\x40\x3b\xc9\x81\xc0"
+			  "\x09\x86\x7f\x01\x62\x95\x67\xb5"
+			  "\x0a\x89\x3a\xca\xeb\xbe\xfc\x4c"
+			  "\x3d\x7b\x43\xb5\xd0\x59\xa1\x68"
+			  "\x7a\x34\x23\xe3\x02\x7e\x7b\x7f"
+			  "\x8f\x3a\xe5\xff\x64\x77\x60\x72"
+			  "\x66\x10\x3c\x79\x35\xb8\xa4\x48"
+			  "\x5a\xea\x35\x3a\xe4\x20\x9b\xf0"
+			  "\xaa\xa6\x02\xd1\x92\x39\x04\x09"
+			  "\xb9\x06\xb9\x9e\x9f\xd3\x31\xf8"
+			  "\xbb\x6a\xcd\x30\x19\x64\xa7\xb7"
+			  "\x10\x5b\x60\x5c\xcc\xba\x43\x33"
+			  "\xf9\x4a\x38\x34\xd0\xd7\x9d\xf7"
+			  "\x6c\xa6\xec\x95\x50\xba\x99\x75"
+			  "\x41\xc4\xbf\xfa\x99\xdc\xd4\x8c"
+			  "\x74\xcf\x6b\xb5\xc2\x06\xdc\xcf"
+			  "\x57\x79\xa9\x6f\xab\x36\x3b\xd8"
+			  "\x3a\x39\x53\x9e\x1c\x3f\xe6\x02"
+			  "\x26\x66\x51\xf9\x01\xc5\xd5\x25"
+			  "\x9f\x28\xf9\x62\xe4\x98\x91\xed"
+			  "\xc1\x32\xb7\x69\x17\xa2\x2f\x71"
+			  "\x01\x47\x94\x1e\x55\x46\xc6\xe2"
+			  "\x76\x04\x9a\x0a\xe8\xd9\x60\x80"
+			  "\x3d\x21\xf0\xb8\x62\xc0\x71\x7d"
+			  "\xfa\x62\x06\x10\x44\xd2\x07\xf5"
+			  "\x70\x34\x61\xf1\x4b\xfc\x83\x9d"
+			  "\x3c\xa4\x37\x17\xab\xf4\x88\x68"
+			  "\x60\x87\xda\x5c\x8b\x97\xe6\x86"
+			  "\x6d\x09\x6f\xc3\x4f\x20\x89\x02"
+			  "\x93\x7b\x72\x13\x9c\x38\x53\x28"
+			  "\x0d\x20\xf6\x9a\xe4\x5a\x5c\x78"
+			  "\xbd\x15\x79\x50\x4a\xa9\x46\xb3"
+			  "\xc8\xb3\xde\x23\x1b\xa0\x9b\xe7"
+			  "\x70\xa6\x77\x30\x01\x10\x29\xe9"
+			  "\xa6\xe9\x83\x8e\x51\x7f\xb0\xe0"
+			  "\xef\x39\xbe\x99\x2a\x82\x7f\x2c"
+			  "\xcc\x6f\xcb\xaa\x83\xda\x19\x0d"
+			  "\x84\xfa\x98\x77\x52\x5c\x60\xa8"
+			  "\xb5\xce\x6e\x06\x74\xbb\x02\xa1"
+			  "\x13\x51\x45\x24\x43\x5c\x5c\x08"
+			  "\x26\xfe\xf5\x08\x58\xf6\xfe\x72"
+			  "\x36\x6f\xf3\x45\x70\x07\xb5\xcd"
+			  "\xb0\x79\xd2\xa5\xfd\xb5\x63\x95"
+			  "\x58\x23\x14\x91\x5a\xfe\x14\xa7"
+			  "\x6e\x84\x4f\xa3\xfd\x8d\x5f\xd5"
+			  "\xf5\x2c\x80\xb4\x45\x77\x38\x14"
+			  "\x0d\xc5\xc2\x4f\x94\xd7\x25\xf0"
+			  "\x5e\x8d\x2f\x7e\x08\x9f\x14\x2e"
+			  "\x96\xf1\x26\xac\x2d\xaf\x1e\x29"
+			  "\x39\xaf\x98\xfb\xb8\x6a\x01\x15"
+			  "\xcf\x94\x6a\xd2\x3e\xe9\xe5\xad"
+			  "\x18\xb6\x4a\x1e\x28\x6c\xf3\x2e"
+			  "\x3c\xcd\xad\x3f\x6a\xca\x50\xca"
+			  "\x51\x66\x85\x55\x85\x15\xd5\xf3"
+			  "\x89\x5c\x44\x35\x80\x97\x3f\x66"
+			  "\x4b\xb7\x97\xc5\xc6\xd4\x4a\xe7"
+			  "\x6e\xc8\x06\xd5\x36\x9e\x60\x23"
+			  "\x42\x6c\x64\xd4\x41\x13\x17\xff"
+			  "\xec\xde\x03\x2f\xd5\x08\x09\xde"
+			  "\x13\x1b\x29\xba\xf5\x05\xa0\xbe"
+			  "\xab\x95\x74\xbd\x73\x8b\x9f\x87"
+			  "\xea\x1f\x87\x7a\x88\xec\xe5\xc3"
+			  "\xc1\xff\xc4\x6e\x8f\x93\xa2\xcf"
+			  "\x61\x11\x63\x6a\xaf\x7e\x3d\xa4"
+			  "\xb7\xec\x11\x4b\x00\x58\x0d\x00"
+			  "\xd1\x64\x1d\x0f\xf0\x63\x4d\xfb"
+			  "\x9e\xd5\xa9\x01\x88\xe7\x62\xd5"
+			  "\x1c\x69\xeb\x96\xa6\xb6\xc1\x90"
+			  "\x06\x48\x00\x42\x38\x99\xf5\xdd"
+			  "\x58\x61\xaf\x27\x8e\xd1\x05\x2d"
+			  "\x5d\x31\x28\x87\x29\x37\x68\xd2"
+			  "\xc7\x18\x8e\x57\xd9\x7a\xc8\xe8"
+			  "\x30\xfe\x5a\xc9\xca\xa8\x97\xda"
+			  "\x27\x10\xd4\xb4\x22\xea\x04\xa3"
+			  "\x83\xc7\x48\xa2\xa7\xe0\x2f\x8e"
+			  "\x36\xd8\xf6\xca\xb9\x55\xaf\x05"
+			  "\xe8\x1a\xad\x81\xb4\x3e\x48\x31"
+			  "\x6e\x05\xba\x83\x2f\x4b\xb7\xc7"
+			  "\x47\xd9\xda\x65\xd4\xf3\x74\x4e"
+			  "\x4a\x8b\xbb\xa8\x20\x51\xf0\x73"
+			  "\x8d\x66\xe3\xce\xda\x0e\x4d\x53"
+			  "\x79\xdf\x38\xcc\x69\x62\x99\x80"
+			  "\xd7\x7d\xb5\x61\x8b\x73\x5e\xd3"
+			  "\x3c\x29\xb1\x8a\xc2\xed\x2a\x3f"
+			  "\x98",
+		.ilen	= 1281,
+		.result	= "\x95\xc8\x59\x47\xfc\x46\x9d\x36"
+			  "\x1d\xbc\x4a\x46\xed\x43\x78\xdc"
+			  "\x1c\x78\xf0\x3c\xeb\xe6\x23\xac"
+			  "\xd2\x31\xa5\x67\x1f\xbc\xbf\xe4"
+			  "\x14\xab\xce\xe6\x0e\xff\x21\x3d"
+			  "\xaa\x29\xa1\x2e\xf2\x23\xa7\x72"
+			  "\xb3\x95\x67\x4c\xdd\x83\x0a\x6e"
+			  "\x42\x1f\x4d\xa3\xac\xb7\x30\xf2"
+			  "\xab\xa8\x8f\x95\xa7\xbf\x07\x02"
+			  "\x00\x9a\x51\xa2\xd4\x57\x00\x95"
+			  "\x4f\x20\x53\x06\x56\x23\x8c\xf1"
+			  "\xca\x86\xbb\x60\xfd\xcc\x5b\x23"
+			  "\x5a\xd0\xd7\xa3\x3c\xab\x98\xe8"
+			  "\xd9\x97\x89\x40\x45\x96\x43\xe2"
+			  "\x2e\x84\x5d\x81\x64\xe7\xda\xc1"
+			  "\x56\x87\x1f\x98\xa7\xa1\xbe\xd0"
+			  "\x8c\x0b\xf6\xf2\xe7\x67\x6f\x37"
+			  "\xce\x84\x9e\x10\x20\x4b\x0e\x2f"
+			  "\x20\x9b\x3b\xb8\x0b\x77\x34\x04"
+			  "\x49\x35\x54\x94\x13\x79\x11\xaa"
+			  "\x3e\xce\x1a\x4a\x0a\xbb\x2c\x02"
+			  "\x31\x3d\xa2\xba\x3c\x13\x7a\x33"
+			  "\xcd\xa1\x2f\xfa\x9b\x03\x22\x9e"
+			  "\xd6\x7a\x4e\xbf\xcc\x5f\x34\x90"
+			  "\x85\x0d\xf0\xea\xbb\xd0\x71\x70"
+			  "\xa2\x11\x96\x7e\x1b\x86\x50\x52"
+			  "\x74\x20\xbd\xb6\xf4\x2b\x08\xa3"
+			  "\x25\x22\xd3\x38\x95\x2f\x0f\xb9"
+			  "\x44\xd6\xa6\xd0\x67\xc5\xa9\x8a"
+			  "\x0b\x39\xcf\xc8\x53\x1a\x43\x34"
+			  "\x81\x61\xdd\x47\xc2\x2a\x54\x08"
+			  "\x37\xe1\xdd\x46\x8a\xb3\xc1\x44"
+			  "\x21\x8c\x9f\x6d\x85\x02\xa4\x80"
+			  "\x7e\xbd\x27\x08\x4a\xf7\x14\xe0"
+			  "\xc4\x65\x8e\xce\xd8\xc2\x47\x0f"
+			  "\xd3\x7d\xe5\x6e\x91\xf3\x31\x6c"
+			  "\x78\x68\xb8\xa7\xf6\xfa\x80\xe5"
+			  "\x56\x4c\xec\xf7\xc0\x74\x23\xc2"
+			  "\x71\x8a\xb8\x66\x0c\xd7\x64\xa3"
+			  "\x04\xfc\xfc\x06\x6b\xd7\x74\x80"
+			  "\x31\x09\x9e\x30\xbe\x75\xc4\x1b"
+			  "\x5b\x15\x30\xce\x8b\x94\x18\x8a"
+			  "\xa3\x99\x52\x02\x08\x45\x3f\x0b"
+			  "\x8d\xec\xbd\x85\x86\xcb\xde\x73"
+			  "\x4e\x0d\x3c\x59\x82\x32\xc9\x0d"
+			  "\xc2\x7c\xb1\xea\xb7\xc8\x68\xd1"
+			  "\x59\x7b\x30\x00\xe6\x58\xf6\x15"
+			  "\xa7\xe7\x6a\xf5\x8e\x2b\x90\x31"
+			  "\x87\xb8\xc0\xf5\x4c\xdd\x7a\x57"
+			  "\x8a\xe7\x65\xfc\xd2\x0c\x55\xbb"
+			  "\xbf\xc6\xec\x54\x2f\xb0\x27\x68"
+			  "\xe5\x4b\x0d\x7b\xe9\x42\xd9\xf4"
+			  "\x5f\x57\x52\x21\x76\xbe\x6b\xaa"
+			  "\x70\x49\xad\x61\x8c\xa9\x05\xb9"
+			  "\x9c\x99\x55\xab\x70\x4c\x8e\x57"
+			  "\x19\x0d\xf3\xda\x34\x82\x85\xea"
+			  "\x9f\xfe\x5c\xcc\xb7\x02\x8a\xdb"
+			  "\x9b\x96\xfe\x25\xca\x37\xe8\x66"
+			  "\x51\xde\x1c\xcf\xea\x26\xde\x0c"
+			  "\xe3\xa0\xe2\x4d\xfb\x00\xcd\xaa"
+			  "\xdb\xa1\x4a\xd0\xa8\xcd\xfc\x6a"
+			  "\x76\xd3\x1d\x9c\x42\xba\xf8\xc1"
+			  "\x56\xdf\xf0\xde\x3e\x9b\x4a\xd6"
+			  "\x4b\xa5\x4d\x49\x88\x1d\x07\x81"
+			  "\x65\x61\x4c\xb2\xe3\x68\xf8\x27"
+			  "\xfa\x72\xe1\x92\x9e\x23\x65\x9a"
+			  "\xb1\xa8\xb4\x93\x98\x8c\x16\xa4"
+			  "\x98\x31\x45\x87\x1e\xd5\xaa\x05"
+			  "\x20\xf5\x79\x12\x76\x95\xe4\x58"
+			  "\xc7\x85\x81\xe9\x6b\x3f\xd2\xfb"
+			  "\xcc\xf0\x38\x98\xa7\x32\xec\xd0"
+			  "\x00\x5b\x33\x85\xd9\x98\x0e\x35"
+			  "\x3b\x1f\x30\xee\xc6\x6f\x1f\xe4"
+			  "\xc0\x45\xd7\xfc\x3f\xf2\x18\x9d"
+			  "\xa0\x6b\x29\xe0\x8a\xa7\x96\x83"
+			  "\x10\x89\x06\xd3\x6c\x4e\xad\x73"
+			  "\xa0\xe9\x92\xab\x00\xa4\x02\x10"
+			  "\x78\x98\xbf\x9f\xd3\x91\xdc\x36"
+			  "\x70\xa5\x5e\x47\x83\xce\x4b\xaf"
+			  "\x7d\x55\x6a\x82\x3d\x83\xf3\x38"
+			  "\x34\x24\x66\xff\xec\x26\x0b\xc9"
+			  "\x60\x69\xef\x09\x54\xf0\x23\x41"
+			  "\x11\x2c\xed\x50\xe5\xbd\x21\x94"
+			  "\x7e\x88\x2a\x18\x2c\x93\x92\x4e"
+			  "\x21\x45\x34\x21\x64\x0d\x3d\xb3"
+			  "\x20\x22\x83\x5c\x98\xaa\x43\x79"
+			  "\x46\x69\x3e\xa2\x17\x09\x35\x5d"
+			  "\xdf\xc8\x28\x69\xef\x2d\xb8\xf7"
+			  "\x01\xfa\x73\xd3\xc5\x37\xdd\xd6"
+			  "\x63\x5f\x17\xa6\x4e\x7e\xd8\x32"
+			  "\x22\xf1\xb6\x51\xbd\x80\x4e\x33"
+			  "\x42\xb3\x45\x02\x16\xa1\x71\xa5"
+			  "\xc2\xdf\x89\x67\x89\xa3\xd6\xfb"
+			  "\x86\x3a\x8b\x6a\x09\x2e\x5e\x3d"
+			  "\x40\x18\x21\x9e\x88\xa1\x72\x3e"
+			  "\xba\x65\x81\x3d\xce\x52\x31\x89"
+			  "\x12\x46\xe1\xe1\x46\x37\x8c\x35"
+			  "\x0a\x49\x00\x97\x7d\xe5\xed\xeb"
+			  "\xc2\x99\x35\x39\x99\x3e\x92\x7d"
+			  "\xf2\x2c\x58\x55\x8c\xdf\x70\xf4"
+			  "\x2f\x6a\xb4\x80\xa6\xa1\x61\x90"
+			  "\xf9\x15\x5c\xdd\x1c\x51\x56\xba"
+			  "\x15\xad\xa0\x6e\x88\x3d\x6e\x5c"
+			  "\x60\xa8\x0c\x58\xbe\xbf\x72\x95"
+			  "\x04\xfe\xf9\x68\xc9\x5d\xce\x14"
+			  "\x66\x56\x59\x85\xcf\xd1\xdf\x55"
+			  "\xf1\xce\x86\x05\x74\x60\x07\xfc"
+			  "\xc9\xfa\x91\x08\x92\x9a\x8d\xb7"
+			  "\xbc\xc5\xbf\x88\xe7\x70\x22\xd0"
+			  "\xad\x48\x34\x19\xb5\x19\x0e\xa4"
+			  "\x0d\x53\x9d\x20\x6a\x3d\xa4\xb7"
+			  "\x9d\x89\xc3\x22\xa7\x2b\xa0\x3e"
+			  "\x0b\x4f\xfd\xdd\xc6\xe4\xdd\x1c"
+			  "\xaa\xa3\x3e\xe4\xa8\x17\x52\x18"
+			  "\x86\xe8\xe5\xe6\xbe\xb2\x86\xd5"
+			  "\xc4\x6b\x3e\xe0\x30\x1b\x4f\xa1"
+			  "\xe5\xea\x25\x28\xa0\x1d\x4e\xf2"
+			  "\x25\xa3\x74\x79\xea\x13\x28\x91"
+			  "\xf1\xf3\x38\x43\x59\x1c\x6a\xe8"
+			  "\x35\xc7\x31\x57\xf0\x20\x73\x92"
+			  "\x5d\x40\xd0\xb5\xf0\xc0\x4a\x70"
+			  "\x00\xa0\x60\x5d\x20\x84\x8d\x52"
+			  "\x13\xcf\x7d\x72\xd9\x44\x08\xd4"
+			  "\xcf\xe8\x1e\x39\xc0\xa5\x53\x39"
+			  "\xd8\x8a\xee\x23\x1c\x02\x3e\x44"
+			  "\xa2\xbd\x06\xe3\x44\xa0\x6c\x20"
+			  "\x4e\x0d\x2a\xe7\xe4\x09\xe5\x85"
+			  "\x3a\xdc\x14\x4f\x13\x84\xa0\x70"
+			  "\x74\xc7\xff\xb1\xda\xde\xf7\xf1"
+			  "\x8a\x22\x85\xe4\x29\x7a\xf1\xfb"
+			  "\x18\xd4\xd4\x91\x27\x90\x80\x5a"
+			  "\x6d\x05\x6f\x2c\x8e\x91\xa0\xca"
+			  "\xf5\x16\x5b\x55\x6c\x44\x47\x5a"
+			  "\x37\x0a\xda\x93\x5a\xf8\xd4\xcc"
+			  "\x3d\xf2\xe5\x22\x9d\xc9\xe3\x47"
+			  "\x3a\x55\x6f\xd0\xdc\xe3\xaa\x22"
+			  "\x65\xfb\x00\x2f\xf4\x01\xce\xc0"
+			  "\xe5\xad\xd2\xf6\xec\x2f\x24\x52"
+			  "\xe0\x7f\xe2\x04\x7a\xf1\xc1\xab"
+			  "\xad\x17\x89\x71\x78\xde\x5a\xdf"
+			  "\xd3\x51\x70\x85\x47\xac\x30\x37"
+			  "\xf4\x64\x88\x5d\x1d\xd6\x0f\x49"
+			  "\x87\x30\x20\x62\x26\x79\x7b\xdf"
+			  "\xf2\xcf\xe4\x58\x91\x45\x85\x2c"
+			  "\x96\xc3\xeb\xfa\x2f\x56\x9b\xc3"
+			  "\x1c\x2f\xa0\x04\x45\xc5\xe9\x05"
+			  "\xce\xe8\xf8\xca\x8a\x35\x19\x48"
+			  "\xb0\x74\x93\xed\x42\x04\x43\xf5"
+			  "\x77\x75\x55\x26\x95\xfb\xbd\x0d"
+			  "\x22\x67\x92\x70\x4c\xfa\xd2\xc0"
+			  "\xde\x24\x14\x03\xc0\xa1\x0b\x99"
+			  "\xa9\xbd\x53\x48\x83\x9b\x61\x63"
+			  "\x6c\x83\xed\xeb\x55\x1d\xf3\x0d"
+			  "\x78\x1b\xb3\xb2\x28\xde\x09\x8c"
+			  "\x68\x1d\xff\x88\x5c\x4d\xeb\x19"
+			  "\x32\xfd\x8c\x06\xfa\x7b\x55\x61"
+			  "\x2d\x1e\xe5\xec\xa0\xc5\x76\x3b"
+			  "\x5a\xe1\x2a\x4b\x4d\x42\x35\x21"
+			  "\xd9\x3e\x22\x43\x79\x8e\x4a\xde"
+			  "\x3d\xfa\x6b\x55\xac\x81\xa4\xf8"
+			  "\x40",
+		.rlen	= 1281,
+		.also_non_np = 1,
+		.np	= 3,
+		.tap	= { 1200, 1, 80 },
+	}, { /* stream position 1 */
+		.key	= "\x88\x09\x23\xc4\x83\x5a\xce\xb4"
+			  "\xd4\x55\xa2\x99\x23\x88\x69\x1b"
+			  "\x14\x28\x2c\x2b\xff\x2c\x0e\x95"
+			  "\x16\x3b\x01\x9a\x85\x7c\x39\x43",
+		.klen	= 32,
+		.iv	= "\x42\xb0\x20\x05\x85\x93\x01\x65"
+			  "\x4d\xca\xb2\x33\x88\x3e\xed\xb3"
+			  "\xc6\xf7\x13\x68\x13\x14\x37\x16"
+			  "\x01\x00\x00\x00\x00\x00\x00\x00",
+		.input	= "\xd3\x2b\x42\x4f\x7c\x75\xaa\xb4"
+			  "\xc7\x48\x35\xec\x5d\xd5\x8a\xf3"
+			  "\x09\xed\x83\xe0\x6a\x67\xf3\xae"
+			  "\x77\x4a\xe3\xd5\x24\x23\xe2\x2d"
+			  "\x06\xf5\x46\x14\x98\xb7\x73\xf4"
+			  "\xb5\xca\x7d\x23\x2e\xd8\x39\x68"
+			  "\x97\xe7\xa2\x32\x2e\x78\x3c\x02"
+			  "\x45\x13\x7a\x1e\x48\x30\xce\x26"
+			  "\xf0",
+		.ilen	= 65,
+		.result	= "\x6c\x1e\x1e\xef\xe8\xd9\xaa\xb8"
+			  "\xb5\x6b\xfa\xb6\x34\xb3\xf7\xfe"
+			  "\xdc\xa7\xbc\x82\xa4\xaf\xec\x0a"
+			  "\xdc\x32\x7d\x41\xfe\x47\xbc\x19"
+			  "\xc0\x3c\xe5\xe2\x1b\x8a\x84\x3a"
+			  "\x29\x44\x56\x49\x9b\x29\x1a\x4f"
+			  "\x25\x82\x81\xa9\x4b\xbf\x5b\xb4"
+			  "\x06\x80\x31\x76\x42\x1c\x07\x1b"
+			  "\xca",
+		.rlen	= 65,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 33, 32 },
+	},
+};
+
+/*
+ * Adiantum test vectors, generated with an independent implementation of the
+ * specification ("Adiantum: length-preserving encryption for entry-level
+ * processors", https://eprint.iacr.org/2018/720.pdf).
+ */
+static const struct cipher_testvec adiantum_xchacha12_aes_enc_tv_template[] = {
+	{
+		.key	= "\xa4\x7f\xe9\x52\x0a\xf0\x76\x43"
+			  "\x1a\x48\x79\xd1\x23\x65\xe9\x4d"
+			  "\x70\x21\xa9\xfe\xb4\xd7\x2e\x5d"
+			  "\x0d\x2b\x1e\xf4\x32\xcc\x7a\xaa",
+		.klen	= 32,
+		.iv	= "\x74\x72\xc4\xe7\x0d\x83\xc7\x21"
+			  "\x1d\x1e\x9f\x2e\xaa\x5a\x90\x68"
+			  "\x09\xb0\x80\x44\x09\x21\x44\x45"
+			  "\xba\x4b\x79\x3d\xaa\x71\xef\xe2",
+		.input	= "\xb4\x53\x7d\x57\x57\x5a\xcf\xf6"
+			  "\x15\x49\x23\x47\xa3\x9c\x49\x0f",
+		.ilen	= 16,
+		.result	= "\x3e\xd0\x5c\x79\x73\x84\x63\xc5"
+			  "\x38\x23\x8e\x9d\xc7\x7d\x34\xe2",
+		.rlen	= 16,
+	}, {
+		.key	= "\x72\xd7\xb0\x69\x5b\x0a\xf5\x89"
+			  "\x23\x79\x8f\x24\x99\xbe\xea\xe4"
+			  "\x1a\x60\x35\x12\xcf\x44\x65\x4a"
+			  "\xc1\x6e\x31\xf5\x86\x04\xfa\x96",
+		.klen	= 32,
+		.iv	= "\xa9\x40\x1e\x44\x91\x82\xaa\xb5"
+			  "\x91\x5e\xe9\x66\x8c\x09\x5d\xb2"
+			  "\x0f\x3c\xa1\x88\xdb\x2e\xaa\xcc"
+			  "\x2b\xe4\xdb\x76\x23\x7b\xda\x51",
+		.input	= "\xc9\xaa\x23\xb6\x19\xf9\xbf\x92"
+			  "\xac\x82\xed\x01\x41\xe5\xeb\x79"
+			  "\xe4",
+		.ilen	= 17,
+		.result	= "\xe2\x94\x6e\xaf\x51\xb1\xcc\xe3"
+			  "\xe5\xa3\x36\x0f\xc6\x2d\xb0\xdd"
+			  "\x5a",
+		.rlen	= 17,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 8, 9 },
+	}, {
+		.key	= "\xf1\xf5\xb9\xbc\x10\xcc\xb9\x2a"
+			  "\xcc\xe9\x79\x4f\x37\x5f\x39\x65"
+			  "\x93\x2c\x79\x83\x3f\x46\x8b\x72"
+			  "\xee\xb4\xde\x44\x0f\x65\x00\xb2",
+		.klen	= 32,
+		.iv	= "\x3c\x82\xea\xe5\x45\xc7\xdb\x46"
+			  "\x4d\x29\x11\x8d\x2c\x7a\x6b\x28"
+			  "\x47\xbd\x6a\x27\xff\x3b\x25\xdc"
+			  "\xdc\x1e\xa3\x9f\xfe\x9c\x03\xa5",
+		.input	= "\x94\x55\x3c\x8c\x42\x2f\x49\x32"
+			  "\xe6\xe5\x84\x4e\x76\xa4\x02\x7d"
+			  "\xf5\x60\xb0\xfd\x22\xa0\xaf\x16"
+			  "\xc5\xb6\x11\xb5\x02\xd7\xf8\xc7"
+			  "\xe3\xe3\x23\x9d\x1d\xe2\x19\x13"
+			  "\x17\xf2\xe3\xbd\xf8\xd0\xec\x2e"
+			  "\x57\xa0\x5c\x95\x9f\x91\x91\xfb"
+			  "\x2f\x73\x28\xb1\x0d\xac\x46\x29"
+			  "\xe4\xec\x28\x31\xdc\x41\x5b\xba"
+			  "\x33\x25\x76\x0c\xfc\xc9\xb1\xb3"
+			  "\x26\x9d\xbd\x96\xe6\x18\x2f\xd8"
+			  "\xf8\x85\x48\x79\x7a\x20\x86\xb5"
+			  "\x6e\xf3\xc1\x81\x08\xec\x4c\xd2"
+			  "\x64\xbe\x32\x5b\x3e\x2a\xe9\x0b"
+			  "\x18\x51\x3c\x81\xc3\x0a\x5a\x67"
+			  "\x01\x9e\xd1\xdc\xe8\x99\xf5\x77",
+		.ilen	= 128,
+		.result	= "\x63\x44\x2b\xc6\x3e\x9d\x66\x13"
+			  "\x21\x13\xfa\x5e\xf3\x96\xd4\x47"
+			  "\x34\x03\x13\x66\x03\xf9\x41\xb8"
+			  "\x51\x9a\x96\xdb\xc4\xb3\x76\xb9"
+			  "\x8d\xb2\xba\x5d\xf1\x9d\x7d\xda"
+			  "\xd8\xc3\x3d\xd4\x1c\x7f\x49\xb1"
+			  "\x95\xb3\xe2\x97\xaf\xd8\x41\xac"
+			  "\x81\xf0\x3f\x91\xe0\xef\xa4\x1b"
+			  "\xce\xa6\xa2\x67\x34\xea\x51\x14"
+			  "\xfd\xb8\x8d\x4f\x2f\xec\xb3\xf7"
+			  "\x82\xcc\x8a\x8d\x22\x6b\x6a\xcd"
+			  "\xdd\x62\x2f\x19\x12\x5e\xf9\xfc"
+			  "\x9e\xe2\x38\xc8\x97\x12\x17\x49"
+			  "\xcc\x4f\x72\xf5\x55\xb1\xdf\xa2"
+			  "\x85\xd7\x39\x78\x4e\x0d\xff\xf0"
+			  "\x9d\xdc\x1c\x29\x52\x1a\xbe\x35",
+		.rlen	= 128,
+	}, {
+		.key	= "\x1a\x7b\x21\x85\xf0\xed\xd2\xa0"
+			  "\xb8\xf8\xae\x2d\x95\x9e\x79\xd9"
+			  "\x45\xbb\xaf\xcf\x2d\x33\xa1\xdf"
+			  "\x45\x68\x77\x24\x89\x24\x2e\xe5",
+		.klen	= 32,
+		.iv	= "\xc9\xf7\x12\x3b\x1d\x04\xfc\x51"
+			  "\xf3\xff\xc0\x16\xb3\x86\x9c\xe1"
+			  "\xcf\x12\xff\xa8\x90\x31\x16\x57"
+			  "\xde\x36\xd6\xa3\x15\x70\x3e\xa4",
+		.input	= "\xfd\x0d\x6b\xe9\x19\x16\x6b\x40"
+			  "\x81\xff\x38\x60\xc9\x8f\x15\xbb"
+			  "\xbd\x26\xe2\x74\x70\x2d\xb5\xc6"
+			  "\xd9\xdc\xce\x55\xcd\x5c\x17\x12"
+			  "\x90\x41\xc1\x68\x7b\x3a\x00\xd2"
+			  "\xa5\xf1\x97\xfe\x19\xfb\x46\xb3"
+			  "\x3b\xfa\xf7\x52\x2a\xbe\xa9\xd2"
+			  "\x5d\x67\x56\x7b\x28\x8d\x05\x62"
+			  "\x32\x42\x26\xac\x58\xf7\xb1\x05"
+			  "\x29\xc4\xe6\x33\x47\xdc\xb2\x3e"
+			  "\x5b\xb1\x7e\x3b\xbe\xb9\xfb\x20"
+			  "\xb5\xfe\x21\x50\x36\x40\xe4\x11"
+			  "\x5c\x12\x76\xcd\x1b\x0a\x61\xa7"
+			  "\x52\x1e\x3d\x58\x5b\x8f\x05\xc0"
+			  "\x59\x55\x57\xd0\x97\xb8\x00\x77"
+			  "\x3d\x33\x78\x4b\xc1\xbe\xb0\x12"
+			  "\xcc\x8a\xed\xce\x63\x60\x0f\x08"
+			  "\x83\xa4\x35\x93\xc8\x8d\xab\x54"
+			  "\x91\xbb\xc9\x5a\xb6\x19\xcd\xa2"
+			  "\x5d\x18\x6e\xbf\xc3\x76\x62\xd6"
+			  "\xa0\x10\xb7\x67\x4f\xb1\x06\x39"
+			  "\xeb\xed\x04\x2f\x50\x0f\x60\x7b"
+			  "\xd0\xcd\xd7\x8b\x77\xd1\x71\x30"
+			  "\x53\x0d\xa9\x8c\xd9\xd2\x50\xe7"
+			  "\xca\x66\x22\x26\xde\xb4\x26\x47"
+			  "\x60\x4f\xaf\xf6\xb5\x39\x8b\x4d"
+			  "\x33\x53\xf5\x95\x8f\x04\xcd\x69"
+			  "\xdb\x7f\x8b\x32\x85\x6e\x86\xf8"
+			  "\xed\xf5\x40\xce\x9c\x33\x8b\x21"
+			  "\x5a\x48\xfe\xe0\x1c\x7a\x63\xaf"
+			  "\x5a\xf4\x68\x2c\xb3\x0c\x6b\x85"
+			  "\x02\x6e\x0a\xad\xa9\x60\xf2\x61"
+			  "\xd1\x70\x75\x3d\xd1\xef\xbb\x43"
+			  "\x54\x40\x02\x87\xdf\x67\xb0\xee"
+			  "\x35\xda\x68\x90\xca\x15\x78\xd1"
+			  "\x9d\x9f\x00\xac\x01\xaf\x84\x5a"
+			  "\xdb\x77\xd3\x6c\x50\x7f\x36\x32"
+			  "\xbe\xcf\xb5\xf5\xdc\x82\x13\xe9"
+			  "\x0a\xe3\x4e\xaa\x8f\x7b\x38\xd6"
+			  "\x1b\xa6\xb1\x2c\x32\xdc\xa5\x38"
+			  "\xea\xd4\xa1\x38\xa7\x04\x9d\xa5"
+			  "\xbc\xbb\x40\x53\x6e\xa5\x44\x00"
+			  "\x77\xc1\x24\xc2\x5f\xf7\x53\x15"
+			  "\x10\x15\x79\x90\x9d\xa4\x7a\xc7"
+			  "\xbb\x51\x59\x07\x50\xf4\x54\x9a"
+			  "\xbd\x79\xd9\x43\x01\xa0\xa3\xa4"
+			  "\x15\x03\x2f\x62\x42\x1c\x22\x0d"
+			  "\xcc\x0f\x35\x45\xee\x4f\x87\x1a"
+			  "\xe6\x11\x00\x61\x9c\xd3\x10\xbb"
+			  "\x48\x7d\x47\x74\xe5\x0a\x41\x9e"
+			  "\x9a\x89\x6f\x63\x64\xdc\x85\x29"
+			  "\x7f\xa9\x48\xeb\xf8\x28\x90\x9e"
+			  "\x3b\x4d\x61\x9f\x51\x6c\x66\x3a"
+			  "\x39\x15\xba\x7f\x0f\xc6\xb3\x80"
+			  "\xfc\x25\x98\x0b\x78\xd2\xf7\x98"
+			  "\xce\x64\xd1\xa4\x0d\xae\x35\xaa"
+			  "\x98\x1f\x9f\x36\x41\x1d\x0e\x06"
+			  "\xd1\x39\xcf\x43\x81\x17\xee\xb0"
+			  "\x1b\xe7\xc0\xe2\x61\x20\xd4\x21"
+			  "\xaa\x1e\x8d\xd1\x84\x37\x9c\x90"
+			  "\xe2\x8d\xe0\x22\x69\xb0\x38\xbb"
+			  "\xf9\x8b\x11\xbe\xb4\x05\xb8\x99"
+			  "\xa3\x8f\x0d\xc6\x13\xb0\xd0\x83"
+			  "\x35\xcd\x91\x2f\xb4\xc6\x42\x10",
+		.ilen	= 512,
+		.result	= "\x49\xc4\x59\x03\x51\xd9\x3c\x38"
+			  "\x45\x82\x75\x3e\x03\x3b\xf9\x39"
+			  "\x6f\x96\x2e\x19\xdd\x0d\x98\x93"
+			  "\x24\x1e\xe5\xd7\x7c\x5e\x29\xc3"
+			  "\x73\xcd\x82\x42\xea\x23\x3c\x15"
+			  "\x99\xd5\xaf\x69\xe4\x68\x03\x38"
+			  "\xab\x1c\xec\x1f\x98\xec\x26\xe8"
+			  "\x20\xff\x14\xee\x72\x14\x95\x15"
+			  "\x83\x0f\x40\xf3\x8e\x8c\x0a\xd7"
+			  "\x1c\x04\x5d\x4e\xb4\xfb\x1e\x2e"
+			  "\xb7\x95\x40\x70\x4b\xa2\x41\xad"
+			  "\xcd\x32\x60\x89\xe9\xea\x09\x2f"
+			  "\x29\xf3\x2e\xf3\xdf\x7d\xef\x2f"
+			  "\xeb\x8e\x8b\x3b\x10\xce\x9b\xad"
+			  "\x3d\x22\xe9\x4b\x7c\xaa\x33\xcb"
+			  "\xc4\x3c\xce\x22\x15\xb8\xa9\x91"
+			  "\x8b\xd3\xb0\xd4\xf8\xf3\x06\x34"
+			  "\x92\x4a\x16\xa9\x99\x61\xa1\x84"
+			  "\x1b\xb1\xef\x7e\x60\xf4\x15\x83"
+			  "\x9a\x00\xe8\xba\x34\xc3\xbf\x94"
+			  "\x2f\x3b\x0a\x78\xa3\xa6\xd0\xab"
+			  "\x4b\xeb\x08\x1a\x36\xbb\xfe\xee"
+			  "\xcf\xfc\x2f\xaa\x1c\xf6\x7f\xd1"
+			  "\xfa\xc0\x0c\x4d\xc6\xd7\x82\x9d"
+			  "\x7d\xa9\xee\x47\x81\xf1\xd0\x56"
+			  "\x11\xaa\xce\x3d\x2b\x56\xb0\xfd"
+			  "\x97\xc2\x68\x87\x38\xa1\xe5\x74"
+			  "\x68\x53\xe1\x81\x16\x6c\x61\x3c"
+			  "\x69\x81\x31\xa8\x92\xa0\x91\x08"
+			  "\xdc\xde\x8f\x3e\x60\xf9\x4e\xeb"
+			  "\xff\xec\xa2\xbb\x8f\x4c\xf9\x77"
+			  "\x3c\xf5\x32\x92\x17\x8b\x92\x02"
+			  "\x5d\xce\x69\xe2\x6f\x3b\x88\x45"
+			  "\xa9\x2e\xfa\x91\xcb\x68\xdb\xec"
+			  "\xd3\xf1\xbf\xf3\x03\x44\xff\x09"
+			  "\x0d\x3e\x38\xb3\xf3\x45\x3c\x02"
+			  "\x4e\x58\xc3\x64\xb7\x83\x13\x88"
+			  "\xcd\xec\x5a\xbc\x4a\xdc\x71\xba"
+			  "\xee\xf9\x99\x8e\xa0\xff\x72\xcb"
+			  "\x77\x73\xf2\xc1\xf6\xdb\xdf\x64"
+			  "\x5f\x02\x50\x82\x06\xfe\x2d\xd3"
+			  "\x9c\x0c\x80\xc3\x96\xcb\xb0\xdf"
+			  "\x07\x8a\x65\x84\x19\x4b\xbd\xe1"
+			  "\xf8\xc9\x27\xe0\x05\x12\x1e\x8f"
+			  "\xcb\x36\x45\x4a\x0e\xa7\x0e\x3f"
+			  "\xe5\x5e\xb3\xf4\xfb\x09\x05\xe7"
+			  "\x87\xc3\x0f\x0f\x14\x89\x9f\xb8"
+			  "\x8f\x12\xf1\xcd\x13\x05\x62\x13"
+			  "\x63\x30\x69\x37\x33\xe9\x35\x93"
+			  "\x9d\x08\xe5\xac\x55\xf4\xe6\xa4"
+			  "\xd1\x83\x92\x12\xb8\x93\x52\xb1"
+			  "\x58\xb4\x2c\xc6\xc0\x15\x1d\x3f"
+			  "\x0c\x22\xa7\xd0\x94\x07\x24\xe5"
+			  "\x60\xd9\x69\x00\x02\x6b\x12\xb9"
+			  "\xbe\x66\xda\xf9\x8c\x52\x76\x9a"
+			  "\xd8\xfe\xcb\xc1\xda\xf5\x63\xfe"
+			  "\xce\x93\x87\xe6\x06\x51\xca\x69"
+			  "\xe4\x7c\xb8\x19\xc4\x89\xa8\x32"
+			  "\xf9\xcb\x3c\x45\x25\x30\x3e\x47"
+			  "\x7a\xfd\x72\xad\x0c\x4d\x04\x94"
+			  "\x16\x31\x5a\xd3\x0e\x0f\x83\x56"
+			  "\xd4\x46\x25\x27\x55\x54\x11\x63"
+			  "\xfc\xa8\x38\xa2\x04\x31\x4d\x07"
+			  "\xb2\x95\x09\x9f\xa6\x47\xff\xed",
+		.rlen	= 512,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 500, 12 },
+	},
+};
+
+static const struct cipher_testvec adiantum_xchacha12_aes_dec_tv_template[] = {
+	{
+		.key	= "\xa4\x7f\xe9\x52\x0a\xf0\x76\x43"
+			  "\x1a\x48\x79\xd1\x23\x65\xe9\x4d"
+			  "\x70\x21\xa9\xfe\xb4\xd7\x2e\x5d"
+			  "\x0d\x2b\x1e\xf4\x32\xcc\x7a\xaa",
+		.klen	= 32,
+		.iv	= "\x74\x72\xc4\xe7\x0d\x83\xc7\x21"
+			  "\x1d\x1e\x9f\x2e\xaa\x5a\x90\x68"
+			  "\x09\xb0\x80\x44\x09\x21\x44\x45"
+			  "\xba\x4b\x79\x3d\xaa\x71\xef\xe2",
+		.input	= "\x3e\xd0\x5c\x79\x73\x84\x63\xc5"
+			  "\x38\x23\x8e\x9d\xc7\x7d\x34\xe2",
+		.ilen	= 16,
+		.result	= "\xb4\x53\x7d\x57\x57\x5a\xcf\xf6"
+			  "\x15\x49\x23\x47\xa3\x9c\x49\x0f",
+		.rlen	= 16,
+	}, {
+		.key	= "\x72\xd7\xb0\x69\x5b\x0a\xf5\x89"
+			  "\x23\x79\x8f\x24\x99\xbe\xea\xe4"
+			  "\x1a\x60\x35\x12\xcf\x44\x65\x4a"
+			  "\xc1\x6e\x31\xf5\x86\x04\xfa\x96",
+		.klen	= 32,
+		.iv	= "\xa9\x40\x1e\x44\x91\x82\xaa\xb5"
+			  "\x91\x5e\xe9\x66\x8c\x09\x5d\xb2"
+			  "\x0f\x3c\xa1\x88\xdb\x2e\xaa\xcc"
+			  "\x2b\xe4\xdb\x76\x23\x7b\xda\x51",
+		.input	= "\xe2\x94\x6e\xaf\x51\xb1\xcc\xe3"
+			  "\xe5\xa3\x36\x0f\xc6\x2d\xb0\xdd"
+			  "\x5a",
+		.ilen	= 17,
+		.result	= "\xc9\xaa\x23\xb6\x19\xf9\xbf\x92"
+			  "\xac\x82\xed\x01\x41\xe5\xeb\x79"
+			  "\xe4",
+		.rlen	= 17,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 8, 9 },
+	}, {
+		.key	= "\xf1\xf5\xb9\xbc\x10\xcc\xb9\x2a"
+			  "\xcc\xe9\x79\x4f\x37\x5f\x39\x65"
+			  "\x93\x2c\x79\x83\x3f\x46\x8b\x72"
+			  "\xee\xb4\xde\x44\x0f\x65\x00\xb2",
+		.klen	= 32,
+		.iv	= "\x3c\x82\xea\xe5\x45\xc7\xdb\x46"
+			  "\x4d\x29\x11\x8d\x2c\x7a\x6b\x28"
+			  "\x47\xbd\x6a\x27\xff\x3b\x25\xdc"
+			  "\xdc\x1e\xa3\x9f\xfe\x9c\x03\xa5",
+		.input	= "\x63\x44\x2b\xc6\x3e\x9d\x66\x13"
+			  "\x21\x13\xfa\x5e\xf3\x96\xd4\x47"
+			  "\x34\x03\x13\x66\x03\xf9\x41\xb8"
+			  "\x51\x9a\x96\xdb\xc4\xb3\x76\xb9"
+			  "\x8d\xb2\xba\x5d\xf1\x9d\x7d\xda"
+			  "\xd8\xc3\x3d\xd4\x1c\x7f\x49\xb1"
+			  "\x95\xb3\xe2\x97\xaf\xd8\x41\xac"
+			  "\x81\xf0\x3f\x91\xe0\xef\xa4\x1b"
+			  "\xce\xa6\xa2\x67\x34\xea\x51\x14"
+			  "\xfd\xb8\x8d\x4f\x2f\xec\xb3\xf7"
+			  "\x82\xcc\x8a\x8d\x22\x6b\x6a\xcd"
+			  "\xdd\x62\x2f\x19\x12\x5e\xf9\xfc"
+			  "\x9e\xe2\x38\xc8\x97\x12\x17\x49"
+			  "\xcc\x4f\x72\xf5\x55\xb1\xdf\xa2"
+			  "\x85\xd7\x39\x78\x4e\x0d\xff\xf0"
+			  "\x9d\xdc\x1c\x29\x52\x1a\xbe\x35",
+		.ilen	= 128,
+		.result	= "\x94\x55\x3c\x8c\x42\x2f\x49\x32"
+			  "\xe6\xe5\x84\x4e\x76\xa4\x02\x7d"
+			  "\xf5\x60\xb0\xfd\x22\xa0\xaf\x16"
+			  "\xc5\xb6\x11\xb5\x02\xd7\xf8\xc7"
+			  "\xe3\xe3\x23\x9d\x1d\xe2\x19\x13"
+			  "\x17\xf2\xe3\xbd\xf8\xd0\xec\x2e"
+			  "\x57\xa0\x5c\x95\x9f\x91\x91\xfb"
+			  "\x2f\x73\x28\xb1\x0d\xac\x46\x29"
+			  "\xe4\xec\x28\x31\xdc\x41\x5b\xba"
+			  "\x33\x25\x76\x0c\xfc\xc9\xb1\xb3"
+			  "\x26\x9d\xbd\x96\xe6\x18\x2f\xd8"
+			  "\xf8\x85\x48\x79\x7a\x20\x86\xb5"
+			  "\x6e\xf3\xc1\x81\x08\xec\x4c\xd2"
+			  "\x64\xbe\x32\x5b\x3e\x2a\xe9\x0b"
+			  "\x18\x51\x3c\x81\xc3\x0a\x5a\x67"
+			  "\x01\x9e\xd1\xdc\xe8\x99\xf5\x77",
+		.rlen	= 128,
+	}, {
+		.key	= "\x1a\x7b\x21\x85\xf0\xed\xd2\xa0"
+			  "\xb8\xf8\xae\x2d\x95\x9e\x79\xd9"
+			  "\x45\xbb\xaf\xcf\x2d\x33\xa1\xdf"
+			  "\x45\x68\x77\x24\x89\x24\x2e\xe5",
+		.klen	= 32,
+		.iv	= "\xc9\xf7\x12\x3b\x1d\x04\xfc\x51"
+			  "\xf3\xff\xc0\x16\xb3\x86\x9c\xe1"
+			  "\xcf\x12\xff\xa8\x90\x31\x16\x57"
+			  "\xde\x36\xd6\xa3\x15\x70\x3e\xa4",
+		.input	= "\x49\xc4\x59\x03\x51\xd9\x3c\x38"
+			  "\x45\x82\x75\x3e\x03\x3b\xf9\x39"
+			  "\x6f\x96\x2e\x19\xdd\x0d\x98\x93"
+			  "\x24\x1e\xe5\xd7\x7c\x5e\x29\xc3"
+			  "\x73\xcd\x82\x42\xea\x23\x3c\x15"
+			  "\x99\xd5\xaf\x69\xe4\x68\x03\x38"
+			  "\xab\x1c\xec\x1f\x98\xec\x26\xe8"
+			  "\x20\xff\x14\xee\x72\x14\x95\x15"
+			  "\x83\x0f\x40\xf3\x8e\x8c\x0a\xd7"
+			  "\x1c\x04\x5d\x4e\xb4\xfb\x1e\x2e"
+			  "\xb7\x95\x40\x70\x4b\xa2\x41\xad"
+			  "\xcd\x32\x60\x89\xe9\xea\x09\x2f"
+			  "\x29\xf3\x2e\xf3\xdf\x7d\xef\x2f"
+			  "\xeb\x8e\x8b\x3b\x10\xce\x9b\xad"
+			  "\x3d\x22\xe9\x4b\x7c\xaa\x33\xcb"
+			  "\xc4\x3c\xce\x22\x15\xb8\xa9\x91"
+			  "\x8b\xd3\xb0\xd4\xf8\xf3\x06\x34"
+			  "\x92\x4a\x16\xa9\x99\x61\xa1\x84"
+			  "\x1b\xb1\xef\x7e\x60\xf4\x15\x83"
+			  "\x9a\x00\xe8\xba\x34\xc3\xbf\x94"
+			  "\x2f\x3b\x0a\x78\xa3\xa6\xd0\xab"
+			  "\x4b\xeb\x08\x1a\x36\xbb\xfe\xee"
+			  "\xcf\xfc\x2f\xaa\x1c\xf6\x7f\xd1"
+			  "\xfa\xc0\x0c\x4d\xc6\xd7\x82\x9d"
+			  "\x7d\xa9\xee\x47\x81\xf1\xd0\x56"
+			  "\x11\xaa\xce\x3d\x2b\x56\xb0\xfd"
+			  "\x97\xc2\x68\x87\x38\xa1\xe5\x74"
+			  "\x68\x53\xe1\x81\x16\x6c\x61\x3c"
+			  "\x69\x81\x31\xa8\x92\xa0\x91\x08"
+			  "\xdc\xde\x8f\x3e\x60\xf9\x4e\xeb"
+			  "\xff\xec\xa2\xbb\x8f\x4c\xf9\x77"
+			  "\x3c\xf5\x32\x92\x17\x8b\x92\x02"
+			  "\x5d\xce\x69\xe2\x6f\x3b\x88\x45"
+			  "\xa9\x2e\xfa\x91\xcb\x68\xdb\xec"
+			  "\xd3\xf1\xbf\xf3\x03\x44\xff\x09"
+			  "\x0d\x3e\x38\xb3\xf3\x45\x3c\x02"
+			  "\x4e\x58\xc3\x64\xb7\x83\x13\x88"
+			  "\xcd\xec\x5a\xbc\x4a\xdc\x71\xba"
+			  "\xee\xf9\x99\x8e\xa0\xff\x72\xcb"
+			  "\x77\x73\xf2\xc1\xf6\xdb\xdf\x64"
+			  "\x5f\x02\x50\x82\x06\xfe\x2d\xd3"
+			  "\x9c\x0c\x80\xc3\x96\xcb\xb0\xdf"
+			  "\x07\x8a\x65\x84\x19\x4b\xbd\xe1"
+			  "\xf8\xc9\x27\xe0\x05\x12\x1e\x8f"
+			  "\xcb\x36\x45\x4a\x0e\xa7\x0e\x3f"
+			  "\xe5\x5e\xb3\xf4\xfb\x09\x05\xe7"
+			  "\x87\xc3\x0f\x0f\x14\x89\x9f\xb8"
+			  "\x8f\x12\xf1\xcd\x13\x05\x62\x13"
+			  "\x63\x30\x69\x37\x33\xe9\x35\x93"
+			  "\x9d\x08\xe5\xac\x55\xf4\xe6\xa4"
+			  "\xd1\x83\x92\x12\xb8\x93\x52\xb1"
+			  "\x58\xb4\x2c\xc6\xc0\x15\x1d\x3f"
+			  "\x0c\x22\xa7\xd0\x94\x07\x24\xe5"
+			  "\x60\xd9\x69\x00\x02\x6b\x12\xb9"
+			  "\xbe\x66\xda\xf9\x8c\x52\x76\x9a"
+			  "\xd8\xfe\xcb\xc1\xda\xf5\x63\xfe"
+			  "\xce\x93\x87\xe6\x06\x51\xca\x69"
+			  "\xe4\x7c\xb8\x19\xc4\x89\xa8\x32"
+			  "\xf9\xcb\x3c\x45\x25\x30\x3e\x47"
+			  "\x7a\xfd\x72\xad\x0c\x4d\x04\x94"
+			  "\x16\x31\x5a\xd3\x0e\x0f\x83\x56"
+			  "\xd4\x46\x25\x27\x55\x54\x11\x63"
+			  "\xfc\xa8\x38\xa2\x04\x31\x4d\x07"
+			  "\xb2\x95\x09\x9f\xa6\x47\xff\xed",
+		.ilen	= 512,
+		.result	= "\xfd\x0d\x6b\xe9\x19\x16\x6b\x40"
+			  "\x81\xff\x38\x60\xc9\x8f\x15\xbb"
+			  "\xbd\x26\xe2\x74\x70\x2d\xb5\xc6"
+			  "\xd9\xdc\xce\x55\xcd\x5c\x17\x12"
+			  "\x90\x41\xc1\x68\x7b\x3a\x00\xd2"
+			  "\xa5\xf1\x97\xfe\x19\xfb\x46\xb3"
+			  "\x3b\xfa\xf7\x52\x2a\xbe\xa9\xd2"
+			  "\x5d\x67\x56\x7b\x28\x8d\x05\x62"
+			  "\x32\x42\x26\xac\x58\xf7\xb1\x05"
+			  "\x29\xc4\xe6\x33\x47\xdc\xb2\x3e"
+			  "\x5b\xb1\x7e\x3b\xbe\xb9\xfb\x20"
+			  "\xb5\xfe\x21\x50\x36\x40\xe4\x11"
+			  "\x5c\x12\x76\xcd\x1b\x0a\x61\xa7"
+			  "\x52\x1e\x3d\x58\x5b\x8f\x05\xc0"
+			  "\x59\x55\x57\xd0\x97\xb8\x00\x77"
+			  "\x3d\x33\x78\x4b\xc1\xbe\xb0\x12"
+			  "\xcc\x8a\xed\xce\x63\x60\x0f\x08"
+			  "\x83\xa4\x35\x93\xc8\x8d\xab\x54"
+			  "\x91\xbb\xc9\x5a\xb6\x19\xcd\xa2"
+			  "\x5d\x18\x6e\xbf\xc3\x76\x62\xd6"
+			  "\xa0\x10\xb7\x67\x4f\xb1\x06\x39"
+			  "\xeb\xed\x04\x2f\x50\x0f\x60\x7b"
+			  "\xd0\xcd\xd7\x8b\x77\xd1\x71\x30"
+			  "\x53\x0d\xa9\x8c\xd9\xd2\x50\xe7"
+			  "\xca\x66\x22\x26\xde\xb4\x26\x47"
+			  "\x60\x4f\xaf\xf6\xb5\x39\x8b\x4d"
+			  "\x33\x53\xf5\x95\x8f\x04\xcd\x69"
+			  "\xdb\x7f\x8b\x32\x85\x6e\x86\xf8"
+			  "\xed\xf5\x40\xce\x9c\x33\x8b\x21"
+			  "\x5a\x48\xfe\xe0\x1c\x7a\x63\xaf"
+			  "\x5a\xf4\x68\x2c\xb3\x0c\x6b\x85"
+			  "\x02\x6e\x0a\xad\xa9\x60\xf2\x61"
+			  "\xd1\x70\x75\x3d\xd1\xef\xbb\x43"
+			  "\x54\x40\x02\x87\xdf\x67\xb0\xee"
+			  "\x35\xda\x68\x90\xca\x15\x78\xd1"
+			  "\x9d\x9f\x00\xac\x01\xaf\x84\x5a"
+			  "\xdb\x77\xd3\x6c\x50\x7f\x36\x32"
+			  "\xbe\xcf\xb5\xf5\xdc\x82\x13\xe9"
+			  "\x0a\xe3\x4e\xaa\x8f\x7b\x38\xd6"
+			  "\x1b\xa6\xb1\x2c\x32\xdc\xa5\x38"
+			  "\xea\xd4\xa1\x38\xa7\x04\x9d\xa5"
+			  "\xbc\xbb\x40\x53\x6e\xa5\x44\x00"
+			  "\x77\xc1\x24\xc2\x5f\xf7\x53\x15"
+			  "\x10\x15\x79\x90\x9d\xa4\x7a\xc7"
+			  "\xbb\x51\x59\x07\x50\xf4\x54\x9a"
+			  "\xbd\x79\xd9\x43\x01\xa0\xa3\xa4"
+			  "\x15\x03\x2f\x62\x42\x1c\x22\x0d"
+			  "\xcc\x0f\x35\x45\xee\x4f\x87\x1a"
+			  "\xe6\x11\x00\x61\x9c\xd3\x10\xbb"
+			  "\x48\x7d\x47\x74\xe5\x0a\x41\x9e"
+			  "\x9a\x89\x6f\x63\x64\xdc\x85\x29"
+			  "\x7f\xa9\x48\xeb\xf8\x28\x90\x9e"
+			  "\x3b\x4d\x61\x9f\x51\x6c\x66\x3a"
+			  "\x39\x15\xba\x7f\x0f\xc6\xb3\x80"
+			  "\xfc\x25\x98\x0b\x78\xd2\xf7\x98"
+			  "\xce\x64\xd1\xa4\x0d\xae\x35\xaa"
+			  "\x98\x1f\x9f\x36\x41\x1d\x0e\x06"
+			  "\xd1\x39\xcf\x43\x81\x17\xee\xb0"
+			  "\x1b\xe7\xc0\xe2\x61\x20\xd4\x21"
+			  "\xaa\x1e\x8d\xd1\x84\x37\x9c\x90"
+			  "\xe2\x8d\xe0\x22\x69\xb0\x38\xbb"
+			  "\xf9\x8b\x11\xbe\xb4\x05\xb8\x99"
+			  "\xa3\x8f\x0d\xc6\x13\xb0\xd0\x83"
+			  "\x35\xcd\x91\x2f\xb4\xc6\x42\x10",
+		.rlen	= 512,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 500, 12 },
+	},
+};
+
+static const struct cipher_testvec adiantum_xchacha20_aes_enc_tv_template[] = {
+	{
+		.key	= "\xc4\xc9\x04\x44\x19\x37\x03\x0d"
+			  "\xdc\x6b\x87\x85\x83\xec\xc0\x51"
+			  "\xba\xf1\x97\x3c\x36\x13\xd0\x87"
+			  "\x01\xe0\x9d\x61\xe6\xfe\xe8\x39",
+		.klen	= 32,
+		.iv	= "\x7c\xab\x05\xc9\x64\xbc\xa3\xca"
+			  "\x36\x04\xb6\x13\xc2\xbd\x20\xc7"
+			  "\x85\x8f\x61\x17\x23\x33\x98\x9f"
+			  "\x8b\xfd\xa6\x3a\x0c\xf8\xf0\x4b",
+		.input	= "\x62\xb7\xc1\x40\x62\xf5\x72\x13"
+			  "\xb9\xad\x1b\xd2\xf8\x7b\x0a\x0b",
+		.ilen	= 16,
+		.result	= "\xa7\x2b\xd2\x37\xf6\x19\x05\xf3"
+			  "\xc0\x6b\x45\x25\x7d\x1c\xa3\x4e",
+		.rlen	= 16,
+	}, {
+		.key	= "\x47\x88\x24\x56\xf3\x37\xf1\x5b"
+			  "\x27\x74\x93\x13\xdf\x06\x0d\x75"
+			  "\x37\x91\x9b\x7d\xda\x6c\x7d\x02"
+			  "\x07\x30\x3d\x9f\x7c\xad\x15\x40",
+		.klen	= 32,
+		.iv	= "\x66\xde\x4e\x74\x95\xf0\x8f\x58"
+			  "\x0a\xa5\xc2\x83\x08\x87\x72\x79"
+			  "\x75\x77\x38\x74\xf4\x5f\xb0\x22"
+			  "\x06\x71\xc5\x98\xb9\xef\xf8\x53",
+		.input	= "\x83\x9a\x4f\xba\x74\x0f\xf4\x76"
+			  "\xce\x7b\xae\xbb\x17\x91\xea\x3f"
+			  "\xa5",
+		.ilen	= 17,
+		.result	= "\x8b\xd4\x06\x52\x76\x37\xc9\xbc"
+			  "\x9a\xfb\x7e\x00\x3f\x4d\xfc\x16"
+			  "\x9f",
+		.rlen	= 17,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 8, 9 },
+	}, {
+		.key	= "\x78\xc1\x1e\x10\x4e\xb2\x45\x32"
+			  "\x2f\x0e\xfd\x6f\xf8\x62\x2e\x42"
+			  "\x98\xa8\xc8\x13\x5f\x9c\x8c\x6a"
+			  "\x2a\x3e\x8a\x97\x08\x62\x57\x2b",
+		.klen	= 32,
+		.iv	= "\xf2\x9b\xa3\xef\xf6\x3e\x4a\x73"
+			  "\x2a\x32\xb7\xb8\xbd\xe8\x70\xdb"
+			  "\x9f\x61\xbb\x99\xa8\xbd\x29\xa5"
+			  "\x33\x01\x39\xe6\x5b\xae\x62\xcc",
+		.input	= "\xd4\xd7\x90\xc5\xc2\x41\x25\xe5"
+			  "\x65\x68\x40\x63\x3e\xf8\xa1\x9e"
+			  "\x01\xab\xad\xfd\x9e\xe2\x85\xfe"
+			  "\x7b\x16\x17\x8b\xdc\x16\x79\x34"
+			  "\x1f\x97\x50\xa3\x1b\x16\x02\xa9"
+			  "\x8a\x35\x14\x2d\xac\x76\x45\x86"
+			  "\x91\x7e\xaa\x34\x70\x27\xad\xaf"
+			  "\x30\x68\xfb\x9d\xd1\x3d\x6e\x02"
+			  "\xbb\x22\x55\xcb\x55\x60\x00\x74"
+			  "\x2d\x28\x4b\xb8\x98\x08\xda\x47"
+			  "\x1a\x52\x7b\xcd\x43\x66\xf1\x01"
+			  "\xec\xee\x45\x24\x56\x9e\x39\xde"
+			  "\x18\xd6\x70\x59\x1c\xc0\x53\xdb"
+			  "\xfb\xc1\x23\xc2\xa5\x3a\x8f\x0c"
+			  "\x04\x8e\xb5\x20\xcc\xd3\xa5\x66"
+			  "\x50\x1a\xfc\x9b\x45\x77\x4d\x77",
+		.ilen	= 128,
+		.result	= "\xd5\xca\x2a\x98\x5f\xac\x0f\x4c"
+			  "\x9c\xab\x9e\x49\xae\x33\xc9\xd9"
+			  "\xa3\xe2\x64\xb9\x6a\xa0\x4a\xea"
+			  "\x12\x2d\xe9\x70\x9e\xc0\x05\xa5"
+			  "\x6c\x60\xc5\x54\xd8\xc9\xe8\x90"
+			  "\x37\x31\x65\x77\xf9\x6c\xab\x0a"
+			  "\x03\x77\xc5\x79\x1b\x64\xa7\xfb"
+			  "\xf6\xfc\xda\xa7\xfd\xc1\x32\x2c"
+			  "\x06\x29\xc9\xca\xd4\x0b\x25\x9f"
+			  "\x7f\x25\x82\x01\x6f\x67\xf8\x3a"
+			  "\xc9\x7d\xde\x4b\x3e\x48\x49\xf8"
+			  "\xec\x03\x1e\x9b\xcb\x8b\x5e\x17"
+			  "\x8f\xde\xc6\xd1\x57\x23\x97\xf7"
+			  "\x6e\xe5\x0e\x3a\xfa\x11\x9c\xe0"
+			  "\x5a\x78\xd8\x6d\x35\xac\xaa\xa7"
+			  "\x21\x09\xff\x2d\xe5\x0b\x10\xc0",
+		.rlen	= 128,
+	}, {
+		.key	= "\x55\xf7\xb7\x7d\x9b\x26\x4b\xa6"
+			  "\x55\x9e\x85\xb0\x16\xbd\x7d\xc4"
+			  "\xc6\xee\x05\x7e\xe4\x02\x9a\x18"
+			  "\x6c\xf4\x83\x9e\x92\x4b\x61\x46",
+		.klen	= 32,
+		.iv	= "\x05\xb3\xbc\x75\x3f\x49\x5c\x16"
+			  "\x6b\x1c\xc3\xf9\x0b\x33\xa0\x63"
+			  "\x96\x71\x13\x88\xb0\x85\x05\x6a"
+			  "\xc9\x2b\x4f\x74\xfd\x84\x4a\xa5",
+		.input	= "\x3b\x74\xb3\x52\x7e\xa8\x1b\xce"
+			  "\xa2\x49\xf6\x1b\x5f\x77\x4b\x86"
+			  "\x20\x97\xc4\x2a\xa7\x52\xce\xe5"
+			  "\xb9\x3b\xa1\xd4\xb7\xac\x38\xe3"
+			  "\x31\x88\x1f\x07\x9b\xfe\x61\x4d"
+			  "\x48\xeb\xef\x51\x33\x09\x60\xf4"
+			  "\x59\x20\xc0\xaa\x45\x4d\x7a\x85"
+			  "\x79\x3e\xbb\x2f\xf0\xf5\xa6\xbb"
+			  "\x85\xf7\x97\xda\x6b\x31\x02\xb1"
+			  "\x5e\x23\x9a\x71\xeb\x15\x3f\x40"
+			  "\xc2\xbb\x2c\x16\x32\xaf\x8b\x68"
+			  "\x06\x5c\x35\xe6\x2e\xa1\x5b\x99"
+			  "\xb3\xb0\xee\xfb\x08\xc7\x07\x84"
+			  "\x66\xb5\x87\xe2\x05\xaf\x29\x37"
+			  "\x9d\x6b\x77\x53\x8e\x7f\x5c\xad"
+			  "\x28\xc8\x16\x38\x11\x78\x82\xff"
+			  "\xf5\x84\x8a\xc7\xef\x86\xc2\x3e"
+			  "\x64\x7d\x2e\x08\x34\x7d\x09\xf5"
+			  "\x6a\x3d\xd5\xae\x65\x67\xf4\x9f"
+			  "\xb7\x41\x9d\x72\xa0\x1d\x31\xaf"
+			  "\x41\x14\x5a\xc6\x40\xee\x65\x3e"
+			  "\x85\xd2\x24\x4e\x8a\x52\xa8\x10"
+			  "\xc4\xc6\xa4\x96\x58\x3e\xac\x8d"
+			  "\x80\xb4\x8c\x95\x74\x83\x79\x83"
+			  "\x92\xcf\xb4\x3d\x96\xf5\x8c\xac"
+			  "\x1d\x44\x4d\x04\x79\x34\x1e\xbf"
+			  "\x88\x6f\x33\x87\x1b\x4d\xb9\x49"
+			  "\x3f\xbc\x16\x12\x6c\xaa\x3d\x0f"
+			  "\x98\x7d\x29\x63\xe0\x1e\x6b\xf3"
+			  "\x63\x36\x01\xea\xe1\x05\x38\x27"
+			  "\xa4\x87\x4f\xb3\x5c\x93\xae\xea"
+			  "\x66\xf6\x7f\x29\xa4\x9e\x87\x84"
+			  "\xb6\x1f\x91\x30\xf6\x67\x9b\x2a"
+			  "\x93\x5f\x1f\x90\x75\xc7\x93\xf5"
+			  "\x46\x15\x68\xd3\x89\x32\x5c\x0b"
+			  "\x0f\x3a\xdd\xa0\x96\xe6\x65\xc5"
+			  "\xfa\x1a\x1c\x2f\x13\x4b\x92\xa5"
+			  "\x64\x71\x53\x54\x43\xba\x2c\xe8"
+			  "\xf1\x1c\x92\x90\xd3\x12\x37\x86"
+			  "\xa1\x7b\x3f\xfe\xa2\xdf\x49\x1b"
+			  "\x15\x6a\xd0\x11\xa5\x4b\x20\x79"
+			  "\xec\xd0\x4d\x02\x90\xb6\x9e\x7c"
+			  "\x9e\xcf\xd4\xb2\xc8\x85\x16\x4a"
+			  "\x8b\x98\x99\x14\x09\x35\x1d\x4a"
+			  "\x91\x77\x16\x2b\x90\x8c\x13\x2c"
+			  "\x27\x94\x9c\x48\xd0\xd1\x38\x73"
+			  "\x67\x94\x11\xd1\x87\x11\x62\x8f"
+			  "\xbf\x91\x2a\xb8\x80\x33\x6d\x99"
+			  "\xea\x41\xc8\x41\x87\x7c\xfa\x6b"
+			  "\x6c\x2c\xe2\xab\xe9\xfd\x00\xeb"
+			  "\x9c\x5c\xb3\xa6\xdd\x26\x9b\x50"
+			  "\x86\xac\x62\xd5\xe5\xfe\x25\x22"
+			  "\x9f\x04\x1b\x7e\x3a\xe1\x41\xbf"
+			  "\x96\xe1\x27\x33\x78\x73\x5f\xb3"
+			  "\x2a\xb5\x96\xfc\x17\x73\xbf\xef"
+			  "\x65\xfb\x99\x35\x9f\x83\x70\xbc"
+			  "\x63\x19\xcd\x2d\x77\xf6\xb8\x13"
+			  "\x3e\x65\x04\xee\x37\x35\xca\xa4"
+			  "\x93\x20\x15\xee\x15\x08\xfe\x03"
+			  "\x76\x8a\x7f\x8f\x9f\xf1\xa3\xdc"
+			  "\x4d\x74\xcb\x71\xb3\xcd\x63\xc0"
+			  "\xe4\xd4\x2e\x55\xea\x4b\xa1\x23"
+			  "\x37\x15\xa4\xf4\xca\xa9\x54\x83"
+			  "\x54\x7b\x13\xa2\xb7\x4e\xa8\xba",
+		.ilen	= 512,
+		.result	= "\xae\x56\x32\x2c\x49\x17\x71\x3b"
+			  "\x58\x20\xbc\x20\x6d\x03\x2e\xcf"
+			  "\x5b\x23\xfa\x45\x1e\x46\x3f\xfa"
+			  "\xc1\x17\x0b\x89\xfc\xb0\x93\x6e"
+			  "\x23\x84\x75\x19\x43\x8e\x56\xc6"
+			  "\x91\x31\xce\x03\x4c\x5f\x54\x0c"
+			  "\xbe\x32\x91\x89\x8b\x3d\x1e\x8d"
+			  "\xa7\x14\xfc\xc4\xa8\x0d\x4f\x7b"
+			  "\xfe\xbe\xa7\x4f\xba\xea\x38\x88"
+			  "\xcb\x7c\xb0\xef\x14\xbb\x0b\x94"
+			  "\x80\x34\x82\x6d\x5f\xd0\x2b\xa5"
+			  "\x2f\x01\x6a\xe1\xb8\x45\xb2\xbe"
+			  "\xb9\x65\x16\x22\xa6\x31\xa6\x9b"
+			  "\xd9\xe7\x6b\x8f\x69\x5f\x84\x65"
+			  "\x8c\x88\x64\x85\x60\x93\xf7\x55"
+			  "\x49\xea\x3f\x67\x73\x84\x53\x0d"
+			  "\xcf\x3f\x53\xb3\xc7\x4b\x78\x6c"
+			  "\xcf\x1d\x34\x8b\x81\x17\xce\x30"
+			  "\xca\x99\x43\x79\xbf\x85\x5e\x3b"
+			  "\xe8\x19\xd6\xe5\x35\x0c\x2b\x44"
+			  "\x6f\x56\xea\x65\x1b\xf1\x26\x05"
+			  "\xd9\x8a\xea\xf9\x1b\xf2\x7b\x05"
+			  "\x0d\x72\x17\x70\xad\xf0\x76\x61"
+			  "\x80\xac\xbc\x0b\x57\x8a\xed\x74"
+			  "\x7b\x5f\x3a\x9a\x26\x35\xb3\x36"
+			  "\xa5\x40\x26\xee\xa5\xa0\x74\x00"
+			  "\xce\xe8\xba\xa5\xad\x30\x36\x31"
+			  "\x71\x79\x09\xf7\x7c\xee\xe7\x85"
+			  "\xf2\x82\x49\x04\x38\x24\x89\xc0"
+			  "\x0f\x7c\xd4\xb6\xdf\xf0\x49\x48"
+			  "\x40\x66\x5e\x22\xe1\xee\xe8\x51"
+			  "\x03\xe4\x63\xb7\xf1\x7e\x78\xff"
+			  "\x95\x6c\xd5\x12\x01\x96\x59\x30"
+			  "\x19\xa8\xf1\x32\x2e\xef\x18\xc2"
+			  "\xad\x24\x66\x75\xe4\x03\xb9\xb8"
+			  "\x90\x21\x2a\xb2\x4e\x16\x31\x6e"
+			  "\x88\x7e\x2d\xa6\x3f\x92\x0b\x24"
+			  "\x01\x36\x99\x2f\xfa\x7f\xa1\x1d"
+			  "\xdb\x26\x7f\x13\x30\x63\xc8\x61"
+			  "\x36\xfb\x9d\xbf\x38\xef\x3d\xde"
+			  "\x5d\xdd\x21\x53\x8f\x21\xbf\x44"
+			  "\x23\xa7\xf0\xd7\x34\x13\xd7\x94"
+			  "\xf2\x0c\xb4\x96\x78\x48\x4f\x48"
+			  "\x3d\xef\xfd\x2b\x6c\x58\x2c\x37"
+			  "\x56\x50\x89\x0a\x7b\x64\x3f\xb6"
+			  "\x44\xbc\xf1\xd6\x0a\x61\xde\x14"
+			  "\x46\xb8\x30\xb9\xb4\xba\xb0\x53"
+			  "\xa6\x92\x47\x3f\xd0\x15\x0b\x80"
+			  "\x6b\x6e\x69\x53\xd6\x13\xb0\x74"
+			  "\x97\x23\x31\x91\x3f\x01\xae\x93"
+			  "\xf7\xdc\x05\x53\xb0\xfe\xf4\xa6"
+			  "\xc3\xef\x4c\xd6\x36\x6b\xb2\x30"
+			  "\xf0\x7d\x82\x3f\xe5\x08\xe5\x3b"
+			  "\x4d\x32\x77\xa8\x85\x47\xf9\x0e"
+			  "\x7c\x1e\xca\xed\x49\xa1\x50\x19"
+			  "\x4c\x08\xb9\x0f\x83\x0f\xa7\x2a"
+			  "\x8a\xd8\xce\x2d\x3e\xfe\x04\xf1"
+			  "\x63\x22\xc1\x55\x3e\x14\x10\x8d"
+			  "\xe5\xab\x6a\xfa\x5d\xca\xc4\x5a"
+			  "\x29\x31\x40\x01\xdc\x4d\x2c\x7a"
+			  "\xf3\xc3\x5b\xd5\x5a\x61\x94\x71"
+			  "\x0a\x41\x99\x57\xed\x12\xd5\x45"
+			  "\x5f\x74\x2d\x5a\x59\x27\x8f\x91"
+			  "\x3f\x6d\x21\x1d\xba\x21\xb4\xa5",
+		.rlen	= 512,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 500, 12 },
+	},
+};
+
+static const struct cipher_testvec adiantum_xchacha20_aes_dec_tv_template[] = {
+	{
+		.key	= "\xc4\xc9\x04\x44\x19\x37\x03\x0d"
+			  "\xdc\x6b\x87\x85\x83\xec\xc0\x51"
+			  "\xba\xf1\x97\x3c\x36\x13\xd0\x87"
+			  "\x01\xe0\x9d\x61\xe6\xfe\xe8\x39",
+		.klen	= 32,
+		.iv	= "\x7c\xab\x05\xc9\x64\xbc\xa3\xca"
+			  "\x36\x04\xb6\x13\xc2\xbd\x20\xc7"
+			  "\x85\x8f\x61\x17\x23\x33\x98\x9f"
+			  "\x8b\xfd\xa6\x3a\x0c\xf8\xf0\x4b",
+		.input	= "\xa7\x2b\xd2\x37\xf6\x19\x05\xf3"
+			  "\xc0\x6b\x45\x25\x7d\x1c\xa3\x4e",
+		.ilen	= 16,
+		.result	= "\x62\xb7\xc1\x40\x62\xf5\x72\x13"
+			  "\xb9\xad\x1b\xd2\xf8\x7b\x0a\x0b",
+		.rlen	= 16,
+	}, {
+		.key	= "\x47\x88\x24\x56\xf3\x37\xf1\x5b"
+			  "\x27\x74\x93\x13\xdf\x06\x0d\x75"
+			  "\x37\x91\x9b\x7d\xda\x6c\x7d\x02"
+			  "\x07\x30\x3d\x9f\x7c\xad\x15\x40",
+		.klen	= 32,
+		.iv	= "\x66\xde\x4e\x74\x95\xf0\x8f\x58"
+			  "\x0a\xa5\xc2\x83\x08\x87\x72\x79"
+			  "\x75\x77\x38\x74\xf4\x5f\xb0\x22"
+			  "\x06\x71\xc5\x98\xb9\xef\xf8\x53",
+		.input	= "\x8b\xd4\x06\x52\x76\x37\xc9\xbc"
+			  "\x9a\xfb\x7e\x00\x3f\x4d\xfc\x16"
+			  "\x9f",
+		.ilen	= 17,
+		.result	= "\x83\x9a\x4f\xba\x74\x0f\xf4\x76"
+			  "\xce\x7b\xae\xbb\x17\x91\xea\x3f"
+			  "\xa5",
+		.rlen	= 17,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 8, 9 },
+	}, {
+		.key	= "\x78\xc1\x1e\x10\x4e\xb2\x45\x32"
+			  "\x2f\x0e\xfd\x6f\xf8\x62\x2e\x42"
+			  "\x98\xa8\xc8\x13\x5f\x9c\x8c\x6a"
+			  "\x2a\x3e\x8a\x97\x08\x62\x57\x2b",
+		.klen	= 32,
+		.iv	= "\xf2\x9b\xa3\xef\xf6\x3e\x4a\x73"
+			  "\x2a\x32\xb7\xb8\xbd\xe8\x70\xdb"
+			  "\x9f\x61\xbb\x99\xa8\xbd\x29\xa5"
+			  "\x33\x01\x39\xe6\x5b\xae\x62\xcc",
+		.input	= "\xd5\xca\x2a\x98\x5f\xac\x0f\x4c"
+			  "\x9c\xab\x9e\x49\xae\x33\xc9\xd9"
+			  "\xa3\xe2\x64\xb9\x6a\xa0\x4a\xea"
+			  "\x12\x2d\xe9\x70\x9e\xc0\x05\xa5"
+			  "\x6c\x60\xc5\x54\xd8\xc9\xe8\x90"
+			  "\x37\x31\x65\x77\xf9\x6c\xab\x0a"
+			  "\x03\x77\xc5\x79\x1b\x64\xa7\xfb"
+			  "\xf6\xfc\xda\xa7\xfd\xc1\x32\x2c"
+			  "\x06\x29\xc9\xca\xd4\x0b\x25\x9f"
+			  "\x7f\x25\x82\x01\x6f\x67\xf8\x3a"
+			  "\xc9\x7d\xde\x4b\x3e\x48\x49\xf8"
+			  "\xec\x03\x1e\x9b\xcb\x8b\x5e\x17"
+			  "\x8f\xde\xc6\xd1\x57\x23\x97\xf7"
+			  "\x6e\xe5\x0e\x3a\xfa\x11\x9c\xe0"
+			  "\x5a\x78\xd8\x6d\x35\xac\xaa\xa7"
+			  "\x21\x09\xff\x2d\xe5\x0b\x10\xc0",
+		.ilen	= 128,
+		.result	= "\xd4\xd7\x90\xc5\xc2\x41\x25\xe5"
+			  "\x65\x68\x40\x63\x3e\xf8\xa1\x9e"
+			  "\x01\xab\xad\xfd\x9e\xe2\x85\xfe"
+			  "\x7b\x16\x17\x8b\xdc\x16\x79\x34"
+			  "\x1f\x97\x50\xa3\x1b\x16\x02\xa9"
+			  "\x8a\x35\x14\x2d\xac\x76\x45\x86"
+			  "\x91\x7e\xaa\x34\x70\x27\xad\xaf"
+			  "\x30\x68\xfb\x9d\xd1\x3d\x6e\x02"
+			  "\xbb\x22\x55\xcb\x55\x60\x00\x74"
+			  "\x2d\x28\x4b\xb8\x98\x08\xda\x47"
+			  "\x1a\x52\x7b\xcd\x43\x66\xf1\x01"
+			  "\xec\xee\x45\x24\x56\x9e\x39\xde"
+			  "\x18\xd6\x70\x59\x1c\xc0\x53\xdb"
+			  "\xfb\xc1\x23\xc2\xa5\x3a\x8f\x0c"
+			  "\x04\x8e\xb5\x20\xcc\xd3\xa5\x66"
+			  "\x50\x1a\xfc\x9b\x45\x77\x4d\x77",
+		.rlen	= 128,
+	}, {
+		.key	= "\x55\xf7\xb7\x7d\x9b\x26\x4b\xa6"
+			  "\x55\x9e\x85\xb0\x16\xbd\x7d\xc4"
+			  "\xc6\xee\x05\x7e\xe4\x02\x9a\x18"
+			  "\x6c\xf4\x83\x9e\x92\x4b\x61\x46",
+		.klen	= 32,
+		.iv	= "\x05\xb3\xbc\x75\x3f\x49\x5c\x16"
+			  "\x6b\x1c\xc3\xf9\x0b\x33\xa0\x63"
+			  "\x96\x71\x13\x88\xb0\x85\x05\x6a"
+			  "\xc9\x2b\x4f\x74\xfd\x84\x4a\xa5",
+		.input	= "\xae\x56\x32\x2c\x49\x17\x71\x3b"
+			  "\x58\x20\xbc\x20\x6d\x03\x2e\xcf"
+			  "\x5b\x23\xfa\x45\x1e\x46\x3f\xfa"
+			  "\xc1\x17\x0b\x89\xfc\xb0\x93\x6e"
+			  "\x23\x84\x75\x19\x43\x8e\x56\xc6"
+			  "\x91\x31\xce\x03\x4c\x5f\x54\x0c"
+			  "\xbe\x32\x91\x89\x8b\x3d\x1e\x8d"
+			  "\xa7\x14\xfc\xc4\xa8\x0d\x4f\x7b"
+			  "\xfe\xbe\xa7\x4f\xba\xea\x38\x88"
+			  "\xcb\x7c\xb0\xef\x14\xbb\x0b\x94"
+			  "\x80\x34\x82\x6d\x5f\xd0\x2b\xa5"
+			  "\x2f\x01\x6a\xe1\xb8\x45\xb2\xbe"
+			  "\xb9\x65\x16\x22\xa6\x31\xa6\x9b"
+			  "\xd9\xe7\x6b\x8f\x69\x5f\x84\x65"
+			  "\x8c\x88\x64\x85\x60\x93\xf7\x55"
+			  "\x49\xea\x3f\x67\x73\x84\x53\x0d"
+			  "\xcf\x3f\x53\xb3\xc7\x4b\x78\x6c"
+			  "\xcf\x1d\x34\x8b\x81\x17\xce\x30"
+			  "\xca\x99\x43\x79\xbf\x85\x5e\x3b"
+			  "\xe8\x19\xd6\xe5\x35\x0c\x2b\x44"
+			  "\x6f\x56\xea\x65\x1b\xf1\x26\x05"
+			  "\xd9\x8a\xea\xf9\x1b\xf2\x7b\x05"
+			  "\x0d\x72\x17\x70\xad\xf0\x76\x61"
+			  "\x80\xac\xbc\x0b\x57\x8a\xed\x74"
+			  "\x7b\x5f\x3a\x9a\x26\x35\xb3\x36"
+			  "\xa5\x40\x26\xee\xa5\xa0\x74\x00"
+			  "\xce\xe8\xba\xa5\xad\x30\x36\x31"
+			  "\x71\x79\x09\xf7\x7c\xee\xe7\x85"
+			  "\xf2\x82\x49\x04\x38\x24\x89\xc0"
+			  "\x0f\x7c\xd4\xb6\xdf\xf0\x49\x48"
+			  "\x40\x66\x5e\x22\xe1\xee\xe8\x51"
+			  "\x03\xe4\x63\xb7\xf1\x7e\x78\xff"
+			  "\x95\x6c\xd5\x12\x01\x96\x59\x30"
+			  "\x19\xa8\xf1\x32\x2e\xef\x18\xc2"
+			  "\xad\x24\x66\x75\xe4\x03\xb9\xb8"
+			  "\x90\x21\x2a\xb2\x4e\x16\x31\x6e"
+			  "\x88\x7e\x2d\xa6\x3f\x92\x0b\x24"
+			  "\x01\x36\x99\x2f\xfa\x7f\xa1\x1d"
+			  "\xdb\x26\x7f\x13\x30\x63\xc8\x61"
+			  "\x36\xfb\x9d\xbf\x38\xef\x3d\xde"
+			  "\x5d\xdd\x21\x53\x8f\x21\xbf\x44"
+			  "\x23\xa7\xf0\xd7\x34\x13\xd7\x94"
+			  "\xf2\x0c\xb4\x96\x78\x48\x4f\x48"
+			  "\x3d\xef\xfd\x2b\x6c\x58\x2c\x37"
+			  "\x56\x50\x89\x0a\x7b\x64\x3f\xb6"
+			  "\x44\xbc\xf1\xd6\x0a\x61\xde\x14"
+			  "\x46\xb8\x30\xb9\xb4\xba\xb0\x53"
+			  "\xa6\x92\x47\x3f\xd0\x15\x0b\x80"
+			  "\x6b\x6e\x69\x53\xd6\x13\xb0\x74"
+			  "\x97\x23\x31\x91\x3f\x01\xae\x93"
+			  "\xf7\xdc\x05\x53\xb0\xfe\xf4\xa6"
+			  "\xc3\xef\x4c\xd6\x36\x6b\xb2\x30"
+			  "\xf0\x7d\x82\x3f\xe5\x08\xe5\x3b"
+			  "\x4d\x32\x77\xa8\x85\x47\xf9\x0e"
+			  "\x7c\x1e\xca\xed\x49\xa1\x50\x19"
+			  "\x4c\x08\xb9\x0f\x83\x0f\xa7\x2a"
+			  "\x8a\xd8\xce\x2d\x3e\xfe\x04\xf1"
+			  "\x63\x22\xc1\x55\x3e\x14\x10\x8d"
+			  "\xe5\xab\x6a\xfa\x5d\xca\xc4\x5a"
+			  "\x29\x31\x40\x01\xdc\x4d\x2c\x7a"
+			  "\xf3\xc3\x5b\xd5\x5a\x61\x94\x71"
+			  "\x0a\x41\x99\x57\xed\x12\xd5\x45"
+			  "\x5f\x74\x2d\x5a\x59\x27\x8f\x91"
+			  "\x3f\x6d\x21\x1d\xba\x21\xb4\xa5",
+		.ilen	= 512,
+		.result	= "\x3b\x74\xb3\x52\x7e\xa8\x1b\xce"
+			  "\xa2\x49\xf6\x1b\x5f\x77\x4b\x86"
+			  "\x20\x97\xc4\x2a\xa7\x52\xce\xe5"
+			  "\xb9\x3b\xa1\xd4\xb7\xac\x38\xe3"
+			  "\x31\x88\x1f\x07\x9b\xfe\x61\x4d"
+			  "\x48\xeb\xef\x51\x33\x09\x60\xf4"
+			  "\x59\x20\xc0\xaa\x45\x4d\x7a\x85"
+			  "\x79\x3e\xbb\x2f\xf0\xf5\xa6\xbb"
+			  "\x85\xf7\x97\xda\x6b\x31\x02\xb1"
+			  "\x5e\x23\x9a\x71\xeb\x15\x3f\x40"
+			  "\xc2\xbb\x2c\x16\x32\xaf\x8b\x68"
+			  "\x06\x5c\x35\xe6\x2e\xa1\x5b\x99"
+			  "\xb3\xb0\xee\xfb\x08\xc7\x07\x84"
+			  "\x66\xb5\x87\xe2\x05\xaf\x29\x37"
+			  "\x9d\x6b\x77\x53\x8e\x7f\x5c\xad"
+			  "\x28\xc8\x16\x38\x11\x78\x82\xff"
+			  "\xf5\x84\x8a\xc7\xef\x86\xc2\x3e"
+			  "\x64\x7d\x2e\x08\x34\x7d\x09\xf5"
+			  "\x6a\x3d\xd5\xae\x65\x67\xf4\x9f"
+			  "\xb7\x41\x9d\x72\xa0\x1d\x31\xaf"
+			  "\x41\x14\x5a\xc6\x40\xee\x65\x3e"
+			  "\x85\xd2\x24\x4e\x8a\x52\xa8\x10"
+			  "\xc4\xc6\xa4\x96\x58\x3e\xac\x8d"
+			  "\x80\xb4\x8c\x95\x74\x83\x79\x83"
+			  "\x92\xcf\xb4\x3d\x96\xf5\x8c\xac"
+			  "\x1d\x44\x4d\x04\x79\x34\x1e\xbf"
+			  "\x88\x6f\x33\x87\x1b\x4d\xb9\x49"
+			  "\x3f\xbc\x16\x12\x6c\xaa\x3d\x0f"
+			  "\x98\x7d\x29\x63\xe0\x1e\x6b\xf3"
+			  "\x63\x36\x01\xea\xe1\x05\x38\x27"
+			  "\xa4\x87\x4f\xb3\x5c\x93\xae\xea"
+			  "\x66\xf6\x7f\x29\xa4\x9e\x87\x84"
+			  "\xb6\x1f\x91\x30\xf6\x67\x9b\x2a"
+			  "\x93\x5f\x1f\x90\x75\xc7\x93\xf5"
+			  "\x46\x15\x68\xd3\x89\x32\x5c\x0b"
+			  "\x0f\x3a\xdd\xa0\x96\xe6\x65\xc5"
+			  "\xfa\x1a\x1c\x2f\x13\x4b\x92\xa5"
+			  "\x64\x71\x53\x54\x43\xba\x2c\xe8"
+			  "\xf1\x1c\x92\x90\xd3\x12\x37\x86"
+			  "\xa1\x7b\x3f\xfe\xa2\xdf\x49\x1b"
+			  "\x15\x6a\xd0\x11\xa5\x4b\x20\x79"
+			  "\xec\xd0\x4d\x02\x90\xb6\x9e\x7c"
+			  "\x9e\xcf\xd4\xb2\xc8\x85\x16\x4a"
+			  "\x8b\x98\x99\x14\x09\x35\x1d\x4a"
+			  "\x91\x77\x16\x2b\x90\x8c\x13\x2c"
+			  "\x27\x94\x9c\x48\xd0\xd1\x38\x73"
+			  "\x67\x94\x11\xd1\x87\x11\x62\x8f"
+			  "\xbf\x91\x2a\xb8\x80\x33\x6d\x99"
+			  "\xea\x41\xc8\x41\x87\x7c\xfa\x6b"
+			  "\x6c\x2c\xe2\xab\xe9\xfd\x00\xeb"
+			  "\x9c\x5c\xb3\xa6\xdd\x26\x9b\x50"
+			  "\x86\xac\x62\xd5\xe5\xfe\x25\x22"
+			  "\x9f\x04\x1b\x7e\x3a\xe1\x41\xbf"
+			  "\x96\xe1\x27\x33\x78\x73\x5f\xb3"
+			  "\x2a\xb5\x96\xfc\x17\x73\xbf\xef"
+			  "\x65\xfb\x99\x35\x9f\x83\x70\xbc"
+			  "\x63\x19\xcd\x2d\x77\xf6\xb8\x13"
+			  "\x3e\x65\x04\xee\x37\x35\xca\xa4"
+			  "\x93\x20\x15\xee\x15\x08\xfe\x03"
+			  "\x76\x8a\x7f\x8f\x9f\xf1\xa3\xdc"
+			  "\x4d\x74\xcb\x71\xb3\xcd\x63\xc0"
+			  "\xe4\xd4\x2e\x55\xea\x4b\xa1\x23"
+			  "\x37\x15\xa4\xf4\xca\xa9\x54\x83"
+			  "\x54\x7b\x13\xa2\xb7\x4e\xa8\xba",
+		.rlen	= 512,
+		.also_non_np = 1,
+		.np	= 2,
+		.tap	= { 500, 12 },
+	},
+};
+
 /*
  * CTS (Cipher Text Stealing) mode tests
  */
@@ -64,6 +64,9 @@ struct driver_private {
  *	binding of drivers which were unable to get all the resources needed by
  *	the device; typically because it depends on another driver getting
  *	probed first.
+ * @deferred_supplier - devicetree node of the supplier a deferred device is
+ *	known to be waiting for, so that it is only retried once that
+ *	supplier gets bound.
  * @device - pointer back to the struct device that this structure is
  * associated with.
  *
@@ -75,6 +78,7 @@ struct device_private {
 	struct klist_node knode_driver;
 	struct klist_node knode_bus;
 	struct list_head deferred_probe;
+	struct device_node *deferred_supplier;
 	struct device *device;
 };
 #define to_device_private_parent(obj)	\
@@ -17,6 +17,7 @@
  * This file is released under the GPLv2
  */
 
+#include <linux/debugfs.h>
 #include <linux/device.h>
 #include <linux/delay.h>
 #include <linux/dma-mapping.h>
@@ -25,8 +26,11 @@
 #include <linux/kthread.h>
 #include <linux/wait.h>
 #include <linux/async.h>
+#include <linux/of.h>
 #include <linux/pm_runtime.h>
 #include <linux/pinctrl/devinfo.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
 
 #include "base.h"
 #include "power/power.h"
@@ -47,6 +51,13 @@
  * from the pending to the active list so that the workqueue will eventually
  * retry them.
  *
+ * When the device has a devicetree node, the first supplier it references
+ * that has a device created but no driver bound yet is recorded when the
+ * device defers.  Until the end of initcalls, a successful probe then only
+ * moves the devices waiting for that particular supplier (plus those with
+ * no known supplier, once deferred probing is enabled) to the active list,
+ * instead of retrying every pending device on each bind.
+ *
  * The deferred_probe_mutex must be held any time the deferred_probe_*_list
  * of the (struct device*)->p->deferred_probe pointers are manipulated
  */
@@ -141,24 +152,52 @@ static void deferred_probe_work_func(struct work_struct *work)
 }
 static DECLARE_WORK(deferred_probe_work, deferred_probe_work_func);
 
+static int deferred_probe_unbound_supplier(struct device_node *sup,
+					   void *data)
+{
+	struct device_node **supplier = data;
+
+	if (!of_node_check_flag(sup, OF_POPULATED) ||
+	    of_node_check_flag(sup, OF_DRIVER_BOUND))
+		return 0;
+
+	*supplier = of_node_get(sup);
+	return 1;
+}
+
 static void driver_deferred_probe_add(struct device *dev)
 {
+	struct device_node *supplier = NULL;
+
+	if (dev->of_node)
+		of_for_each_supplier(dev->of_node,
+				     deferred_probe_unbound_supplier, &supplier);
+
 	mutex_lock(&deferred_probe_mutex);
 	if (list_empty(&dev->p->deferred_probe)) {
 		dev_dbg(dev, "Added to deferred list\n");
 		list_add_tail(&dev->p->deferred_probe, &deferred_probe_pending_list);
 	}
+	swap(dev->p->deferred_supplier, supplier);
 	mutex_unlock(&deferred_probe_mutex);
+
+	of_node_put(supplier);
 }
 
 void driver_deferred_probe_del(struct device *dev)
 {
+	struct device_node *supplier;
+
 	mutex_lock(&deferred_probe_mutex);
 	if (!list_empty(&dev->p->deferred_probe)) {
 		dev_dbg(dev, "Removed from deferred list\n");
 		list_del_init(&dev->p->deferred_probe);
 	}
+	supplier = dev->p->deferred_supplier;
+	dev->p->deferred_supplier = NULL;
 	mutex_unlock(&deferred_probe_mutex);
+
+	of_node_put(supplier);
 }
 
 static bool driver_deferred_probe_enable = false;
@@ -203,6 +242,47 @@ static void driver_deferred_probe_trigger(void)
 	schedule_work(&deferred_probe_work);
 }
 
+static bool driver_deferred_probe_ready(struct device_private *p)
+{
+	if (!p->deferred_supplier)
+		return driver_deferred_probe_enable;
+
+	return of_node_check_flag(p->deferred_supplier, OF_DRIVER_BOUND);
+}
+
+/**
+ * driver_deferred_probe_trigger_ready() - Re-probe devices whose supplier bound
+ *
+ * Called when a driver got bound to a device.  Until the end of initcalls,
+ * only the pending devices that were waiting for a supplier that is now
+ * bound, or whose supplier is not known, are moved to the active list.
+ * Afterwards, this falls back to driver_deferred_probe_trigger().
+ */
+static void driver_deferred_probe_trigger_ready(void)
+{
+	struct device_private *p, *n;
+	bool kick = false;
+
+	if (initcalls_done) {
+		driver_deferred_probe_trigger();
+		return;
+	}
+
+	mutex_lock(&deferred_probe_mutex);
+	atomic_inc(&deferred_trigger_count);
+	list_for_each_entry_safe(p, n, &deferred_probe_pending_list,
+				 deferred_probe) {
+		if (!driver_deferred_probe_ready(p))
+			continue;
+		list_move_tail(&p->deferred_probe, &deferred_probe_active_list);
+		kick = true;
+	}
+	mutex_unlock(&deferred_probe_mutex);
+
+	if (kick)
+		schedule_work(&deferred_probe_work);
+}
+
 /**
  * device_block_probing() - Block/defere device's probes
  *
@@ -227,15 +307,208 @@ void device_unblock_probing(void)
 	driver_deferred_probe_trigger();
 }
 
+#ifdef CONFIG_DEBUG_FS
+/*
+ * The last probe attempt made for each device while the system boots is
+ * recorded, so that slow drivers and long deferral chains can be spotted
+ * from /sys/kernel/debug/device_probe_times.  A device keeps a single
+ * record, updated on every attempt and dropped when its driver unbinds.
+ */
+struct probe_time {
+	struct list_head list;
+	struct device *dev;
+	const char *dev_name;
+	const char *drv_name;
+	s64 usecs;
+	unsigned int attempts;
+	int ret;
+};
+
+static LIST_HEAD(probe_times);
+static DEFINE_MUTEX(probe_times_mutex);
+
+static struct probe_time *probe_time_find(struct device *dev)
+{
+	struct probe_time *t;
+
+	list_for_each_entry(t, &probe_times, list)
+		if (t->dev == dev)
+			return t;
+
+	return NULL;
+}
+
+static void probe_time_free(struct probe_time *t)
+{
+	kfree(t->dev_name);
+	kfree_const(t->drv_name);
+	kfree(t);
+}
+
+static void probe_time_record(struct device *dev, struct device_driver *drv,
+			      ktime_t calltime, int ret)
+{
+	struct probe_time *t;
+	const char *drv_name;
+	s64 usecs = ktime_us_delta(ktime_get(), calltime);
+
+	if (system_state >= SYSTEM_RUNNING)
+		return;
+
+	mutex_lock(&probe_times_mutex);
+
+	t = probe_time_find(dev);
+	if (t) {
+		/* A deferred device is usually retried by the same driver. */
+		if (strcmp(t->drv_name, drv->name)) {
+			drv_name = kstrdup_const(drv->name, GFP_KERNEL);
+			if (drv_name) {
+				kfree_const(t->drv_name);
+				t->drv_name = drv_name;
+			}
+		}
+		goto update;
+	}
+
+	t = kzalloc(sizeof(*t), GFP_KERNEL);
+	if (!t)
+		goto out;
+	t->dev_name = kstrdup(dev_name(dev), GFP_KERNEL);
+	t->drv_name = kstrdup_const(drv->name, GFP_KERNEL);
+	if (!t->dev_name || !t->drv_name) {
+		probe_time_free(t);
+		goto out;
+	}
+	t->dev = dev;
+	list_add_tail(&t->list, &probe_times);
+
+update:
+	t->usecs = usecs;
+	t->ret = ret;
+	t->attempts++;
+out:
+	mutex_unlock(&probe_times_mutex);
+}
+
+static void probe_time_release(struct device *dev)
+{
+	struct probe_time *t;
+
+	mutex_lock(&probe_times_mutex);
+
+	t = probe_time_find(dev);
+	if (t) {
+		list_del(&t->list);
+		probe_time_free(t);
+	}
+
+	mutex_unlock(&probe_times_mutex);
+}
+
+/*
+ * deferred_devs_show() - Show the devices in the deferred probe pending list,
+ * along with the supplier each of them is waiting for, when known.
+ */
+static int deferred_devs_show(struct seq_file *s, void *data)
+{
+	struct device_private *curr;
+
+	mutex_lock(&deferred_probe_mutex);
+
+	list_for_each_entry(curr, &deferred_probe_pending_list, deferred_probe) {
+		if (curr->deferred_supplier)
+			seq_printf(s, "%s\t%pOF\n", dev_name(curr->device),
+				   curr->deferred_supplier);
+		else
+			seq_printf(s, "%s\n", dev_name(curr->device));
+	}
+
+	mutex_unlock(&deferred_probe_mutex);
+
+	return 0;
+}
+
+static int deferred_devs_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, deferred_devs_show, inode->i_private);
+}
+
+static const struct file_operations deferred_devs_fops = {
+	.owner		= THIS_MODULE,
+	.open		= deferred_devs_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+/*
+ * probe_times_show() - Show the duration in microseconds and the result of
+ * the last probe attempt made during boot for each device, along with the
+ * number of attempts, in the order the devices were first probed.
+ */
+static int probe_times_show(struct seq_file *s, void *data)
+{
+	struct probe_time *t;
+
+	mutex_lock(&probe_times_mutex);
+
+	list_for_each_entry(t, &probe_times, list)
+		seq_printf(s, "%10lld %5d %4u %s %s\n", t->usecs, t->ret,
+			   t->attempts, t->drv_name, t->dev_name);
+
+	mutex_unlock(&probe_times_mutex);
+
+	return 0;
+}
+
+static int probe_times_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, probe_times_show, inode->i_private);
+}
+
+static const struct file_operations probe_times_fops = {
+	.owner		= THIS_MODULE,
+	.open		= probe_times_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static void probe_debugfs_init(void)
+{
+	debugfs_create_file("devices_deferred", 0444, NULL, NULL,
+			    &deferred_devs_fops);
+	debugfs_create_file("device_probe_times", 0444, NULL, NULL,
+			    &probe_times_fops);
+}
+#else
+static inline void probe_time_record(struct device *dev,
+				     struct device_driver *drv,
+				     ktime_t calltime, int ret)
+{
+}
+
+static inline void probe_time_release(struct device *dev)
+{
+}
+
+static inline void probe_debugfs_init(void)
+{
+}
+#endif
+
 /**
  * deferred_probe_initcall() - Enable probing of deferred devices
  *
  * We don't want to get in the way when the bulk of drivers are getting probed.
  * Instead, this initcall makes sure that deferred probing is delayed until
- * late_initcall time.
+ * late_initcall time.  Devices whose deferral was caused by a known supplier
+ * are retried as soon as that supplier gets bound, though.
  */
 static int deferred_probe_initcall(void)
 {
+	probe_debugfs_init();
+
 	driver_deferred_probe_enable = true;
 	driver_deferred_probe_trigger();
 	/* Sort as many dependencies as possible before exiting initcalls */
@@ -275,12 +548,15 @@ static void driver_bound(struct device *dev)
 
 	device_pm_check_callbacks(dev);
 
+	if (dev->of_node && !dev->of_node_reused)
+		of_node_set_flag(dev->of_node, OF_DRIVER_BOUND);
+
 	/*
 	 * Make sure the device is no longer in one of the deferred lists and
-	 * kick off retrying all pending devices
+	 * kick off retrying the pending devices that were waiting for it
 	 */
 	driver_deferred_probe_del(dev);
-	driver_deferred_probe_trigger();
+	driver_deferred_probe_trigger_ready();
 
 	if (dev->bus)
 		blocking_notifier_call_chain(&dev->bus->p->bus_notifier,
@@ -354,6 +630,7 @@ static int really_probe(struct device *dev, struct device_driver *drv)
 {
 	int ret = -EPROBE_DEFER;
 	int local_trigger_count = atomic_read(&deferred_trigger_count);
+	ktime_t calltime;
 	bool test_remove = IS_ENABLED(CONFIG_DEBUG_TEST_DRIVER_REMOVE) &&
 			   !drv->suppress_bind_attrs;
 
@@ -377,6 +654,7 @@ static int really_probe(struct device *dev, struct device_driver *drv)
 		 drv->bus->name, __func__, drv->name, dev_name(dev));
 	WARN_ON(!list_empty(&dev->devres_head));
 
+	calltime = ktime_get();
 re_probe:
 	dev->driver = drv;
 
@@ -436,6 +714,7 @@ re_probe:
 		dev->pm_domain->sync(dev);
 
 	driver_bound(dev);
+	probe_time_record(dev, drv, calltime, 0);
 	ret = 1;
 	pr_debug("bus: '%s': %s: bound device %s to driver %s\n",
 		 drv->bus->name, __func__, dev_name(dev), drv->name);
@@ -456,6 +735,7 @@ pinctrl_bind_failed:
 	if (dev->pm_domain && dev->pm_domain->dismiss)
 		dev->pm_domain->dismiss(dev);
 	pm_runtime_reinit(dev);
+	probe_time_record(dev, drv, calltime, ret);
 
 	switch (ret) {
 	case -EPROBE_DEFER:
@@ -464,7 +744,7 @@ pinctrl_bind_failed:
 		driver_deferred_probe_add(dev);
 		/* Did a trigger occur while probing? Need to re-trigger if yes */
 		if (local_trigger_count != atomic_read(&deferred_trigger_count))
-			driver_deferred_probe_trigger();
+			driver_deferred_probe_trigger_ready();
 		break;
 	case -ENODEV:
 	case -ENXIO:
@@ -556,6 +836,36 @@ int driver_probe_device(struct device_driver *drv, struct device *dev)
 	return ret;
 }
 
+#define ASYNC_DRV_NAMES_MAX_LEN	256
+static char async_probe_drv_names[ASYNC_DRV_NAMES_MAX_LEN];
+static bool async_probe_default;
+
+/*
+ * "driver_async_probe=" takes a comma separated list of drivers to probe
+ * asynchronously.  "*" selects every driver that does not force synchronous
+ * probing, in which case the drivers listed alongside it are excluded.
+ */
+static int __init save_async_options(char *buf)
+{
+	if (strlen(buf) >= ASYNC_DRV_NAMES_MAX_LEN)
+		pr_warn("Too long list of driver names for 'driver_async_probe'!\n");
+
+	strlcpy(async_probe_drv_names, buf, ASYNC_DRV_NAMES_MAX_LEN);
+	async_probe_default = parse_option_str(async_probe_drv_names, "*");
+
+	return 1;
+}
+__setup("driver_async_probe=", save_async_options);
+
+static bool cmdline_requested_async_probing(const char *drv_name)
+{
+	bool async_drv;
+
+	async_drv = parse_option_str(async_probe_drv_names, drv_name);
+
+	return async_probe_default != async_drv;
+}
+
 bool driver_allows_async_probing(struct device_driver *drv)
 {
 	switch (drv->probe_type) {
@@ -566,6 +876,9 @@ bool driver_allows_async_probing(struct device_driver *drv)
 		return false;
 
 	default:
+		if (cmdline_requested_async_probing(drv->name))
+			return true;
+
 		if (module_requested_async_probing(drv->owner))
 			return true;
 
@@ -856,6 +1169,7 @@ static void __device_release_driver(struct device *dev, struct device *parent)
 		dma_deconfigure(dev);
 
 		devres_release_all(dev);
+		probe_time_release(dev);
 		dev->driver = NULL;
 		dev_set_drvdata(dev, NULL);
 		if (dev->pm_domain && dev->pm_domain->dismiss)
@@ -863,6 +1177,8 @@ static void __device_release_driver(struct device *dev, struct device *parent)
 		pm_runtime_reinit(dev);
 
 		klist_remove(&dev->p->knode_driver);
+		if (dev->of_node && !dev->of_node_reused)
+			of_node_clear_flag(dev->of_node, OF_DRIVER_BOUND);
 		device_pm_check_callbacks(dev);
 		if (dev->bus)
 			blocking_notifier_call_chain(&dev->bus->p->bus_notifier,
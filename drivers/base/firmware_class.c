@@ -27,6 +27,7 @@
 #include <linux/list.h>
 #include <linux/fs.h>
 #include <linux/async.h>
+#include <linux/initrd.h>
 #include <linux/pm.h>
 #include <linux/suspend.h>
 #include <linux/syscore_ops.h>
@@ -392,6 +393,8 @@ fw_get_filesystem_firmware(struct device *device, struct firmware_buf *buf)
 	enum kernel_read_file_id id = READING_FIRMWARE;
 	size_t msize = INT_MAX;
 
+	wait_for_initramfs();
+
 	/* Already populated data member means we're loading into a buffer */
 	if (buf->data) {
 		id = READING_FIRMWARE_PREALLOC_BUFFER;
@@ -32,7 +32,7 @@
 extern u64 efi_system_table;
 
 static struct mm_struct efi_mm = {
-	.mm_rb			= RB_ROOT,
+	.mm_rt			= RANGE_TREE_INIT,
 	.mm_users		= ATOMIC_INIT(2),
 	.mm_count		= ATOMIC_INIT(1),
 	.mmap_sem		= __RWSEM_INITIALIZER(efi_mm.mmap_sem),
@@ -15,6 +15,7 @@
 /****************************************************************************/
 
 #include <linux/clocksource.h>
+#include <linux/dim.h>
 #include <linux/net_tstamp.h>
 #include <linux/pm_qos.h>
 #include <linux/ptp_clock_kernel.h>
@@ -394,6 +395,7 @@ struct bufdesc_ex {
 #define FEC_ITR_EN		(0x1 << 31)
 #define FEC_ITR_ICFT(X)		(((X) & 0xff) << 20)
 #define FEC_ITR_ICTT(X)		((X) & 0xffff)
+#define FEC_ITR_ICFT_MAX	0xff
 #define FEC_ITR_ICFT_DEFAULT	200  /* Set 200 frame count threshold */
 #define FEC_ITR_ICTT_DEFAULT	1000 /* Set 1000us timer threshold */
 
@@ -622,6 +624,13 @@ struct fec_enet_private {
 	unsigned int tx_time_itr;
 	unsigned int itr_clk_rate;
 
+	/* adaptive interrupt coalesce, see lib/dim */
+	bool rx_dim_enabled;
+	bool tx_dim_enabled;
+	u16 dim_events;
+	struct dim rx_dim;
+	struct dim tx_dim;
+
 	/* tx lpi eee mode */
 	struct ethtool_eee eee;
 	unsigned int clk_ref_rate;
@@ -73,7 +73,7 @@
 #include "fec.h"
 
 static void set_multicast_list(struct net_device *ndev);
-static void fec_enet_itr_coal_init(struct net_device *ndev);
+static void fec_enet_itr_coal_set(struct net_device *ndev);
 
 #define DRIVER_NAME	"fec"
 
@@ -1125,8 +1125,9 @@ fec_restart(struct net_device *ndev)
 	else
 		writel(FEC_ENET_MII, fep->hwp + FEC_IMASK);
 
-	/* Init the interrupt coalescing */
-	fec_enet_itr_coal_init(ndev);
+	/* Restore the interrupt coalescing */
+	if (fep->quirks & FEC_QUIRK_HAS_COALESCE)
+		fec_enet_itr_coal_set(ndev);
 
 }
 
@@ -1689,6 +1690,30 @@ fec_enet_interrupt(int irq, void *dev_id)
 	return ret;
 }
 
+/* Feed the adaptive coalescing with the counters of a completed poll */
+static void fec_enet_dim_sample(struct net_device *ndev)
+{
+	struct fec_enet_private *fep = netdev_priv(ndev);
+	struct dim_sample sample;
+
+	if (!fep->rx_dim_enabled && !fep->tx_dim_enabled)
+		return;
+
+	fep->dim_events++;
+
+	if (fep->rx_dim_enabled) {
+		dim_update_sample(fep->dim_events, ndev->stats.rx_packets,
+				  ndev->stats.rx_bytes, &sample);
+		net_dim(&fep->rx_dim, sample);
+	}
+
+	if (fep->tx_dim_enabled) {
+		dim_update_sample(fep->dim_events, ndev->stats.tx_packets,
+				  ndev->stats.tx_bytes, &sample);
+		net_dim(&fep->tx_dim, sample);
+	}
+}
+
 static int fec_enet_rx_napi(struct napi_struct *napi, int budget)
 {
 	struct net_device *ndev = napi->dev;
@@ -1701,6 +1726,7 @@ static int fec_enet_rx_napi(struct napi_struct *napi, int budget)
 
 	if (pkts < budget) {
 		napi_complete_done(napi, pkts);
+		fec_enet_dim_sample(ndev);
 		writel(FEC_DEFAULT_IMASK, fep->hwp + FEC_IMASK);
 	}
 	return pkts;
@@ -2557,6 +2583,55 @@ static void fec_enet_itr_coal_set(struct net_device *ndev)
 	}
 }
 
+/* The ITR timer starts with the first frame, i.e. the CQE based profiles */
+static void fec_enet_rx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct fec_enet_private *fep =
+		container_of(dim, struct fec_enet_private, rx_dim);
+	struct dim_cq_moder moder;
+
+	moder = net_dim_get_rx_moderation(dim->mode, dim->profile_ix);
+	fep->rx_time_itr = moder.usec;
+	fep->rx_pkts_itr = min_t(u16, moder.pkts, FEC_ITR_ICFT_MAX);
+	fec_enet_itr_coal_set(fep->netdev);
+
+	dim->state = DIM_START_MEASURE;
+}
+
+static void fec_enet_tx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct fec_enet_private *fep =
+		container_of(dim, struct fec_enet_private, tx_dim);
+	struct dim_cq_moder moder;
+
+	moder = net_dim_get_tx_moderation(dim->mode, dim->profile_ix);
+	fep->tx_time_itr = moder.usec;
+	fep->tx_pkts_itr = min_t(u16, moder.pkts, FEC_ITR_ICFT_MAX);
+	fec_enet_itr_coal_set(fep->netdev);
+
+	dim->state = DIM_START_MEASURE;
+}
+
+static void fec_enet_dim_init(struct dim *dim, work_func_t func)
+{
+	memset(dim, 0, sizeof(*dim));
+	INIT_WORK(&dim->work, func);
+	dim->mode = DIM_CQ_PERIOD_MODE_START_FROM_CQE;
+	dim->profile_ix = NET_DIM_DEF_PROFILE_CQE;
+}
+
+static void fec_enet_dim_cancel(struct fec_enet_private *fep)
+{
+	cancel_work_sync(&fep->rx_dim.work);
+	cancel_work_sync(&fep->tx_dim.work);
+
+	/* A cancelled profile change would leave the tuning stuck */
+	fep->rx_dim.state = DIM_START_MEASURE;
+	fep->tx_dim.state = DIM_START_MEASURE;
+}
+
 static int
 fec_enet_get_coalesce(struct net_device *ndev, struct ethtool_coalesce *ec)
 {
@@ -2571,6 +2646,9 @@ fec_enet_get_coalesce(struct net_device *ndev, struct ethtool_coalesce *ec)
 	ec->tx_coalesce_usecs = fep->tx_time_itr;
 	ec->tx_max_coalesced_frames = fep->tx_pkts_itr;
 
+	ec->use_adaptive_rx_coalesce = fep->rx_dim_enabled;
+	ec->use_adaptive_tx_coalesce = fep->tx_dim_enabled;
+
 	return 0;
 }
 
@@ -2578,6 +2656,7 @@ static int
 fec_enet_set_coalesce(struct net_device *ndev, struct ethtool_coalesce *ec)
 {
 	struct fec_enet_private *fep = netdev_priv(ndev);
+	struct dim_cq_moder moder;
 	unsigned int cycle;
 
 	if (!(fep->quirks & FEC_QUIRK_HAS_COALESCE))
@@ -2593,40 +2672,68 @@ fec_enet_set_coalesce(struct net_device *ndev, struct ethtool_coalesce *ec)
 		return -EINVAL;
 	}
 
-	cycle = fec_enet_us_to_itr_clock(ndev, fep->rx_time_itr);
+	cycle = fec_enet_us_to_itr_clock(ndev, ec->rx_coalesce_usecs);
 	if (cycle > 0xFFFF) {
 		pr_err("Rx coalesced usec exceed hardware limitation\n");
 		return -EINVAL;
 	}
 
-	cycle = fec_enet_us_to_itr_clock(ndev, fep->tx_time_itr);
+	cycle = fec_enet_us_to_itr_clock(ndev, ec->tx_coalesce_usecs);
 	if (cycle > 0xFFFF) {
-		pr_err("Rx coalesced usec exceed hardware limitation\n");
+		pr_err("Tx coalesced usec exceed hardware limitation\n");
 		return -EINVAL;
 	}
 
-	fep->rx_time_itr = ec->rx_coalesce_usecs;
-	fep->rx_pkts_itr = ec->rx_max_coalesced_frames;
+	/* Stop the adaptive tuning before overwriting its settings */
+	if (netif_running(ndev))
+		napi_disable(&fep->napi);
+	fec_enet_dim_cancel(fep);
+
+	/* The adaptive profiles override the static values */
+	if (ec->use_adaptive_rx_coalesce) {
+		fec_enet_dim_init(&fep->rx_dim, fec_enet_rx_dim_work);
+		moder = net_dim_get_def_rx_moderation(fep->rx_dim.mode);
+		fep->rx_time_itr = moder.usec;
+		fep->rx_pkts_itr = min_t(u16, moder.pkts, FEC_ITR_ICFT_MAX);
+	} else {
+		fep->rx_time_itr = ec->rx_coalesce_usecs;
+		fep->rx_pkts_itr = ec->rx_max_coalesced_frames;
+	}
 
-	fep->tx_time_itr = ec->tx_coalesce_usecs;
-	fep->tx_pkts_itr = ec->tx_max_coalesced_frames;
+	if (ec->use_adaptive_tx_coalesce) {
+		fec_enet_dim_init(&fep->tx_dim, fec_enet_tx_dim_work);
+		moder = net_dim_get_def_tx_moderation(fep->tx_dim.mode);
+		fep->tx_time_itr = moder.usec;
+		fep->tx_pkts_itr = min_t(u16, moder.pkts, FEC_ITR_ICFT_MAX);
+	} else {
+		fep->tx_time_itr = ec->tx_coalesce_usecs;
+		fep->tx_pkts_itr = ec->tx_max_coalesced_frames;
+	}
 
-	fec_enet_itr_coal_set(ndev);
+	fep->rx_dim_enabled = ec->use_adaptive_rx_coalesce;
+	fep->tx_dim_enabled = ec->use_adaptive_tx_coalesce;
+
+	if (netif_running(ndev)) {
+		fec_enet_itr_coal_set(ndev);
+		napi_enable(&fep->napi);
+	}
 
 	return 0;
 }
 
+/* Programmed into the hardware on every fec_restart() */
 static void fec_enet_itr_coal_init(struct net_device *ndev)
 {
-	struct ethtool_coalesce ec;
+	struct fec_enet_private *fep = netdev_priv(ndev);
 
-	ec.rx_coalesce_usecs = FEC_ITR_ICTT_DEFAULT;
-	ec.rx_max_coalesced_frames = FEC_ITR_ICFT_DEFAULT;
+	fep->rx_time_itr = FEC_ITR_ICTT_DEFAULT;
+	fep->rx_pkts_itr = FEC_ITR_ICFT_DEFAULT;
 
-	ec.tx_coalesce_usecs = FEC_ITR_ICTT_DEFAULT;
-	ec.tx_max_coalesced_frames = FEC_ITR_ICFT_DEFAULT;
+	fep->tx_time_itr = FEC_ITR_ICTT_DEFAULT;
+	fep->tx_pkts_itr = FEC_ITR_ICFT_DEFAULT;
 
-	fec_enet_set_coalesce(ndev, &ec);
+	fec_enet_dim_init(&fep->rx_dim, fec_enet_rx_dim_work);
+	fec_enet_dim_init(&fep->tx_dim, fec_enet_tx_dim_work);
 }
 
 static int fec_enet_get_tunable(struct net_device *netdev,
@@ -3135,6 +3242,9 @@ fec_enet_close(struct net_device *ndev)
 		fec_stop(ndev);
 	}
 
+	/* No register access once the clocks are off */
+	fec_enet_dim_cancel(fep);
+
 	phy_disconnect(ndev->phydev);
 	ndev->phydev = NULL;
 
@@ -3455,6 +3565,8 @@ static int fec_enet_init(struct net_device *ndev)
 	writel(FEC_RX_DISABLED_IMASK, fep->hwp + FEC_IMASK);
 	netif_napi_add(ndev, &fep->napi, fec_enet_rx_napi, NAPI_POLL_WEIGHT);
 
+	fec_enet_itr_coal_init(ndev);
+
 	if (fep->quirks & FEC_QUIRK_HAS_VLAN)
 		/* enable hw VLAN support */
 		ndev->features |= NETIF_F_HW_VLAN_CTAG_RX;
@@ -3925,6 +4037,7 @@ static int __maybe_unused fec_suspend(struct device *dev)
 		netif_device_detach(ndev);
 		netif_tx_unlock_bh(ndev);
 		fec_stop(ndev);
+		fec_enet_dim_cancel(fep);
 		if (!(fep->wol_flag & FEC_WOL_FLAG_ENABLE)) {
 			fec_irqs_disable(ndev);
 			pinctrl_pm_select_sleep_state(&fep->pdev->dev);
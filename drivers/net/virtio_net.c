@@ -29,6 +29,7 @@
 #include <linux/slab.h>
 #include <linux/cpu.h>
 #include <linux/average.h>
+#include <linux/dim.h>
 #include <net/route.h>
 
 static int napi_weight = NAPI_POLL_WEIGHT;
@@ -115,6 +116,13 @@ struct receive_queue {
 
 	/* Name of this receive queue: input.$index */
 	char name[40];
+
+	/* Counters sampled by the adaptive coalescing */
+	u64 packets;
+	u64 bytes;
+	u16 calls;
+
+	struct dim dim;
 };
 
 /* Control VQ buffers: protected by the rtnl lock */
@@ -126,6 +134,9 @@ struct control_buf {
 	u8 allmulti;
 	__virtio16 vid;
 	u64 offloads;
+	struct virtio_net_ctrl_coal_tx coal_tx;
+	struct virtio_net_ctrl_coal_rx coal_rx;
+	struct virtio_net_ctrl_coal_vq coal_vq;
 };
 
 struct virtnet_info {
@@ -183,6 +194,13 @@ struct virtnet_info {
 	u32 speed;
 
 	unsigned long guest_offloads;
+
+	/* Notification coalescing, protected by the rtnl lock */
+	u32 tx_usecs;
+	u32 tx_max_packets;
+	u32 rx_usecs;
+	u32 rx_max_packets;
+	bool rx_dim_enabled;
 };
 
 struct padded_vnet_hdr {
@@ -1116,6 +1134,9 @@ static int virtnet_receive(struct receive_queue *rq, int budget)
 	stats->rx_packets += received;
 	u64_stats_update_end(&stats->rx_syncp);
 
+	rq->bytes += bytes;
+	rq->packets += received;
+
 	return received;
 }
 
@@ -1178,10 +1199,34 @@ static void virtnet_poll_cleantx(struct receive_queue *rq)
 		netif_tx_wake_queue(txq);
 }
 
+static void virtnet_rx_dim_update(struct virtnet_info *vi,
+				  struct receive_queue *rq)
+{
+	struct dim_sample sample;
+
+	if (!READ_ONCE(vi->rx_dim_enabled))
+		return;
+
+	dim_update_sample(++rq->calls, rq->packets, rq->bytes, &sample);
+	net_dim(&rq->dim, sample);
+}
+
+static void virtnet_rx_dim_cancel(struct virtnet_info *vi)
+{
+	int i;
+
+	for (i = 0; i < vi->max_queue_pairs; i++) {
+		cancel_work_sync(&vi->rq[i].dim.work);
+		/* Don't leave the tuning waiting for a cancelled update */
+		vi->rq[i].dim.state = DIM_START_MEASURE;
+	}
+}
+
 static int virtnet_poll(struct napi_struct *napi, int budget)
 {
 	struct receive_queue *rq =
 		container_of(napi, struct receive_queue, napi);
+	struct virtnet_info *vi = rq->vq->vdev->priv;
 	unsigned int received;
 
 	virtnet_poll_cleantx(rq);
@@ -1189,8 +1234,10 @@ static int virtnet_poll(struct napi_struct *napi, int budget)
 	received = virtnet_receive(rq, budget);
 
 	/* Out of packets? */
-	if (received < budget)
+	if (received < budget) {
 		virtqueue_napi_complete(napi, rq->vq, received);
+		virtnet_rx_dim_update(vi, rq);
+	}
 
 	return received;
 }
@@ -1546,6 +1593,8 @@ static int virtnet_close(struct net_device *dev)
 		virtnet_napi_tx_disable(&vi->sq[i].napi);
 	}
 
+	virtnet_rx_dim_cancel(vi);
+
 	return 0;
 }
 
@@ -1876,6 +1925,187 @@ static void virtnet_init_settings(struct net_device *dev)
 	vi->duplex = DUPLEX_UNKNOWN;
 }
 
+static int virtnet_send_rx_coal_vq(struct virtnet_info *vi, int queue,
+				   u32 max_usecs, u32 max_packets)
+{
+	struct scatterlist sg;
+
+	vi->ctrl->coal_vq.vqn = cpu_to_le16(rxq2vq(queue));
+	vi->ctrl->coal_vq.coal.max_usecs = cpu_to_le32(max_usecs);
+	vi->ctrl->coal_vq.coal.max_packets = cpu_to_le32(max_packets);
+	sg_init_one(&sg, &vi->ctrl->coal_vq, sizeof(vi->ctrl->coal_vq));
+
+	if (!virtnet_send_command(vi, VIRTIO_NET_CTRL_NOTF_COAL,
+				  VIRTIO_NET_CTRL_NOTF_COAL_VQ_SET, &sg))
+		return -EINVAL;
+
+	return 0;
+}
+
+static void virtnet_rx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct receive_queue *rq = container_of(dim, struct receive_queue, dim);
+	struct virtnet_info *vi = rq->vq->vdev->priv;
+	int qnum = vq2rxq(rq->vq);
+	struct dim_cq_moder update;
+
+	/* The control buffer is protected by the rtnl lock, and the work
+	 * is cancelled with the lock held when the device goes down.
+	 */
+	if (!rtnl_trylock()) {
+		schedule_work(&dim->work);
+		return;
+	}
+
+	if (vi->rx_dim_enabled && qnum < vi->curr_queue_pairs) {
+		update = net_dim_get_rx_moderation(dim->mode, dim->profile_ix);
+		if (virtnet_send_rx_coal_vq(vi, qnum, update.usec, update.pkts))
+			dev_warn(&vi->dev->dev,
+				 "Failed to set coalescing of rx queue %d\n",
+				 qnum);
+	}
+
+	dim->state = DIM_START_MEASURE;
+	rtnl_unlock();
+}
+
+static void virtnet_rx_dim_init(struct receive_queue *rq)
+{
+	memset(&rq->dim, 0, sizeof(rq->dim));
+	INIT_WORK(&rq->dim.work, virtnet_rx_dim_work);
+	rq->dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+	rq->dim.profile_ix = NET_DIM_DEF_PROFILE_EQE;
+}
+
+static int virtnet_send_notf_coal_cmds(struct virtnet_info *vi,
+				       struct ethtool_coalesce *ec)
+{
+	struct scatterlist sg;
+
+	vi->ctrl->coal_tx.tx_usecs = cpu_to_le32(ec->tx_coalesce_usecs);
+	vi->ctrl->coal_tx.tx_max_packets =
+		cpu_to_le32(ec->tx_max_coalesced_frames);
+	sg_init_one(&sg, &vi->ctrl->coal_tx, sizeof(vi->ctrl->coal_tx));
+
+	if (!virtnet_send_command(vi, VIRTIO_NET_CTRL_NOTF_COAL,
+				  VIRTIO_NET_CTRL_NOTF_COAL_TX_SET, &sg))
+		return -EINVAL;
+
+	vi->tx_usecs = ec->tx_coalesce_usecs;
+	vi->tx_max_packets = ec->tx_max_coalesced_frames;
+
+	/* The per queue settings of the adaptive mode win */
+	if (ec->use_adaptive_rx_coalesce)
+		return 0;
+
+	vi->ctrl->coal_rx.rx_usecs = cpu_to_le32(ec->rx_coalesce_usecs);
+	vi->ctrl->coal_rx.rx_max_packets =
+		cpu_to_le32(ec->rx_max_coalesced_frames);
+	sg_init_one(&sg, &vi->ctrl->coal_rx, sizeof(vi->ctrl->coal_rx));
+
+	if (!virtnet_send_command(vi, VIRTIO_NET_CTRL_NOTF_COAL,
+				  VIRTIO_NET_CTRL_NOTF_COAL_RX_SET, &sg))
+		return -EINVAL;
+
+	vi->rx_usecs = ec->rx_coalesce_usecs;
+	vi->rx_max_packets = ec->rx_max_coalesced_frames;
+
+	return 0;
+}
+
+static int virtnet_set_rx_dim(struct virtnet_info *vi, bool enable)
+{
+	struct dim_cq_moder moder;
+	int i, err;
+
+	if (enable == vi->rx_dim_enabled)
+		return 0;
+
+	if (!enable) {
+		WRITE_ONCE(vi->rx_dim_enabled, false);
+		virtnet_rx_dim_cancel(vi);
+
+		/* Back to the static setting on every queue */
+		for (i = 0; i < vi->curr_queue_pairs; i++) {
+			err = virtnet_send_rx_coal_vq(vi, i, vi->rx_usecs,
+						      vi->rx_max_packets);
+			if (err)
+				return err;
+		}
+		return 0;
+	}
+
+	/* NAPI doesn't touch the state until the mode is enabled, make sure
+	 * no update raced with the last disabling either.
+	 */
+	virtnet_rx_dim_cancel(vi);
+	for (i = 0; i < vi->max_queue_pairs; i++) {
+		virtnet_rx_dim_init(&vi->rq[i]);
+		if (i >= vi->curr_queue_pairs)
+			continue;
+
+		moder = net_dim_get_def_rx_moderation(vi->rq[i].dim.mode);
+		err = virtnet_send_rx_coal_vq(vi, i, moder.usec, moder.pkts);
+		if (err)
+			return err;
+	}
+
+	WRITE_ONCE(vi->rx_dim_enabled, true);
+	return 0;
+}
+
+static int virtnet_get_coalesce(struct net_device *dev,
+				struct ethtool_coalesce *ec)
+{
+	struct virtnet_info *vi = netdev_priv(dev);
+
+	if (!virtio_has_feature(vi->vdev, VIRTIO_NET_F_NOTF_COAL) &&
+	    !virtio_has_feature(vi->vdev, VIRTIO_NET_F_VQ_NOTF_COAL))
+		return -EOPNOTSUPP;
+
+	ec->rx_coalesce_usecs = vi->rx_usecs;
+	ec->rx_max_coalesced_frames = vi->rx_max_packets;
+	ec->tx_coalesce_usecs = vi->tx_usecs;
+	ec->tx_max_coalesced_frames = vi->tx_max_packets;
+	ec->use_adaptive_rx_coalesce = vi->rx_dim_enabled;
+
+	return 0;
+}
+
+static int virtnet_set_coalesce(struct net_device *dev,
+				struct ethtool_coalesce *ec)
+{
+	struct virtnet_info *vi = netdev_priv(dev);
+	int err;
+
+	/* TX completions are mostly reaped from start_xmit, there is no
+	 * per poll TX signal to tune on.
+	 */
+	if (ec->use_adaptive_tx_coalesce)
+		return -EOPNOTSUPP;
+
+	if (ec->use_adaptive_rx_coalesce &&
+	    !virtio_has_feature(vi->vdev, VIRTIO_NET_F_VQ_NOTF_COAL))
+		return -EOPNOTSUPP;
+
+	if (virtio_has_feature(vi->vdev, VIRTIO_NET_F_NOTF_COAL)) {
+		err = virtnet_send_notf_coal_cmds(vi, ec);
+		if (err)
+			return err;
+	} else if (ec->rx_coalesce_usecs != vi->rx_usecs ||
+		   ec->rx_max_coalesced_frames != vi->rx_max_packets ||
+		   ec->tx_coalesce_usecs != vi->tx_usecs ||
+		   ec->tx_max_coalesced_frames != vi->tx_max_packets) {
+		return -EOPNOTSUPP;
+	}
+
+	if (!virtio_has_feature(vi->vdev, VIRTIO_NET_F_VQ_NOTF_COAL))
+		return 0;
+
+	return virtnet_set_rx_dim(vi, ec->use_adaptive_rx_coalesce);
+}
+
 static const struct ethtool_ops virtnet_ethtool_ops = {
 	.get_drvinfo = virtnet_get_drvinfo,
 	.get_link = ethtool_op_get_link,
@@ -1885,6 +2115,8 @@ static const struct ethtool_ops virtnet_ethtool_ops = {
 	.get_ts_info = ethtool_op_get_ts_info,
 	.get_link_ksettings = virtnet_get_link_ksettings,
 	.set_link_ksettings = virtnet_set_link_ksettings,
+	.get_coalesce = virtnet_get_coalesce,
+	.set_coalesce = virtnet_set_coalesce,
 };
 
 static void virtnet_freeze_down(struct virtio_device *vdev)
@@ -1905,6 +2137,7 @@ static void virtnet_freeze_down(struct virtio_device *vdev)
 			napi_disable(&vi->rq[i].napi);
 			virtnet_napi_tx_disable(&vi->sq[i].napi);
 		}
+		virtnet_rx_dim_cancel(vi);
 	}
 }
 
@@ -2374,6 +2607,7 @@ static int virtnet_alloc_queues(struct virtnet_info *vi)
 
 		sg_init_table(vi->rq[i].sg, ARRAY_SIZE(vi->rq[i].sg));
 		ewma_pkt_len_init(&vi->rq[i].mrg_avg_pkt_len);
+		virtnet_rx_dim_init(&vi->rq[i]);
 		sg_init_table(vi->sq[i].sg, ARRAY_SIZE(vi->sq[i].sg));
 	}
 
@@ -2467,6 +2701,10 @@ static bool virtnet_validate_features(struct virtio_device *vdev)
 			     "VIRTIO_NET_F_CTRL_VQ") ||
 	     VIRTNET_FAIL_ON(vdev, VIRTIO_NET_F_MQ, "VIRTIO_NET_F_CTRL_VQ") ||
 	     VIRTNET_FAIL_ON(vdev, VIRTIO_NET_F_CTRL_MAC_ADDR,
+			     "VIRTIO_NET_F_CTRL_VQ") ||
+	     VIRTNET_FAIL_ON(vdev, VIRTIO_NET_F_NOTF_COAL,
+			     "VIRTIO_NET_F_CTRL_VQ") ||
+	     VIRTNET_FAIL_ON(vdev, VIRTIO_NET_F_VQ_NOTF_COAL,
 			     "VIRTIO_NET_F_CTRL_VQ"))) {
 		return false;
 	}
@@ -2788,6 +3026,8 @@ static struct virtio_device_id id_table[] = {
 
 static unsigned int features[] = {
 	VIRTNET_FEATURES,
+	VIRTIO_NET_F_NOTF_COAL,
+	VIRTIO_NET_F_VQ_NOTF_COAL,
 };
 
 static unsigned int features_legacy[] = {
@@ -25,6 +25,7 @@
 
 #define pr_fmt(fmt)	"OF: " fmt
 
+#include <linux/ctype.h>
 #include <linux/of.h>
 #include <linux/of_device.h>
 #include <linux/of_graph.h>
@@ -818,6 +819,134 @@ struct device_node *of_graph_get_remote_node(const struct device_node *node,
 }
 EXPORT_SYMBOL(of_graph_get_remote_node);
 
+/*
+ * Consumer bindings that reference the providers a device depends on,
+ * along with the name of the provider's #cells property.
+ */
+static const struct of_supplier_binding {
+	const char *list_name;
+	const char *cells_name;
+} of_supplier_bindings[] = {
+	{ "clocks", "#clock-cells" },
+	{ "resets", "#reset-cells" },
+	{ "phys", "#phy-cells" },
+	{ "power-domains", "#power-domain-cells" },
+	{ "dmas", "#dma-cells" },
+	{ "iommus", "#iommu-cells" },
+	{ "pwms", "#pwm-cells" },
+	{ "mboxes", "#mbox-cells" },
+	{ "io-channels", "#io-channel-cells" },
+	{ "gpios", "#gpio-cells" },
+};
+
+static bool of_prop_has_suffix(const char *name, const char *suffix)
+{
+	size_t len = strlen(name), slen = strlen(suffix);
+
+	return len > slen && !strcmp(name + len - slen, suffix);
+}
+
+static bool of_prop_is_pinctrl(const char *name)
+{
+	if (strncmp(name, "pinctrl-", 8) || !name[8])
+		return false;
+	for (name += 8; *name; name++)
+		if (!isdigit(*name))
+			return false;
+	return true;
+}
+
+/*
+ * Resolve @sup to the node a device gets created for (pin configuration
+ * nodes, for instance, live below their pin controller) and hand it to
+ * @fn, unless it is @np itself or disabled.
+ */
+static int of_supplier_call(struct device_node *np, struct device_node *sup,
+			    int (*fn)(struct device_node *, void *), void *data)
+{
+	struct device_node *dn = of_node_get(sup);
+	int ret = 0;
+
+	while (dn && !of_find_property(dn, "compatible", NULL))
+		dn = of_get_next_parent(dn);
+	if (dn && dn != np && of_device_is_available(dn))
+		ret = fn(dn, data);
+	of_node_put(dn);
+
+	return ret;
+}
+
+static int of_supplier_list(struct device_node *np, const char *list_name,
+			    const char *cells_name,
+			    int (*fn)(struct device_node *, void *), void *data)
+{
+	struct of_phandle_iterator it;
+	int err, ret;
+
+	of_for_each_phandle(&it, err, np, list_name, cells_name, 0) {
+		if (!it.node)
+			continue;
+		ret = of_supplier_call(np, it.node, fn, data);
+		if (ret) {
+			of_node_put(it.node);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * of_for_each_supplier - Iterate over the providers a device node depends on
+ * @np:		consumer device node
+ * @fn:		callback invoked for each supplier device node
+ * @data:	opaque pointer passed to @fn
+ *
+ * Walks the common consumer bindings of @np (clocks, resets, regulators,
+ * GPIOs, pin control states, ...) and calls @fn for every available
+ * provider node they reference.  A provider may be reported more than
+ * once.  The iteration stops at the first non-zero value returned by @fn.
+ *
+ * Returns the value that stopped the iteration, or 0.
+ */
+int of_for_each_supplier(struct device_node *np,
+			 int (*fn)(struct device_node *sup, void *data),
+			 void *data)
+{
+	const struct of_supplier_binding *b;
+	struct property *prop;
+	int ret;
+
+	for (b = of_supplier_bindings;
+	     b < of_supplier_bindings + ARRAY_SIZE(of_supplier_bindings); b++) {
+		ret = of_supplier_list(np, b->list_name, b->cells_name,
+				       fn, data);
+		if (ret)
+			return ret;
+	}
+
+	for_each_property_of_node(np, prop) {
+		const char *cells_name;
+
+		if (of_prop_has_suffix(prop->name, "-supply") ||
+		    of_prop_is_pinctrl(prop->name))
+			cells_name = NULL;
+		else if ((of_prop_has_suffix(prop->name, "-gpios") ||
+			  of_prop_has_suffix(prop->name, "-gpio")) &&
+			 strcmp(prop->name, "nr-gpios"))
+			cells_name = "#gpio-cells";
+		else
+			continue;
+
+		ret = of_supplier_list(np, prop->name, cells_name, fn, data);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(of_for_each_supplier);
+
 static void of_fwnode_get(struct fwnode_handle *fwnode)
 {
 	of_node_get(to_of_node(fwnode));
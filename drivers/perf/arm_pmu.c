@@ -228,6 +228,8 @@ armpmu_del(struct perf_event *event, int flags)
 	clear_bit(idx, hw_events->used_mask);
 	if (armpmu->clear_event_idx)
 		armpmu->clear_event_idx(hw_events, event);
+	if (hwc->flags & ARMPMU_EL0_RD_CNTR)
+		perf_sched_cb_dec(event->pmu);
 
 	perf_event_update_userpage(event);
 }
@@ -256,6 +258,8 @@ armpmu_add(struct perf_event *event, int flags)
 	event->hw.idx = idx;
 	armpmu->disable(event);
 	hw_events->events[idx] = event;
+	if (hwc->flags & ARMPMU_EL0_RD_CNTR)
+		perf_sched_cb_inc(event->pmu);
 
 	hwc->state = PERF_HES_STOPPED | PERF_HES_UPTODATE;
 	if (flags & PERF_EF_START)
@@ -474,6 +478,19 @@ static void armpmu_disable(struct pmu *pmu)
 	armpmu->stop(armpmu);
 }
 
+/*
+ * Registered through perf_sched_cb_inc() while an event that user space
+ * reads directly is on the PMU. There is nothing to do here: the core
+ * calls us with the PMU disabled, and re-enabling it lets the driver
+ * decide again whether EL0 may access the counters, now on behalf of
+ * the incoming task. This matters when the core swaps a cloned context
+ * to the next task instead of scheduling its events out and back in,
+ * which would otherwise leave the previous task's access enabled.
+ */
+static void armpmu_sched_task(struct perf_event_context *ctx, bool sched_in)
+{
+}
+
 /*
  * In heterogeneous systems, events are specific to a particular
  * microarchitecture, and aren't suitable for another. Thus, only match CPUs of
@@ -833,6 +850,7 @@ struct arm_pmu *armpmu_alloc(void)
 		.stop		= armpmu_stop,
 		.read		= armpmu_read,
 		.filter_match	= armpmu_filter_match,
+		.sched_task	= armpmu_sched_task,
 		.attr_groups	= pmu->attr_groups,
 		/*
 		 * This is a CPU PMU potentially in a heterogeneous
@@ -45,7 +45,7 @@ static int fname_encrypt(struct inode *inode,
 	struct fscrypt_info *ci = inode->i_crypt_info;
 	struct crypto_skcipher *tfm = ci->ci_ctfm;
 	int res = 0;
-	char iv[FS_CRYPTO_BLOCK_SIZE];
+	char iv[FSCRYPT_MAX_IV_SIZE];
 	struct scatterlist sg;
 	int padding = 4 << (ci->ci_flags & FS_POLICY_FLAGS_PAD_MASK);
 	unsigned int lim;
@@ -66,7 +66,7 @@ static int fname_encrypt(struct inode *inode,
 	memset(oname->name + iname->len, 0, cryptlen - iname->len);
 
 	/* Initialize the IV */
-	memset(iv, 0, FS_CRYPTO_BLOCK_SIZE);
+	memset(iv, 0, sizeof(iv));
 
 	/* Set up the encryption request */
 	req = skcipher_request_alloc(tfm, GFP_NOFS);
@@ -116,7 +116,7 @@ static int fname_decrypt(struct inode *inode,
 	struct fscrypt_info *ci = inode->i_crypt_info;
 	struct crypto_skcipher *tfm = ci->ci_ctfm;
 	int res = 0;
-	char iv[FS_CRYPTO_BLOCK_SIZE];
+	char iv[FSCRYPT_MAX_IV_SIZE];
 	unsigned lim;
 
 	lim = inode->i_sb->s_cop->max_namelen(inode);
@@ -135,7 +135,7 @@ static int fname_decrypt(struct inode *inode,
 		fname_crypt_complete, &ecr);
 
 	/* Initialize IV */
-	memset(iv, 0, FS_CRYPTO_BLOCK_SIZE);
+	memset(iv, 0, sizeof(iv));
 
 	/* Create decryption request */
 	sg_init_one(&src_sg, iname->name, iname->len);
@@ -24,6 +24,10 @@
 #define FS_AES_256_CBC_KEY_SIZE		32
 #define FS_AES_256_CTS_KEY_SIZE		32
 #define FS_AES_256_XTS_KEY_SIZE		64
+#define FS_ADIANTUM_KEY_SIZE		32
+
+/* Adiantum takes a 32-byte IV, the AES based modes a 16-byte one */
+#define FSCRYPT_MAX_IV_SIZE		32
 
 #define FS_KEY_DERIVATION_NONCE_SIZE		16
 
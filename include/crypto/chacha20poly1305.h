@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Common values and helper functions for single pass implementations of the
+ * ChaCha20-Poly1305 AEAD (RFC7539) that only supply a faster ChaCha20 core.
+ */
+
+#ifndef _CRYPTO_CHACHA20POLY1305_H
+#define _CRYPTO_CHACHA20POLY1305_H
+
+#include <crypto/aead.h>
+#include <crypto/chacha.h>
+#include <crypto/hash.h>
+
+#define CHACHAPOLY_IV_SIZE	12
+
+struct chachapoly_simd_ctx {
+	struct chacha_ctx chacha;
+	struct crypto_shash *poly;
+	/* key bytes we use for the ChaCha20 IV */
+	unsigned int saltlen;
+	u8 salt[CHACHAPOLY_IV_SIZE - 8];
+};
+
+/*
+ * XOR @bytes of ChaCha20 keystream into @src and store the result in @dst,
+ * advancing the block counter in @state.  Only the final call of a request
+ * may pass a length that is not a multiple of CHACHA_BLOCK_SIZE.
+ */
+typedef void (*chachapoly_xor_t)(u32 *state, u8 *dst, const u8 *src,
+				 unsigned int bytes);
+
+int crypto_chachapoly_setkey(struct crypto_aead *tfm, const u8 *key,
+			     unsigned int keylen);
+int crypto_chachapoly_setauthsize(struct crypto_aead *tfm,
+				  unsigned int authsize);
+int crypto_chachapoly_init_tfm(struct crypto_aead *tfm);
+void crypto_chachapoly_exit_tfm(struct crypto_aead *tfm);
+int crypto_chachapoly_crypt_helper(struct aead_request *req, bool encrypt,
+				   chachapoly_xor_t xor_fn);
+
+#endif /* _CRYPTO_CHACHA20POLY1305_H */
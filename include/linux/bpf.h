@@ -105,6 +105,9 @@ enum bpf_return_type {
 	RET_PTR_TO_MAP_VALUE_OR_NULL,	/* returns a pointer to map elem value or NULL */
 };
 
+/* Max number of arguments a tracepoint passes to a raw tracepoint program */
+#define MAX_BPF_FUNC_ARGS 12
+
 /* eBPF function prototype used by verifier to allow BPF_CALLs from eBPF programs
  * to in-kernel helper functions and for adjusting imm32 field in BPF_CALL
  * instructions after verifying
@@ -669,6 +669,10 @@ asmlinkage long compat_sys_ioctl(unsigned int fd, unsigned int cmd,
 asmlinkage long compat_sys_futex(u32 __user *uaddr, int op, u32 val,
 		struct compat_timespec __user *utime, u32 __user *uaddr2,
 		u32 val3);
+struct futex_waitv;
+asmlinkage long compat_sys_futex_waitv(struct futex_waitv __user *waiters,
+		unsigned int nr_futexes, unsigned int flags,
+		struct compat_timespec __user *timeout, clockid_t clockid);
 asmlinkage long compat_sys_getsockopt(int fd, int level, int optname,
 				      char __user *optval, int __user *optlen);
 asmlinkage long compat_sys_kexec_load(compat_ulong_t entry,
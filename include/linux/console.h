@@ -21,6 +21,7 @@ struct console_font_op;
 struct console_font;
 struct module;
 struct tty_struct;
+struct task_struct;
 
 /*
  * this is what the terminal answers to a ESC-Z or csi0c query.
@@ -145,6 +146,9 @@ struct console {
 	short	flags;
 	short	index;
 	int	cflag;
+	u64	seq;		/* next record to print, under console_lock */
+	unsigned long dropped;	/* records lost since the last print */
+	struct task_struct *thread;	/* printer thread, see printk.c */
 	void	*data;
 	struct	 console *next;
 };
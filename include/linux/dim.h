@@ -0,0 +1,160 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Dynamic Interrupt Moderation (DIM) library
+ *
+ * A network driver samples the number of packets, bytes and interrupt
+ * events at the end of every NAPI poll and feeds them to net_dim(). Once
+ * enough events have been collected, DIM compares the measured rates with
+ * the previous window and walks a small table of moderation profiles
+ * (interrupt delay / packet threshold pairs) toward the one that gives the
+ * best throughput, falling back to lighter moderation when traffic becomes
+ * latency bound. When a new profile has been chosen, dim->work is scheduled
+ * and the driver programs the hardware from there.
+ */
+#ifndef _LINUX_DIM_H
+#define _LINUX_DIM_H
+
+#include <linux/kernel.h>
+#include <linux/ktime.h>
+#include <linux/workqueue.h>
+
+/* Number of events between two decisions */
+#define DIM_NEVENTS 64
+
+/* More than 10% difference */
+#define IS_SIGNIFICANT_DIFF(val, ref) \
+	((ref) && (((100UL * abs((val) - (ref))) / (ref)) > 10))
+
+/* Wrap safe distance between two free running counters of @bits width */
+#define BIT_GAP(bits, end, start) \
+	((((end) - (start)) + BIT_ULL(bits)) & (BIT_ULL(bits) - 1))
+
+/**
+ * struct dim_cq_moder - moderation profile
+ * @usec: interrupt delay in microseconds
+ * @pkts: number of packets which fire the interrupt before @usec expired
+ * @cq_period_mode: whether the timer starts at the first completion
+ *		    (DIM_CQ_PERIOD_MODE_START_FROM_CQE) or at the last event
+ *		    (DIM_CQ_PERIOD_MODE_START_FROM_EQE)
+ */
+struct dim_cq_moder {
+	u16 usec;
+	u16 pkts;
+	u8 cq_period_mode;
+};
+
+/**
+ * struct dim_sample - snapshot of the driver counters
+ * @time: time of the snapshot
+ * @pkt_ctr: free running packet counter
+ * @byte_ctr: free running byte counter
+ * @event_ctr: free running interrupt / NAPI completion counter
+ */
+struct dim_sample {
+	ktime_t time;
+	u32 pkt_ctr;
+	u32 byte_ctr;
+	u16 event_ctr;
+};
+
+/**
+ * struct dim_stats - rates measured over one window, per millisecond
+ * @ppms: packets
+ * @bpms: bytes
+ * @epms: events
+ */
+struct dim_stats {
+	int ppms;
+	int bpms;
+	int epms;
+};
+
+/**
+ * struct dim - per queue moderation state
+ * @state: see enum dim_state
+ * @prev_stats: rates of the previous window
+ * @start_sample: counters at the start of the current window
+ * @work: scheduled when a new profile must be applied, the driver's
+ *	  handler sets @state back to DIM_START_MEASURE once it is done
+ * @priv: owned by the driver
+ * @profile_ix: current profile
+ * @mode: enum dim_cq_period_mode of the profile table
+ * @tune_state: see enum dim_tune_state
+ * @steps_right: profiles moved toward heavier moderation in this run
+ * @steps_left: profiles moved toward lighter moderation in this run
+ * @tired: steps taken since the last parking, bounds the oscillation
+ */
+struct dim {
+	u8 state;
+	struct dim_stats prev_stats;
+	struct dim_sample start_sample;
+	struct work_struct work;
+	void *priv;
+	u8 profile_ix;
+	u8 mode;
+	u8 tune_state;
+	u8 steps_right;
+	u8 steps_left;
+	u8 tired;
+};
+
+enum dim_cq_period_mode {
+	DIM_CQ_PERIOD_MODE_START_FROM_EQE = 0x0,
+	DIM_CQ_PERIOD_MODE_START_FROM_CQE = 0x1,
+	DIM_CQ_PERIOD_NUM_MODES
+};
+
+enum dim_state {
+	DIM_START_MEASURE,
+	DIM_MEASURE_IN_PROGRESS,
+	DIM_APPLY_NEW_PROFILE,
+};
+
+enum dim_tune_state {
+	DIM_PARKING_ON_TOP,
+	DIM_PARKING_TIRED,
+	DIM_GOING_RIGHT,
+	DIM_GOING_LEFT,
+};
+
+enum dim_stats_state {
+	DIM_STATS_WORSE,
+	DIM_STATS_SAME,
+	DIM_STATS_BETTER,
+};
+
+enum dim_step_result {
+	DIM_STEPPED,
+	DIM_TOO_TIRED,
+	DIM_ON_EDGE,
+};
+
+bool dim_on_top(struct dim *dim);
+void dim_turn(struct dim *dim);
+void dim_park_on_top(struct dim *dim);
+void dim_park_tired(struct dim *dim);
+void dim_calc_stats(struct dim_sample *start, struct dim_sample *end,
+		    struct dim_stats *curr_stats);
+
+static inline void
+dim_update_sample(u16 event_ctr, u64 packets, u64 bytes, struct dim_sample *s)
+{
+	s->time = ktime_get();
+	s->pkt_ctr = packets;
+	s->byte_ctr = bytes;
+	s->event_ctr = event_ctr;
+}
+
+/* Profile tables for network devices */
+#define NET_DIM_PARAMS_NUM_PROFILES 5
+#define NET_DIM_DEF_PROFILE_CQE 1
+#define NET_DIM_DEF_PROFILE_EQE 1
+
+struct dim_cq_moder net_dim_get_rx_moderation(u8 cq_period_mode, int ix);
+struct dim_cq_moder net_dim_get_def_rx_moderation(u8 cq_period_mode);
+struct dim_cq_moder net_dim_get_tx_moderation(u8 cq_period_mode, int ix);
+struct dim_cq_moder net_dim_get_def_tx_moderation(u8 cq_period_mode);
+
+void net_dim(struct dim *dim, struct dim_sample end_sample);
+
+#endif /* _LINUX_DIM_H */
@@ -3,6 +3,7 @@
 #define _LINUX_FUTEX_H
 
 #include <linux/ktime.h>
+#include <linux/mm_types.h>
 #include <uapi/linux/futex.h>
 
 struct inode;
@@ -11,6 +12,8 @@ struct task_struct;
 
 long do_futex(u32 __user *uaddr, int op, u32 val, ktime_t *timeout,
 	      u32 __user *uaddr2, u32 val2, u32 val3);
+long do_futex_waitv(struct futex_waitv __user *waiters, unsigned int nr_futexes,
+		    unsigned int flags, ktime_t *abs_time, clockid_t clockid);
 
 extern int
 handle_futex_death(u32 __user *uaddr, struct task_struct *curr, int pi);
@@ -60,10 +63,26 @@ extern void exit_robust_list(struct task_struct *curr);
 #else
 extern int futex_cmpxchg_enabled;
 #endif
+static inline void futex_mm_init(struct mm_struct *mm)
+{
+	mm->futex_phash = NULL;
+}
+extern void futex_hash_free(struct mm_struct *mm);
+extern int futex_hash_prctl(unsigned long arg2, unsigned long arg3);
 #else
 static inline void exit_robust_list(struct task_struct *curr)
 {
 }
+static inline void futex_mm_init(struct mm_struct *mm)
+{
+}
+static inline void futex_hash_free(struct mm_struct *mm)
+{
+}
+static inline int futex_hash_prctl(unsigned long arg2, unsigned long arg3)
+{
+	return -EINVAL;
+}
 #endif
 
 #ifdef CONFIG_FUTEX_PI
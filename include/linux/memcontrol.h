@@ -91,6 +91,24 @@ struct mem_cgroup_stat_cpu {
 	unsigned long events[MEMCG_NR_EVENTS];
 	unsigned long nr_page_events;
 	unsigned long targets[MEM_CGROUP_NTARGETS];
+
+	/* Counter values at the last flush */
+	long count_prev[MEMCG_NR_STAT];
+	unsigned long events_prev[MEMCG_NR_EVENTS];
+
+	/*
+	 * Tree of the cgroups updated on this CPU since the last flush.
+	 * An updated cgroup is linked into its parent's updated_children
+	 * list through updated_next, which is NULL while not queued.
+	 */
+	struct mem_cgroup *updated_children;
+	struct mem_cgroup *updated_next;
+};
+
+/* Statistics aggregated from the per-cpu counters */
+struct mem_cgroup_stat {
+	long count[MEMCG_NR_STAT];
+	unsigned long events[MEMCG_NR_EVENTS];
 };
 
 struct mem_cgroup_reclaim_iter {
@@ -232,6 +250,14 @@ struct mem_cgroup {
 	 */
 	struct mem_cgroup_stat_cpu __percpu *stat;
 
+	/*
+	 * Flushed statistics of this cgroup alone, of this cgroup and its
+	 * descendants, and descendant deltas not yet folded in.
+	 */
+	struct mem_cgroup_stat	stat_local;
+	struct mem_cgroup_stat	stat_tree;
+	struct mem_cgroup_stat	stat_pending;
+
 	unsigned long		socket_pressure;
 
 	/* Legacy tcp memory accounting */
@@ -272,10 +298,26 @@ static inline bool mem_cgroup_disabled(void)
 	return !cgroup_subsys_enabled(memory_cgrp_subsys);
 }
 
+void __mem_cgroup_rstat_updated(struct mem_cgroup *memcg);
+
+/*
+ * Queue @memcg for the next stat flush after its per-cpu counters were
+ * modified on this CPU. Must be called with preemption disabled.
+ */
+static inline void mem_cgroup_rstat_updated(struct mem_cgroup *memcg)
+{
+	/* Racy check, worst case the change shows up one flush later */
+	if (!__this_cpu_read(memcg->stat->updated_next))
+		__mem_cgroup_rstat_updated(memcg);
+}
+
 static inline void mem_cgroup_event(struct mem_cgroup *memcg,
 				    enum memcg_event_item event)
 {
+	preempt_disable();
 	this_cpu_inc(memcg->stat->events[event]);
+	mem_cgroup_rstat_updated(memcg);
+	preempt_enable();
 	cgroup_file_notify(&memcg->events_file);
 }
 
@@ -508,16 +550,22 @@ static inline unsigned long memcg_page_state(struct mem_cgroup *memcg,
 static inline void __mod_memcg_state(struct mem_cgroup *memcg,
 				     int idx, int val)
 {
-	if (!mem_cgroup_disabled())
+	if (!mem_cgroup_disabled()) {
 		__this_cpu_add(memcg->stat->count[idx], val);
+		mem_cgroup_rstat_updated(memcg);
+	}
 }
 
 /* idx can be of type enum memcg_stat_item or node_stat_item */
 static inline void mod_memcg_state(struct mem_cgroup *memcg,
 				   int idx, int val)
 {
-	if (!mem_cgroup_disabled())
+	if (!mem_cgroup_disabled()) {
+		preempt_disable();
 		this_cpu_add(memcg->stat->count[idx], val);
+		mem_cgroup_rstat_updated(memcg);
+		preempt_enable();
+	}
 }
 
 /**
@@ -631,8 +679,12 @@ static inline void count_memcg_events(struct mem_cgroup *memcg,
 				      enum vm_event_item idx,
 				      unsigned long count)
 {
-	if (!mem_cgroup_disabled())
+	if (!mem_cgroup_disabled()) {
+		preempt_disable();
 		this_cpu_add(memcg->stat->events[idx], count);
+		mem_cgroup_rstat_updated(memcg);
+		preempt_enable();
+	}
 }
 
 /* idx can be of type enum memcg_stat_item or node_stat_item */
@@ -654,7 +706,10 @@ static inline void count_memcg_event_mm(struct mm_struct *mm,
 	rcu_read_lock();
 	memcg = mem_cgroup_from_task(rcu_dereference(mm->owner));
 	if (likely(memcg)) {
+		preempt_disable();
 		this_cpu_inc(memcg->stat->events[idx]);
+		mem_cgroup_rstat_updated(memcg);
+		preempt_enable();
 		if (idx == OOM_KILL)
 			cgroup_file_notify(&memcg->events_file);
 	}
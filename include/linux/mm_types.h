@@ -8,6 +8,7 @@
 #include <linux/list.h>
 #include <linux/spinlock.h>
 #include <linux/rbtree.h>
+#include <linux/range_tree.h>
 #include <linux/rwsem.h>
 #include <linux/completion.h>
 #include <linux/cpumask.h>
@@ -285,15 +286,9 @@ struct vm_area_struct {
 	/* linked list of VM areas per task, sorted by address */
 	struct vm_area_struct *vm_next, *vm_prev;
 
+#ifndef CONFIG_MMU
 	struct rb_node vm_rb;
-
-	/*
-	 * Largest free memory gap in bytes to the left of this VMA.
-	 * Either between this VMA and vma->vm_prev, or between one of the
-	 * VMAs below us in the VMA rbtree and its ->vm_prev. This helps
-	 * get_unmapped_area find a free area of the right size.
-	 */
-	unsigned long rb_subtree_gap;
+#endif
 
 	/* Second cache line starts here. */
 
@@ -351,10 +346,15 @@ struct core_state {
 };
 
 struct kioctx_table;
+struct futex_private_hash;
 struct mm_struct {
 	struct vm_area_struct *mmap;		/* list of VMAs */
+#ifdef CONFIG_MMU
+	struct range_tree mm_rt;		/* VMAs indexed by address,
+						 * mmap_sem held to look up */
+#else
 	struct rb_root mm_rb;
-	u64 vmacache_seqnum;                   /* per-thread vmacache */
+#endif
 #ifdef CONFIG_MMU
 	unsigned long (*get_unmapped_area) (struct file *filp,
 				unsigned long addr, unsigned long len,
@@ -505,6 +505,10 @@ struct mm_struct {
 	/* HMM needs to track a few things per mm */
 	struct hmm *hmm;
 #endif
+#ifdef CONFIG_FUTEX
+	/* Optional process-private futex hash, see PR_FUTEX_HASH */
+	struct futex_private_hash *futex_phash;
+#endif
 } __randomize_layout;
 
 extern struct mm_struct init_mm;
@@ -143,6 +143,7 @@ extern raw_spinlock_t devtree_lock;
 #define OF_DETACHED	2 /* node has been detached from the device tree */
 #define OF_POPULATED	3 /* device already created for the node */
 #define OF_POPULATED_BUS	4 /* of_platform_populate recursed to children of this node */
+#define OF_DRIVER_BOUND	5 /* a driver is bound to the device created for the node */
 
 #define OF_BAD_ADDR	((u64)-1)
 
@@ -381,6 +382,9 @@ extern int of_phandle_iterator_args(struct of_phandle_iterator *it,
 				    uint32_t *args,
 				    int size);
 
+extern int of_for_each_supplier(struct device_node *np,
+	int (*fn)(struct device_node *sup, void *data), void *data);
+
 extern void of_alias_scan(void * (*dt_alloc)(u64 size, u64 align));
 extern int of_alias_get_id(struct device_node *np, const char *stem);
 extern int of_alias_get_highest_id(const char *stem);
@@ -817,6 +821,12 @@ static inline int of_phandle_iterator_args(struct of_phandle_iterator *it,
 	return 0;
 }
 
+static inline int of_for_each_supplier(struct device_node *np,
+	int (*fn)(struct device_node *sup, void *data), void *data)
+{
+	return 0;
+}
+
 static inline int of_alias_get_id(struct device_node *np, const char *stem)
 {
 	return -ENOSYS;
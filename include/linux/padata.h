@@ -164,6 +164,44 @@ struct padata_instance {
 #define	PADATA_INVALID	4
 };
 
+/**
+ * struct padata_mt_job - represents one multithreaded job
+ *
+ * @thread_fn: Called for each chunk of work that a padata thread does.
+ * @fn_arg: The thread function argument.
+ * @start: The start of the job (units are job-specific).
+ * @size: size of this node's work (units are job-specific).
+ * @align: Ranges passed to the thread function fall on this boundary, with
+ *         the possible exceptions of the beginning and end of the job.
+ * @min_chunk: The minimum chunk size in job-specific units. This allows
+ *             the client to communicate the minimum amount of work that's
+ *             appropriate for one worker thread to do at once.
+ * @max_threads: Max threads to use for the job, actual number may be less
+ *               depending on task size and minimum chunk size.
+ */
+struct padata_mt_job {
+	void (*thread_fn)(unsigned long start, unsigned long end, void *arg);
+	void			*fn_arg;
+	unsigned long		start;
+	unsigned long		size;
+	unsigned long		align;
+	unsigned long		min_chunk;
+	int			max_threads;
+};
+
+#ifdef CONFIG_PADATA
+extern int __init padata_do_multithreaded(struct padata_mt_job *job);
+#else
+static inline int __init padata_do_multithreaded(struct padata_mt_job *job)
+{
+	if (!job->size)
+		return 0;
+
+	job->thread_fn(job->start, job->start + job->size, job->fn_arg);
+	return 1;
+}
+#endif
+
 extern struct padata_instance *padata_alloc_possible(
 					struct workqueue_struct *wq);
 extern void padata_free(struct padata_instance *pinst);
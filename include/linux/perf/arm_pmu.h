@@ -129,6 +129,9 @@ struct arm_pmu {
 
 #define to_arm_pmu(p) (container_of(p, struct arm_pmu, pmu))
 
+/* hw_perf_event::flags, event counter may be read directly from EL0 */
+#define ARMPMU_EL0_RD_CNTR	BIT(0)
+
 u64 armpmu_event_update(struct perf_event *event);
 
 int armpmu_event_set_period(struct perf_event *event);
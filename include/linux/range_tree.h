@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Range trees: B-trees of non-overlapping [start, end) ranges
+ *
+ * A range tree maps non-overlapping address ranges to pointers. All the
+ * ranges are stored in the leaves, sorted by address; every node keeps the
+ * bounds of the ranges below each of its slots next to the slot pointer, so
+ * that a lookup only touches a few cachelines per level and never needs to
+ * dereference the indexed objects.
+ *
+ * The nodes also track the largest gap between the ranges below each slot,
+ * which lets range_tree_empty_area() and range_tree_empty_area_rev() find a
+ * free area of a given size in O(log n).
+ *
+ * Modifications must be serialized by the caller. Lookups may run
+ * concurrently with range_tree_adjust(), which never reshapes the tree, but
+ * not with insertions or erasures. Insertions allocate nodes, so that they
+ * can be done while holding locks the page allocator might need, the nodes
+ * are reserved beforehand with range_tree_preload().
+ *
+ * The tree is not RCU safe: nodes are modified in place and freed at once,
+ * so there is no lockless lookup. Readers hold the lock the writers take,
+ * for the VMA tree the mmap_sem.
+ */
+#ifndef _LINUX_RANGE_TREE_H
+#define _LINUX_RANGE_TREE_H
+
+#include <linux/types.h>
+
+struct range_tree_node;
+
+struct range_tree {
+	struct range_tree_node	*root;
+	unsigned int		height;		/* 0 if empty, 1 if root is a leaf */
+	unsigned int		nr_spare;	/* nodes reserved for insertions */
+	struct range_tree_node	*spare;
+};
+
+#define RANGE_TREE_INIT		{ .root = NULL, }
+
+static inline void INIT_RANGE_TREE(struct range_tree *rt)
+{
+	rt->root = NULL;
+	rt->height = 0;
+	rt->nr_spare = 0;
+	rt->spare = NULL;
+}
+
+static inline bool range_tree_empty(const struct range_tree *rt)
+{
+	return rt->root == NULL;
+}
+
+void *range_tree_find(const struct range_tree *rt, unsigned long addr);
+void *range_tree_last(const struct range_tree *rt);
+
+int range_tree_preload(struct range_tree *rt, gfp_t gfp);
+int range_tree_insert(struct range_tree *rt, unsigned long start,
+		      unsigned long end, void *entry);
+void *range_tree_erase(struct range_tree *rt, unsigned long start);
+void range_tree_adjust(struct range_tree *rt, unsigned long start,
+		       unsigned long new_start, unsigned long new_end);
+
+int range_tree_empty_area(const struct range_tree *rt, unsigned long low,
+			  unsigned long high, unsigned long size,
+			  unsigned long *addr);
+int range_tree_empty_area_rev(const struct range_tree *rt, unsigned long low,
+			      unsigned long high, unsigned long size,
+			      unsigned long *addr);
+
+void range_tree_destroy(struct range_tree *rt);
+bool range_tree_valid(const struct range_tree *rt);
+
+void range_tree_init(void);
+
+#endif /* _LINUX_RANGE_TREE_H */
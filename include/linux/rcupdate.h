@@ -57,6 +57,16 @@ void call_rcu(struct rcu_head *head, rcu_callback_t func);
 
 void call_rcu_bh(struct rcu_head *head, rcu_callback_t func);
 void call_rcu_sched(struct rcu_head *head, rcu_callback_t func);
+
+#ifdef CONFIG_RCU_LAZY
+void call_rcu_lazy(struct rcu_head *head, rcu_callback_t func);
+#else /* #ifdef CONFIG_RCU_LAZY */
+static inline void call_rcu_lazy(struct rcu_head *head, rcu_callback_t func)
+{
+	call_rcu(head, func);
+}
+#endif /* #else #ifdef CONFIG_RCU_LAZY */
+
 void synchronize_sched(void);
 void rcu_barrier_tasks(void);
 
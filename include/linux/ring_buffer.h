@@ -188,6 +188,14 @@ void ring_buffer_free_read_page(struct ring_buffer *buffer, int cpu, void *data)
 int ring_buffer_read_page(struct ring_buffer *buffer, void **data_page,
 			  size_t len, int cpu, int full);
 
+struct vm_area_struct;
+
+int ring_buffer_map(struct ring_buffer *buffer, int cpu,
+		    struct vm_area_struct *vma);
+int ring_buffer_map_dup(struct ring_buffer *buffer, int cpu);
+int ring_buffer_unmap(struct ring_buffer *buffer, int cpu);
+int ring_buffer_map_get_reader(struct ring_buffer *buffer, int cpu);
+
 struct trace_seq;
 
 int ring_buffer_print_entry_header(struct trace_seq *s);
@@ -35,4 +35,15 @@ struct tracepoint {
 	struct tracepoint_func __rcu *funcs;
 };
 
+/*
+ * Entry of the __bpf_raw_tp_map section, generated for each tracepoint by
+ * include/trace/bpf_probe.h: the probe that passes the arguments of the
+ * tracepoint to a BPF_PROG_TYPE_RAW_TRACEPOINT program.
+ */
+struct bpf_raw_event_map {
+	struct tracepoint	*tp;
+	void			*bpf_func;
+	u32			num_args;
+} __aligned(32);
+
 #endif
@@ -120,6 +120,24 @@ struct delayed_work {
 	int cpu;
 };
 
+/**
+ * enum wq_affn_scope - affinity scope of an unbound workqueue
+ *
+ * Work items queued on an unbound workqueue are executed by workers which
+ * are confined to the CPUs sharing the pod of the given scope with the
+ * CPU the work item was issued on.
+ */
+enum wq_affn_scope {
+	WQ_AFFN_DFL,			/* use system default */
+	WQ_AFFN_CPU,			/* one pod per CPU */
+	WQ_AFFN_SMT,			/* one pod per SMT core */
+	WQ_AFFN_CACHE,			/* one pod per LLC / cluster */
+	WQ_AFFN_NUMA,			/* one pod per NUMA node */
+	WQ_AFFN_SYSTEM,			/* one pod across the whole system */
+
+	WQ_AFFN_NR_TYPES,
+};
+
 /**
  * struct workqueue_attrs - A struct for workqueue attributes.
  *
@@ -137,13 +155,19 @@ struct workqueue_attrs {
 	cpumask_var_t cpumask;
 
 	/**
-	 * @no_numa: disable NUMA affinity
+	 * @affn_scope: unbound CPU affinity scope
+	 *
+	 * CPU pods are used to improve execution locality of unbound work
+	 * items.  The CPUs are grouped into pods of the given scope, and
+	 * work items issued on a CPU are executed by workers confined to
+	 * the CPUs of its pod.
 	 *
-	 * Unlike other fields, ``no_numa`` isn't a property of a worker_pool. It
-	 * only modifies how :c:func:`apply_workqueue_attrs` select pools and thus
-	 * doesn't participate in pool hash calculations or equality comparisons.
+	 * Unlike other fields, ``affn_scope`` isn't a property of a
+	 * worker_pool.  It only modifies how :c:func:`apply_workqueue_attrs`
+	 * select pools and thus doesn't participate in pool hash
+	 * calculations or equality comparisons.
 	 */
-	bool no_numa;
+	enum wq_affn_scope affn_scope;
 };
 
 static inline struct delayed_work *to_delayed_work(struct work_struct *work)
@@ -648,5 +672,6 @@ int workqueue_offline_cpu(unsigned int cpu);
 
 int __init workqueue_init_early(void);
 int __init workqueue_init(void);
+void __init workqueue_init_topology(void);
 
 #endif
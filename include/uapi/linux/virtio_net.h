@@ -56,6 +56,10 @@
 #define VIRTIO_NET_F_MQ	22	/* Device supports Receive Flow
 					 * Steering */
 #define VIRTIO_NET_F_CTRL_MAC_ADDR 23	/* Set MAC address */
+#define VIRTIO_NET_F_VQ_NOTF_COAL 52	/* Device supports virtqueue
+					 * notification coalescing */
+#define VIRTIO_NET_F_NOTF_COAL	53	/* Device supports notification
+					 * coalescing */
 
 #ifndef VIRTIO_NET_NO_LEGACY
 #define VIRTIO_NET_F_GSO	6	/* Host handles pkts w/ any GSO type */
@@ -245,4 +249,49 @@ struct virtio_net_ctrl_mq {
 #define VIRTIO_NET_CTRL_GUEST_OFFLOADS   5
 #define VIRTIO_NET_CTRL_GUEST_OFFLOADS_SET        0
 
+/*
+ * Control notification coalescing.
+ *
+ * Request the device to change the notification coalescing parameters,
+ * i.e. how many packets or microseconds it may accumulate before
+ * notifying the driver of used buffers.
+ *
+ * TX_SET and RX_SET apply to all the transmit or receive virtqueues and
+ * are available with the VIRTIO_NET_F_NOTF_COAL feature bit. VQ_SET
+ * applies to a single virtqueue and is available with the
+ * VIRTIO_NET_F_VQ_NOTF_COAL feature bit.
+ */
+#define VIRTIO_NET_CTRL_NOTF_COAL		6
+
+struct virtio_net_ctrl_coal_tx {
+	/* Maximum number of packets to send before a TX notification */
+	__le32 tx_max_packets;
+	/* Maximum number of usecs to delay a TX notification */
+	__le32 tx_usecs;
+};
+
+#define VIRTIO_NET_CTRL_NOTF_COAL_TX_SET	0
+
+struct virtio_net_ctrl_coal_rx {
+	/* Maximum number of packets to receive before a RX notification */
+	__le32 rx_max_packets;
+	/* Maximum number of usecs to delay a RX notification */
+	__le32 rx_usecs;
+};
+
+#define VIRTIO_NET_CTRL_NOTF_COAL_RX_SET	1
+
+struct virtio_net_ctrl_coal {
+	__le32 max_packets;
+	__le32 max_usecs;
+};
+
+struct virtio_net_ctrl_coal_vq {
+	__le16 vqn;
+	__le16 reserved;
+	struct virtio_net_ctrl_coal coal;
+};
+
+#define VIRTIO_NET_CTRL_NOTF_COAL_VQ_SET	2
+
 #endif /* _UAPI_LINUX_VIRTIO_NET_H */
@@ -100,6 +100,7 @@ static int kernel_init(void *);
 extern void init_IRQ(void);
 extern void fork_init(void);
 extern void radix_tree_init(void);
+extern void range_tree_init(void);
 
 /*
  * Debug helper: via this flag we know that we are in 'early bootup code'
@@ -592,6 +593,7 @@ asmlinkage __visible void __init start_kernel(void)
 		 "Interrupts were enabled *very* early, fixing it\n"))
 		local_irq_disable();
 	radix_tree_init();
+	range_tree_init();
 
 	/*
 	 * Allow workqueue creation and work item queueing/cancelling
@@ -928,9 +930,11 @@ static void __init do_pre_smp_initcalls(void)
 
 /*
  * This function requests modules which should be loaded by default and is
- * called twice right after initrd is mounted and right before init is
- * exec'd.  If such modules are on either initrd or rootfs, they will be
- * loaded before control is passed to userland.
+ * called right after an old-style initrd is mounted and right before init
+ * is exec'd.  It must not run from the asynchronous initramfs unpacking:
+ * request_module() waits for the initramfs itself.  If such modules are on
+ * either initrd or rootfs, they will be loaded before control is passed to
+ * userland.
  */
 void __init load_default_modules(void)
 {
@@ -1067,11 +1071,14 @@ static noinline void __init kernel_init_freeable(void)
 
 	smp_init();
 	sched_init_smp();
+	workqueue_init_topology();
 
 	page_alloc_init_late();
 
 	do_basic_setup();
 
+	wait_for_initramfs();
+
 	/* Open the /dev/console on the rootfs, this should never fail */
 	if (sys_open((const char __user *) "/dev/console", O_RDWR, 0) < 0)
 		pr_err("Warning: unable to open an initial console.\n");
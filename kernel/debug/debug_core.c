@@ -53,7 +53,6 @@
 #include <linux/pid.h>
 #include <linux/smp.h>
 #include <linux/mm.h>
-#include <linux/vmacache.h>
 #include <linux/rcupdate.h>
 
 #include <asm/cacheflush.h>
@@ -230,14 +229,10 @@ static void kgdb_flush_swbreak_addr(unsigned long addr)
 		return;
 
 	if (current->mm) {
-		int i;
+		struct vm_area_struct *vma = find_vma(current->mm, addr);
 
-		for (i = 0; i < VMACACHE_SIZE; i++) {
-			if (!current->vmacache.vmas[i])
-				continue;
-			flush_cache_range(current->vmacache.vmas[i],
-					  addr, addr + BREAK_INSTR_SIZE);
-		}
+		if (vma && vma->vm_start <= addr)
+			flush_cache_range(vma, addr, addr + BREAK_INSTR_SIZE);
 	}
 
 	/* Force flush instruction cache if it was outside the mm */
@@ -67,6 +67,7 @@
 #include <linux/freezer.h>
 #include <linux/bootmem.h>
 #include <linux/fault-inject.h>
+#include <linux/prctl.h>
 
 #include <asm/futex.h>
 
@@ -277,6 +278,16 @@ static struct {
 #define futex_queues   (__futex_data.queues)
 #define futex_hashsize (__futex_data.hashsize)
 
+/*
+ * A process may opt into a hash table of its own for private futexes (see
+ * PR_FUTEX_HASH), so that its waiters do not contend on buckets shared with
+ * unrelated processes. Shared futexes always use the global hash.
+ */
+struct futex_private_hash {
+	unsigned int			hash_mask;
+	struct futex_hash_bucket	queues[];
+};
+
 
 /*
  * Fault injections for futexes.
@@ -384,20 +395,103 @@ static inline int hb_waiters_pending(struct futex_hash_bucket *hb)
 }
 
 /**
- * hash_futex - Return the hash bucket in the global hash
+ * hash_futex - Return the hash bucket for a futex key
  * @key:	Pointer to the futex key for which the hash is calculated
  *
  * We hash on the keys returned from get_futex_key (see below) and return the
- * corresponding hash bucket in the global hash.
+ * corresponding hash bucket. Private keys of a process which installed its
+ * own hash table are looked up there, everything else in the global hash.
  */
 static struct futex_hash_bucket *hash_futex(union futex_key *key)
 {
 	u32 hash = jhash2((u32*)&key->both.word,
 			  (sizeof(key->both.word)+sizeof(key->both.ptr))/4,
 			  key->both.offset);
+
+	if (!(key->both.offset & (FUT_OFF_INODE | FUT_OFF_MMSHARED))) {
+		struct futex_private_hash *fph;
+
+		fph = READ_ONCE(key->private.mm->futex_phash);
+		if (fph)
+			return &fph->queues[hash & fph->hash_mask];
+	}
+
 	return &futex_queues[hash & (futex_hashsize - 1)];
 }
 
+static void futex_hash_bucket_init(struct futex_hash_bucket *hb)
+{
+	atomic_set(&hb->waiters, 0);
+	plist_head_init(&hb->chain);
+	spin_lock_init(&hb->lock);
+}
+
+static int futex_hash_allocate(unsigned int slots)
+{
+	struct mm_struct *mm = current->mm;
+	struct futex_private_hash *fph;
+	unsigned int i;
+
+	if (!slots || !is_power_of_2(slots) || slots > futex_hashsize)
+		return -EINVAL;
+
+	/*
+	 * Switching tables under queued waiters would strand them in the
+	 * old one, so only allow the switch while nobody else can be using
+	 * this mm, i.e. before the process spawns its first thread.
+	 */
+	if (mm->futex_phash || atomic_read(&mm->mm_users) != 1)
+		return -EBUSY;
+
+	fph = kvzalloc(sizeof(*fph) + slots * sizeof(fph->queues[0]),
+		       GFP_KERNEL_ACCOUNT);
+	if (!fph)
+		return -ENOMEM;
+
+	fph->hash_mask = slots - 1;
+	for (i = 0; i < slots; i++)
+		futex_hash_bucket_init(&fph->queues[i]);
+
+	if (cmpxchg(&mm->futex_phash, NULL, fph)) {
+		kvfree(fph);
+		return -EBUSY;
+	}
+	return 0;
+}
+
+/**
+ * futex_hash_prctl() - PR_FUTEX_HASH handler
+ * @arg2:	PR_FUTEX_HASH_SET_SLOTS or PR_FUTEX_HASH_GET_SLOTS
+ * @arg3:	number of slots for PR_FUTEX_HASH_SET_SLOTS, must be 0 otherwise
+ *
+ * Return: 0 or the number of slots on success, negative error code otherwise.
+ * A process without a private hash reports 0 slots.
+ */
+int futex_hash_prctl(unsigned long arg2, unsigned long arg3)
+{
+	struct futex_private_hash *fph;
+
+	switch (arg2) {
+	case PR_FUTEX_HASH_SET_SLOTS:
+		if (arg3 > UINT_MAX)
+			return -EINVAL;
+		return futex_hash_allocate(arg3);
+
+	case PR_FUTEX_HASH_GET_SLOTS:
+		if (arg3)
+			return -EINVAL;
+		fph = READ_ONCE(current->mm->futex_phash);
+		return fph ? fph->hash_mask + 1 : 0;
+	}
+	return -EINVAL;
+}
+
+void futex_hash_free(struct mm_struct *mm)
+{
+	kvfree(mm->futex_phash);
+	mm->futex_phash = NULL;
+}
+
 
 /**
  * match_futex - Check whether two futex keys are equal
@@ -2716,6 +2810,304 @@ static long futex_wait_restart(struct restart_block *restart)
 				restart->futex.val, tp, restart->futex.bitset);
 }
 
+/**
+ * struct futex_vector - Auxiliary struct for futex_waitv()
+ * @w:	Userspace provided data
+ * @q:	Kernel side data
+ *
+ * Struct used to build an array with all data needed for futex_waitv()
+ */
+struct futex_vector {
+	struct futex_waitv w;
+	struct futex_q q;
+};
+
+/* Mask of available flags for each futex in futex_waitv list */
+#define FUTEXV_WAITER_MASK (FUTEX_32 | FUTEX_PRIVATE_FLAG)
+
+/**
+ * futex_parse_waitv() - Parse a waitv array from userspace
+ * @futexv:	Kernel side list of waiters to be filled
+ * @uwaitv:	Userspace list to be parsed
+ * @nr_futexes:	Length of futexv
+ *
+ * Return: Error code on failure, 0 on success
+ */
+static int futex_parse_waitv(struct futex_vector *futexv,
+			     struct futex_waitv __user *uwaitv,
+			     unsigned int nr_futexes)
+{
+	struct futex_waitv aux;
+	unsigned int i;
+
+	for (i = 0; i < nr_futexes; i++) {
+		if (copy_from_user(&aux, &uwaitv[i], sizeof(aux)))
+			return -EFAULT;
+
+		if ((aux.flags & ~FUTEXV_WAITER_MASK) || aux.__reserved)
+			return -EINVAL;
+
+		if (!(aux.flags & FUTEX_32))
+			return -EINVAL;
+
+		futexv[i].w.flags = aux.flags;
+		futexv[i].w.val = aux.val;
+		futexv[i].w.uaddr = aux.uaddr;
+		futexv[i].q = futex_q_init;
+	}
+
+	return 0;
+}
+
+/**
+ * unqueue_multiple() - Remove various futexes from their hash bucket
+ * @v:		The list of futexes to unqueue
+ * @count:	Number of futexes in the list
+ *
+ * Helper to unqueue a list of futexes. This can't fail. Like unqueue_me()
+ * it drops the key references.
+ *
+ * Return:
+ *  - >=0 - Index of the last futex that was awoken;
+ *  - -1  - No futex was awoken
+ */
+static int unqueue_multiple(struct futex_vector *v, int count)
+{
+	int ret = -1, i;
+
+	for (i = 0; i < count; i++) {
+		if (!unqueue_me(&v[i].q))
+			ret = i;
+	}
+
+	return ret;
+}
+
+/**
+ * futex_wait_multiple_setup() - Prepare to wait and enqueue multiple futexes
+ * @vs:		The futex list to wait on
+ * @count:	The size of the list
+ * @woken:	Index of the last woken futex, if any. Used to notify the
+ *		caller that it can return this index to userspace (return
+ *		parameter)
+ *
+ * Prepare multiple futexes in a single step and enqueue them. This may fail
+ * if the futex list is invalid or if any futex was already awoken. On
+ * success the task is ready to interruptible sleep.
+ *
+ * Return:
+ *  -  1  - One of the futexes was woken by another thread
+ *  -  0  - Success
+ *  - <0  - -EFAULT, -EWOULDBLOCK or -EINVAL
+ */
+static int futex_wait_multiple_setup(struct futex_vector *vs, int count,
+				     int *woken)
+{
+	struct futex_hash_bucket *hb;
+	u32 __user *uaddr;
+	int ret, i, j;
+	u32 uval;
+
+retry:
+	for (i = 0; i < count; i++) {
+		uaddr = u64_to_user_ptr(vs[i].w.uaddr);
+		ret = get_futex_key(uaddr,
+				    !(vs[i].w.flags & FUTEX_PRIVATE_FLAG),
+				    &vs[i].q.key, VERIFY_READ);
+		if (unlikely(ret)) {
+			while (--i >= 0)
+				put_futex_key(&vs[i].q.key);
+			return ret;
+		}
+	}
+
+	/*
+	 * The task state is guaranteed to be set before another task can
+	 * wake it, see futex_wait_queue_me(). A wakeup of any futex queued
+	 * below is therefore not lost before we get to schedule().
+	 */
+	set_current_state(TASK_INTERRUPTIBLE);
+
+	for (i = 0; i < count; i++) {
+		uaddr = u64_to_user_ptr(vs[i].w.uaddr);
+
+		hb = queue_lock(&vs[i].q);
+		ret = get_futex_value_locked(&uval, uaddr);
+
+		if (!ret && uval == (u32)vs[i].w.val) {
+			/* queue_me() drops the hb lock */
+			queue_me(&vs[i].q, hb);
+			continue;
+		}
+
+		queue_unlock(hb);
+		__set_current_state(TASK_RUNNING);
+
+		/*
+		 * Even if something went wrong, if we find out that a futex
+		 * was woken, we don't return error and return this index to
+		 * userspace.
+		 */
+		*woken = unqueue_multiple(vs, i);
+		for (j = i; j < count; j++)
+			put_futex_key(&vs[j].q.key);
+		if (*woken >= 0)
+			return 1;
+
+		if (ret) {
+			/*
+			 * If we need to handle a page fault, we need to do
+			 * so without any lock and any enqueued futex
+			 * (otherwise we could lose some wakeup). So we do it
+			 * here, after undoing all the work done so far. In
+			 * success, we retry all the work.
+			 */
+			if (get_user(uval, uaddr))
+				return -EFAULT;
+
+			goto retry;
+		}
+
+		return -EWOULDBLOCK;
+	}
+
+	return 0;
+}
+
+/**
+ * futex_sleep_multiple() - Check sleeping conditions and sleep
+ * @vs:		List of futexes to wait for
+ * @count:	Length of vs
+ * @to:		Timeout
+ *
+ * Sleep if and only if the timeout hasn't expired and no futex on the list
+ * has been woken up.
+ */
+static void futex_sleep_multiple(struct futex_vector *vs, unsigned int count,
+				 struct hrtimer_sleeper *to)
+{
+	if (to && !to->task)
+		return;
+
+	for (; count; count--, vs++) {
+		if (!READ_ONCE(vs->q.lock_ptr))
+			return;
+	}
+
+	freezable_schedule();
+}
+
+/**
+ * futex_wait_multiple() - Prepare to wait on and enqueue several futexes
+ * @vs:		The list of futexes to wait on
+ * @count:	The number of objects
+ * @to:		Timeout before giving up and returning to userspace
+ *
+ * Entry point for the FUTEX_WAIT_MULTIPLE futex operation, this function
+ * sleeps on a group of futexes and returns on the first futex that is
+ * woken, or after the timeout has elapsed.
+ *
+ * Return:
+ *  - >=0 - Hint to the futex that was awoken
+ *  - <0  - On error
+ */
+static int futex_wait_multiple(struct futex_vector *vs, unsigned int count,
+			       struct hrtimer_sleeper *to)
+{
+	int ret, hint = 0;
+
+	if (to)
+		hrtimer_start_expires(&to->timer, HRTIMER_MODE_ABS);
+
+	while (1) {
+		ret = futex_wait_multiple_setup(vs, count, &hint);
+		if (ret) {
+			if (ret > 0) {
+				/* A futex was woken during setup */
+				ret = hint;
+			}
+			return ret;
+		}
+
+		futex_sleep_multiple(vs, count, to);
+
+		__set_current_state(TASK_RUNNING);
+
+		ret = unqueue_multiple(vs, count);
+		if (ret >= 0)
+			return ret;
+
+		if (to && !to->task)
+			return -ETIMEDOUT;
+		else if (signal_pending(current))
+			return -ERESTARTSYS;
+		/*
+		 * The final case is a spurious wakeup, for
+		 * which just retry.
+		 */
+	}
+}
+
+/**
+ * do_futex_waitv() - Wait on a list of futexes
+ * @waiters:	List of futexes to wait on
+ * @nr_futexes:	Length of futexv
+ * @flags:	Flag for timeout (monotonic/realtime), must be 0 for now
+ * @abs_time:	Absolute timeout, or NULL to wait forever
+ * @clockid:	Clock to be used for the timeout, realtime or monotonic
+ *
+ * Common backend of the native and compat futex_waitv() syscalls.
+ *
+ * Return:
+ *  - >=0 - Index of the futex that was woken
+ *  - <0  - -EINVAL, -EFAULT, -ENOMEM, -EWOULDBLOCK, -ETIMEDOUT or
+ *	    -ERESTARTSYS
+ */
+long do_futex_waitv(struct futex_waitv __user *waiters, unsigned int nr_futexes,
+		    unsigned int flags, ktime_t *abs_time, clockid_t clockid)
+{
+	struct hrtimer_sleeper timeout, *to = NULL;
+	struct futex_vector *futexv;
+	int ret;
+
+	/* This syscall supports no flags for now */
+	if (flags)
+		return -EINVAL;
+
+	if (!nr_futexes || nr_futexes > FUTEX_WAITV_MAX || !waiters)
+		return -EINVAL;
+
+	if (abs_time) {
+		if (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC)
+			return -EINVAL;
+
+		to = &timeout;
+		hrtimer_init_on_stack(&to->timer, clockid, HRTIMER_MODE_ABS);
+		hrtimer_init_sleeper(to, current);
+		hrtimer_set_expires_range_ns(&to->timer, *abs_time,
+					     current->timer_slack_ns);
+	}
+
+	futexv = kcalloc(nr_futexes, sizeof(*futexv), GFP_KERNEL);
+	if (!futexv) {
+		ret = -ENOMEM;
+		goto destroy_timer;
+	}
+
+	ret = futex_parse_waitv(futexv, waiters, nr_futexes);
+	if (!ret)
+		ret = futex_wait_multiple(futexv, nr_futexes, to);
+
+	kfree(futexv);
+
+destroy_timer:
+	if (to) {
+		hrtimer_cancel(&to->timer);
+		destroy_hrtimer_on_stack(&to->timer);
+	}
+	return ret;
+}
+
 
 /*
  * Userspace tried a 0 -> TID atomic transition of the futex value
@@ -3605,6 +3997,44 @@ SYSCALL_DEFINE6(futex, u32 __user *, uaddr, int, op, u32, val,
 	return do_futex(uaddr, op, val, tp, uaddr2, val2, val3);
 }
 
+/**
+ * sys_futex_waitv - Wait on a list of futexes
+ * @waiters:	List of futexes to wait on
+ * @nr_futexes:	Length of futexv
+ * @flags:	Reserved for future use, must be 0
+ * @timeout:	Optional absolute timeout
+ * @clockid:	Clock to be used for the timeout, realtime or monotonic
+ *
+ * Given an array of `struct futex_waitv`, wait on each uaddr. The thread wakes
+ * if a futex_wake() is performed at any uaddr. The syscall returns immediately
+ * if any waiter has *uaddr != val. Each waiter has individual flags for the
+ * futex size and for private futexes.
+ *
+ * Returns the array index of one of the woken futexes. No further information
+ * is provided: any number of other futexes may also have been woken by the
+ * same event, and if more than one futex was woken, the returned index may
+ * refer to any one of them.
+ */
+SYSCALL_DEFINE5(futex_waitv, struct futex_waitv __user *, waiters,
+		unsigned int, nr_futexes, unsigned int, flags,
+		struct timespec __user *, timeout, clockid_t, clockid)
+{
+	struct timespec ts;
+	ktime_t t, *tp = NULL;
+
+	if (timeout) {
+		if (copy_from_user(&ts, timeout, sizeof(ts)) != 0)
+			return -EFAULT;
+		if (!timespec_valid(&ts))
+			return -EINVAL;
+
+		t = timespec_to_ktime(ts);
+		tp = &t;
+	}
+
+	return do_futex_waitv(waiters, nr_futexes, flags, tp, clockid);
+}
+
 static void __init futex_detect_cmpxchg(void)
 {
 #ifndef CONFIG_HAVE_FUTEX_CMPXCHG
@@ -3645,11 +4075,8 @@ static int __init futex_init(void)
 
 	futex_detect_cmpxchg();
 
-	for (i = 0; i < futex_hashsize; i++) {
-		atomic_set(&futex_queues[i].waiters, 0);
-		plist_head_init(&futex_queues[i].chain);
-		spin_lock_init(&futex_queues[i].lock);
-	}
+	for (i = 0; i < futex_hashsize; i++)
+		futex_hash_bucket_init(&futex_queues[i]);
 
 	return 0;
 }
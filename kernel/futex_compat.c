@@ -200,3 +200,23 @@ COMPAT_SYSCALL_DEFINE6(futex, u32 __user *, uaddr, int, op, u32, val,
 
 	return do_futex(uaddr, op, val, tp, uaddr2, val2, val3);
 }
+
+COMPAT_SYSCALL_DEFINE5(futex_waitv, struct futex_waitv __user *, waiters,
+		unsigned int, nr_futexes, unsigned int, flags,
+		struct compat_timespec __user *, timeout, clockid_t, clockid)
+{
+	struct timespec ts;
+	ktime_t t, *tp = NULL;
+
+	if (timeout) {
+		if (compat_get_timespec(&ts, timeout))
+			return -EFAULT;
+		if (!timespec_valid(&ts))
+			return -EINVAL;
+
+		t = timespec_to_ktime(ts);
+		tp = &t;
+	}
+
+	return do_futex_waitv(waiters, nr_futexes, flags, tp, clockid);
+}
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Per-cpu counters for events of interest in the locking slowpaths.
+ *
+ * When CONFIG_LOCK_EVENT_COUNTS is enabled, the counters listed in
+ * lock_events_list.h are reported in <debugfs>/lock_event_counts/.
+ * Otherwise lockevent_inc() and friends compile away.
+ */
+#ifndef __LOCKING_LOCK_EVENTS_H
+#define __LOCKING_LOCK_EVENTS_H
+
+enum lock_events {
+
+#include "lock_events_list.h"
+
+	lockevent_num,	/* Total number of lock event counts */
+	LOCKEVENT_reset_cnts = lockevent_num,
+};
+
+#ifdef CONFIG_LOCK_EVENT_COUNTS
+#include <linux/percpu.h>
+
+DECLARE_PER_CPU(unsigned long, lockevents[lockevent_num]);
+
+/*
+ * The counters are only statistics, so a lost update from migrating
+ * between the load and the store does not matter and raw_cpu_inc()
+ * keeps the slowpaths free of preemption toggling.
+ */
+static inline void __lockevent_inc(enum lock_events event, bool cond)
+{
+	if (cond)
+		raw_cpu_inc(lockevents[event]);
+}
+
+#define lockevent_inc(ev)	  __lockevent_inc(LOCKEVENT_ ##ev, true)
+#define lockevent_cond_inc(ev, c) __lockevent_inc(LOCKEVENT_ ##ev, c)
+
+#else  /* CONFIG_LOCK_EVENT_COUNTS */
+
+#define lockevent_inc(ev)
+#define lockevent_cond_inc(ev, c)
+
+#endif /* CONFIG_LOCK_EVENT_COUNTS */
+#endif /* __LOCKING_LOCK_EVENTS_H */
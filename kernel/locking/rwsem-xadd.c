@@ -20,6 +20,7 @@
 #include <linux/osq_lock.h>
 
 #include "rwsem.h"
+#include "lock_events.h"
 
 /*
  * Guide to the rw_semaphore's count field for common values.
@@ -68,7 +69,59 @@
  *	 are only waiters but none active (5th case above), and attempt to
  *	 steal the lock.
  *
+ * Lock handoff:
+ *	 A writer at the head of the wait queue that has been waiting for
+ *	 more than RWSEM_WAIT_TIMEOUT adds RWSEM_HANDOFF_BIAS, which is a
+ *	 second WAITING_BIAS, to the count. With it, the count of a free
+ *	 lock becomes RWSEM_HANDOFF_WAITING (2 * WAITING_BIAS, that is
+ *	 0xfffe0000 with a 32-bit count and 0xfffffffe00000000 with a 64-bit
+ *	 one such as arm64's) instead of WAITING_BIAS, so optimistic
+ *	 spinners and newly queued writers can no longer steal the lock and
+ *	 the next release goes to that writer, which removes the extra bias
+ *	 when it takes the lock.
+ *
+ */
+
+#define RWSEM_HANDOFF_BIAS	RWSEM_WAITING_BIAS
+#define RWSEM_HANDOFF_WAITING	(RWSEM_WAITING_BIAS + RWSEM_HANDOFF_BIAS)
+
+/*
+ * Minimum time a writer waits at the head of the queue before it asks
+ * for the lock to be handed off to it.
  */
+#define RWSEM_WAIT_TIMEOUT	DIV_ROUND_UP(HZ, 250)
+
+/*
+ * The handoff encoding, worked out for a given RWSEM_ACTIVE_MASK and
+ * checked below for both count layouts in use: a 16-bit active mask in a
+ * 32-bit count and a 32-bit active mask in a 64-bit one (arm64).
+ */
+#define __RWSEM_WAITING_BIAS(mask)	(-(s64)(mask) - 1)
+#define __RWSEM_HANDOFF_WAITING(mask)	(2 * __RWSEM_WAITING_BIAS(mask))
+
+#define rwsem_check_handoff_encoding(mask, count_min)			\
+do {									\
+	/* No active lockers: spinners and stealers see a free lock */	\
+	BUILD_BUG_ON(__RWSEM_HANDOFF_WAITING(mask) & (mask));		\
+	/* Can't be confused with the waiting bias plus active lockers */ \
+	BUILD_BUG_ON(__RWSEM_HANDOFF_WAITING(mask) + (mask) >=		\
+		     __RWSEM_WAITING_BIAS(mask));				\
+	/* A writer's transient ACTIVE_WRITE_BIAS on top doesn't wrap */	\
+	BUILD_BUG_ON(__RWSEM_HANDOFF_WAITING(mask) +			\
+		     __RWSEM_WAITING_BIAS(mask) + 1 < (count_min));		\
+} while (0)
+
+static inline void rwsem_check_handoff(void)
+{
+	rwsem_check_handoff_encoding(0x0000ffffL, (s64)S32_MIN);
+	rwsem_check_handoff_encoding(0xffffffffLL, S64_MIN);
+
+	/* ...and the encoding this kernel uses is the one checked */
+	BUILD_BUG_ON(RWSEM_ACTIVE_MASK != 0x0000ffffL &&
+		     RWSEM_ACTIVE_MASK != 0xffffffffLL);
+	BUILD_BUG_ON(RWSEM_HANDOFF_WAITING !=
+		     __RWSEM_HANDOFF_WAITING(RWSEM_ACTIVE_MASK));
+}
 
 /*
  * Initialize an rwsem:
@@ -76,6 +129,8 @@
 void __init_rwsem(struct rw_semaphore *sem, const char *name,
 		  struct lock_class_key *key)
 {
+	rwsem_check_handoff();
+
 #ifdef CONFIG_DEBUG_LOCK_ALLOC
 	/*
 	 * Make sure we are not reinitializing a held semaphore:
@@ -103,6 +158,8 @@ struct rwsem_waiter {
 	struct list_head list;
 	struct task_struct *task;
 	enum rwsem_waiter_type type;
+	unsigned long timeout;
+	bool handoff_set;
 };
 
 enum rwsem_wake_type {
@@ -219,6 +276,9 @@ static void __rwsem_mark_wake(struct rw_semaphore *sem,
 		atomic_long_add(adjustment, &sem->count);
 }
 
+static bool rwsem_optimistic_spin(struct rw_semaphore *sem, bool wlock);
+static inline bool rwsem_reader_can_spin(struct rw_semaphore *sem);
+
 /*
  * Wait for the read lock to be granted
  */
@@ -226,15 +286,31 @@ static inline struct rw_semaphore __sched *
 __rwsem_down_read_failed_common(struct rw_semaphore *sem, int state)
 {
 	long count, adjustment = -RWSEM_ACTIVE_READ_BIAS;
+	bool first = false;
 	struct rwsem_waiter waiter;
 	DEFINE_WAKE_Q(wake_q);
 
+	/*
+	 * If the lock is held by a running writer and nobody is queued,
+	 * spin until the writer releases it rather than going to sleep.
+	 * Our read bias is dropped first, any wakeup it may have hidden
+	 * from an unlocker is done below if we end up queueing.
+	 */
+	if (rwsem_reader_can_spin(sem)) {
+		atomic_long_add(-RWSEM_ACTIVE_READ_BIAS, &sem->count);
+		adjustment = 0;
+		if (rwsem_optimistic_spin(sem, false))
+			return sem;
+	}
+
 	waiter.task = current;
 	waiter.type = RWSEM_WAITING_FOR_READ;
 
 	raw_spin_lock_irq(&sem->wait_lock);
-	if (list_empty(&sem->wait_list))
+	if (list_empty(&sem->wait_list)) {
 		adjustment += RWSEM_WAITING_BIAS;
+		first = true;
+	}
 	list_add_tail(&waiter.list, &sem->wait_list);
 
 	/* we're now waiting on the lock, but no longer actively locking */
@@ -246,13 +322,13 @@ __rwsem_down_read_failed_common(struct rw_semaphore *sem, int state)
 	 * If there are no writers and we are first in the queue,
 	 * wake our own waiter to join the existing active readers !
 	 */
-	if (count == RWSEM_WAITING_BIAS ||
-	    (count > RWSEM_WAITING_BIAS &&
-	     adjustment != -RWSEM_ACTIVE_READ_BIAS))
+	if (count == RWSEM_WAITING_BIAS || count == RWSEM_HANDOFF_WAITING ||
+	    (count > RWSEM_WAITING_BIAS && first))
 		__rwsem_mark_wake(sem, RWSEM_WAKE_ANY, &wake_q);
 
 	raw_spin_unlock_irq(&sem->wait_lock);
 	wake_up_q(&wake_q);
+	lockevent_inc(rwsem_sleep_reader);
 
 	/* wait to be given the lock */
 	while (true) {
@@ -298,25 +374,45 @@ EXPORT_SYMBOL(rwsem_down_read_failed_killable);
  * This function must be called with the sem->wait_lock held to prevent
  * race conditions between checking the rwsem wait list and setting the
  * sem->count accordingly.
+ *
+ * A writer that has been waiting at the head of the queue for too long
+ * sets the handoff bias here, the lock is then free for it only at
+ * RWSEM_HANDOFF_WAITING.
  */
-static inline bool rwsem_try_write_lock(long count, struct rw_semaphore *sem)
+static inline bool rwsem_try_write_lock(long count, struct rw_semaphore *sem,
+					struct rwsem_waiter *waiter)
 {
+	long expected, locked;
+
+	if (!waiter->handoff_set && time_after(jiffies, waiter->timeout) &&
+	    list_first_entry(&sem->wait_list, struct rwsem_waiter,
+			     list) == waiter) {
+		count = atomic_long_add_return(RWSEM_HANDOFF_BIAS,
+					       &sem->count);
+		waiter->handoff_set = true;
+		lockevent_inc(rwsem_wlock_handoff);
+	}
+
+	expected = waiter->handoff_set ? RWSEM_HANDOFF_WAITING :
+					 RWSEM_WAITING_BIAS;
+
 	/*
-	 * Avoid trying to acquire write lock if count isn't RWSEM_WAITING_BIAS.
+	 * Avoid trying to acquire write lock if there are active lockers.
 	 */
-	if (count != RWSEM_WAITING_BIAS)
+	if (count != expected)
 		return false;
 
 	/*
 	 * Acquire the lock by trying to set it to ACTIVE_WRITE_BIAS. If there
 	 * are other tasks on the wait list, we need to add on WAITING_BIAS.
+	 * This also drops the handoff bias, if any.
 	 */
-	count = list_is_singular(&sem->wait_list) ?
+	locked = list_is_singular(&sem->wait_list) ?
 			RWSEM_ACTIVE_WRITE_BIAS :
 			RWSEM_ACTIVE_WRITE_BIAS + RWSEM_WAITING_BIAS;
 
-	if (atomic_long_cmpxchg_acquire(&sem->count, RWSEM_WAITING_BIAS, count)
-							== RWSEM_WAITING_BIAS) {
+	if (atomic_long_cmpxchg_acquire(&sem->count, expected, locked)
+							== expected) {
 		rwsem_set_owner(sem);
 		return true;
 	}
@@ -347,6 +443,41 @@ static inline bool rwsem_try_write_lock_unqueued(struct rw_semaphore *sem)
 	}
 }
 
+/*
+ * Try to acquire read lock before the reader has been put on wait queue.
+ * Only succeeds while there is neither a writer nor a waiter, so that
+ * spinning readers never take the lock away from queued writers.
+ */
+static inline bool rwsem_try_read_lock_unqueued(struct rw_semaphore *sem)
+{
+	long old, count = atomic_long_read(&sem->count);
+
+	while (count >= 0) {
+		old = atomic_long_cmpxchg_acquire(&sem->count, count,
+				      count + RWSEM_ACTIVE_READ_BIAS);
+		if (old == count) {
+			rwsem_set_reader_owned(sem);
+			return true;
+		}
+
+		count = old;
+	}
+
+	return false;
+}
+
+/*
+ * Readers only spin on a writer owner and only while nobody is queued,
+ * as they can't take the lock ahead of waiters anyway.
+ */
+static inline bool rwsem_reader_can_spin(struct rw_semaphore *sem)
+{
+	struct task_struct *owner = READ_ONCE(sem->owner);
+
+	return owner && is_rwsem_owner_spinnable(owner) &&
+	       list_empty(&sem->wait_list);
+}
+
 static inline bool rwsem_can_spin_on_owner(struct rw_semaphore *sem)
 {
 	struct task_struct *owner;
@@ -415,7 +546,7 @@ static noinline bool rwsem_spin_on_owner(struct rw_semaphore *sem)
 	return is_rwsem_owner_spinnable(READ_ONCE(sem->owner));
 }
 
-static bool rwsem_optimistic_spin(struct rw_semaphore *sem)
+static bool rwsem_optimistic_spin(struct rw_semaphore *sem, bool wlock)
 {
 	bool taken = false;
 
@@ -433,17 +564,28 @@ static bool rwsem_optimistic_spin(struct rw_semaphore *sem)
 	 * lock whenever the owner changes. Spinning will be stopped when:
 	 *  1) the owning writer isn't running; or
 	 *  2) readers own the lock as we can't determine if they are
-	 *     actively running or not.
+	 *     actively running or not; or
+	 *  3) the lock is free but has been promised to a waiting writer.
 	 */
 	while (rwsem_spin_on_owner(sem)) {
 		/*
 		 * Try to acquire the lock
 		 */
-		if (rwsem_try_write_lock_unqueued(sem)) {
+		if (wlock ? rwsem_try_write_lock_unqueued(sem) :
+			    rwsem_try_read_lock_unqueued(sem)) {
 			taken = true;
 			break;
 		}
 
+		/*
+		 * Somebody has to wake up the writer the lock is handed off
+		 * to, and a spinning reader can't get ahead of waiters.
+		 */
+		if (atomic_long_read(&sem->count) == RWSEM_HANDOFF_WAITING)
+			break;
+		if (!wlock && !list_empty(&sem->wait_list))
+			break;
+
 		/*
 		 * When there's no owner, we might have preempted between the
 		 * owner acquiring the lock and setting the owner field. If
@@ -461,7 +603,22 @@ static bool rwsem_optimistic_spin(struct rw_semaphore *sem)
 		 */
 		cpu_relax();
 	}
+
+	/*
+	 * A writer handing the lock over to readers stops the spinning on
+	 * its way out, a reader can still join them.
+	 */
+	if (!taken && !wlock)
+		taken = rwsem_try_read_lock_unqueued(sem);
+
 	osq_unlock(&sem->osq);
+
+	if (taken && wlock)
+		lockevent_inc(rwsem_opt_wlock);
+	else if (taken)
+		lockevent_inc(rwsem_opt_rlock);
+	else
+		lockevent_inc(rwsem_opt_fail);
 done:
 	preempt_enable();
 	return taken;
@@ -476,7 +633,12 @@ static inline bool rwsem_has_spinner(struct rw_semaphore *sem)
 }
 
 #else
-static bool rwsem_optimistic_spin(struct rw_semaphore *sem)
+static bool rwsem_optimistic_spin(struct rw_semaphore *sem, bool wlock)
+{
+	return false;
+}
+
+static inline bool rwsem_reader_can_spin(struct rw_semaphore *sem)
 {
 	return false;
 }
@@ -503,7 +665,7 @@ __rwsem_down_write_failed_common(struct rw_semaphore *sem, int state)
 	count = atomic_long_sub_return(RWSEM_ACTIVE_WRITE_BIAS, &sem->count);
 
 	/* do optimistic spinning and steal lock if possible */
-	if (rwsem_optimistic_spin(sem))
+	if (rwsem_optimistic_spin(sem, true))
 		return sem;
 
 	/*
@@ -512,6 +674,8 @@ __rwsem_down_write_failed_common(struct rw_semaphore *sem, int state)
 	 */
 	waiter.task = current;
 	waiter.type = RWSEM_WAITING_FOR_WRITE;
+	waiter.timeout = jiffies + RWSEM_WAIT_TIMEOUT;
+	waiter.handoff_set = false;
 
 	raw_spin_lock_irq(&sem->wait_lock);
 
@@ -545,6 +709,15 @@ __rwsem_down_write_failed_common(struct rw_semaphore *sem, int state)
 			 * Reinitialize wake_q after use.
 			 */
 			wake_q_init(&wake_q);
+		} else if (count == RWSEM_HANDOFF_WAITING) {
+			/*
+			 * The lock is free but handed off to the writer at
+			 * the head of the queue, and our write bias may have
+			 * hidden the release from the unlocker. Wake it up.
+			 */
+			__rwsem_mark_wake(sem, RWSEM_WAKE_ANY, &wake_q);
+			wake_up_q(&wake_q);
+			wake_q_init(&wake_q);
 		}
 
 	} else
@@ -553,18 +726,25 @@ __rwsem_down_write_failed_common(struct rw_semaphore *sem, int state)
 	/* wait until we successfully acquire the lock */
 	set_current_state(state);
 	while (true) {
-		if (rwsem_try_write_lock(count, sem))
+		if (rwsem_try_write_lock(count, sem, &waiter))
 			break;
 		raw_spin_unlock_irq(&sem->wait_lock);
 
-		/* Block until there are no active lockers. */
+		/*
+		 * Block until there are no active lockers, or until we have
+		 * waited long enough to ask for the lock to be handed off.
+		 */
 		do {
 			if (signal_pending_state(state, current))
 				goto out_nolock;
 
 			schedule();
+			lockevent_inc(rwsem_sleep_writer);
 			set_current_state(state);
-		} while ((count = atomic_long_read(&sem->count)) & RWSEM_ACTIVE_MASK);
+			count = atomic_long_read(&sem->count);
+		} while ((count & RWSEM_ACTIVE_MASK) &&
+			 (waiter.handoff_set ||
+			  !time_after(jiffies, waiter.timeout)));
 
 		raw_spin_lock_irq(&sem->wait_lock);
 	}
@@ -578,6 +758,8 @@ out_nolock:
 	__set_current_state(TASK_RUNNING);
 	raw_spin_lock_irq(&sem->wait_lock);
 	list_del(&waiter.list);
+	if (waiter.handoff_set)
+		atomic_long_add(-RWSEM_HANDOFF_BIAS, &sem->count);
 	if (list_empty(&sem->wait_list))
 		atomic_long_add(-RWSEM_WAITING_BIAS, &sem->count);
 	else
@@ -299,24 +299,6 @@ int unregister_module_notifier(struct notifier_block *nb)
 }
 EXPORT_SYMBOL(unregister_module_notifier);
 
-struct load_info {
-	const char *name;
-	Elf_Ehdr *hdr;
-	unsigned long len;
-	Elf_Shdr *sechdrs;
-	char *secstrings, *strtab;
-	unsigned long symoffs, stroffs;
-	struct _ddebug *debug;
-	unsigned int num_debug;
-	bool sig_ok;
-#ifdef CONFIG_KALLSYMS
-	unsigned long mod_kallsyms_init_off;
-#endif
-	struct {
-		unsigned int sym, str, mod, vers, info, pcpu;
-	} index;
-};
-
 /*
  * We require a truly strong try_module_get(): 0 means success.
  * Otherwise an error is returned due to ongoing or failed
@@ -2894,6 +2876,12 @@ static int copy_module_from_user(const void __user *umod, unsigned long len,
 
 static void free_copy(struct load_info *info)
 {
+#ifdef CONFIG_MODULE_DECOMPRESS
+	if (info->pages) {
+		module_decompress_cleanup(info);
+		return;
+	}
+#endif
 	vfree(info->hdr);
 }
 
@@ -3863,15 +3851,24 @@ SYSCALL_DEFINE3(finit_module, int, fd, const char __user *, uargs, int, flags)
 	pr_debug("finit_module: fd=%d, uargs=%p, flags=%i\n", fd, uargs, flags);
 
 	if (flags & ~(MODULE_INIT_IGNORE_MODVERSIONS
-		      |MODULE_INIT_IGNORE_VERMAGIC))
+		      |MODULE_INIT_IGNORE_VERMAGIC
+		      |MODULE_INIT_COMPRESSED_FILE))
 		return -EINVAL;
 
 	err = kernel_read_file_from_fd(fd, &hdr, &size, INT_MAX,
 				       READING_MODULE);
 	if (err)
 		return err;
-	info.hdr = hdr;
-	info.len = size;
+
+	if (flags & MODULE_INIT_COMPRESSED_FILE) {
+		err = module_decompress(&info, hdr, size);
+		vfree(hdr); /* compressed data is no longer needed */
+		if (err)
+			return err;
+	} else {
+		info.hdr = hdr;
+		info.len = size;
+	}
 
 	return load_module(&info, uargs, flags);
 }
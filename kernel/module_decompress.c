@@ -0,0 +1,400 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * In-kernel decompression of compressed kernel modules
+ *
+ * finit_module() called with MODULE_INIT_COMPRESSED_FILE hands us the
+ * compressed file contents.  The module image is decompressed straight
+ * into freshly allocated pages, which are then mapped contiguously so
+ * that load_module() can work on them as on a vmalloc'ed copy.
+ */
+
+#define pr_fmt(fmt) "module: " fmt
+
+#include <linux/highmem.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/sysfs.h>
+#include <linux/vmalloc.h>
+#include <linux/xz.h>
+#include <linux/zlib.h>
+#include <linux/zstd.h>
+
+#include "module-internal.h"
+
+static int module_extend_max_pages(struct load_info *info, unsigned int extent)
+{
+	struct page **new_pages;
+
+	new_pages = kvmalloc_array(info->max_pages + extent,
+				   sizeof(*info->pages), GFP_KERNEL);
+	if (!new_pages)
+		return -ENOMEM;
+
+	if (info->pages)
+		memcpy(new_pages, info->pages,
+		       info->max_pages * sizeof(*info->pages));
+	kvfree(info->pages);
+	info->pages = new_pages;
+	info->max_pages += extent;
+
+	return 0;
+}
+
+static struct page *module_get_next_page(struct load_info *info)
+{
+	struct page *page;
+	int error;
+
+	if (info->max_pages == info->used_pages) {
+		error = module_extend_max_pages(info, info->used_pages);
+		if (error)
+			return ERR_PTR(error);
+	}
+
+	page = alloc_page(GFP_KERNEL | __GFP_HIGHMEM);
+	if (!page)
+		return ERR_PTR(-ENOMEM);
+
+	info->pages[info->used_pages++] = page;
+	return page;
+}
+
+#ifdef CONFIG_ZLIB_INFLATE
+static const u8 module_gzip_magic[] = { 0x1f, 0x8b, 0x08 };
+
+/*
+ * Skip the gzip member header (RFC 1952), so that the payload can be fed
+ * to zlib as a raw deflate stream.  Returns 0 if the header is malformed.
+ */
+static size_t module_gzip_header_len(const u8 *buf, size_t size)
+{
+	size_t len = 10;
+
+	if (size < len || memcmp(buf, module_gzip_magic,
+				 sizeof(module_gzip_magic)))
+		return 0;
+
+	if (buf[3] & 0x08) {
+		/* Skip the original file name (FNAME). */
+		do {
+			if (len == size)
+				return 0;
+		} while (buf[len++] != '\0');
+	}
+
+	return len;
+}
+
+static ssize_t module_gzip_decompress(struct load_info *info,
+				      const void *buf, size_t size)
+{
+	struct z_stream_s s = { 0 };
+	size_t new_size = 0;
+	size_t gzip_hdr_len;
+	ssize_t retval;
+	int rc;
+
+	gzip_hdr_len = module_gzip_header_len(buf, size);
+	if (!gzip_hdr_len) {
+		pr_err("not a gzip compressed module\n");
+		return -EINVAL;
+	}
+
+	s.next_in = buf + gzip_hdr_len;
+	s.avail_in = size - gzip_hdr_len;
+
+	s.workspace = vmalloc(zlib_inflate_workspacesize());
+	if (!s.workspace)
+		return -ENOMEM;
+
+	rc = zlib_inflateInit2(&s, -MAX_WBITS);
+	if (rc != Z_OK) {
+		pr_err("failed to initialize decompressor: %d\n", rc);
+		retval = -EINVAL;
+		goto out;
+	}
+
+	do {
+		struct page *page = module_get_next_page(info);
+
+		if (IS_ERR(page)) {
+			retval = PTR_ERR(page);
+			goto out_inflate_end;
+		}
+
+		s.next_out = kmap(page);
+		s.avail_out = PAGE_SIZE;
+		rc = zlib_inflate(&s, 0);
+		kunmap(page);
+
+		new_size += PAGE_SIZE - s.avail_out;
+	} while (rc == Z_OK);
+
+	if (rc != Z_STREAM_END) {
+		pr_err("decompression failed with status %d\n", rc);
+		retval = -EINVAL;
+		goto out_inflate_end;
+	}
+
+	retval = new_size;
+
+out_inflate_end:
+	zlib_inflateEnd(&s);
+out:
+	vfree(s.workspace);
+	return retval;
+}
+#endif
+
+#ifdef CONFIG_XZ_DEC
+static const u8 module_xz_magic[] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+
+static ssize_t module_xz_decompress(struct load_info *info,
+				    const void *buf, size_t size)
+{
+	struct xz_dec *xz_dec;
+	struct xz_buf xz_buf;
+	enum xz_ret xz_ret;
+	size_t new_size = 0;
+	ssize_t retval;
+
+	xz_dec = xz_dec_init(XZ_DYNALLOC, (u32)-1);
+	if (!xz_dec)
+		return -ENOMEM;
+
+	xz_buf.in_size = size;
+	xz_buf.in = buf;
+	xz_buf.in_pos = 0;
+
+	do {
+		struct page *page = module_get_next_page(info);
+
+		if (IS_ERR(page)) {
+			retval = PTR_ERR(page);
+			goto out;
+		}
+
+		xz_buf.out = kmap(page);
+		xz_buf.out_pos = 0;
+		xz_buf.out_size = PAGE_SIZE;
+		xz_ret = xz_dec_run(xz_dec, &xz_buf);
+		kunmap(page);
+
+		new_size += xz_buf.out_pos;
+	} while (xz_buf.out_pos == PAGE_SIZE && xz_ret == XZ_OK);
+
+	if (xz_ret != XZ_STREAM_END) {
+		pr_err("decompression failed with status %d\n", xz_ret);
+		retval = -EINVAL;
+		goto out;
+	}
+
+	retval = new_size;
+
+out:
+	xz_dec_end(xz_dec);
+	return retval;
+}
+#endif
+
+#ifdef CONFIG_ZSTD_DECOMPRESS
+static const u8 module_zstd_magic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+static ssize_t module_zstd_decompress(struct load_info *info,
+				      const void *buf, size_t size)
+{
+	ZSTD_frameParams params;
+	ZSTD_inBuffer zstd_buf;
+	ZSTD_DStream *dstream;
+	size_t new_size = 0;
+	size_t wksp_size;
+	void *wksp = NULL;
+	ssize_t retval;
+	size_t ret;
+
+	ret = ZSTD_getFrameParams(&params, buf, size);
+	if (ret != 0) {
+		pr_err("failed to read zstd frame header\n");
+		return -EINVAL;
+	}
+
+	wksp_size = ZSTD_DStreamWorkspaceBound(params.windowSize);
+	wksp = vmalloc(wksp_size);
+	if (!wksp)
+		return -ENOMEM;
+
+	dstream = ZSTD_initDStream(params.windowSize, wksp, wksp_size);
+	if (!dstream) {
+		pr_err("can't initialize zstd stream\n");
+		retval = -ENOMEM;
+		goto out;
+	}
+
+	zstd_buf.src = buf;
+	zstd_buf.pos = 0;
+	zstd_buf.size = size;
+
+	for (;;) {
+		struct page *page = module_get_next_page(info);
+		ZSTD_outBuffer zstd_dec;
+
+		if (IS_ERR(page)) {
+			retval = PTR_ERR(page);
+			goto out;
+		}
+
+		zstd_dec.dst = kmap(page);
+		zstd_dec.pos = 0;
+		zstd_dec.size = PAGE_SIZE;
+
+		ret = ZSTD_decompressStream(dstream, &zstd_dec, &zstd_buf);
+		kunmap(page);
+		if (ZSTD_isError(ret)) {
+			pr_err("ZSTD-compressed data is corrupt\n");
+			retval = -EINVAL;
+			goto out;
+		}
+
+		new_size += zstd_dec.pos;
+		if (!ret)
+			break;
+
+		if (zstd_buf.pos == zstd_buf.size && zstd_dec.pos < PAGE_SIZE) {
+			pr_err("ZSTD-compressed data is truncated\n");
+			retval = -EINVAL;
+			goto out;
+		}
+	}
+
+	retval = new_size;
+
+out:
+	vfree(wksp);
+	return retval;
+}
+#endif
+
+static const struct module_decompressor {
+	const char *name;
+	const u8 *magic;
+	size_t magic_len;
+	ssize_t (*decompress)(struct load_info *info, const void *buf,
+			      size_t size);
+} module_decompressors[] = {
+#ifdef CONFIG_ZLIB_INFLATE
+	{ "gzip", module_gzip_magic, sizeof(module_gzip_magic),
+	  module_gzip_decompress },
+#endif
+#ifdef CONFIG_XZ_DEC
+	{ "xz", module_xz_magic, sizeof(module_xz_magic),
+	  module_xz_decompress },
+#endif
+#ifdef CONFIG_ZSTD_DECOMPRESS
+	{ "zstd", module_zstd_magic, sizeof(module_zstd_magic),
+	  module_zstd_decompress },
+#endif
+};
+
+int module_decompress(struct load_info *info, const void *buf, size_t size)
+{
+	const struct module_decompressor *d = NULL;
+	unsigned int n_pages;
+	ssize_t data_size;
+	int error;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(module_decompressors); i++) {
+		if (size >= module_decompressors[i].magic_len &&
+		    !memcmp(buf, module_decompressors[i].magic,
+			    module_decompressors[i].magic_len)) {
+			d = &module_decompressors[i];
+			break;
+		}
+	}
+	if (!d) {
+		pr_err("unsupported module compression format\n");
+		return -EOPNOTSUPP;
+	}
+
+	/*
+	 * Start with number of pages twice as big as needed for
+	 * compressed data.
+	 */
+	n_pages = DIV_ROUND_UP(size, PAGE_SIZE) * 2;
+	error = module_extend_max_pages(info, n_pages);
+	if (error)
+		goto err;
+
+	data_size = d->decompress(info, buf, size);
+	if (data_size < 0) {
+		error = data_size;
+		goto err;
+	}
+
+	info->hdr = vmap(info->pages, info->used_pages, VM_MAP, PAGE_KERNEL);
+	if (!info->hdr) {
+		error = -ENOMEM;
+		goto err;
+	}
+
+	info->len = data_size;
+	return 0;
+
+err:
+	module_decompress_cleanup(info);
+	return error;
+}
+
+void module_decompress_cleanup(struct load_info *info)
+{
+	int i;
+
+	if (info->hdr)
+		vunmap(info->hdr);
+
+	for (i = 0; i < info->used_pages; i++)
+		__free_page(info->pages[i]);
+
+	kvfree(info->pages);
+
+	info->pages = NULL;
+	info->max_pages = info->used_pages = 0;
+}
+
+#ifdef CONFIG_SYSFS
+/*
+ * /sys/module/compression lists the formats finit_module() accepts with
+ * MODULE_INIT_COMPRESSED_FILE, so that user space knows it can pass the
+ * compressed file directly.
+ */
+static ssize_t compression_show(struct kobject *kobj,
+				struct kobj_attribute *attr, char *buf)
+{
+	ssize_t len = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(module_decompressors); i++)
+		len += sprintf(buf + len, "%s%s", i ? " " : "",
+			       module_decompressors[i].name);
+	len += sprintf(buf + len, "\n");
+
+	return len;
+}
+static struct kobj_attribute module_compression_attr = __ATTR_RO(compression);
+
+static int __init module_decompress_sysfs_init(void)
+{
+	int error;
+
+	error = sysfs_create_file(&module_kset->kobj,
+				  &module_compression_attr.attr);
+	if (error)
+		pr_warn("Failed to create 'compression' attribute");
+
+	return 0;
+}
+late_initcall(module_decompress_sysfs_init);
+#endif
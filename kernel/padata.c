@@ -20,6 +20,7 @@
  * 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <linux/completion.h>
 #include <linux/export.h>
 #include <linux/cpumask.h>
 #include <linux/err.h>
@@ -28,12 +29,19 @@
 #include <linux/mutex.h>
 #include <linux/sched.h>
 #include <linux/slab.h>
+#include <linux/topology.h>
 #include <linux/sysfs.h>
 #include <linux/rcupdate.h>
 #include <linux/module.h>
 
 #define MAX_OBJ_NUM 1000
 
+/*
+ * Number of chunks each thread of a multithreaded job gets on average,
+ * so that threads finishing early pick up the work of slower ones.
+ */
+#define PADATA_MT_LOAD_BALANCE_FACTOR 4
+
 static int padata_index_to_cpu(struct parallel_data *pd, int cpu_index)
 {
 	int cpu, target_cpu;
@@ -1022,6 +1030,153 @@ void padata_free(struct padata_instance *pinst)
 }
 EXPORT_SYMBOL(padata_free);
 
+struct padata_mt_job_state {
+	spinlock_t		lock;
+	struct completion	completion;
+	struct padata_mt_job	*job;
+	int			nworks;
+	int			nworks_fini;
+	unsigned long		chunk_size;
+};
+
+struct padata_mt_work {
+	struct work_struct		work;
+	struct padata_mt_job_state	*state;
+};
+
+static void __init padata_mt_helper(struct work_struct *w)
+{
+	struct padata_mt_work *pw = container_of(w, struct padata_mt_work,
+						 work);
+	struct padata_mt_job_state *ps = pw->state;
+	struct padata_mt_job *job = ps->job;
+	bool done;
+
+	spin_lock(&ps->lock);
+
+	while (job->size > 0) {
+		unsigned long start, size, end;
+
+		start = job->start;
+		/* So end is chunk size aligned if enough work remains. */
+		size = roundup(start + 1, ps->chunk_size) - start;
+		size = min(size, job->size);
+		end = start + size;
+
+		job->start = end;
+		job->size -= size;
+
+		spin_unlock(&ps->lock);
+		job->thread_fn(start, end, job->fn_arg);
+		spin_lock(&ps->lock);
+	}
+
+	++ps->nworks_fini;
+	done = (ps->nworks_fini == ps->nworks);
+	spin_unlock(&ps->lock);
+
+	if (done)
+		complete(&ps->completion);
+}
+
+/*
+ * Pick the CPU to queue the next helper on, going round the online CPUs of
+ * @node after @cpu.  An unbound work item only runs within the affinity
+ * scope pod of the CPU it is queued on, which may be as small as a cache
+ * domain, so queueing every helper locally would leave the other pods of
+ * the node idle.  Returns nr_cpu_ids if @node has no online CPU.
+ */
+static int __init padata_mt_next_cpu(int cpu, int node)
+{
+	const struct cpumask *node_cpus = cpumask_of_node(node);
+
+	cpu = cpumask_next_and(cpu, node_cpus, cpu_online_mask);
+	if (cpu >= nr_cpu_ids)
+		cpu = cpumask_first_and(node_cpus, cpu_online_mask);
+
+	return cpu;
+}
+
+/**
+ * padata_do_multithreaded - run a multithreaded job
+ *
+ * @job: Description of the job.
+ *
+ * The range [job->start, job->start + job->size) is split into chunks
+ * which are handed out to up to job->max_threads threads, the caller
+ * being one of them. Helper threads are unbound workqueue workers spread
+ * over the CPUs of the calling CPU's NUMA node. Returns once the whole
+ * range has been processed. Only usable at boot, before __init memory
+ * is freed.
+ *
+ * Return: the number of threads that worked on the job.
+ */
+int __init padata_do_multithreaded(struct padata_mt_job *job)
+{
+	struct padata_mt_job_state ps;
+	struct padata_mt_work my_work, *works = NULL;
+	unsigned long nworks;
+	int i, cpu, node;
+
+	if (!job->size)
+		return 0;
+
+	/* Ensure at least one thread when size < min_chunk. */
+	nworks = max(job->size / job->min_chunk, 1UL);
+	nworks = min(nworks, (unsigned long)job->max_threads);
+
+	if (nworks > 1)
+		works = kcalloc(nworks - 1, sizeof(*works), GFP_KERNEL);
+
+	/* Single thread, no coordination needed, cut to the chase. */
+	if (!works) {
+		job->thread_fn(job->start, job->start + job->size, job->fn_arg);
+		return 1;
+	}
+
+	spin_lock_init(&ps.lock);
+	init_completion(&ps.completion);
+	ps.job = job;
+	ps.nworks = nworks;
+	ps.nworks_fini = 0;
+
+	/*
+	 * Chunk size is the amount of work a helper does per call to the
+	 * thread function. Load balance large jobs between threads by
+	 * increasing the number of chunks, guarantee at least the minimum
+	 * chunk size from the caller, and honor the caller's alignment.
+	 */
+	ps.chunk_size = job->size / (nworks * PADATA_MT_LOAD_BALANCE_FACTOR);
+	ps.chunk_size = max(ps.chunk_size, job->min_chunk);
+	ps.chunk_size = roundup(ps.chunk_size, job->align);
+
+	cpu = raw_smp_processor_id();
+	node = cpu_to_node(cpu);
+
+	for (i = 0; i < nworks - 1; i++) {
+		INIT_WORK(&works[i].work, padata_mt_helper);
+		works[i].state = &ps;
+		cpu = padata_mt_next_cpu(cpu, node);
+		if (cpu < nr_cpu_ids)
+			queue_work_on(cpu, system_unbound_wq, &works[i].work);
+		else
+			queue_work(system_unbound_wq, &works[i].work);
+	}
+
+	/* Use the current thread, which saves starting a workqueue worker. */
+	INIT_WORK_ONSTACK(&my_work.work, padata_mt_helper);
+	my_work.state = &ps;
+	padata_mt_helper(&my_work.work);
+
+	/* Wait for all the helpers to finish. */
+	wait_for_completion(&ps.completion);
+
+	destroy_work_on_stack(&my_work.work);
+	kfree(works);
+
+	return nworks;
+}
+
 #ifdef CONFIG_HOTPLUG_CPU
 
 static __init int padata_driver_init(void)
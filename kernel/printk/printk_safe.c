@@ -26,10 +26,12 @@
 #include "internal.h"
 
 /*
- * printk() could not take logbuf_lock in NMI context. Instead,
- * it uses an alternative implementation that temporary stores
- * the strings into a per-CPU buffer. The content of the buffer
- * is later flushed into the main ring buffer via IRQ work.
+ * printk() stores messages into the lockless ring buffer directly, even
+ * in NMI context. Only a printk() recursion (on the same CPU, in safe
+ * context or while an NMI is already storing a message) uses an
+ * alternative implementation that temporary stores the strings into
+ * a per-CPU buffer. The content of the buffer is later flushed into
+ * the main ring buffer via IRQ work.
  *
  * The alternative implementation is chosen transparently
  * by examinig current printk() context mask stored in @printk_context
@@ -56,6 +58,8 @@ struct printk_safe_seq_buf {
 static DEFINE_PER_CPU(struct printk_safe_seq_buf, safe_print_seq);
 static DEFINE_PER_CPU(int, printk_context);
 
+static DEFINE_RAW_SPINLOCK(safe_read_lock);
+
 #ifdef CONFIG_PRINTK_NMI
 static DEFINE_PER_CPU(struct printk_safe_seq_buf, nmi_print_seq);
 #endif
@@ -194,8 +198,6 @@ static void report_message_lost(struct printk_safe_seq_buf *s)
  */
 static void __printk_safe_flush(struct irq_work *work)
 {
-	static raw_spinlock_t read_lock =
-		__RAW_SPIN_LOCK_INITIALIZER(read_lock);
 	struct printk_safe_seq_buf *s =
 		container_of(work, struct printk_safe_seq_buf, work);
 	unsigned long flags;
@@ -209,7 +211,7 @@ static void __printk_safe_flush(struct irq_work *work)
 	 * different CPUs. This is especially important when printing
 	 * a backtrace.
 	 */
-	raw_spin_lock_irqsave(&read_lock, flags);
+	raw_spin_lock_irqsave(&safe_read_lock, flags);
 
 	i = 0;
 more:
@@ -246,7 +248,7 @@ more:
 
 out:
 	report_message_lost(s);
-	raw_spin_unlock_irqrestore(&read_lock, flags);
+	raw_spin_unlock_irqrestore(&safe_read_lock, flags);
 }
 
 /**
@@ -281,15 +283,17 @@ void printk_safe_flush(void)
 void printk_safe_flush_on_panic(void)
 {
 	/*
-	 * Make sure that we could access the main ring buffer.
-	 * Do not risk a double release when more CPUs are up.
+	 * The main ring buffer is lockless, but a CPU stopped while
+	 * flushing could have left the read lock of the per-CPU
+	 * buffers taken. Do not risk a double release when more
+	 * CPUs are up.
 	 */
-	if (raw_spin_is_locked(&logbuf_lock)) {
+	if (raw_spin_is_locked(&safe_read_lock)) {
 		if (num_online_cpus() > 1)
 			return;
 
 		debug_locks_off();
-		raw_spin_lock_init(&logbuf_lock);
+		raw_spin_lock_init(&safe_read_lock);
 	}
 
 	printk_safe_flush();
@@ -319,27 +323,6 @@ void notrace printk_nmi_exit(void)
 	this_cpu_and(printk_context, ~PRINTK_NMI_CONTEXT_MASK);
 }
 
-/*
- * Marks a code that might produce many messages in NMI context
- * and the risk of losing them is more critical than eventual
- * reordering.
- *
- * It has effect only when called in NMI context. Then printk()
- * will try to store the messages into the main logbuf directly
- * and use the per-CPU buffers only as a fallback when the lock
- * is not available.
- */
-void printk_nmi_direct_enter(void)
-{
-	if (this_cpu_read(printk_context) & PRINTK_NMI_CONTEXT_MASK)
-		this_cpu_or(printk_context, PRINTK_NMI_DIRECT_CONTEXT_MASK);
-}
-
-void printk_nmi_direct_exit(void)
-{
-	this_cpu_and(printk_context, ~PRINTK_NMI_DIRECT_CONTEXT_MASK);
-}
-
 #else
 
 static __printf(1, 0) int vprintk_nmi(const char *fmt, va_list args)
@@ -375,26 +358,30 @@ void __printk_safe_exit(void)
 
 __printf(1, 0) int vprintk_func(const char *fmt, va_list args)
 {
+	int ctx = this_cpu_read(printk_context);
+
 	/*
-	 * Try to use the main logbuf even in NMI. But avoid calling console
-	 * drivers that might have their own locks.
+	 * The main ring buffer is lockless, use it even in NMI. But avoid
+	 * calling console drivers that might have their own locks. Only
+	 * a recursion from within the store itself needs the extra buffer.
 	 */
-	if ((this_cpu_read(printk_context) & PRINTK_NMI_DIRECT_CONTEXT_MASK) &&
-	    raw_spin_trylock(&logbuf_lock)) {
+	if ((ctx & PRINTK_NMI_CONTEXT_MASK) &&
+	    !(ctx & PRINTK_NMI_STORE_CONTEXT_MASK)) {
 		int len;
 
+		this_cpu_or(printk_context, PRINTK_NMI_STORE_CONTEXT_MASK);
 		len = vprintk_store(0, LOGLEVEL_DEFAULT, NULL, 0, fmt, args);
-		raw_spin_unlock(&logbuf_lock);
+		this_cpu_and(printk_context, ~PRINTK_NMI_STORE_CONTEXT_MASK);
 		defer_console_output();
 		return len;
 	}
 
-	/* Use extra buffer in NMI when logbuf_lock is taken or in safe mode. */
-	if (this_cpu_read(printk_context) & PRINTK_NMI_CONTEXT_MASK)
+	/* Use extra buffer for a printk() recursion in NMI. */
+	if (ctx & PRINTK_NMI_CONTEXT_MASK)
 		return vprintk_nmi(fmt, args);
 
 	/* Use extra buffer to prevent a recursion deadlock in safe mode. */
-	if (this_cpu_read(printk_context) & PRINTK_SAFE_CONTEXT_MASK)
+	if (ctx & PRINTK_SAFE_CONTEXT_MASK)
 		return vprintk_safe(fmt, args);
 
 	/* No obstacles. */
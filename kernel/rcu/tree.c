@@ -3152,10 +3152,11 @@ EXPORT_SYMBOL_GPL(call_rcu_bh);
 
 /*
  * Queue an RCU callback for lazy invocation after a grace period.
- * This will likely be later named something like "call_rcu_lazy()",
- * but this change will require some way of tagging the lazy RCU
- * callbacks in the list of pending callbacks. Until then, this
- * function may only be called from __kfree_rcu().
+ * This function may only be called from __kfree_rcu(); other callers
+ * wanting lazy invocation should use call_rcu_lazy().  "Lazy" here only
+ * affects the accounting of idle CPUs: unlike those of call_rcu_lazy(),
+ * these callbacks are not batched on no-CBs CPUs, as holding back every
+ * kfree_rcu() for seconds could keep a lot of memory allocated.
  */
 void kfree_call_rcu(struct rcu_head *head,
 		    rcu_callback_t func)
@@ -3164,6 +3165,32 @@ void kfree_call_rcu(struct rcu_head *head,
 }
 EXPORT_SYMBOL_GPL(kfree_call_rcu);
 
+#ifdef CONFIG_RCU_LAZY
+/**
+ * call_rcu_lazy() - Queue an RCU callback that is in no hurry to run.
+ * @head: structure to be used for queueing the RCU updates.
+ * @func: actual callback function to be invoked after the grace period
+ *
+ * This is call_rcu() for callbacks whose invocation may be put off for
+ * several seconds, typically because all they do is free memory.  On
+ * no-CBs CPUs such callbacks are batched rather than immediately waking
+ * the rcuo kthread and starting a grace period, which saves wakeups
+ * and therefore energy on idle or lightly loaded systems.  The batch
+ * is flushed after rcutree.jiffies_till_flush, once rcutree.qhimark
+ * callbacks have accumulated, when a non-lazy callback is queued behind
+ * it (so that synchronize_rcu() and rcu_barrier() are not delayed), or
+ * under memory pressure.
+ *
+ * Callers must not rely on the callback running promptly.  Otherwise
+ * the guarantees are those of call_rcu().
+ */
+void call_rcu_lazy(struct rcu_head *head, rcu_callback_t func)
+{
+	__call_rcu(head, func, rcu_state_p, -1, 1);
+}
+EXPORT_SYMBOL_GPL(call_rcu_lazy);
+#endif /* #ifdef CONFIG_RCU_LAZY */
+
 /*
  * Because a context switch is a grace period for RCU-sched and RCU-bh,
  * any blocking grace-period wait automatically implies a grace period
@@ -269,6 +269,10 @@ struct rcu_data {
 	raw_spinlock_t nocb_lock;	/* Guard following pair of fields. */
 	int nocb_defer_wakeup;		/* Defer wakeup of nocb_kthread. */
 	struct timer_list nocb_timer;	/* Enforce finite deferral. */
+#ifdef CONFIG_RCU_LAZY
+	atomic_long_t nocb_lazy_len;	/* # lazy CBs not yet announced. */
+	struct timer_list nocb_lazy_timer; /* Bound lazy CB batching. */
+#endif /* #ifdef CONFIG_RCU_LAZY */
 
 	/* The following fields are used by the leader, hence own cacheline. */
 	struct rcu_head *nocb_gp_head ____cacheline_internodealigned_in_smp;
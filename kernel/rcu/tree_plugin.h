@@ -27,6 +27,7 @@
 #include <linux/delay.h>
 #include <linux/gfp.h>
 #include <linux/oom.h>
+#include <linux/shrinker.h>
 #include <linux/sched/debug.h>
 #include <linux/smpboot.h>
 #include <uapi/linux/sched/types.h>
@@ -1869,6 +1870,152 @@ static void wake_nocb_leader_defer(struct rcu_data *rdp, int waketype,
 	raw_spin_unlock_irqrestore(&rdp->nocb_lock, flags);
 }
 
+#ifdef CONFIG_RCU_LAZY
+
+/*
+ * Lazy callbacks, those queued with call_rcu_lazy() but not the ones
+ * from kfree_rcu(), do not wake the rcuo kthread right away when queued
+ * onto an empty no-CBs list.  Instead they are batched until
+ * jiffies_till_flush has elapsed, until qhimark of them have piled up,
+ * until a non-lazy callback is queued behind them, or until the shrinker
+ * asks for the memory they hold.  This avoids starting a grace period (and waking
+ * the grace-period and rcuo kthreads) for each of the trickle of
+ * callbacks an otherwise idle system generates.
+ */
+static ulong jiffies_till_flush = 10 * HZ;
+module_param(jiffies_till_flush, ulong, 0644);
+
+/*
+ * Claim the deferred wakeup owed for this CPU's lazy callbacks, if any.
+ * Returns the number of lazy callbacks that were waiting on it.
+ */
+static long rcu_nocb_lazy_claim(struct rcu_data *rdp)
+{
+	if (!atomic_long_read(&rdp->nocb_lazy_len))
+		return 0;
+	return atomic_long_xchg(&rdp->nocb_lazy_len, 0);
+}
+
+/*
+ * Account for callbacks just enqueued onto the no-CBs list, lazy if they
+ * all came from call_rcu_lazy().  Returns true if the wakeup of the rcuo
+ * kthread should be deferred, and sets *flush if a wakeup owed for
+ * earlier lazy callbacks must be done now.
+ */
+static bool rcu_nocb_lazy_enqueue(struct rcu_data *rdp, bool was_empty,
+				  int rhcount, bool lazy, bool *flush)
+{
+	unsigned long flags;
+	long len;
+
+	*flush = false;
+	if (!lazy) {
+		/* Non-lazy callbacks take any lazy ones along with them. */
+		*flush = rcu_nocb_lazy_claim(rdp);
+		return false;
+	}
+
+	if (was_empty) {
+		atomic_long_set(&rdp->nocb_lazy_len, rhcount);
+		raw_spin_lock_irqsave(&rdp->nocb_lock, flags);
+		if (!timer_pending(&rdp->nocb_lazy_timer))
+			mod_timer(&rdp->nocb_lazy_timer,
+				  jiffies + READ_ONCE(jiffies_till_flush));
+		raw_spin_unlock_irqrestore(&rdp->nocb_lock, flags);
+		trace_rcu_nocb_wake(rdp->rsp->name, rdp->cpu,
+				    TPS("WakeLazyDeferred"));
+		return true;
+	}
+
+	/* Queue already announced to the rcuo kthread? */
+	if (!atomic_long_read(&rdp->nocb_lazy_len))
+		return false;
+
+	len = atomic_long_add_return(rhcount, &rdp->nocb_lazy_len);
+	if (len < qhimark)
+		return true;
+	*flush = rcu_nocb_lazy_claim(rdp);
+	return false;
+}
+
+/* Flush this CPU's lazy callbacks once jiffies_till_flush has passed. */
+static void do_nocb_lazy_flush_timer(unsigned long x)
+{
+	struct rcu_data *rdp = (struct rcu_data *)x;
+
+	if (!rcu_nocb_lazy_claim(rdp))
+		return;
+	wake_nocb_leader(rdp, false);
+	trace_rcu_nocb_wake(rdp->rsp->name, rdp->cpu, TPS("WakeLazyTimer"));
+}
+
+static unsigned long rcu_lazy_shrink_count(struct shrinker *shrink,
+					   struct shrink_control *sc)
+{
+	unsigned long count = 0;
+	struct rcu_state *rsp;
+	struct rcu_data *rdp;
+	int cpu;
+
+	for_each_rcu_flavor(rsp) {
+		for_each_cpu(cpu, rcu_nocb_mask) {
+			rdp = per_cpu_ptr(rsp->rda, cpu);
+			count += atomic_long_read(&rdp->nocb_lazy_len);
+		}
+	}
+	return count;
+}
+
+/*
+ * Under memory pressure, hand the lazy callbacks to their rcuo kthreads
+ * so that the memory they free is reclaimed after the next grace period
+ * rather than after jiffies_till_flush.
+ */
+static unsigned long rcu_lazy_shrink_scan(struct shrinker *shrink,
+					  struct shrink_control *sc)
+{
+	unsigned long count = 0;
+	struct rcu_state *rsp;
+	struct rcu_data *rdp;
+	long len;
+	int cpu;
+
+	for_each_rcu_flavor(rsp) {
+		for_each_cpu(cpu, rcu_nocb_mask) {
+			if (count >= sc->nr_to_scan)
+				goto out;
+			rdp = per_cpu_ptr(rsp->rda, cpu);
+			len = rcu_nocb_lazy_claim(rdp);
+			if (!len)
+				continue;
+			wake_nocb_leader(rdp, false);
+			trace_rcu_nocb_wake(rdp->rsp->name, rdp->cpu,
+					    TPS("WakeLazyShrink"));
+			count += len;
+		}
+	}
+out:
+	return count ? count : SHRINK_STOP;
+}
+
+static struct shrinker rcu_lazy_shrinker = {
+	.count_objects = rcu_lazy_shrink_count,
+	.scan_objects = rcu_lazy_shrink_scan,
+	.seeks = DEFAULT_SEEKS,
+	.batch = 0,
+};
+
+#else /* #ifdef CONFIG_RCU_LAZY */
+
+static bool rcu_nocb_lazy_enqueue(struct rcu_data *rdp, bool was_empty,
+				  int rhcount, bool lazy, bool *flush)
+{
+	*flush = false;
+	return false;
+}
+
+#endif /* #else #ifdef CONFIG_RCU_LAZY */
+
 /*
  * Does the specified CPU need an RCU callback for the specified flavor
  * of rcu_barrier()?
@@ -1930,8 +2077,17 @@ static void __call_rcu_nocb_enqueue(struct rcu_data *rdp,
 				    unsigned long flags)
 {
 	int len;
+	bool flush;
 	struct rcu_head **old_rhpp;
 	struct task_struct *t;
+	/*
+	 * Only a lone call_rcu_lazy() callback may be held back.  kfree_rcu()
+	 * callbacks are lazy as well, but under churn deferring them would
+	 * keep a lot of memory allocated for up to jiffies_till_flush.  Look
+	 * at the callback now, it may be invoked as soon as it is queued.
+	 */
+	bool lazy = rhcount == 1 && rhcount_lazy == 1 &&
+		    !__is_kfree_rcu_offset((unsigned long)rhp->func);
 
 	/* Enqueue the callback on the nocb list and update counts. */
 	atomic_long_add(rhcount, &rdp->nocb_q_count);
@@ -1948,10 +2104,13 @@ static void __call_rcu_nocb_enqueue(struct rcu_data *rdp,
 				    TPS("WakeNotPoll"));
 		return;
 	}
+	if (rcu_nocb_lazy_enqueue(rdp, old_rhpp == &rdp->nocb_head,
+				  rhcount, lazy, &flush))
+		return;
 	len = atomic_long_read(&rdp->nocb_q_count);
-	if (old_rhpp == &rdp->nocb_head) {
+	if (old_rhpp == &rdp->nocb_head || flush) {
 		if (!irqs_disabled_flags(flags)) {
-			/* ... if queue was empty ... */
+			/* ... if queue was empty or held lazy CBs ... */
 			wake_nocb_leader(rdp, false);
 			trace_rcu_nocb_wake(rdp->rsp->name, rdp->cpu,
 					    TPS("WakeEmpty"));
@@ -2341,6 +2500,10 @@ static void __init rcu_boot_init_nocb_percpu_data(struct rcu_data *rdp)
 	raw_spin_lock_init(&rdp->nocb_lock);
 	setup_timer(&rdp->nocb_timer, do_nocb_deferred_wakeup_timer,
 		    (unsigned long)rdp);
+#ifdef CONFIG_RCU_LAZY
+	setup_timer(&rdp->nocb_lazy_timer, do_nocb_lazy_flush_timer,
+		    (unsigned long)rdp);
+#endif /* #ifdef CONFIG_RCU_LAZY */
 }
 
 /*
@@ -2416,6 +2579,10 @@ static void __init rcu_spawn_nocb_kthreads(void)
 
 	for_each_online_cpu(cpu)
 		rcu_spawn_all_nocb_kthreads(cpu);
+#ifdef CONFIG_RCU_LAZY
+	if (have_rcu_nocb_mask && register_shrinker(&rcu_lazy_shrinker))
+		pr_err("Failed to register lazy RCU shrinker!\n");
+#endif /* #ifdef CONFIG_RCU_LAZY */
 }
 
 /* How many follower CPU IDs per leader?  Default of -1 for sqrt(nr_cpu_ids). */
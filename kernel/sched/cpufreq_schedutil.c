@@ -176,14 +176,58 @@ static unsigned int get_next_freq(struct sugov_policy *sg_policy,
 	return cpufreq_driver_resolve_freq(policy, freq);
 }
 
-static void sugov_get_util(unsigned long *util, unsigned long *max, int cpu)
+/*
+ * With utilization clamping RT tasks no longer force the maximum frequency:
+ * they request their actual utilization, which the rq clamps then boost (by
+ * default up to the full CPU capacity) or cap.
+ */
+#ifdef CONFIG_UCLAMP_TASK
+#define SUGOV_MAX_FREQ_FLAGS	SCHED_CPUFREQ_DL
+#else
+#define SUGOV_MAX_FREQ_FLAGS	SCHED_CPUFREQ_RT_DL
+#endif
+
+#ifdef CONFIG_SMP
+/*
+ * Utilization of the time spent outside of CFS on @rq, from the same decayed
+ * rq->rt_avg that scale_rt_capacity() uses.
+ */
+static unsigned long sugov_rt_util(struct rq *rq, unsigned long max)
+{
+	u64 total, used, age_stamp, avg;
+	s64 delta;
+
+	age_stamp = READ_ONCE(rq->age_stamp);
+	avg = READ_ONCE(rq->rt_avg);
+	delta = __rq_clock_broken(rq) - age_stamp;
+
+	if (unlikely(delta < 0))
+		delta = 0;
+
+	total = sched_avg_period() + delta;
+	used = div_u64(avg, total);
+
+	return min_t(u64, (used * max) >> SCHED_CAPACITY_SHIFT, max);
+}
+#else
+static unsigned long sugov_rt_util(struct rq *rq, unsigned long max)
+{
+	return max;
+}
+#endif
+
+static void sugov_get_util(unsigned long *util, unsigned long *max, int cpu,
+			   unsigned int flags)
 {
 	struct rq *rq = cpu_rq(cpu);
 	unsigned long cfs_max;
 
 	cfs_max = arch_scale_cpu_capacity(NULL, cpu);
 
-	*util = min(rq->cfs.avg.util_avg, cfs_max);
+	*util = rq->cfs.avg.util_avg;
+	if (flags & SCHED_CPUFREQ_RT)
+		*util += sugov_rt_util(rq, cfs_max);
+	*util = uclamp_util(rq, min(*util, cfs_max));
 	*max = cfs_max;
 }
 
@@ -272,10 +316,10 @@ static void sugov_update_single(struct update_util_data *hook, u64 time,
 
 	busy = sugov_cpu_is_busy(sg_cpu);
 
-	if (flags & SCHED_CPUFREQ_RT_DL) {
+	if (flags & SUGOV_MAX_FREQ_FLAGS) {
 		next_f = policy->cpuinfo.max_freq;
 	} else {
-		sugov_get_util(&util, &max, sg_cpu->cpu);
+		sugov_get_util(&util, &max, sg_cpu->cpu, flags);
 		sugov_iowait_boost(sg_cpu, &util, &max);
 		next_f = get_next_freq(sg_policy, util, max);
 		/*
@@ -318,7 +362,7 @@ static unsigned int sugov_next_freq_shared(struct sugov_cpu *sg_cpu, u64 time)
 			j_sg_cpu->iowait_boost_pending = false;
 			continue;
 		}
-		if (j_sg_cpu->flags & SCHED_CPUFREQ_RT_DL)
+		if (j_sg_cpu->flags & SUGOV_MAX_FREQ_FLAGS)
 			return policy->cpuinfo.max_freq;
 
 		j_util = j_sg_cpu->util;
@@ -342,7 +386,7 @@ static void sugov_update_shared(struct update_util_data *hook, u64 time,
 	unsigned long util, max;
 	unsigned int next_f;
 
-	sugov_get_util(&util, &max, sg_cpu->cpu);
+	sugov_get_util(&util, &max, sg_cpu->cpu, flags);
 
 	raw_spin_lock(&sg_policy->update_lock);
 
@@ -354,7 +398,7 @@ static void sugov_update_shared(struct update_util_data *hook, u64 time,
 	sg_cpu->last_update = time;
 
 	if (sugov_should_update_freq(sg_policy, time)) {
-		if (flags & SCHED_CPUFREQ_RT_DL)
+		if (flags & SUGOV_MAX_FREQ_FLAGS)
 			next_f = sg_policy->policy->cpuinfo.max_freq;
 		else
 			next_f = sugov_next_freq_shared(sg_cpu, time);
@@ -61,6 +61,8 @@ cond_syscall(compat_sys_recvmmsg);
 cond_syscall(sys_socketcall);
 cond_syscall(sys_futex);
 cond_syscall(compat_sys_futex);
+cond_syscall(sys_futex_waitv);
+cond_syscall(compat_sys_futex_waitv);
 cond_syscall(sys_set_robust_list);
 cond_syscall(compat_sys_set_robust_list);
 cond_syscall(sys_get_robust_list);
@@ -259,3 +261,6 @@ cond_syscall(sys_membarrier);
 cond_syscall(sys_pkey_mprotect);
 cond_syscall(sys_pkey_alloc);
 cond_syscall(sys_pkey_free);
+
+/* restartable sequence */
+cond_syscall(sys_rseq);
@@ -227,6 +227,111 @@ static int test_jprobes(void)
 
 	return 0;
 }
+
+#ifdef CONFIG_OPTPROBES
+static bool kprobe_is_optimized(struct kprobe *p)
+{
+	struct kprobe *ap;
+	bool ret;
+
+	preempt_disable();
+	ap = get_kprobe(p->addr);
+	ret = ap && kprobe_optimized(ap);
+	preempt_enable();
+
+	return ret;
+}
+
+/*
+ * Register @p and wait for the optimizer.  Returns 1 if the probe could
+ * not be optimized, in which case it is unregistered again.
+ */
+static int register_optprobe(struct kprobe *p)
+{
+	int ret;
+
+	/* addr and flags should be cleared for reusing kprobe. */
+	p->addr = NULL;
+	p->flags = 0;
+	ret = register_kprobe(p);
+	if (ret < 0) {
+		pr_err("register_kprobe returned %d\n", ret);
+		return ret;
+	}
+
+	wait_for_kprobe_optimizer();
+	if (!kprobe_is_optimized(p)) {
+		unregister_kprobe(p);
+		pr_info("kprobe_target can't be optimized, optprobe test skipped\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Without a post_handler the probe can be jump optimized */
+static struct kprobe okp = {
+	.symbol_name = "kprobe_target",
+	.pre_handler = kp_pre_handler,
+};
+
+#ifdef CONFIG_ARM64
+static int kp_redirect_handler(struct kprobe *p, struct pt_regs *regs)
+{
+	instruction_pointer_set(regs, (unsigned long)kprobe_target2);
+	return 1;
+}
+
+static struct kprobe okp_redirect = {
+	.symbol_name = "kprobe_target",
+	.pre_handler = kp_redirect_handler,
+};
+#endif
+
+static int test_optprobe(void)
+{
+	int ret;
+	u32 val;
+
+	ret = register_optprobe(&okp);
+	if (ret)
+		return ret < 0 ? ret : 0;
+
+	preh_val = 0;
+	val = target(rand1);
+	unregister_kprobe(&okp);
+
+	if (preh_val == 0) {
+		pr_err("optprobe pre_handler not called\n");
+		handler_errors++;
+	}
+	if (val != rand1 / div_factor) {
+		pr_err("incorrect value with optprobe\n");
+		handler_errors++;
+	}
+
+#ifdef CONFIG_ARM64
+	/*
+	 * A pc set by the pre_handler must be honoured.  The x86 detour
+	 * buffer does not resume at a modified ip, so this is arm64 only.
+	 */
+	ret = register_optprobe(&okp_redirect);
+	if (ret)
+		return ret < 0 ? ret : 0;
+
+	val = target(rand1);
+	unregister_kprobe(&okp_redirect);
+
+	if (val != (rand1 / div_factor) + 1) {
+		pr_err("optprobe pre_handler redirection ignored\n");
+		handler_errors++;
+	}
+#endif
+
+	return 0;
+}
+#endif /* CONFIG_OPTPROBES */
+
 #ifdef CONFIG_KRETPROBES
 static u32 krph_val;
 
@@ -366,6 +471,13 @@ int init_test_probes(void)
 	if (ret < 0)
 		errors++;
 
+#ifdef CONFIG_OPTPROBES
+	num_tests++;
+	ret = test_optprobe();
+	if (ret < 0)
+		errors++;
+#endif /* CONFIG_OPTPROBES */
+
 #ifdef CONFIG_KRETPROBES
 	num_tests++;
 	ret = test_kretprobe();
@@ -164,3 +164,16 @@ DECLARE_PER_CPU(struct hrtimer_cpu_base, hrtimer_bases);
 
 extern u64 get_next_timer_interrupt(unsigned long basej, u64 basem);
 void timer_clear_idle(void);
+
+#ifdef CONFIG_TIMER_MIGRATION
+extern u64 timer_expire_remote(unsigned int cpu);
+extern bool tmigr_requires_handle_remote(void);
+extern void tmigr_handle_remote(void);
+extern u64 tmigr_cpu_deactivate(u64 nextexp);
+extern void tmigr_cpu_activate(void);
+#else
+static inline bool tmigr_requires_handle_remote(void) { return false; }
+static inline void tmigr_handle_remote(void) { }
+static inline u64 tmigr_cpu_deactivate(u64 nextexp) { return nextexp; }
+static inline void tmigr_cpu_activate(void) { }
+#endif
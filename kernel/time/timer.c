@@ -180,18 +180,27 @@ EXPORT_SYMBOL(jiffies_64);
 
 /*
  * The resulting wheel size. If NOHZ is configured we allocate two
- * wheels so we have a separate storage for the deferrable timers.
+ * wheels so we have a separate storage for the deferrable timers. With
+ * timer migration, a third wheel holds the timers which are not pinned
+ * and which an idle CPU hands off to the migration hierarchy.
  */
 #define WHEEL_SIZE	(LVL_SIZE * LVL_DEPTH)
 
 #ifdef CONFIG_NO_HZ_COMMON
-# define NR_BASES	2
 # define BASE_STD	0
 # define BASE_DEF	1
+# ifdef CONFIG_TIMER_MIGRATION
+#  define NR_BASES	3
+#  define BASE_GLOBAL	2
+# else
+#  define NR_BASES	2
+#  define BASE_GLOBAL	BASE_STD
+# endif
 #else
 # define NR_BASES	1
 # define BASE_STD	0
 # define BASE_DEF	0
+# define BASE_GLOBAL	0
 #endif
 
 struct timer_base {
@@ -217,19 +226,20 @@ void timers_update_migration(bool update_nohz)
 {
 	bool on = sysctl_timer_migration && tick_nohz_active;
 	unsigned int cpu;
+	int b;
 
 	/* Avoid the loop, if nothing to update */
 	if (this_cpu_read(timer_bases[BASE_STD].migration_enabled) == on)
 		return;
 
 	for_each_possible_cpu(cpu) {
-		per_cpu(timer_bases[BASE_STD].migration_enabled, cpu) = on;
-		per_cpu(timer_bases[BASE_DEF].migration_enabled, cpu) = on;
+		for (b = 0; b < NR_BASES; b++)
+			per_cpu(timer_bases[b].migration_enabled, cpu) = on;
 		per_cpu(hrtimer_bases.migration_enabled, cpu) = on;
 		if (!update_nohz)
 			continue;
-		per_cpu(timer_bases[BASE_STD].nohz_active, cpu) = true;
-		per_cpu(timer_bases[BASE_DEF].nohz_active, cpu) = true;
+		for (b = 0; b < NR_BASES; b++)
+			per_cpu(timer_bases[b].nohz_active, cpu) = true;
 		per_cpu(hrtimer_bases.nohz_active, cpu) = true;
 	}
 }
@@ -809,30 +819,25 @@ static int detach_if_pending(struct timer_list *timer, struct timer_base *base,
 	return 1;
 }
 
-static inline struct timer_base *get_timer_cpu_base(u32 tflags, u32 cpu)
+static inline unsigned int get_timer_base_idx(u32 tflags)
 {
-	struct timer_base *base = per_cpu_ptr(&timer_bases[BASE_STD], cpu);
-
 	/*
 	 * If the timer is deferrable and NO_HZ_COMMON is set then we need
 	 * to use the deferrable base.
 	 */
 	if (IS_ENABLED(CONFIG_NO_HZ_COMMON) && (tflags & TIMER_DEFERRABLE))
-		base = per_cpu_ptr(&timer_bases[BASE_DEF], cpu);
-	return base;
+		return BASE_DEF;
+	return tflags & TIMER_PINNED ? BASE_STD : BASE_GLOBAL;
 }
 
-static inline struct timer_base *get_timer_this_cpu_base(u32 tflags)
+static inline struct timer_base *get_timer_cpu_base(u32 tflags, u32 cpu)
 {
-	struct timer_base *base = this_cpu_ptr(&timer_bases[BASE_STD]);
+	return per_cpu_ptr(&timer_bases[get_timer_base_idx(tflags)], cpu);
+}
 
-	/*
-	 * If the timer is deferrable and NO_HZ_COMMON is set then we need
-	 * to use the deferrable base.
-	 */
-	if (IS_ENABLED(CONFIG_NO_HZ_COMMON) && (tflags & TIMER_DEFERRABLE))
-		base = this_cpu_ptr(&timer_bases[BASE_DEF]);
-	return base;
+static inline struct timer_base *get_timer_this_cpu_base(u32 tflags)
+{
+	return this_cpu_ptr(&timer_bases[get_timer_base_idx(tflags)]);
 }
 
 static inline struct timer_base *get_timer_base(u32 tflags)
@@ -844,11 +849,15 @@ static inline struct timer_base *get_timer_base(u32 tflags)
 static inline struct timer_base *
 get_target_base(struct timer_base *base, unsigned tflags)
 {
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) && !defined(CONFIG_TIMER_MIGRATION)
 	if ((tflags & TIMER_PINNED) || !base->migration_enabled)
 		return get_timer_this_cpu_base(tflags);
 	return get_timer_cpu_base(tflags, get_nohz_timer_target());
 #else
+	/*
+	 * With timer migration, global timers stay on the local CPU until
+	 * it goes idle and hands them off, see timer_migration.c.
+	 */
 	return get_timer_this_cpu_base(tflags);
 #endif
 }
@@ -1105,6 +1114,8 @@ void add_timer_on(struct timer_list *timer, int cpu)
 
 	BUG_ON(timer_pending(timer) || !timer->function);
 
+	/* The timer must not be expired by a timer migrator elsewhere */
+	timer->flags |= TIMER_PINNED;
 	new_base = get_timer_cpu_base(timer->flags, cpu);
 
 	/*
@@ -1471,20 +1482,13 @@ static u64 cmp_next_hrtimer_event(u64 basem, u64 expires)
  * Returns the tick aligned clock monotonic time of the next pending
  * timer or KTIME_MAX if no timer is pending.
  */
-u64 get_next_timer_interrupt(unsigned long basej, u64 basem)
+static u64 fetch_next_timer_interrupt(struct timer_base *base,
+				      unsigned long basej, u64 basem)
 {
-	struct timer_base *base = this_cpu_ptr(&timer_bases[BASE_STD]);
 	u64 expires = KTIME_MAX;
 	unsigned long nextevt;
 	bool is_max_delta;
 
-	/*
-	 * Pretend that there is no timer pending if the cpu is offline.
-	 * Possible pending timers will be migrated later to an active cpu.
-	 */
-	if (cpu_is_offline(smp_processor_id()))
-		return expires;
-
 	raw_spin_lock(&base->lock);
 	nextevt = __next_timer_interrupt(base);
 	is_max_delta = (nextevt == base->clk + NEXT_TIMER_MAX_DELTA);
@@ -1511,8 +1515,9 @@ u64 get_next_timer_interrupt(unsigned long basej, u64 basem)
 		 * If we expect to sleep more than a tick, mark the base idle.
 		 * Also the tick is stopped so any added timer must forward
 		 * the base clk itself to keep granularity small. This idle
-		 * logic is only maintained for the BASE_STD base, deferrable
-		 * timers may still see large granularity skew (by design).
+		 * logic is only maintained for the BASE_STD and BASE_GLOBAL
+		 * bases, deferrable timers may still see large granularity
+		 * skew (by design).
 		 */
 		if ((expires - basem) > TICK_NSEC) {
 			base->must_forward_clk = true;
@@ -1521,7 +1526,45 @@ u64 get_next_timer_interrupt(unsigned long basej, u64 basem)
 	}
 	raw_spin_unlock(&base->lock);
 
-	return cmp_next_hrtimer_event(basem, expires);
+	return expires;
+}
+
+u64 get_next_timer_interrupt(unsigned long basej, u64 basem)
+{
+	struct timer_base *base = this_cpu_ptr(&timer_bases[BASE_STD]);
+	struct timer_base *base_global;
+	u64 expires, expires_global;
+
+	/*
+	 * Pretend that there is no timer pending if the cpu is offline.
+	 * Possible pending timers will be migrated later to an active cpu.
+	 */
+	if (cpu_is_offline(smp_processor_id()))
+		return KTIME_MAX;
+
+	expires = fetch_next_timer_interrupt(base, basej, basem);
+	if (BASE_GLOBAL == BASE_STD)
+		return cmp_next_hrtimer_event(basem, expires);
+
+	base_global = this_cpu_ptr(&timer_bases[BASE_GLOBAL]);
+	expires_global = fetch_next_timer_interrupt(base_global, basej, basem);
+
+	/*
+	 * An idle CPU which stops the tick for longer hands off its global
+	 * timers to the migration hierarchy and only has to wake up for
+	 * them if no other CPU is left active. With migration disabled, it
+	 * still goes idle in the hierarchy so it doesn't act as migrator,
+	 * but keeps its global timers for itself.
+	 */
+	if (is_idle_task(current) && base->is_idle) {
+		if (!base_global->migration_enabled) {
+			expires = min(expires, expires_global);
+			expires_global = KTIME_MAX;
+		}
+		expires_global = tmigr_cpu_deactivate(expires_global);
+	}
+
+	return cmp_next_hrtimer_event(basem, min(expires, expires_global));
 }
 
 /**
@@ -1531,15 +1574,17 @@ u64 get_next_timer_interrupt(unsigned long basej, u64 basem)
  */
 void timer_clear_idle(void)
 {
-	struct timer_base *base = this_cpu_ptr(&timer_bases[BASE_STD]);
-
 	/*
 	 * We do this unlocked. The worst outcome is a remote enqueue sending
 	 * a pointless IPI, but taking the lock would just make the window for
 	 * sending the IPI a few instructions smaller for the cost of taking
 	 * the lock in the exit from idle path.
 	 */
-	base->is_idle = false;
+	__this_cpu_write(timer_bases[BASE_STD].is_idle, false);
+	if (BASE_GLOBAL != BASE_STD) {
+		__this_cpu_write(timer_bases[BASE_GLOBAL].is_idle, false);
+		tmigr_cpu_activate();
+	}
 }
 
 static int collect_expired_timers(struct timer_base *base,
@@ -1609,6 +1654,16 @@ static inline void __run_timers(struct timer_base *base)
 
 	raw_spin_lock_irq(&base->lock);
 
+	/*
+	 * The global base of an idle CPU may be expired remotely by a timer
+	 * migrator, while the CPU itself wakes up. Timers of a base must
+	 * not run concurrently, so leave it to whoever is running it.
+	 */
+	if (base->running_timer) {
+		raw_spin_unlock_irq(&base->lock);
+		return;
+	}
+
 	/*
 	 * timer_base::must_forward_clk must be cleared before running
 	 * timers so that any timer functions that call mod_timer() will
@@ -1647,6 +1702,10 @@ static __latent_entropy void run_timer_softirq(struct softirq_action *h)
 	__run_timers(base);
 	if (IS_ENABLED(CONFIG_NO_HZ_COMMON))
 		__run_timers(this_cpu_ptr(&timer_bases[BASE_DEF]));
+	if (BASE_GLOBAL != BASE_STD) {
+		__run_timers(this_cpu_ptr(&timer_bases[BASE_GLOBAL]));
+		tmigr_handle_remote();
+	}
 }
 
 /*
@@ -1655,20 +1714,61 @@ static __latent_entropy void run_timer_softirq(struct softirq_action *h)
 void run_local_timers(void)
 {
 	struct timer_base *base = this_cpu_ptr(&timer_bases[BASE_STD]);
+	int b;
 
 	hrtimer_run_queues();
-	/* Raise the softirq only if required. */
-	if (time_before(jiffies, base->clk)) {
-		if (!IS_ENABLED(CONFIG_NO_HZ_COMMON))
-			return;
-		/* CPU is awake, so check the deferrable base. */
-		base++;
-		if (time_before(jiffies, base->clk))
-			return;
+	/*
+	 * Raise the softirq only if required. The CPU is awake, so check
+	 * the deferrable and global bases as well.
+	 */
+	for (b = 0; b < NR_BASES; b++, base++) {
+		if (time_after_eq(jiffies, base->clk))
+			goto raise;
 	}
+	if (!tmigr_requires_handle_remote())
+		return;
+raise:
 	raise_softirq(TIMER_SOFTIRQ);
 }
 
+#ifdef CONFIG_TIMER_MIGRATION
+/**
+ * timer_expire_remote - expire the global timers of an idle CPU
+ * @cpu:	The idle CPU
+ *
+ * Called by the timer migrator on behalf of @cpu. Returns the first
+ * expiry of the remaining global timers of @cpu, KTIME_MAX if none.
+ */
+u64 timer_expire_remote(unsigned int cpu)
+{
+	struct timer_base *base = per_cpu_ptr(&timer_bases[BASE_GLOBAL], cpu);
+	unsigned long nextevt, basej;
+	u64 expires = KTIME_MAX;
+
+	__run_timers(base);
+
+	raw_spin_lock_irq(&base->lock);
+	basej = jiffies;
+	nextevt = __next_timer_interrupt(base);
+	if (nextevt != base->clk + NEXT_TIMER_MAX_DELTA) {
+		base->next_expiry = nextevt;
+		/*
+		 * Err on the early side, a timer which is not due yet is
+		 * simply reported again.
+		 */
+		if (time_after(nextevt, basej + 1))
+			expires = ktime_get_ns() +
+				  (u64)(nextevt - basej - 1) * TICK_NSEC;
+		else
+			expires = ktime_get_ns();
+	}
+	base->must_forward_clk = base->is_idle;
+	raw_spin_unlock_irq(&base->lock);
+
+	return expires;
+}
+#endif
+
 static void process_timeout(unsigned long __data)
 {
 	wake_up_process((struct task_struct *)__data);
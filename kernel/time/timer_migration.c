@@ -0,0 +1,495 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Idle driven, hierarchical migration of global timers
+ *
+ * Timers which are not pinned to a CPU ("global" timers) are queued on
+ * the CPU which arms them. Instead of pushing them to a presumably busy
+ * CPU at enqueue time, an idle CPU hands its global timers off at the
+ * time it stops the tick: it reports the first expiry of its global
+ * timer base to the hierarchy and only wakes up for its pinned timers.
+ *
+ * The hierarchy mirrors the topology. CPUs sharing a cluster (package
+ * id) form a level 0 group, the level 0 groups are the children of the
+ * top level group:
+ *
+ *		       [ top level group ]
+ *		      /                   \
+ *	     [ cluster 0 ]               [ cluster 1 ]
+ *	     /  |  |   \                 /  |  |   \
+ *	  CPU0 CPU1 CPU2 CPU3         CPU4 CPU5 CPU6 CPU7
+ *
+ * A group is active as long as one of its children is. One active child
+ * is the migrator of the group and expires the global timers of the
+ * idle children when due, from its tick. Once the last child of a group
+ * goes idle, the group goes idle in its parent and reports the first
+ * expiry of all its children there, so the migrator of the parent takes
+ * over. So a whole idle cluster hands its timers to the cluster which
+ * is still running and stays idle. When the last CPU of the system goes
+ * idle, it has to wake up for the first global timer of everyone.
+ *
+ * Group locks nest bottom up. Expiring remote timers happens without
+ * any group lock held.
+ */
+
+#include <linux/cpuhotplug.h>
+#include <linux/cpumask.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/sched/nohz.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/tick.h>
+#include <linux/topology.h>
+
+#include "tick-internal.h"
+#include "timer_migration.h"
+
+enum tmigr_op {
+	TMIGR_ACTIVATE,
+	TMIGR_DEACTIVATE,
+	TMIGR_NEW_EXPIRY,
+};
+
+static DEFINE_PER_CPU(struct tmigr_cpu, tmigr_cpu);
+static DEFINE_PER_CPU(struct cpumask, tmigr_expire_mask);
+
+static DEFINE_MUTEX(tmigr_mutex);
+static LIST_HEAD(tmigr_level0_list);
+static struct tmigr_group *tmigr_root;
+
+static u64 tmigr_group_next_expiry(struct tmigr_group *group)
+{
+	u64 next = KTIME_MAX;
+	unsigned int i;
+
+	for (i = 0; i < group->num_children; i++) {
+		if (!test_bit(i, &group->active))
+			next = min(next, group->child_expiry[i]);
+	}
+	return next;
+}
+
+static u64 tmigr_update(struct tmigr_group *group, unsigned int childidx,
+			enum tmigr_op op, u64 expiry);
+
+/*
+ * Propagate the change of the state of @group, whose lock is held, up the
+ * hierarchy and drop the lock. Returns as tmigr_update().
+ */
+static u64 tmigr_propagate(struct tmigr_group *group, bool was_active)
+{
+	u64 ret = KTIME_MAX;
+
+	WRITE_ONCE(group->next_expiry, tmigr_group_next_expiry(group));
+
+	if (group->active) {
+		if (!was_active && group->parent)
+			tmigr_update(group->parent, group->childidx,
+				     TMIGR_ACTIVATE, KTIME_MAX);
+	} else if (group->parent) {
+		/* Let the parent's migrator take care of the idle group */
+		ret = tmigr_update(group->parent, group->childidx,
+				   was_active ? TMIGR_DEACTIVATE :
+						TMIGR_NEW_EXPIRY,
+				   group->next_expiry);
+	} else {
+		/* Nobody is left to take care of the idle hierarchy */
+		ret = group->next_expiry;
+	}
+
+	raw_spin_unlock(&group->lock);
+	return ret;
+}
+
+/*
+ * Apply @op to child @childidx of @group and propagate the resulting
+ * change of the group state up the hierarchy. Called with interrupts
+ * disabled.
+ *
+ * Returns the time at which the caller has to expire the global timers
+ * of the hierarchy because no CPU is active anymore, or KTIME_MAX.
+ */
+static u64 tmigr_update(struct tmigr_group *group, unsigned int childidx,
+			enum tmigr_op op, u64 expiry)
+{
+	bool was_active;
+
+	raw_spin_lock_nested(&group->lock, group->level);
+
+	was_active = group->active != 0;
+
+	switch (op) {
+	case TMIGR_ACTIVATE:
+		__set_bit(childidx, &group->active);
+		group->child_expiry[childidx] = KTIME_MAX;
+		if (group->migrator == TMIGR_NONE)
+			WRITE_ONCE(group->migrator, childidx);
+		break;
+	case TMIGR_DEACTIVATE:
+		__clear_bit(childidx, &group->active);
+		group->child_expiry[childidx] = expiry;
+		if (group->migrator == childidx)
+			WRITE_ONCE(group->migrator, group->active ?
+				   __ffs(group->active) : TMIGR_NONE);
+		break;
+	case TMIGR_NEW_EXPIRY:
+		/* The child became active again in the meantime */
+		if (test_bit(childidx, &group->active)) {
+			raw_spin_unlock(&group->lock);
+			return KTIME_MAX;
+		}
+		group->child_expiry[childidx] = expiry;
+		break;
+	}
+
+	return tmigr_propagate(group, was_active);
+}
+
+/*
+ * Report @expiry, the first expiry left on the global base of the idle
+ * CPU @rtmc after its due timers were expired remotely. @seq is the
+ * sequence count of @rtmc sampled before the expiry. If the CPU became
+ * active or reported an expiry itself since, its own report is newer and
+ * is left alone. Called with interrupts disabled, returns as
+ * tmigr_update().
+ */
+static u64 tmigr_update_remote(struct tmigr_cpu *rtmc, unsigned int seq,
+			       u64 expiry)
+{
+	struct tmigr_group *group = rtmc->tmgroup;
+	unsigned int childidx = rtmc->childidx;
+
+	raw_spin_lock_nested(&group->lock, group->level);
+
+	if (test_bit(childidx, &group->active) ||
+	    READ_ONCE(rtmc->seq) != seq) {
+		raw_spin_unlock(&group->lock);
+		return KTIME_MAX;
+	}
+	group->child_expiry[childidx] = expiry;
+
+	return tmigr_propagate(group, group->active != 0);
+}
+
+/*
+ * Report a new state of the local CPU. The sequence count tells remote
+ * expiry in tmigr_handle_remote() that its result may be stale.
+ */
+static u64 tmigr_cpu_update(struct tmigr_cpu *tmc, enum tmigr_op op,
+			    u64 expiry)
+{
+	WRITE_ONCE(tmc->seq, tmc->seq + 1);
+	return tmigr_update(tmc->tmgroup, tmc->childidx, op, expiry);
+}
+
+/* Collect the idle CPUs below @group with global timers due at @now */
+static void tmigr_collect_expired(struct tmigr_group *group, u64 now,
+				  struct cpumask *mask)
+{
+	unsigned long expired = 0;
+	unsigned int i;
+
+	raw_spin_lock_nested(&group->lock, group->level);
+	for (i = 0; i < group->num_children; i++) {
+		if (!test_bit(i, &group->active) &&
+		    group->child_expiry[i] <= now)
+			__set_bit(i, &expired);
+	}
+	raw_spin_unlock(&group->lock);
+
+	for_each_set_bit(i, &expired, TMIGR_CHILDREN_MAX) {
+		if (!group->level)
+			cpumask_set_cpu(group->child_cpu[i], mask);
+		else
+			tmigr_collect_expired(group->child_group[i], now, mask);
+	}
+}
+
+/**
+ * tmigr_requires_handle_remote - check for due remote timers
+ *
+ * Called from the tick. Returns true if the CPU is the migrator of a
+ * group with due timers of idle children, or the idle CPU in charge of
+ * the whole idle hierarchy and its wakeup time passed.
+ */
+bool tmigr_requires_handle_remote(void)
+{
+	struct tmigr_cpu *tmc = this_cpu_ptr(&tmigr_cpu);
+	struct tmigr_group *group;
+	unsigned int childidx;
+	u64 next = KTIME_MAX;
+
+	if (!tmc->online)
+		return false;
+
+	if (tmc->idle) {
+		next = tmc->wakeup;
+	} else {
+		childidx = tmc->childidx;
+		for (group = tmc->tmgroup; group; group = group->parent) {
+			if (READ_ONCE(group->migrator) != childidx)
+				break;
+			next = min(next, READ_ONCE(group->next_expiry));
+			childidx = group->childidx;
+		}
+	}
+
+	return next != KTIME_MAX && next <= ktime_get_ns();
+}
+
+/**
+ * tmigr_handle_remote - expire the due global timers of idle CPUs
+ *
+ * Called from the timer softirq.
+ */
+void tmigr_handle_remote(void)
+{
+	struct tmigr_cpu *tmc = this_cpu_ptr(&tmigr_cpu);
+	struct cpumask *mask = this_cpu_ptr(&tmigr_expire_mask);
+	struct tmigr_group *group;
+	unsigned int childidx;
+	int cpu;
+	u64 now;
+
+	if (!tmigr_requires_handle_remote())
+		return;
+
+	now = ktime_get_ns();
+	cpumask_clear(mask);
+
+	local_irq_disable();
+	if (tmc->idle) {
+		if (!READ_ONCE(tmigr_root->active))
+			tmigr_collect_expired(tmigr_root, now, mask);
+	} else {
+		childidx = tmc->childidx;
+		for (group = tmc->tmgroup; group; group = group->parent) {
+			if (READ_ONCE(group->migrator) != childidx)
+				break;
+			tmigr_collect_expired(group, now, mask);
+			childidx = group->childidx;
+		}
+	}
+	local_irq_enable();
+
+	for_each_cpu(cpu, mask) {
+		struct tmigr_cpu *rtmc = per_cpu_ptr(&tmigr_cpu, cpu);
+		unsigned int seq = READ_ONCE(rtmc->seq);
+		u64 next, wakeup;
+
+		/* Sample the count before the base is looked at */
+		smp_rmb();
+		next = timer_expire_remote(cpu);
+
+		local_irq_disable();
+		wakeup = tmigr_update_remote(rtmc, seq, next);
+		/*
+		 * An idle CPU in charge of the idle hierarchy stays in charge
+		 * of the new first expiry.
+		 */
+		if (tmc->idle)
+			tmc->wakeup = wakeup;
+		local_irq_enable();
+	}
+}
+
+/**
+ * tmigr_cpu_deactivate - hand off the global timers of an idle CPU
+ * @nextexp:	First expiry of the CPU's global timers
+ *
+ * Called with interrupts disabled when the CPU stops the tick in idle,
+ * possibly several times until it becomes active again. Returns the
+ * time at which the CPU has to wake up for global timers, KTIME_MAX if
+ * another CPU takes care of them.
+ */
+u64 tmigr_cpu_deactivate(u64 nextexp)
+{
+	struct tmigr_cpu *tmc = this_cpu_ptr(&tmigr_cpu);
+	enum tmigr_op op;
+
+	if (!tmc->online)
+		return nextexp;
+
+	op = tmc->idle ? TMIGR_NEW_EXPIRY : TMIGR_DEACTIVATE;
+	tmc->idle = true;
+	tmc->wakeup = tmigr_cpu_update(tmc, op, nextexp);
+	return tmc->wakeup;
+}
+
+/**
+ * tmigr_cpu_activate - take back the global timers of the CPU
+ *
+ * Called with interrupts disabled when the CPU leaves idle.
+ */
+void tmigr_cpu_activate(void)
+{
+	struct tmigr_cpu *tmc = this_cpu_ptr(&tmigr_cpu);
+
+	if (!tmc->online || !tmc->idle)
+		return;
+
+	tmc->idle = false;
+	tmc->wakeup = KTIME_MAX;
+	tmigr_cpu_update(tmc, TMIGR_ACTIVATE, KTIME_MAX);
+}
+
+static struct tmigr_group *tmigr_group_alloc(unsigned int level, int key)
+{
+	struct tmigr_group *group;
+	unsigned int i;
+
+	group = kzalloc(sizeof(*group), GFP_KERNEL);
+	if (!group)
+		return NULL;
+
+	raw_spin_lock_init(&group->lock);
+	group->level = level;
+	group->key = key;
+	group->migrator = TMIGR_NONE;
+	group->next_expiry = KTIME_MAX;
+	for (i = 0; i < TMIGR_CHILDREN_MAX; i++)
+		group->child_expiry[i] = KTIME_MAX;
+	INIT_LIST_HEAD(&group->list);
+
+	return group;
+}
+
+/* Add a child to @group, which starts out idle without timers */
+static unsigned int tmigr_add_child(struct tmigr_group *group,
+				    unsigned int cpu,
+				    struct tmigr_group *child)
+{
+	unsigned long flags;
+	unsigned int idx;
+
+	raw_spin_lock_irqsave_nested(&group->lock, flags, group->level);
+	idx = group->num_children;
+	if (group->level)
+		group->child_group[idx] = child;
+	else
+		group->child_cpu[idx] = cpu;
+	group->num_children++;
+	raw_spin_unlock_irqrestore(&group->lock, flags);
+
+	return idx;
+}
+
+static int tmigr_add_cpu(unsigned int cpu)
+{
+	struct tmigr_cpu *tmc = per_cpu_ptr(&tmigr_cpu, cpu);
+	int key = topology_physical_package_id(cpu);
+	struct tmigr_group *group;
+	int ret = 0;
+
+	mutex_lock(&tmigr_mutex);
+
+	if (!tmigr_root) {
+		tmigr_root = tmigr_group_alloc(1, 0);
+		if (!tmigr_root) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	list_for_each_entry(group, &tmigr_level0_list, list) {
+		if (group->key == key &&
+		    group->num_children < TMIGR_CHILDREN_MAX)
+			goto found;
+	}
+
+	if (tmigr_root->num_children == TMIGR_CHILDREN_MAX) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	group = tmigr_group_alloc(0, key);
+	if (!group) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	group->parent = tmigr_root;
+	group->childidx = tmigr_add_child(tmigr_root, 0, group);
+	list_add_tail(&group->list, &tmigr_level0_list);
+found:
+	tmc->childidx = tmigr_add_child(group, cpu, NULL);
+	tmc->tmgroup = group;
+out:
+	mutex_unlock(&tmigr_mutex);
+	return ret;
+}
+
+static int tmigr_cpu_online(unsigned int cpu)
+{
+	struct tmigr_cpu *tmc = per_cpu_ptr(&tmigr_cpu, cpu);
+	int ret;
+
+	/* Without a tick the CPU couldn't expire the timers of others */
+	if (tick_nohz_full_cpu(cpu))
+		return 0;
+
+	if (!tmc->tmgroup) {
+		ret = tmigr_add_cpu(cpu);
+		if (ret) {
+			pr_warn("Timer migration: CPU%u not added: %d\n",
+				cpu, ret);
+			return 0;
+		}
+	}
+
+	local_irq_disable();
+	tmc->idle = false;
+	tmc->wakeup = KTIME_MAX;
+	tmigr_cpu_update(tmc, TMIGR_ACTIVATE, KTIME_MAX);
+	tmc->online = true;
+	local_irq_enable();
+
+	return 0;
+}
+
+/*
+ * The hierarchy went idle with global timers pending and nobody in charge
+ * of them. Kick an idle CPU of the hierarchy: it reports its expiry again
+ * when it stops the tick anew, which puts it in charge.
+ */
+static void tmigr_kick_idle(unsigned int offline_cpu)
+{
+	unsigned int cpu;
+
+	for_each_online_cpu(cpu) {
+		if (cpu == offline_cpu ||
+		    !READ_ONCE(per_cpu(tmigr_cpu, cpu).online))
+			continue;
+		wake_up_nohz_cpu(cpu);
+		return;
+	}
+}
+
+static int tmigr_cpu_offline(unsigned int cpu)
+{
+	struct tmigr_cpu *tmc = per_cpu_ptr(&tmigr_cpu, cpu);
+	u64 wakeup;
+
+	if (!tmc->online)
+		return 0;
+
+	/* The pending timers are moved to a live CPU by timers_dead_cpu() */
+	local_irq_disable();
+	tmc->online = false;
+	wakeup = tmigr_cpu_update(tmc, TMIGR_DEACTIVATE, KTIME_MAX);
+	local_irq_enable();
+
+	if (wakeup != KTIME_MAX)
+		tmigr_kick_idle(cpu);
+
+	return 0;
+}
+
+static int __init tmigr_init(void)
+{
+	int ret;
+
+	ret = cpuhp_setup_state(CPUHP_AP_ONLINE_DYN, "timers/migration:online",
+				tmigr_cpu_online, tmigr_cpu_offline);
+	return ret < 0 ? ret : 0;
+}
+early_initcall(tmigr_init);
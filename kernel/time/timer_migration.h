@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _KERNEL_TIME_MIGRATION_H
+#define _KERNEL_TIME_MIGRATION_H
+
+/* Children of a group, CPUs at level 0 and groups above */
+#define TMIGR_CHILDREN_MAX	BITS_PER_LONG
+
+#define TMIGR_NONE		-1
+
+/**
+ * struct tmigr_group - timer migration hierarchy group
+ * @lock:		Protects the group state below, nests bottom up
+ * @parent:		Parent group, NULL for the top level group
+ * @childidx:		Index of this group in the parent's children
+ * @level:		0 for groups of CPUs, 1 for the top level
+ * @key:		Topology id (cluster or package) of the CPUs in a
+ *			level 0 group
+ * @num_children:	Number of valid child slots
+ * @active:		Bitmap of the children which are active
+ * @migrator:		Active child in charge of expiring the global
+ *			timers of the idle children, TMIGR_NONE if the
+ *			group is idle
+ * @next_expiry:	First expiry of the idle children, KTIME_MAX if
+ *			there is none
+ * @child_expiry:	First expiry reported by each idle child
+ * @child_cpu:		CPU of each child of a level 0 group
+ * @child_group:	Group of each child of an upper level group
+ * @list:		Entry in the list of level 0 groups
+ */
+struct tmigr_group {
+	raw_spinlock_t		lock;
+	struct tmigr_group	*parent;
+	unsigned int		childidx;
+	unsigned int		level;
+	int			key;
+	unsigned int		num_children;
+	unsigned long		active;
+	int			migrator;
+	u64			next_expiry;
+	u64			child_expiry[TMIGR_CHILDREN_MAX];
+	union {
+		unsigned int		child_cpu[TMIGR_CHILDREN_MAX];
+		struct tmigr_group	*child_group[TMIGR_CHILDREN_MAX];
+	};
+	struct list_head	list;
+};
+
+/**
+ * struct tmigr_cpu - per CPU timer migration state
+ * @tmgroup:		Level 0 group of the CPU
+ * @childidx:		Index of the CPU in @tmgroup
+ * @online:		The CPU takes part in the hierarchy
+ * @idle:		The CPU is idle and handed off its global timers
+ * @wakeup:		Time the idle CPU has to expire the global timers
+ *			of the whole idle hierarchy, KTIME_MAX if not in
+ *			charge
+ * @seq:		Incremented each time the CPU reports its state, so
+ *			that an expiry computed remotely in the meantime is
+ *			not written back over the CPU's own report
+ *
+ * Only modified by the CPU itself with interrupts disabled.
+ */
+struct tmigr_cpu {
+	struct tmigr_group	*tmgroup;
+	unsigned int		childidx;
+	bool			online;
+	bool			idle;
+	unsigned int		seq;
+	u64			wakeup;
+};
+
+#endif
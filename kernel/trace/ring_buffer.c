@@ -6,6 +6,7 @@
 #include <linux/trace_events.h>
 #include <linux/ring_buffer.h>
 #include <linux/trace_clock.h>
+#include <linux/trace_mmap.h>
 #include <linux/sched/clock.h>
 #include <linux/trace_seq.h>
 #include <linux/spinlock.h>
@@ -22,7 +23,9 @@
 #include <linux/hash.h>
 #include <linux/list.h>
 #include <linux/cpu.h>
+#include <linux/mm.h>
 
+#include <asm/cacheflush.h>
 #include <asm/local.h>
 
 static void update_pages_handler(struct work_struct *work);
@@ -302,6 +305,7 @@ struct buffer_page {
 	unsigned	 read;		/* index for next read */
 	local_t		 entries;	/* entries on this page */
 	unsigned long	 real_end;	/* real end of data */
+	unsigned	 id;		/* ID for external mapping */
 	struct buffer_data_page *page;	/* Actual data page */
 };
 
@@ -469,6 +473,12 @@ struct ring_buffer_per_cpu {
 	struct completion		update_done;
 
 	struct rb_irq_work		irq_work;
+
+	/* user space mapping of the buffer, see ring_buffer_map() */
+	struct mutex			mapping_lock;
+	unsigned long			*subbuf_ids;	/* ID to subbuf VA */
+	struct trace_buffer_meta	*meta_page;
+	int				mapped;
 };
 
 struct ring_buffer {
@@ -1223,6 +1233,7 @@ rb_allocate_cpu_buffer(struct ring_buffer *buffer, long nr_pages, int cpu)
 	init_irq_work(&cpu_buffer->irq_work.work, rb_wake_up_waiters);
 	init_waitqueue_head(&cpu_buffer->irq_work.waiters);
 	init_waitqueue_head(&cpu_buffer->irq_work.full_waiters);
+	mutex_init(&cpu_buffer->mapping_lock);
 
 	bpage = kzalloc_node(ALIGN(sizeof(*bpage), cache_line_size()),
 			    GFP_KERNEL, cpu_to_node(cpu));
@@ -1657,6 +1668,16 @@ int ring_buffer_resize(struct ring_buffer *buffer, unsigned long size,
 	/* prevent another thread from changing buffer sizes */
 	mutex_lock(&buffer->mutex);
 
+	/* The page layout of a mapped buffer is visible to user space */
+	for_each_buffer_cpu(buffer, cpu) {
+		if (cpu_id != RING_BUFFER_ALL_CPUS && cpu != cpu_id)
+			continue;
+		if (buffer->buffers[cpu]->mapped) {
+			mutex_unlock(&buffer->mutex);
+			return -EBUSY;
+		}
+	}
+
 	if (cpu_id == RING_BUFFER_ALL_CPUS) {
 		/* calculate the pages to update */
 		for_each_buffer_cpu(buffer, cpu) {
@@ -4215,6 +4236,30 @@ rb_reset_cpu(struct ring_buffer_per_cpu *cpu_buffer)
 	rb_head_page_activate(cpu_buffer);
 }
 
+/*
+ * Refresh the meta-page of a mapped cpu_buffer. Called with the
+ * reader_lock held.
+ */
+static void rb_update_meta_page(struct ring_buffer_per_cpu *cpu_buffer,
+				unsigned long lost_events)
+{
+	struct trace_buffer_meta *meta = cpu_buffer->meta_page;
+
+	if (!meta)
+		return;
+
+	meta->reader.read = cpu_buffer->reader_page->read;
+	meta->reader.id = cpu_buffer->reader_page->id;
+	meta->reader.lost_events = lost_events;
+
+	meta->entries = local_read(&cpu_buffer->entries);
+	meta->overrun = local_read(&cpu_buffer->overrun);
+	meta->read = cpu_buffer->read;
+
+	/* Some archs do not have data cache coherency with user space */
+	flush_dcache_page(virt_to_page(meta));
+}
+
 /**
  * ring_buffer_reset_cpu - reset a ring buffer per CPU buffer
  * @buffer: The ring buffer to reset a per cpu buffer of
@@ -4245,6 +4290,8 @@ void ring_buffer_reset_cpu(struct ring_buffer *buffer, int cpu)
 
 	arch_spin_unlock(&cpu_buffer->lock);
 
+	rb_update_meta_page(cpu_buffer, 0);
+
  out:
 	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
 
@@ -4364,6 +4411,11 @@ int ring_buffer_swap_cpu(struct ring_buffer *buffer_a,
 	if (atomic_read(&cpu_buffer_b->record_disabled))
 		goto out;
 
+	/* A mapped buffer can't have its pages swapped under user space */
+	ret = -EBUSY;
+	if (cpu_buffer_a->mapped || cpu_buffer_b->mapped)
+		goto out;
+
 	/*
 	 * We can't do a synchronize_sched here because this
 	 * function can be called in atomic context.
@@ -4574,7 +4626,8 @@ int ring_buffer_read_page(struct ring_buffer *buffer,
 	 * Otherwise, we can simply swap the page with the one passed in.
 	 */
 	if (read || (len < (commit - read)) ||
-	    cpu_buffer->reader_page == cpu_buffer->commit_page) {
+	    cpu_buffer->reader_page == cpu_buffer->commit_page ||
+	    cpu_buffer->mapped) {
 		struct buffer_data_page *rpage = cpu_buffer->reader_page->page;
 		unsigned int rpos = read;
 		unsigned int pos = 0;
@@ -4683,6 +4736,332 @@ int ring_buffer_read_page(struct ring_buffer *buffer,
 }
 EXPORT_SYMBOL_GPL(ring_buffer_read_page);
 
+/*
+ * Give every sub-buffer an ID, starting with the reader page and then
+ * walking the ring from the head page, and initialize the meta-page.
+ * The IDs are also the order in which the sub-buffers are mapped.
+ */
+static void rb_setup_ids_meta_page(struct ring_buffer_per_cpu *cpu_buffer,
+				   unsigned long *subbuf_ids)
+{
+	struct trace_buffer_meta *meta = cpu_buffer->meta_page;
+	unsigned int nr_subbufs = cpu_buffer->nr_pages + 1;
+	struct buffer_page *first_subbuf, *subbuf;
+	int id = 0;
+
+	subbuf_ids[id] = (unsigned long)cpu_buffer->reader_page->page;
+	cpu_buffer->reader_page->id = id++;
+
+	first_subbuf = subbuf = rb_set_head_page(cpu_buffer);
+	do {
+		if (RB_WARN_ON(cpu_buffer, id >= nr_subbufs))
+			break;
+
+		subbuf_ids[id] = (unsigned long)subbuf->page;
+		subbuf->id = id;
+
+		rb_inc_page(cpu_buffer, &subbuf);
+		id++;
+	} while (subbuf != first_subbuf);
+
+	/* install subbuf ID to kern VA translation */
+	cpu_buffer->subbuf_ids = subbuf_ids;
+
+	meta->meta_page_size = PAGE_SIZE;
+	meta->meta_struct_len = sizeof(*meta);
+	meta->nr_subbufs = nr_subbufs;
+	meta->subbuf_size = PAGE_SIZE;
+
+	rb_update_meta_page(cpu_buffer, 0);
+}
+
+static int __rb_map_vma(struct ring_buffer_per_cpu *cpu_buffer,
+			struct vm_area_struct *vma)
+{
+	unsigned long nr_subbufs, nr_pages, nr_vma_pages, pgoff = vma->vm_pgoff;
+	unsigned long addr = vma->vm_start;
+	unsigned int s = 0;
+	int err;
+
+	/* The mapping is read-only: user space can't tamper with the pages */
+	if (vma->vm_flags & VM_WRITE || vma->vm_flags & VM_EXEC ||
+	    !(vma->vm_flags & VM_MAYSHARE))
+		return -EPERM;
+
+	lockdep_assert_held(&cpu_buffer->mapping_lock);
+
+	nr_subbufs = cpu_buffer->nr_pages + 1;	/* + reader-subbuf */
+	nr_pages = nr_subbufs + 1;		/* + meta-page */
+	if (pgoff >= nr_pages)
+		return -EINVAL;
+	nr_pages -= pgoff;
+
+	nr_vma_pages = vma_pages(vma);
+	if (!nr_vma_pages || nr_vma_pages > nr_pages)
+		return -EINVAL;
+
+	vma->vm_flags |= VM_DONTCOPY | VM_DONTEXPAND | VM_DONTDUMP;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	if (!pgoff) {
+		err = vm_insert_page(vma, addr,
+				     virt_to_page(cpu_buffer->meta_page));
+		if (err)
+			return err;
+		addr += PAGE_SIZE;
+	} else {
+		s = pgoff - 1;
+	}
+
+	for (; addr < vma->vm_end; addr += PAGE_SIZE, s++) {
+		struct page *page;
+
+		if (WARN_ON_ONCE(s >= nr_subbufs))
+			return -EINVAL;
+
+		page = virt_to_page((void *)cpu_buffer->subbuf_ids[s]);
+		err = vm_insert_page(vma, addr, page);
+		if (err)
+			return err;
+	}
+
+	return 0;
+}
+
+/**
+ * ring_buffer_map - map a per CPU buffer into user space
+ * @buffer: the buffer the CPU buffer belongs to
+ * @cpu: the CPU buffer to map
+ * @vma: the user space mapping to populate
+ *
+ * Maps the meta-page followed by all the sub-buffers of the @cpu buffer
+ * read-only into @vma. While mapped, the buffer can't be resized or
+ * swapped, and ring_buffer_read_page() always copies the data out, so
+ * the pages seen by user space stay in place.
+ *
+ * Returns 0 on success and < 0 on failure.
+ */
+int ring_buffer_map(struct ring_buffer *buffer, int cpu,
+		    struct vm_area_struct *vma)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	unsigned long flags, *subbuf_ids;
+	struct page *meta;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	mutex_lock(&cpu_buffer->mapping_lock);
+
+	if (cpu_buffer->mapped) {
+		err = __rb_map_vma(cpu_buffer, vma);
+		if (!err)
+			cpu_buffer->mapped++;
+		mutex_unlock(&cpu_buffer->mapping_lock);
+		return err;
+	}
+
+	/* prevent another thread from changing buffer sizes */
+	mutex_lock(&buffer->mutex);
+
+	meta = alloc_pages_node(cpu_to_node(cpu), GFP_KERNEL | __GFP_ZERO, 0);
+	if (!meta) {
+		err = -ENOMEM;
+		goto unlock;
+	}
+
+	/* subbuf_ids include the reader while nr_pages does not */
+	subbuf_ids = kcalloc(cpu_buffer->nr_pages + 1, sizeof(*subbuf_ids),
+			     GFP_KERNEL);
+	if (!subbuf_ids) {
+		__free_page(meta);
+		err = -ENOMEM;
+		goto unlock;
+	}
+
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+	cpu_buffer->meta_page = page_address(meta);
+	rb_setup_ids_meta_page(cpu_buffer, subbuf_ids);
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+	err = __rb_map_vma(cpu_buffer, vma);
+	if (!err) {
+		cpu_buffer->mapped = 1;
+	} else {
+		raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+		cpu_buffer->meta_page = NULL;
+		cpu_buffer->subbuf_ids = NULL;
+		raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+		kfree(subbuf_ids);
+		__free_page(meta);
+	}
+
+unlock:
+	mutex_unlock(&buffer->mutex);
+	mutex_unlock(&cpu_buffer->mapping_lock);
+
+	return err;
+}
+EXPORT_SYMBOL_GPL(ring_buffer_map);
+
+/**
+ * ring_buffer_map_dup - account a copy of an existing user space mapping
+ * @buffer: the buffer the CPU buffer belongs to
+ * @cpu: the mapped CPU buffer
+ *
+ * The mm duplicates a mapping when it is moved with mremap(): the pages are
+ * carried over, only the extra ring_buffer_unmap() needs accounting for.
+ */
+int ring_buffer_map_dup(struct ring_buffer *buffer, int cpu)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	mutex_lock(&cpu_buffer->mapping_lock);
+
+	if (cpu_buffer->mapped)
+		cpu_buffer->mapped++;
+	else
+		err = -ENODEV;
+
+	mutex_unlock(&cpu_buffer->mapping_lock);
+
+	return err;
+}
+EXPORT_SYMBOL_GPL(ring_buffer_map_dup);
+
+/**
+ * ring_buffer_unmap - drop a user space mapping of a per CPU buffer
+ * @buffer: the buffer the CPU buffer belongs to
+ * @cpu: the CPU buffer to unmap
+ *
+ * Releases the meta-page once the last mapping is gone.
+ */
+int ring_buffer_unmap(struct ring_buffer *buffer, int cpu)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	struct trace_buffer_meta *meta;
+	unsigned long flags, *subbuf_ids;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	mutex_lock(&cpu_buffer->mapping_lock);
+
+	if (!cpu_buffer->mapped) {
+		err = -ENODEV;
+		goto out;
+	} else if (cpu_buffer->mapped > 1) {
+		cpu_buffer->mapped--;
+		goto out;
+	}
+
+	mutex_lock(&buffer->mutex);
+
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+	meta = cpu_buffer->meta_page;
+	subbuf_ids = cpu_buffer->subbuf_ids;
+	cpu_buffer->meta_page = NULL;
+	cpu_buffer->subbuf_ids = NULL;
+	cpu_buffer->mapped = 0;
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+	kfree(subbuf_ids);
+	free_page((unsigned long)meta);
+
+	mutex_unlock(&buffer->mutex);
+out:
+	mutex_unlock(&cpu_buffer->mapping_lock);
+
+	return err;
+}
+EXPORT_SYMBOL_GPL(ring_buffer_unmap);
+
+/**
+ * ring_buffer_map_get_reader - hand the next reader page to user space
+ * @buffer: the buffer the CPU buffer belongs to
+ * @cpu: the mapped CPU buffer
+ *
+ * Everything up to the writer on the current reader page is considered
+ * consumed by user space. Once the reader page has been entirely read,
+ * it is swapped with the head page so that the next batch of events can
+ * be parsed in place. The meta-page is updated accordingly.
+ */
+int ring_buffer_map_get_reader(struct ring_buffer *buffer, int cpu)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	unsigned long missed_events = 0;
+	struct buffer_page *reader;
+	unsigned long reader_size;
+	unsigned long flags;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	mutex_lock(&cpu_buffer->mapping_lock);
+
+	if (!cpu_buffer->mapped) {
+		err = -ENODEV;
+		goto out_unlock;
+	}
+
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+
+consume:
+	if (rb_per_cpu_empty(cpu_buffer))
+		goto out;
+
+	reader_size = rb_page_size(cpu_buffer->reader_page);
+
+	/*
+	 * There is data to be read on the current reader page: user space
+	 * is going to read all of it, advance the kernel reader accordingly.
+	 */
+	if (cpu_buffer->reader_page->read < reader_size) {
+		while (cpu_buffer->reader_page->read < reader_size)
+			rb_advance_reader(cpu_buffer);
+		goto out;
+	}
+
+	reader = rb_get_reader_page(cpu_buffer);
+	if (RB_WARN_ON(cpu_buffer, !reader))
+		goto out;
+
+	/* Report the events dropped before the new reader page */
+	missed_events = cpu_buffer->lost_events;
+	cpu_buffer->lost_events = 0;
+
+	goto consume;
+
+out:
+	/* Some archs do not have data cache coherency with user space */
+	flush_dcache_page(virt_to_page(cpu_buffer->reader_page->page));
+
+	rb_update_meta_page(cpu_buffer, missed_events);
+
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+out_unlock:
+	mutex_unlock(&cpu_buffer->mapping_lock);
+
+	return err;
+}
+EXPORT_SYMBOL_GPL(ring_buffer_map_get_reader);
+
 /*
  * We only allocate new buffers, never free them if the CPU goes down.
  * If we were to free the buffer, then the user would lose any trace that was in
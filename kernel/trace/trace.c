@@ -42,6 +42,7 @@
 #include <linux/fs.h>
 #include <linux/trace.h>
 #include <linux/sched/rt.h>
+#include <linux/trace_mmap.h>
 
 #include "trace.h"
 #include "trace_output.h"
@@ -956,6 +957,10 @@ int tracing_alloc_snapshot_instance(struct trace_array *tr)
 
 	if (!tr->allocated_snapshot) {
 
+		/* snapshots swap the buffers user space has mapped */
+		if (tr->mapped)
+			return -EBUSY;
+
 		/* allocate spare buffer */
 		ret = resize_buffer_duplicate_size(&tr->max_buffer,
 				   &tr->trace_buffer, RING_BUFFER_ALL_CPUS);
@@ -6872,12 +6877,122 @@ out:
 	return ret;
 }
 
+static long tracing_buffers_ioctl(struct file *file, unsigned int cmd,
+				  unsigned long arg)
+{
+	struct ftrace_buffer_info *info = file->private_data;
+	struct trace_iterator *iter = &info->iter;
+	int err;
+
+	if (cmd != TRACE_MMAP_IOCTL_GET_READER)
+		return -ENOTTY;
+
+	if (!(file->f_flags & O_NONBLOCK)) {
+		err = wait_on_pipe(iter, false);
+		if (err)
+			return err;
+	}
+
+	return ring_buffer_map_get_reader(iter->trace_buffer->buffer,
+					  iter->cpu_file);
+}
+
+/*
+ * Taking a snapshot swaps the live buffer with the max_buffer, which
+ * would pull the mapped pages from under user space: both are exclusive.
+ */
+static int get_snapshot_map(struct trace_array *tr)
+{
+	int err = 0;
+
+#ifdef CONFIG_TRACER_MAX_TRACE
+	mutex_lock(&trace_types_lock);
+	if (tr->allocated_snapshot)
+		err = -EBUSY;
+	else
+		tr->mapped++;
+	mutex_unlock(&trace_types_lock);
+#endif
+
+	return err;
+}
+
+static void put_snapshot_map(struct trace_array *tr)
+{
+#ifdef CONFIG_TRACER_MAX_TRACE
+	mutex_lock(&trace_types_lock);
+	if (!WARN_ON(!tr->mapped))
+		tr->mapped--;
+	mutex_unlock(&trace_types_lock);
+#endif
+}
+
+/* mremap() duplicates the VMA: take the reference its close will drop */
+static void tracing_buffers_mmap_open(struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = vma->vm_file->private_data;
+	struct trace_iterator *iter = &info->iter;
+
+	WARN_ON(ring_buffer_map_dup(iter->trace_buffer->buffer,
+				    iter->cpu_file));
+	WARN_ON(get_snapshot_map(iter->tr));
+}
+
+static void tracing_buffers_mmap_close(struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = vma->vm_file->private_data;
+	struct trace_iterator *iter = &info->iter;
+
+	WARN_ON(ring_buffer_unmap(iter->trace_buffer->buffer, iter->cpu_file));
+	put_snapshot_map(iter->tr);
+}
+
+/* The mapping is accounted per VMA, it must not be split */
+static int tracing_buffers_mmap_split(struct vm_area_struct *vma,
+				      unsigned long addr)
+{
+	return -EINVAL;
+}
+
+static const struct vm_operations_struct tracing_buffers_vmops = {
+	.open		= tracing_buffers_mmap_open,
+	.close		= tracing_buffers_mmap_close,
+	.split		= tracing_buffers_mmap_split,
+};
+
+static int tracing_buffers_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct ftrace_buffer_info *info = filp->private_data;
+	struct trace_iterator *iter = &info->iter;
+	int ret;
+
+	if (iter->cpu_file == RING_BUFFER_ALL_CPUS)
+		return -EINVAL;
+
+	ret = get_snapshot_map(iter->tr);
+	if (ret)
+		return ret;
+
+	ret = ring_buffer_map(iter->trace_buffer->buffer, iter->cpu_file, vma);
+	if (ret) {
+		put_snapshot_map(iter->tr);
+		return ret;
+	}
+
+	vma->vm_ops = &tracing_buffers_vmops;
+
+	return 0;
+}
+
 static const struct file_operations tracing_buffers_fops = {
 	.open		= tracing_buffers_open,
 	.read		= tracing_buffers_read,
 	.poll		= tracing_buffers_poll,
 	.release	= tracing_buffers_release,
 	.splice_read	= tracing_buffers_splice_read,
+	.unlocked_ioctl = tracing_buffers_ioctl,
+	.compat_ioctl	= tracing_buffers_ioctl,
+	.mmap		= tracing_buffers_mmap,
 	.llseek		= no_llseek,
 };
 
@@ -8189,7 +8304,6 @@ void ftrace_dump(enum ftrace_dump_mode oops_dump_mode)
 	tracing_off();
 
 	local_irq_save(flags);
-	printk_nmi_direct_enter();
 
 	/* Simulate the iterator */
 	trace_init_global_iter(&iter);
@@ -8270,7 +8384,6 @@ void ftrace_dump(enum ftrace_dump_mode oops_dump_mode)
 		atomic_dec(&per_cpu_ptr(iter.trace_buffer->data, cpu)->disabled);
 	}
 	atomic_dec(&dump_running);
-	printk_nmi_direct_exit();
 	local_irq_restore(flags);
 }
 EXPORT_SYMBOL_GPL(ftrace_dump);
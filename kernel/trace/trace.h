@@ -217,6 +217,8 @@ struct trace_array {
 	 */
 	struct trace_buffer	max_buffer;
 	bool			allocated_snapshot;
+	/* per CPU buffers mapped in user space, see tracing_buffers_mmap() */
+	unsigned int		mapped;
 #endif
 #if defined(CONFIG_TRACER_MAX_TRACE) || defined(CONFIG_HWLAT_TRACER)
 	unsigned long		max_latency;
@@ -0,0 +1,708 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Range trees: B-trees of non-overlapping [start, end) ranges
+ *
+ * All the leaves are at the same depth. Every node but the root has between
+ * RANGE_TREE_MIN and RANGE_TREE_SLOTS slots in use, a leaf root has at least
+ * one, an inner root at least two. Insertions split full nodes on their way
+ * back up, erasures borrow from or merge with a sibling.
+ *
+ * There are no parent pointers: the modifications record the path they walk
+ * down, which is short given the fan-out.
+ */
+
+#include <linux/bug.h>
+#include <linux/errno.h>
+#include <linux/export.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/printk.h>
+#include <linux/range_tree.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#define RANGE_TREE_SLOTS	16
+#define RANGE_TREE_MIN		(RANGE_TREE_SLOTS / 2)
+#define RANGE_TREE_MAX_HEIGHT	16
+
+/*
+ * In a leaf, slot[i] is the entry indexed with [start[i], end[i]) and gap[i]
+ * is zero. In an inner node, slot[i] is a child node, start[i] and end[i] are
+ * the bounds of the first and last ranges below it, and gap[i] is the largest
+ * gap between two consecutive ranges below it.
+ *
+ * end[] comes first as it is what lookups scan.
+ */
+struct range_tree_node {
+	unsigned long	end[RANGE_TREE_SLOTS];
+	unsigned long	start[RANGE_TREE_SLOTS];
+	void		*slot[RANGE_TREE_SLOTS];
+	unsigned long	gap[RANGE_TREE_SLOTS];
+	unsigned int	count;
+};
+
+/* The nodes and slot positions walked down, indexed by level, 0 is a leaf */
+struct range_tree_path {
+	struct range_tree_node	*node[RANGE_TREE_MAX_HEIGHT];
+	unsigned int		pos[RANGE_TREE_MAX_HEIGHT];
+};
+
+static struct kmem_cache *range_tree_cachep __read_mostly;
+
+/* Position of the first slot whose ranges end above addr, or node->count */
+static inline unsigned int node_find(const struct range_tree_node *node,
+				     unsigned long addr)
+{
+	unsigned int i;
+
+	for (i = 0; i < node->count; i++)
+		if (node->end[i] > addr)
+			break;
+	return i;
+}
+
+/* Largest gap between two consecutive ranges below node */
+static unsigned long node_gap(const struct range_tree_node *node)
+{
+	unsigned long max = 0;
+	unsigned int i;
+
+	for (i = 0; i < node->count; i++) {
+		if (node->gap[i] > max)
+			max = node->gap[i];
+		if (i && node->start[i] - node->end[i - 1] > max)
+			max = node->start[i] - node->end[i - 1];
+	}
+	return max;
+}
+
+/* Refresh the bounds and gap of slot pos of an inner node */
+static void node_update(struct range_tree_node *node, unsigned int pos)
+{
+	const struct range_tree_node *child = node->slot[pos];
+
+	node->start[pos] = child->start[0];
+	node->end[pos] = child->end[child->count - 1];
+	node->gap[pos] = node_gap(child);
+}
+
+static void node_copy(struct range_tree_node *dst, unsigned int dpos,
+		      const struct range_tree_node *src, unsigned int spos,
+		      unsigned int n)
+{
+	memmove(&dst->end[dpos], &src->end[spos], n * sizeof(dst->end[0]));
+	memmove(&dst->start[dpos], &src->start[spos], n * sizeof(dst->start[0]));
+	memmove(&dst->slot[dpos], &src->slot[spos], n * sizeof(dst->slot[0]));
+	memmove(&dst->gap[dpos], &src->gap[spos], n * sizeof(dst->gap[0]));
+}
+
+static void node_insert(struct range_tree_node *node, unsigned int pos,
+			unsigned long start, unsigned long end,
+			unsigned long gap, void *slot)
+{
+	node_copy(node, pos + 1, node, pos, node->count - pos);
+	node->end[pos] = end;
+	node->start[pos] = start;
+	node->slot[pos] = slot;
+	node->gap[pos] = gap;
+	node->count++;
+}
+
+static void node_remove(struct range_tree_node *node, unsigned int pos)
+{
+	node_copy(node, pos, node, pos + 1, node->count - pos - 1);
+	node->count--;
+}
+
+static struct range_tree_node *node_alloc(struct range_tree *rt)
+{
+	struct range_tree_node *node = rt->spare;
+
+	if (node) {
+		rt->spare = node->slot[0];
+		rt->nr_spare--;
+	} else {
+		node = kmem_cache_alloc(range_tree_cachep,
+					GFP_NOWAIT | __GFP_NOWARN);
+		if (!node)
+			return NULL;
+	}
+	node->count = 0;
+	return node;
+}
+
+/* Keep the node for the next insertion if the reserve isn't full */
+static void node_free(struct range_tree *rt, struct range_tree_node *node)
+{
+	if (rt->nr_spare > rt->height) {
+		kmem_cache_free(range_tree_cachep, node);
+		return;
+	}
+	node->slot[0] = rt->spare;
+	rt->spare = node;
+	rt->nr_spare++;
+}
+
+/*
+ * Walk down to the leaf slot of the first range ending above addr. If there
+ * is none, the path leads to the end of the last leaf.
+ */
+static void range_tree_walk(const struct range_tree *rt, unsigned long addr,
+			    struct range_tree_path *path)
+{
+	struct range_tree_node *node = rt->root;
+	unsigned int level = rt->height;
+	unsigned int pos;
+
+	while (level--) {
+		pos = node_find(node, addr);
+		path->node[level] = node;
+		if (level) {
+			if (pos == node->count)
+				pos--;
+			node = node->slot[pos];
+		}
+		path->pos[level] = pos;
+	}
+}
+
+/**
+ * range_tree_find - look up the first range ending above an address
+ * @rt: the range tree
+ * @addr: the address
+ *
+ * Returns the entry of the range containing @addr or, if there is none, of
+ * the first range above @addr. NULL if no range ends above @addr.
+ */
+void *range_tree_find(const struct range_tree *rt, unsigned long addr)
+{
+	const struct range_tree_node *node = rt->root;
+	unsigned int level = rt->height;
+	unsigned int pos;
+
+	if (!node)
+		return NULL;
+
+	for (;;) {
+		pos = node_find(node, addr);
+		if (pos == node->count)
+			return NULL;
+		if (!--level)
+			return node->slot[pos];
+		node = node->slot[pos];
+	}
+}
+EXPORT_SYMBOL(range_tree_find);
+
+/**
+ * range_tree_last - look up the highest range
+ * @rt: the range tree
+ *
+ * Returns the entry of the highest range, NULL if the tree is empty.
+ */
+void *range_tree_last(const struct range_tree *rt)
+{
+	const struct range_tree_node *node = rt->root;
+	unsigned int level = rt->height;
+
+	if (!node)
+		return NULL;
+
+	while (--level)
+		node = node->slot[node->count - 1];
+	return node->slot[node->count - 1];
+}
+EXPORT_SYMBOL(range_tree_last);
+
+/**
+ * range_tree_preload - reserve the nodes needed by an insertion
+ * @rt: the range tree
+ * @gfp: allocation flags
+ *
+ * An insertion splits at most every node on its path and adds a new root,
+ * make sure that many nodes are available so that the next insertion into
+ * @rt cannot fail. The reserve stays with the tree until it is destroyed.
+ *
+ * Returns 0 or -ENOMEM.
+ */
+int range_tree_preload(struct range_tree *rt, gfp_t gfp)
+{
+	struct range_tree_node *node;
+
+	while (rt->nr_spare <= rt->height) {
+		node = kmem_cache_alloc(range_tree_cachep, gfp);
+		if (!node)
+			return -ENOMEM;
+		node->slot[0] = rt->spare;
+		rt->spare = node;
+		rt->nr_spare++;
+	}
+	return 0;
+}
+EXPORT_SYMBOL(range_tree_preload);
+
+/**
+ * range_tree_insert - index a range
+ * @rt: the range tree
+ * @start: first address of the range
+ * @end: first address above the range
+ * @entry: the pointer to store
+ *
+ * Returns 0, -EEXIST if the range overlaps an indexed one, or -ENOMEM if
+ * a node was needed and the tree wasn't preloaded. @rt is left untouched
+ * on failure.
+ */
+int range_tree_insert(struct range_tree *rt, unsigned long start,
+		      unsigned long end, void *entry)
+{
+	struct range_tree_node *new[RANGE_TREE_MAX_HEIGHT + 1];
+	struct range_tree_node *node, *right;
+	struct range_tree_path path;
+	unsigned int level, pos, need, i;
+	unsigned long gap = 0;
+	void *slot = entry;
+
+	if (WARN_ON_ONCE(start >= end))
+		return -EINVAL;
+
+	if (!rt->root) {
+		node = node_alloc(rt);
+		if (!node)
+			return -ENOMEM;
+		node_insert(node, 0, start, end, 0, entry);
+		rt->root = node;
+		rt->height = 1;
+		return 0;
+	}
+
+	range_tree_walk(rt, start, &path);
+	node = path.node[0];
+	pos = path.pos[0];
+	if (pos < node->count && node->start[pos] < end)
+		return -EEXIST;
+
+	/* Get a node for each full node on the path, and one more for a root */
+	for (need = 0; need < rt->height; need++)
+		if (path.node[need]->count < RANGE_TREE_SLOTS)
+			break;
+	if (need == rt->height) {
+		if (WARN_ON_ONCE(rt->height == RANGE_TREE_MAX_HEIGHT))
+			return -ENOMEM;
+		need++;
+	}
+	for (i = 0; i < need; i++) {
+		new[i] = node_alloc(rt);
+		if (!new[i]) {
+			while (i--)
+				node_free(rt, new[i]);
+			return -ENOMEM;
+		}
+	}
+
+	i = 0;
+	for (level = 0; level < rt->height; level++) {
+		node = path.node[level];
+		pos = path.pos[level];
+		if (level) {
+			/* The child at pos was split, its sibling goes next */
+			node_update(node, pos);
+			pos++;
+		}
+
+		if (node->count < RANGE_TREE_SLOTS) {
+			node_insert(node, pos, start, end, gap, slot);
+			break;
+		}
+
+		right = new[i++];
+		node_copy(right, 0, node, RANGE_TREE_MIN,
+			  RANGE_TREE_SLOTS - RANGE_TREE_MIN);
+		right->count = RANGE_TREE_SLOTS - RANGE_TREE_MIN;
+		node->count = RANGE_TREE_MIN;
+		if (pos <= node->count)
+			node_insert(node, pos, start, end, gap, slot);
+		else
+			node_insert(right, pos - node->count, start, end, gap,
+				    slot);
+
+		start = right->start[0];
+		end = right->end[right->count - 1];
+		gap = node_gap(right);
+		slot = right;
+	}
+
+	if (level == rt->height) {
+		/* The root was split, add a level */
+		right = rt->root;
+		node = new[i];
+		node_insert(node, 0, right->start[0],
+			    right->end[right->count - 1], node_gap(right), right);
+		node_insert(node, 1, start, end, gap, slot);
+		rt->root = node;
+		rt->height++;
+		return 0;
+	}
+
+	while (++level < rt->height)
+		node_update(path.node[level], path.pos[level]);
+	return 0;
+}
+EXPORT_SYMBOL(range_tree_insert);
+
+/**
+ * range_tree_erase - remove a range
+ * @rt: the range tree
+ * @start: first address of the range
+ *
+ * Returns the entry of the removed range, NULL if no range starts at @start.
+ */
+void *range_tree_erase(struct range_tree *rt, unsigned long start)
+{
+	struct range_tree_node *node, *parent, *sibling;
+	struct range_tree_path path;
+	unsigned int level, pos, i;
+	void *entry;
+
+	if (!rt->root)
+		return NULL;
+
+	range_tree_walk(rt, start, &path);
+	node = path.node[0];
+	pos = path.pos[0];
+	if (pos == node->count || node->start[pos] != start)
+		return NULL;
+
+	entry = node->slot[pos];
+	node_remove(node, pos);
+
+	for (level = 0; level + 1 < rt->height; level++) {
+		node = path.node[level];
+		if (node->count >= RANGE_TREE_MIN)
+			break;
+
+		parent = path.node[level + 1];
+		pos = path.pos[level + 1];
+
+		/* Borrow a slot from a sibling which can spare one... */
+		if (pos > 0) {
+			sibling = parent->slot[pos - 1];
+			if (sibling->count > RANGE_TREE_MIN) {
+				i = sibling->count - 1;
+				node_insert(node, 0, sibling->start[i],
+					    sibling->end[i], sibling->gap[i],
+					    sibling->slot[i]);
+				sibling->count--;
+				node_update(parent, pos - 1);
+				break;
+			}
+		}
+		if (pos + 1 < parent->count) {
+			sibling = parent->slot[pos + 1];
+			if (sibling->count > RANGE_TREE_MIN) {
+				node_insert(node, node->count,
+					    sibling->start[0], sibling->end[0],
+					    sibling->gap[0], sibling->slot[0]);
+				node_remove(sibling, 0);
+				node_update(parent, pos + 1);
+				break;
+			}
+		}
+
+		/* ... or merge with one, the parent loses a slot */
+		if (pos > 0) {
+			sibling = parent->slot[pos - 1];
+			node_copy(sibling, sibling->count, node, 0, node->count);
+			sibling->count += node->count;
+			node_remove(parent, pos);
+			node_free(rt, node);
+			pos--;
+		} else {
+			sibling = parent->slot[pos + 1];
+			node_copy(node, node->count, sibling, 0, sibling->count);
+			node->count += sibling->count;
+			node_remove(parent, pos + 1);
+			node_free(rt, sibling);
+		}
+		node_update(parent, pos);
+		path.pos[level + 1] = pos;
+	}
+
+	while (++level < rt->height)
+		node_update(path.node[level], path.pos[level]);
+
+	node = rt->root;
+	if (rt->height > 1 && node->count == 1) {
+		rt->root = node->slot[0];
+		rt->height--;
+		node_free(rt, node);
+	} else if (!node->count) {
+		rt->root = NULL;
+		rt->height = 0;
+		node_free(rt, node);
+	}
+	return entry;
+}
+EXPORT_SYMBOL(range_tree_erase);
+
+/**
+ * range_tree_adjust - change the bounds of a range
+ * @rt: the range tree
+ * @start: current first address of the range
+ * @new_start: new first address of the range
+ * @new_end: new first address above the range
+ *
+ * The range must stay between its neighbours: when moving the boundary
+ * between two ranges, shrink the one losing addresses first.
+ *
+ * This does not change the shape of the tree, and may be called while
+ * lookups are running.
+ */
+void range_tree_adjust(struct range_tree *rt, unsigned long start,
+		       unsigned long new_start, unsigned long new_end)
+{
+	struct range_tree_path path;
+	struct range_tree_node *node;
+	unsigned int level, pos;
+
+	if (WARN_ON_ONCE(!rt->root || new_start >= new_end))
+		return;
+
+	range_tree_walk(rt, start, &path);
+	node = path.node[0];
+	pos = path.pos[0];
+	if (WARN_ON_ONCE(pos == node->count || node->start[pos] != start))
+		return;
+
+	node->start[pos] = new_start;
+	node->end[pos] = new_end;
+	for (level = 1; level < rt->height; level++)
+		node_update(path.node[level], path.pos[level]);
+}
+EXPORT_SYMBOL(range_tree_adjust);
+
+/*
+ * The free gaps are the areas between the ranges, below the first one and
+ * above the last one up to ULONG_MAX. These search for a gap which fits
+ * size bytes inside [low, high) below node, given the end of the range
+ * preceding node, or the start of the range following it. level is the
+ * number of levels below node.
+ */
+static bool gap_fits(unsigned long gap_start, unsigned long gap_end,
+		     unsigned long low, unsigned long high, unsigned long size)
+{
+	gap_start = max(gap_start, low);
+	gap_end = min(gap_end, high);
+	return gap_start < gap_end && gap_end - gap_start >= size;
+}
+
+static bool empty_area(const struct range_tree_node *node, unsigned int level,
+		       unsigned long prev_end, unsigned long low,
+		       unsigned long high, unsigned long size,
+		       unsigned long *addr)
+{
+	unsigned int i;
+
+	for (i = 0; i < node->count; i++) {
+		if (gap_fits(prev_end, node->start[i], low, high, size)) {
+			*addr = max(prev_end, low);
+			return true;
+		}
+		if (node->start[i] >= high)
+			return false;
+		if (level && node->gap[i] >= size && node->end[i] > low &&
+		    empty_area(node->slot[i], level - 1, prev_end, low, high,
+			       size, addr))
+			return true;
+		prev_end = node->end[i];
+	}
+	return false;
+}
+
+static bool empty_area_rev(const struct range_tree_node *node,
+			   unsigned int level, unsigned long next_start,
+			   unsigned long low, unsigned long high,
+			   unsigned long size, unsigned long *addr)
+{
+	unsigned int i = node->count;
+
+	while (i--) {
+		if (gap_fits(node->end[i], next_start, low, high, size)) {
+			*addr = min(next_start, high) - size;
+			return true;
+		}
+		if (node->end[i] <= low)
+			return false;
+		if (level && node->gap[i] >= size && node->start[i] < high &&
+		    empty_area_rev(node->slot[i], level - 1, next_start, low,
+				   high, size, addr))
+			return true;
+		next_start = node->start[i];
+	}
+	return false;
+}
+
+/**
+ * range_tree_empty_area - find the lowest free area of a given size
+ * @rt: the range tree
+ * @low: lowest address of the area
+ * @high: highest end of the area
+ * @size: size of the area
+ * @addr: returns the start of the area
+ *
+ * Returns 0, or -EBUSY if no range-free area of @size bytes fits in
+ * [@low, @high).
+ */
+int range_tree_empty_area(const struct range_tree *rt, unsigned long low,
+			  unsigned long high, unsigned long size,
+			  unsigned long *addr)
+{
+	const struct range_tree_node *root = rt->root;
+	unsigned long last_end = 0;
+
+	if (!size || low >= high || high - low < size)
+		return -EBUSY;
+
+	if (root) {
+		if (empty_area(root, rt->height - 1, 0, low, high, size, addr))
+			return 0;
+		last_end = root->end[root->count - 1];
+	}
+	if (gap_fits(last_end, ULONG_MAX, low, high, size)) {
+		*addr = max(last_end, low);
+		return 0;
+	}
+	return -EBUSY;
+}
+EXPORT_SYMBOL(range_tree_empty_area);
+
+/**
+ * range_tree_empty_area_rev - find the highest free area of a given size
+ * @rt: the range tree
+ * @low: lowest address of the area
+ * @high: highest end of the area
+ * @size: size of the area
+ * @addr: returns the start of the area
+ *
+ * Returns 0, or -EBUSY if no range-free area of @size bytes fits in
+ * [@low, @high).
+ */
+int range_tree_empty_area_rev(const struct range_tree *rt, unsigned long low,
+			      unsigned long high, unsigned long size,
+			      unsigned long *addr)
+{
+	const struct range_tree_node *root = rt->root;
+	unsigned long first_start = ULONG_MAX;
+
+	if (!size || low >= high || high - low < size)
+		return -EBUSY;
+
+	if (root) {
+		if (empty_area_rev(root, rt->height - 1, ULONG_MAX, low, high,
+				   size, addr))
+			return 0;
+		first_start = root->start[0];
+	}
+	if (gap_fits(0, first_start, low, high, size)) {
+		*addr = min(first_start, high) - size;
+		return 0;
+	}
+	return -EBUSY;
+}
+EXPORT_SYMBOL(range_tree_empty_area_rev);
+
+static void node_destroy(struct range_tree_node *node, unsigned int level)
+{
+	unsigned int i;
+
+	if (level)
+		for (i = 0; i < node->count; i++)
+			node_destroy(node->slot[i], level - 1);
+	kmem_cache_free(range_tree_cachep, node);
+}
+
+/**
+ * range_tree_destroy - free all the nodes of a range tree
+ * @rt: the range tree
+ *
+ * The entries are left alone, @rt is empty afterwards.
+ */
+void range_tree_destroy(struct range_tree *rt)
+{
+	struct range_tree_node *node;
+
+	if (rt->root)
+		node_destroy(rt->root, rt->height - 1);
+	while ((node = rt->spare)) {
+		rt->spare = node->slot[0];
+		kmem_cache_free(range_tree_cachep, node);
+	}
+	INIT_RANGE_TREE(rt);
+}
+EXPORT_SYMBOL(range_tree_destroy);
+
+static bool node_valid(const struct range_tree_node *node, unsigned int level,
+		       bool root, unsigned long *prev_end)
+{
+	const struct range_tree_node *child;
+	unsigned int min = root ? (level ? 2 : 1) : RANGE_TREE_MIN;
+	unsigned int i;
+
+	if (node->count < min || node->count > RANGE_TREE_SLOTS) {
+		pr_err("range_tree: node %p at level %u has %u slots\n",
+		       node, level, node->count);
+		return false;
+	}
+
+	for (i = 0; i < node->count; i++) {
+		if (node->start[i] >= node->end[i] ||
+		    node->start[i] < *prev_end) {
+			pr_err("range_tree: bad range [%lx, %lx) after %lx\n",
+			       node->start[i], node->end[i], *prev_end);
+			return false;
+		}
+		if (!level) {
+			if (node->gap[i]) {
+				pr_err("range_tree: leaf gap %lx\n",
+				       node->gap[i]);
+				return false;
+			}
+			*prev_end = node->end[i];
+			continue;
+		}
+
+		child = node->slot[i];
+		if (!node_valid(child, level - 1, false, prev_end))
+			return false;
+		if (node->start[i] != child->start[0] ||
+		    node->end[i] != child->end[child->count - 1] ||
+		    node->gap[i] != node_gap(child)) {
+			pr_err("range_tree: stale slot [%lx, %lx) gap %lx\n",
+			       node->start[i], node->end[i], node->gap[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * range_tree_valid - check the invariants of a range tree
+ * @rt: the range tree
+ *
+ * For debugging, reports the first problem found.
+ */
+bool range_tree_valid(const struct range_tree *rt)
+{
+	unsigned long prev_end = 0;
+
+	if (!rt->root)
+		return !rt->height;
+	return node_valid(rt->root, rt->height - 1, true, &prev_end);
+}
+EXPORT_SYMBOL(range_tree_valid);
+
+void __init range_tree_init(void)
+{
+	range_tree_cachep = kmem_cache_create("range_tree_node",
+			sizeof(struct range_tree_node), 0,
+			SLAB_HWCACHE_ALIGN | SLAB_PANIC | SLAB_ACCOUNT, NULL);
+}
@@ -0,0 +1,336 @@
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/range_tree.h>
+#include <linux/random.h>
+#include <linux/slab.h>
+#include <asm/timex.h>
+
+#define __param(type, name, init, msg)		\
+	static type name = init;		\
+	module_param(name, type, 0444);		\
+	MODULE_PARM_DESC(name, msg);
+
+__param(int, nnodes, 1000, "Number of ranges in the range tree");
+__param(int, perf_loops, 100, "Number of iterations modifying the tree");
+__param(int, check_loops, 10, "Number of iterations checking the tree");
+
+__param(int, nsearches, 1000, "Number of searches to the range tree");
+__param(int, search_loops, 100, "Number of iterations searching the tree");
+
+/* Each range sits at the bottom of its own STRIDE sized slot */
+#define STRIDE	(16 * PAGE_SIZE)
+
+struct test_range {
+	unsigned long start;
+	unsigned long end;
+};
+
+static struct range_tree rt = RANGE_TREE_INIT;
+static struct test_range *ranges;
+/* The ranges sorted by address, as they stay within their slots */
+static struct test_range **by_addr;
+static unsigned long *queries;
+
+static struct rnd_state rnd;
+
+static void init(void)
+{
+	struct test_range tmp;
+	int i, j;
+
+	for (i = 0; i < nnodes; i++) {
+		ranges[i].start = (i + 1) * STRIDE;
+		ranges[i].end = ranges[i].start + PAGE_SIZE *
+			(1 + prandom_u32_state(&rnd) % (STRIDE / PAGE_SIZE - 1));
+	}
+
+	/* Insert them in random order */
+	for (i = nnodes - 1; i > 0; i--) {
+		j = prandom_u32_state(&rnd) % (i + 1);
+		tmp = ranges[i];
+		ranges[i] = ranges[j];
+		ranges[j] = tmp;
+	}
+
+	for (i = 0; i < nnodes; i++)
+		by_addr[ranges[i].start / STRIDE - 1] = ranges + i;
+
+	for (i = 0; i < nsearches; i++)
+		queries[i] = prandom_u32_state(&rnd) % ((nnodes + 1) * STRIDE);
+}
+
+static int insert(struct test_range *range)
+{
+	int ret = range_tree_preload(&rt, GFP_KERNEL);
+
+	if (!ret)
+		ret = range_tree_insert(&rt, range->start, range->end, range);
+	return ret;
+}
+
+static bool check(int nr_inserted)
+{
+	struct test_range *range;
+	unsigned long addr = 0;
+	int count = 0;
+	bool ok = range_tree_valid(&rt);
+
+	while ((range = range_tree_find(&rt, addr))) {
+		ok &= range->start >= addr;
+		addr = range->end;
+		count++;
+	}
+	ok &= count == nr_inserted;
+
+	return !WARN_ON_ONCE(!ok);
+}
+
+/* Every range must be found at both of its ends, once all are inserted */
+static bool check_bounds(void)
+{
+	bool ok = check(nnodes);
+	int i;
+
+	for (i = 0; i < nnodes; i++) {
+		struct test_range *range = by_addr[i];
+
+		ok &= range_tree_find(&rt, range->start) == range;
+		ok &= range_tree_find(&rt, range->end - 1) == range;
+		ok &= range_tree_find(&rt, range->start - 1) == range;
+	}
+
+	return !WARN_ON_ONCE(!ok);
+}
+
+/* The lowest and highest gaps found by scanning all the ranges */
+static int scan_empty_area(unsigned long low, unsigned long high,
+			   unsigned long size, unsigned long *addr)
+{
+	unsigned long prev_end = 0, gap_start, gap_end;
+	int i;
+
+	for (i = 0; i <= nnodes; i++) {
+		gap_start = max(prev_end, low);
+		gap_end = min(i < nnodes ? by_addr[i]->start : ULONG_MAX, high);
+		if (gap_start < gap_end && gap_end - gap_start >= size) {
+			*addr = gap_start;
+			return 0;
+		}
+		if (i < nnodes)
+			prev_end = by_addr[i]->end;
+	}
+	return -EBUSY;
+}
+
+static int scan_empty_area_rev(unsigned long low, unsigned long high,
+			       unsigned long size, unsigned long *addr)
+{
+	unsigned long next_start = ULONG_MAX, gap_start, gap_end;
+	int i;
+
+	for (i = nnodes; i >= 0; i--) {
+		gap_start = max(i ? by_addr[i - 1]->end : 0, low);
+		gap_end = min(next_start, high);
+		if (gap_start < gap_end && gap_end - gap_start >= size) {
+			*addr = gap_end - size;
+			return 0;
+		}
+		if (i)
+			next_start = by_addr[i - 1]->start;
+	}
+	return -EBUSY;
+}
+
+static bool check_empty_area(unsigned long low, unsigned long high,
+			     unsigned long size)
+{
+	unsigned long addr = 0, want = 0;
+	int ret, want_ret;
+	bool ok;
+
+	ret = range_tree_empty_area(&rt, low, high, size, &addr);
+	want_ret = scan_empty_area(low, high, size, &want);
+	ok = ret == want_ret && (ret || addr == want);
+
+	ret = range_tree_empty_area_rev(&rt, low, high, size, &addr);
+	want_ret = scan_empty_area_rev(low, high, size, &want);
+	ok &= ret == want_ret && (ret || addr == want);
+
+	return !WARN_ON_ONCE(!ok);
+}
+
+/*
+ * Look for areas from a page up to twice the slot size, so that some of
+ * them only fit in the gaps merged over several slots or not at all.
+ */
+static bool check_empty_areas(void)
+{
+	unsigned long size, span;
+	bool ok = true;
+	int i;
+
+	for (i = 0; i < nsearches; i++) {
+		size = PAGE_SIZE * (1 + prandom_u32_state(&rnd) %
+				    (2 * STRIDE / PAGE_SIZE));
+		span = prandom_u32_state(&rnd) % (4 * STRIDE);
+
+		ok &= check_empty_area(queries[i], ULONG_MAX, size);
+		ok &= check_empty_area(0, queries[i], size);
+		ok &= check_empty_area(queries[i], queries[i] + span, size);
+	}
+
+	return ok;
+}
+
+/*
+ * Move both bounds of every range within its slot, without reshaping the
+ * tree, and check that lookups and gaps follow.
+ */
+static void adjust(void)
+{
+	struct test_range *range;
+	unsigned long start, end;
+	unsigned int pages;
+	int i;
+
+	for (i = 0; i < nnodes; i++) {
+		range = ranges + i;
+
+		/* Keep a page free below, so that no two ranges touch */
+		pages = 1 + prandom_u32_state(&rnd) % (STRIDE / PAGE_SIZE - 1);
+		start = (range->start & ~(STRIDE - 1)) + pages * PAGE_SIZE;
+		pages = 1 + prandom_u32_state(&rnd) % (STRIDE / PAGE_SIZE - pages);
+		end = start + pages * PAGE_SIZE;
+
+		range_tree_adjust(&rt, range->start, start, end);
+		range->start = start;
+		range->end = end;
+	}
+}
+
+static int range_tree_test_init(void)
+{
+	int i, j, err = 0;
+	unsigned long results, addr;
+	cycles_t time1, time2, time;
+
+	ranges = kmalloc_array(nnodes, sizeof(*ranges), GFP_KERNEL);
+	if (!ranges)
+		return -ENOMEM;
+
+	by_addr = kmalloc_array(nnodes, sizeof(*by_addr), GFP_KERNEL);
+	queries = kmalloc_array(nsearches, sizeof(*queries), GFP_KERNEL);
+	if (!by_addr || !queries) {
+		kfree(queries);
+		kfree(by_addr);
+		kfree(ranges);
+		return -ENOMEM;
+	}
+
+	printk(KERN_ALERT "range tree insert/erase");
+
+	prandom_seed_state(&rnd, 3141592653589793238ULL);
+	init();
+
+	time1 = get_cycles();
+
+	for (i = 0; i < perf_loops && !err; i++) {
+		for (j = 0; j < nnodes && !err; j++)
+			err = insert(ranges + j);
+		for (j = 0; j < nnodes; j++)
+			range_tree_erase(&rt, ranges[j].start);
+	}
+
+	time2 = get_cycles();
+	time = time2 - time1;
+
+	time = div_u64(time, perf_loops);
+	printk(" -> %llu cycles\n", (unsigned long long)time);
+
+	for (i = 0; i < check_loops && !err; i++) {
+		for (j = 0; j < nnodes && !err; j++) {
+			err = insert(ranges + j);
+			if (!err && !check(j + 1))
+				err = -EINVAL;
+		}
+		for (j = 0; j < nnodes; j++) {
+			range_tree_erase(&rt, ranges[j].start);
+			if (!check(nnodes - j - 1))
+				err = -EINVAL;
+		}
+	}
+
+	printk(KERN_ALERT "range tree search");
+
+	for (j = 0; j < nnodes && !err; j++)
+		err = insert(ranges + j);
+
+	time1 = get_cycles();
+
+	results = 0;
+	for (i = 0; i < search_loops; i++)
+		for (j = 0; j < nsearches; j++)
+			if (range_tree_find(&rt, queries[j]))
+				results++;
+
+	time2 = get_cycles();
+	time = time2 - time1;
+
+	time = div_u64(time, search_loops);
+	results = div_u64(results, search_loops);
+	printk(" -> %llu cycles (%lu results)\n",
+	       (unsigned long long)time, results);
+
+	printk(KERN_ALERT "range tree empty area and adjust checks\n");
+
+	if (!err && (!check_bounds() || !check_empty_areas()))
+		err = -EINVAL;
+	for (i = 0; i < check_loops && !err; i++) {
+		adjust();
+		if (!check_bounds() || !check_empty_areas())
+			err = -EINVAL;
+	}
+
+	printk(KERN_ALERT "range tree empty area search");
+
+	time1 = get_cycles();
+
+	results = 0;
+	for (i = 0; i < search_loops; i++)
+		for (j = 0; j < nsearches; j++) {
+			if (!range_tree_empty_area(&rt, queries[j], ULONG_MAX,
+						   STRIDE / 2, &addr))
+				results++;
+			if (!range_tree_empty_area_rev(&rt, 0, queries[j],
+						       STRIDE / 2, &addr))
+				results++;
+		}
+
+	time2 = get_cycles();
+	time = time2 - time1;
+
+	time = div_u64(time, search_loops);
+	results = div_u64(results, search_loops);
+	printk(" -> %llu cycles (%lu results)\n",
+	       (unsigned long long)time, results);
+
+	range_tree_destroy(&rt);
+	kfree(queries);
+	kfree(by_addr);
+	kfree(ranges);
+
+	if (err)
+		return err;
+	return -EAGAIN; /* Fail will directly unload the module */
+}
+
+static void range_tree_test_exit(void)
+{
+	printk(KERN_ALERT "test exit\n");
+}
+
+module_init(range_tree_test_init)
+module_exit(range_tree_test_exit)
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("Range Tree test");
@@ -16,7 +16,11 @@
 #endif
 
 struct mm_struct init_mm = {
+#ifdef CONFIG_MMU
+	.mm_rt		= RANGE_TREE_INIT,
+#else
 	.mm_rb		= RB_ROOT,
+#endif
 	.pgd		= swapper_pg_dir,
 	.mm_users	= ATOMIC_INIT(2),
 	.mm_count	= ATOMIC_INIT(1),
@@ -543,38 +543,215 @@ mem_cgroup_largest_soft_limit_node(struct mem_cgroup_tree_per_node *mctz)
 }
 
 /*
- * Return page count for single (non recursive) @memcg.
+ * Statistics are kept in per-cpu counters, which are cheap to update but
+ * expensive to read: a reader has to visit every possible CPU and, for
+ * hierarchical numbers, every descendant cgroup. Monitoring the stats of
+ * many cgroups then burns a lot of CPU time even if hardly anything
+ * changed in between.
  *
- * Implementation Note: reading percpu statistics for memcg.
+ * So the user visible statistics are aggregated lazily instead. Each CPU
+ * keeps a tree of the cgroups whose counters it modified since the last
+ * flush, with all their ancestors. mem_cgroup_flush_stats() walks these
+ * trees children first, folds each cgroup's per-cpu delta into its local
+ * and hierarchical totals and hands the hierarchical delta on to the
+ * parent. A flush therefore costs as much as what changed since the
+ * previous one, and readers just look at the totals afterwards.
  *
- * Both of vmstat[] and percpu_counter has threshold and do periodic
- * synchronization to implement "quick" read. There are trade-off between
- * reading cost and precision of value. Then, we may have a chance to implement
- * a periodic synchronization of counter in memcg's counter.
- *
- * But this _read() function is used for user interface now. The user accounts
- * memory usage by memory cgroup and he _always_ requires exact value because
- * he accounts memory. Even if we provide quick-and-fuzzy read, we always
- * have to visit all online cpus and make sum. So, for now, unnecessary
- * synchronization is not implemented. (just implemented for cpu hotplug)
- *
- * If there are kernel internal actions which can make use of some not-exact
- * value, and reading all cpu value can be performance bottleneck in some
- * common workload, threshold and synchronization as vmstat[] should be
- * implemented.
- *
- * The parameter idx can be of type enum memcg_event_item or vm_event_item.
+ * In-kernel users which can't afford a flush read the totals as left by
+ * the periodic flush, or memcg_page_state() for an exact local value.
  */
 
-static unsigned long memcg_sum_events(struct mem_cgroup *memcg,
-				      int event)
+#define MEMCG_FLUSH_PERIOD	(2UL * HZ)
+
+static DEFINE_PER_CPU(raw_spinlock_t, memcg_rstat_cpu_lock) =
+	__RAW_SPIN_LOCK_UNLOCKED(memcg_rstat_cpu_lock);
+static DEFINE_MUTEX(memcg_rstat_mutex);
+
+static void memcg_flush_stats_workfn(struct work_struct *w);
+static DECLARE_DEFERRABLE_WORK(memcg_flush_stats_work,
+			       memcg_flush_stats_workfn);
+
+/* Hierarchical statistics follow the cgroup tree */
+static struct mem_cgroup *memcg_rstat_parent(struct mem_cgroup *memcg)
 {
-	unsigned long val = 0;
+	if (!memcg->css.parent)
+		return NULL;
+	return mem_cgroup_from_css(memcg->css.parent);
+}
+
+void __mem_cgroup_rstat_updated(struct mem_cgroup *memcg)
+{
+	int cpu = smp_processor_id();
+	raw_spinlock_t *cpu_lock = per_cpu_ptr(&memcg_rstat_cpu_lock, cpu);
+	struct mem_cgroup *parent;
+	unsigned long flags;
+
+	raw_spin_lock_irqsave(cpu_lock, flags);
+
+	/* Queue @memcg and those of its ancestors that aren't yet */
+	for (; memcg; memcg = parent) {
+		struct mem_cgroup_stat_cpu *statc = per_cpu_ptr(memcg->stat, cpu);
+		struct mem_cgroup_stat_cpu *pstatc;
+
+		if (statc->updated_next)
+			break;
+
+		parent = memcg_rstat_parent(memcg);
+		if (!parent) {
+			/* The root is queued by pointing to itself */
+			statc->updated_next = memcg;
+			break;
+		}
+
+		/* The last child on the list points back to the parent */
+		pstatc = per_cpu_ptr(parent->stat, cpu);
+		statc->updated_next = pstatc->updated_children ?: parent;
+		pstatc->updated_children = memcg;
+	}
+
+	raw_spin_unlock_irqrestore(cpu_lock, flags);
+}
+
+/*
+ * Unlink and return the next cgroup to flush on @cpu, or NULL once the
+ * tree is empty. Children are returned before their parents.
+ */
+static struct mem_cgroup *memcg_rstat_pop_updated(int cpu)
+{
+	raw_spinlock_t *cpu_lock = per_cpu_ptr(&memcg_rstat_cpu_lock, cpu);
+	struct mem_cgroup *pos = root_mem_cgroup;
+	struct mem_cgroup_stat_cpu *statc, *pstatc;
+	struct mem_cgroup *parent;
+	unsigned long flags;
+
+	raw_spin_lock_irqsave(cpu_lock, flags);
+
+	statc = per_cpu_ptr(pos->stat, cpu);
+	if (!statc->updated_next) {
+		pos = NULL;
+		goto out;
+	}
+
+	/* Descend along the list heads to a cgroup without queued children */
+	while (statc->updated_children) {
+		pos = statc->updated_children;
+		statc = per_cpu_ptr(pos->stat, cpu);
+	}
+
+	parent = memcg_rstat_parent(pos);
+	if (parent) {
+		pstatc = per_cpu_ptr(parent->stat, cpu);
+		if (statc->updated_next == parent)
+			pstatc->updated_children = NULL;
+		else
+			pstatc->updated_children = statc->updated_next;
+	}
+	statc->updated_next = NULL;
+out:
+	raw_spin_unlock_irqrestore(cpu_lock, flags);
+	return pos;
+}
+
+static void memcg_rstat_flush_cpu(struct mem_cgroup *memcg, int cpu)
+{
+	struct mem_cgroup_stat_cpu *statc = per_cpu_ptr(memcg->stat, cpu);
+	struct mem_cgroup *parent = memcg_rstat_parent(memcg);
+	int i;
+
+	for (i = 0; i < MEMCG_NR_STAT; i++) {
+		long count = READ_ONCE(statc->count[i]);
+		long delta = count - statc->count_prev[i];
+
+		statc->count_prev[i] = count;
+		memcg->stat_local.count[i] += delta;
+
+		delta += memcg->stat_pending.count[i];
+		if (!delta)
+			continue;
+		memcg->stat_pending.count[i] = 0;
+		memcg->stat_tree.count[i] += delta;
+		if (parent)
+			parent->stat_pending.count[i] += delta;
+	}
+
+	for (i = 0; i < MEMCG_NR_EVENTS; i++) {
+		unsigned long events = READ_ONCE(statc->events[i]);
+		unsigned long delta = events - statc->events_prev[i];
+
+		statc->events_prev[i] = events;
+		memcg->stat_local.events[i] += delta;
+
+		delta += memcg->stat_pending.events[i];
+		if (!delta)
+			continue;
+		memcg->stat_pending.events[i] = 0;
+		memcg->stat_tree.events[i] += delta;
+		if (parent)
+			parent->stat_pending.events[i] += delta;
+	}
+}
+
+/**
+ * mem_cgroup_flush_stats - fold pending per-cpu statistics into the totals
+ *
+ * Only the cgroups updated since the last flush are visited.
+ */
+static void mem_cgroup_flush_stats(void)
+{
+	struct mem_cgroup *memcg;
 	int cpu;
 
-	for_each_possible_cpu(cpu)
-		val += per_cpu(memcg->stat->events[event], cpu);
-	return val;
+	mutex_lock(&memcg_rstat_mutex);
+	for_each_possible_cpu(cpu) {
+		while ((memcg = memcg_rstat_pop_updated(cpu)))
+			memcg_rstat_flush_cpu(memcg, cpu);
+		cond_resched();
+	}
+	mutex_unlock(&memcg_rstat_mutex);
+}
+
+static void memcg_flush_stats_workfn(struct work_struct *w)
+{
+	mem_cgroup_flush_stats();
+	queue_delayed_work(system_unbound_wq, &memcg_flush_stats_work,
+			   MEMCG_FLUSH_PERIOD);
+}
+
+/* Flushed page state of @memcg alone; idx as for memcg_page_state() */
+static unsigned long memcg_stat_local(struct mem_cgroup *memcg, int idx)
+{
+	long val = READ_ONCE(memcg->stat_local.count[idx]);
+
+	return val < 0 ? 0 : val;
+}
+
+/*
+ * Flushed page state of @memcg and, if it accounts hierarchically, its
+ * descendants. The root always covers the whole tree.
+ */
+static unsigned long memcg_stat_tree(struct mem_cgroup *memcg, int idx)
+{
+	long val;
+
+	if (!memcg->use_hierarchy && !mem_cgroup_is_root(memcg))
+		return memcg_stat_local(memcg, idx);
+
+	val = READ_ONCE(memcg->stat_tree.count[idx]);
+	return val < 0 ? 0 : val;
+}
+
+/* idx can be of type enum memcg_event_item or vm_event_item */
+static unsigned long memcg_events_local(struct mem_cgroup *memcg, int idx)
+{
+	return READ_ONCE(memcg->stat_local.events[idx]);
+}
+
+static unsigned long memcg_events_tree(struct mem_cgroup *memcg, int idx)
+{
+	if (!memcg->use_hierarchy && !mem_cgroup_is_root(memcg))
+		return memcg_events_local(memcg, idx);
+
+	return READ_ONCE(memcg->stat_tree.events[idx]);
 }
 
 static void mem_cgroup_charge_statistics(struct mem_cgroup *memcg,
@@ -607,6 +784,7 @@ static void mem_cgroup_charge_statistics(struct mem_cgroup *memcg,
 	}
 
 	__this_cpu_add(memcg->stat->nr_page_events, nr_pages);
+	mem_cgroup_rstat_updated(memcg);
 }
 
 unsigned long mem_cgroup_node_nr_lru_pages(struct mem_cgroup *memcg,
@@ -2417,6 +2595,7 @@ void mem_cgroup_split_huge_fixup(struct page *head)
 
 	__this_cpu_sub(head->mem_cgroup->stat->count[MEMCG_RSS_HUGE],
 		       HPAGE_PMD_NR);
+	mem_cgroup_rstat_updated(head->mem_cgroup);
 }
 #endif /* CONFIG_TRANSPARENT_HUGEPAGE */
 
@@ -2424,7 +2603,7 @@ void mem_cgroup_split_huge_fixup(struct page *head)
 static void mem_cgroup_swap_statistics(struct mem_cgroup *memcg,
 				       int nr_entries)
 {
-	this_cpu_add(memcg->stat->count[MEMCG_SWAP], nr_entries);
+	mod_memcg_state(memcg, MEMCG_SWAP, nr_entries);
 }
 
 /**
@@ -2751,43 +2930,30 @@ static int mem_cgroup_hierarchy_write(struct cgroup_subsys_state *css,
 
 static void tree_stat(struct mem_cgroup *memcg, unsigned long *stat)
 {
-	struct mem_cgroup *iter;
 	int i;
 
-	memset(stat, 0, sizeof(*stat) * MEMCG_NR_STAT);
-
-	for_each_mem_cgroup_tree(iter, memcg) {
-		for (i = 0; i < MEMCG_NR_STAT; i++)
-			stat[i] += memcg_page_state(iter, i);
-	}
+	for (i = 0; i < MEMCG_NR_STAT; i++)
+		stat[i] = memcg_stat_tree(memcg, i);
 }
 
 static void tree_events(struct mem_cgroup *memcg, unsigned long *events)
 {
-	struct mem_cgroup *iter;
 	int i;
 
-	memset(events, 0, sizeof(*events) * MEMCG_NR_EVENTS);
-
-	for_each_mem_cgroup_tree(iter, memcg) {
-		for (i = 0; i < MEMCG_NR_EVENTS; i++)
-			events[i] += memcg_sum_events(iter, i);
-	}
+	for (i = 0; i < MEMCG_NR_EVENTS; i++)
+		events[i] = memcg_events_tree(memcg, i);
 }
 
+/* The root's usage is only as recent as the last stat flush */
 static unsigned long mem_cgroup_usage(struct mem_cgroup *memcg, bool swap)
 {
 	unsigned long val = 0;
 
 	if (mem_cgroup_is_root(memcg)) {
-		struct mem_cgroup *iter;
-
-		for_each_mem_cgroup_tree(iter, memcg) {
-			val += memcg_page_state(iter, MEMCG_CACHE);
-			val += memcg_page_state(iter, MEMCG_RSS);
-			if (swap)
-				val += memcg_page_state(iter, MEMCG_SWAP);
-		}
+		val += memcg_stat_tree(memcg, MEMCG_CACHE);
+		val += memcg_stat_tree(memcg, MEMCG_RSS);
+		if (swap)
+			val += memcg_stat_tree(memcg, MEMCG_SWAP);
 	} else {
 		if (!swap)
 			val = page_counter_read(&memcg->memory);
@@ -2830,6 +2996,8 @@ static u64 mem_cgroup_read_u64(struct cgroup_subsys_state *css,
 
 	switch (MEMFILE_ATTR(cft->private)) {
 	case RES_USAGE:
+		if (mem_cgroup_is_root(memcg))
+			mem_cgroup_flush_stats();
 		if (counter == &memcg->memory)
 			return (u64)mem_cgroup_usage(memcg, false) * PAGE_SIZE;
 		if (counter == &memcg->memsw)
@@ -3186,17 +3354,19 @@ static int memcg_stat_show(struct seq_file *m, void *v)
 	BUILD_BUG_ON(ARRAY_SIZE(memcg1_stat_names) != ARRAY_SIZE(memcg1_stats));
 	BUILD_BUG_ON(ARRAY_SIZE(mem_cgroup_lru_names) != NR_LRU_LISTS);
 
+	mem_cgroup_flush_stats();
+
 	for (i = 0; i < ARRAY_SIZE(memcg1_stats); i++) {
 		if (memcg1_stats[i] == MEMCG_SWAP && !do_memsw_account())
 			continue;
 		seq_printf(m, "%s %lu\n", memcg1_stat_names[i],
-			   memcg_page_state(memcg, memcg1_stats[i]) *
+			   memcg_stat_local(memcg, memcg1_stats[i]) *
 			   PAGE_SIZE);
 	}
 
 	for (i = 0; i < ARRAY_SIZE(memcg1_events); i++)
 		seq_printf(m, "%s %lu\n", memcg1_event_names[i],
-			   memcg_sum_events(memcg, memcg1_events[i]));
+			   memcg_events_local(memcg, memcg1_events[i]));
 
 	for (i = 0; i < NR_LRU_LISTS; i++)
 		seq_printf(m, "%s %lu\n", mem_cgroup_lru_names[i],
@@ -3215,23 +3385,17 @@ static int memcg_stat_show(struct seq_file *m, void *v)
 			   (u64)memsw * PAGE_SIZE);
 
 	for (i = 0; i < ARRAY_SIZE(memcg1_stats); i++) {
-		unsigned long long val = 0;
+		unsigned long long val;
 
 		if (memcg1_stats[i] == MEMCG_SWAP && !do_memsw_account())
 			continue;
-		for_each_mem_cgroup_tree(mi, memcg)
-			val += memcg_page_state(mi, memcg1_stats[i]) *
-			PAGE_SIZE;
+		val = (u64)memcg_stat_tree(memcg, memcg1_stats[i]) * PAGE_SIZE;
 		seq_printf(m, "total_%s %llu\n", memcg1_stat_names[i], val);
 	}
 
-	for (i = 0; i < ARRAY_SIZE(memcg1_events); i++) {
-		unsigned long long val = 0;
-
-		for_each_mem_cgroup_tree(mi, memcg)
-			val += memcg_sum_events(mi, memcg1_events[i]);
-		seq_printf(m, "total_%s %llu\n", memcg1_event_names[i], val);
-	}
+	for (i = 0; i < ARRAY_SIZE(memcg1_events); i++)
+		seq_printf(m, "total_%s %llu\n", memcg1_event_names[i],
+			   (u64)memcg_events_tree(memcg, memcg1_events[i]));
 
 	for (i = 0; i < NR_LRU_LISTS; i++) {
 		unsigned long long val = 0;
@@ -3619,7 +3783,8 @@ static int mem_cgroup_oom_control_read(struct seq_file *sf, void *v)
 
 	seq_printf(sf, "oom_kill_disable %d\n", memcg->oom_kill_disable);
 	seq_printf(sf, "under_oom %d\n", (bool)memcg->under_oom);
-	seq_printf(sf, "oom_kill %lu\n", memcg_sum_events(memcg, OOM_KILL));
+	mem_cgroup_flush_stats();
+	seq_printf(sf, "oom_kill %lu\n", memcg_events_local(memcg, OOM_KILL));
 	return 0;
 }
 
@@ -4385,6 +4550,8 @@ static void mem_cgroup_css_free(struct cgroup_subsys_state *css)
 	cancel_work_sync(&memcg->high_work);
 	mem_cgroup_remove_from_trees(memcg);
 	memcg_free_kmem(memcg);
+	/* Unqueue from the update trees, passing the counts to the parent */
+	mem_cgroup_flush_stats();
 	mem_cgroup_free(memcg);
 }
 
@@ -5282,11 +5449,13 @@ static int memory_events_show(struct seq_file *m, void *v)
 {
 	struct mem_cgroup *memcg = mem_cgroup_from_css(seq_css(m));
 
-	seq_printf(m, "low %lu\n", memcg_sum_events(memcg, MEMCG_LOW));
-	seq_printf(m, "high %lu\n", memcg_sum_events(memcg, MEMCG_HIGH));
-	seq_printf(m, "max %lu\n", memcg_sum_events(memcg, MEMCG_MAX));
-	seq_printf(m, "oom %lu\n", memcg_sum_events(memcg, MEMCG_OOM));
-	seq_printf(m, "oom_kill %lu\n", memcg_sum_events(memcg, OOM_KILL));
+	mem_cgroup_flush_stats();
+
+	seq_printf(m, "low %lu\n", memcg_events_local(memcg, MEMCG_LOW));
+	seq_printf(m, "high %lu\n", memcg_events_local(memcg, MEMCG_HIGH));
+	seq_printf(m, "max %lu\n", memcg_events_local(memcg, MEMCG_MAX));
+	seq_printf(m, "oom %lu\n", memcg_events_local(memcg, MEMCG_OOM));
+	seq_printf(m, "oom_kill %lu\n", memcg_events_local(memcg, OOM_KILL));
 
 	return 0;
 }
@@ -5309,6 +5478,7 @@ static int memory_stat_show(struct seq_file *m, void *v)
 	 * Current memory state:
 	 */
 
+	mem_cgroup_flush_stats();
 	tree_stat(memcg, stat);
 	tree_events(memcg, events);
 
@@ -5658,6 +5828,7 @@ static void uncharge_batch(const struct uncharge_gather *ug)
 	__this_cpu_sub(ug->memcg->stat->count[NR_SHMEM], ug->nr_shmem);
 	__this_cpu_add(ug->memcg->stat->events[PGPGOUT], ug->pgpgout);
 	__this_cpu_add(ug->memcg->stat->nr_page_events, nr_pages);
+	mem_cgroup_rstat_updated(ug->memcg);
 	memcg_check_events(ug->memcg, ug->dummy_page);
 	local_irq_restore(flags);
 
@@ -5898,7 +6069,7 @@ bool mem_cgroup_charge_skmem(struct mem_cgroup *memcg, unsigned int nr_pages)
 	if (in_softirq())
 		gfp_mask = GFP_NOWAIT;
 
-	this_cpu_add(memcg->stat->count[MEMCG_SOCK], nr_pages);
+	mod_memcg_state(memcg, MEMCG_SOCK, nr_pages);
 
 	if (try_charge(memcg, gfp_mask, nr_pages) == 0)
 		return true;
@@ -5919,7 +6090,7 @@ void mem_cgroup_uncharge_skmem(struct mem_cgroup *memcg, unsigned int nr_pages)
 		return;
 	}
 
-	this_cpu_sub(memcg->stat->count[MEMCG_SOCK], nr_pages);
+	mod_memcg_state(memcg, MEMCG_SOCK, -nr_pages);
 
 	refill_stock(memcg, nr_pages);
 }
@@ -5982,6 +6153,10 @@ static int __init mem_cgroup_init(void)
 		soft_limit_tree.rb_tree_per_node[node] = rtpn;
 	}
 
+	if (!mem_cgroup_disabled())
+		queue_delayed_work(system_unbound_wq, &memcg_flush_stats_work,
+				   MEMCG_FLUSH_PERIOD);
+
 	return 0;
 }
 subsys_initcall(mem_cgroup_init);
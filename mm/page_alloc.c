@@ -67,6 +67,7 @@
 #include <linux/ftrace.h>
 #include <linux/lockdep.h>
 #include <linux/nmi.h>
+#include <linux/padata.h>
 
 #include <asm/sections.h>
 #include <asm/tlbflush.h>
@@ -1263,7 +1264,12 @@ static void __free_pages_ok(struct page *page, unsigned int order)
 	local_irq_restore(flags);
 }
 
-static void __init __free_pages_boot_core(struct page *page, unsigned int order)
+/*
+ * Hand boot memory to the buddy allocator without accounting it in
+ * zone->managed_pages, for callers that account a whole batch at once.
+ */
+static void __init __free_pages_boot_nocount(struct page *page,
+					     unsigned int order)
 {
 	unsigned int nr_pages = 1 << order;
 	struct page *p = page;
@@ -1278,11 +1284,16 @@ static void __init __free_pages_boot_core(struct page *page, unsigned int order)
 	__ClearPageReserved(p);
 	set_page_count(p, 0);
 
-	page_zone(page)->managed_pages += nr_pages;
 	set_page_refcounted(page);
 	__free_pages(page, order);
 }
 
+static void __init __free_pages_boot_core(struct page *page, unsigned int order)
+{
+	page_zone(page)->managed_pages += 1 << order;
+	__free_pages_boot_nocount(page, order);
+}
+
 #if defined(CONFIG_HAVE_ARCH_EARLY_PFN_TO_NID) || \
 	defined(CONFIG_HAVE_MEMBLOCK_NODE_MAP)
 
@@ -1429,14 +1440,14 @@ static void __init deferred_free_range(struct page *page,
 	if (nr_pages == pageblock_nr_pages &&
 	    (pfn & (pageblock_nr_pages - 1)) == 0) {
 		set_pageblock_migratetype(page, MIGRATE_MOVABLE);
-		__free_pages_boot_core(page, pageblock_order);
+		__free_pages_boot_nocount(page, pageblock_order);
 		return;
 	}
 
 	for (i = 0; i < nr_pages; i++, page++, pfn++) {
 		if ((pfn & (pageblock_nr_pages - 1)) == 0)
 			set_pageblock_migratetype(page, MIGRATE_MOVABLE);
-		__free_pages_boot_core(page, 0);
+		__free_pages_boot_nocount(page, 0);
 	}
 }
 
@@ -1450,56 +1461,34 @@ static inline void __init pgdat_init_report_one_done(void)
 		complete(&pgdat_init_all_done_comp);
 }
 
-/* Initialise remaining memory on a node */
-static int __init deferred_init_memmap(void *data)
+/*
+ * Initialise and free the struct pages of [start_pfn, end_pfn) in @zone
+ * which belong to the node's memory ranges, returning the number of pages
+ * handed to the allocator. Called concurrently for disjoint ranges, so the
+ * freed pages are not added to zone->managed_pages here.
+ */
+static unsigned long __init
+deferred_init_range(struct zone *zone, unsigned long start_pfn,
+		    unsigned long end_pfn)
 {
-	pg_data_t *pgdat = data;
-	int nid = pgdat->node_id;
+	int nid = zone_to_nid(zone);
+	int zid = zone_idx(zone);
 	struct mminit_pfnnid_cache nid_init_state = { };
-	unsigned long start = jiffies;
 	unsigned long nr_pages = 0;
 	unsigned long walk_start, walk_end;
-	int i, zid;
-	struct zone *zone;
-	unsigned long first_init_pfn = pgdat->first_deferred_pfn;
-	const struct cpumask *cpumask = cpumask_of_node(pgdat->node_id);
-
-	if (first_init_pfn == ULONG_MAX) {
-		pgdat_init_report_one_done();
-		return 0;
-	}
-
-	/* Bind memory initialisation thread to a local node if possible */
-	if (!cpumask_empty(cpumask))
-		set_cpus_allowed_ptr(current, cpumask);
-
-	/* Sanity check boundaries */
-	BUG_ON(pgdat->first_deferred_pfn < pgdat->node_start_pfn);
-	BUG_ON(pgdat->first_deferred_pfn > pgdat_end_pfn(pgdat));
-	pgdat->first_deferred_pfn = ULONG_MAX;
-
-	/* Only the highest zone is deferred so find it */
-	for (zid = 0; zid < MAX_NR_ZONES; zid++) {
-		zone = pgdat->node_zones + zid;
-		if (first_init_pfn < zone_end_pfn(zone))
-			break;
-	}
+	int i;
 
 	for_each_mem_pfn_range(i, nid, &walk_start, &walk_end, NULL) {
-		unsigned long pfn, end_pfn;
+		unsigned long pfn, range_end;
 		struct page *page = NULL;
 		struct page *free_base_page = NULL;
 		unsigned long free_base_pfn = 0;
 		int nr_to_free = 0;
 
-		end_pfn = min(walk_end, zone_end_pfn(zone));
-		pfn = first_init_pfn;
-		if (pfn < walk_start)
-			pfn = walk_start;
-		if (pfn < zone->zone_start_pfn)
-			pfn = zone->zone_start_pfn;
+		pfn = max(walk_start, start_pfn);
+		range_end = min(walk_end, end_pfn);
 
-		for (; pfn < end_pfn; pfn++) {
+		for (; pfn < range_end; pfn++) {
 			if (!pfn_valid_within(pfn))
 				goto free_range;
 
@@ -1559,15 +1548,110 @@ free_range:
 		/* Free the last block of pages to allocator */
 		nr_pages += nr_to_free;
 		deferred_free_range(free_base_page, free_base_pfn, nr_to_free);
+	}
+
+	return nr_pages;
+}
+
+struct deferred_init_job {
+	struct zone *zone;
+	atomic_long_t nr_pages;
+};
+
+static void __init
+deferred_init_memmap_chunk(unsigned long start_pfn, unsigned long end_pfn,
+			   void *arg)
+{
+	struct deferred_init_job *dj = arg;
+	unsigned long nr_pages;
+
+	nr_pages = deferred_init_range(dj->zone, start_pfn, end_pfn);
 
-		first_init_pfn = max(end_pfn, first_init_pfn);
+	spin_lock(&managed_page_count_lock);
+	dj->zone->managed_pages += nr_pages;
+	spin_unlock(&managed_page_count_lock);
+
+	atomic_long_add(nr_pages, &dj->nr_pages);
+}
+
+/* An arch may override for more concurrency. */
+__weak int __init
+deferred_page_init_max_threads(const struct cpumask *node_cpumask)
+{
+	return max_t(int, cpumask_weight(node_cpumask), 1);
+}
+
+/*
+ * Chunks are kept to whole MAX_ORDER blocks so that a block is always
+ * initialised by a single thread before any of it is freed and merged.
+ */
+#ifdef CONFIG_SPARSEMEM
+#define DEFERRED_INIT_CHUNK	max_t(unsigned long, PAGES_PER_SECTION, \
+				      MAX_ORDER_NR_PAGES)
+#else
+#define DEFERRED_INIT_CHUNK	MAX_ORDER_NR_PAGES
+#endif
+
+/* Initialise remaining memory on a node */
+static int __init deferred_init_memmap(void *data)
+{
+	pg_data_t *pgdat = data;
+	int nid = pgdat->node_id;
+	unsigned long start = jiffies;
+	struct deferred_init_job dj;
+	struct padata_mt_job job;
+	int zid, nr_threads;
+	struct zone *zone;
+	unsigned long first_init_pfn = pgdat->first_deferred_pfn;
+	const struct cpumask *cpumask = cpumask_of_node(pgdat->node_id);
+
+	if (first_init_pfn == ULONG_MAX) {
+		pgdat_init_report_one_done();
+		return 0;
 	}
 
+	/* Bind memory initialisation thread to a local node if possible */
+	if (!cpumask_empty(cpumask))
+		set_cpus_allowed_ptr(current, cpumask);
+
+	/* Sanity check boundaries */
+	BUG_ON(pgdat->first_deferred_pfn < pgdat->node_start_pfn);
+	BUG_ON(pgdat->first_deferred_pfn > pgdat_end_pfn(pgdat));
+	pgdat->first_deferred_pfn = ULONG_MAX;
+
+	/* Only the highest zone is deferred so find it */
+	for (zid = 0; zid < MAX_NR_ZONES; zid++) {
+		zone = pgdat->node_zones + zid;
+		if (first_init_pfn < zone_end_pfn(zone))
+			break;
+	}
+	first_init_pfn = max(first_init_pfn, zone->zone_start_pfn);
+
+	/*
+	 * Split the deferred part of the zone between the CPUs of the node.
+	 * The helpers are unbound workqueue workers spread over the CPUs of
+	 * the node this thread is bound to, so they stay node local as well.
+	 */
+	dj.zone = zone;
+	atomic_long_set(&dj.nr_pages, 0);
+
+	job = (struct padata_mt_job) {
+		.thread_fn   = deferred_init_memmap_chunk,
+		.fn_arg      = &dj,
+		.start       = first_init_pfn,
+		.size        = zone_end_pfn(zone) - first_init_pfn,
+		.align       = DEFERRED_INIT_CHUNK,
+		.min_chunk   = DEFERRED_INIT_CHUNK,
+		.max_threads = deferred_page_init_max_threads(cpumask),
+	};
+	nr_threads = padata_do_multithreaded(&job);
+
 	/* Sanity check that the next zone really is unpopulated */
 	WARN_ON(++zid < MAX_NR_ZONES && populated_zone(++zone));
 
-	pr_info("node %d initialised, %lu pages in %ums\n", nid, nr_pages,
-					jiffies_to_msecs(jiffies - start));
+	pr_info("node %d initialised, %lu pages in %ums (%d threads)\n", nid,
+		atomic_long_read(&dj.nr_pages),
+		jiffies_to_msecs(jiffies - start), nr_threads);
 
 	pgdat_init_report_one_done();
 	return 0;
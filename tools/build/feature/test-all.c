@@ -138,6 +138,10 @@
 # include "test-lzma.c"
 #undef main
 
+#define main main_test_libzstd
+# include "test-libzstd.c"
+#undef main
+
 #define main main_test_get_cpuid
 # include "test-get_cpuid.c"
 #undef main
@@ -188,6 +192,7 @@ int main(int argc, char *argv[])
 	main_test_zlib();
 	main_test_pthread_attr_setaffinity_np();
 	main_test_lzma();
+	main_test_libzstd();
 	main_test_get_cpuid();
 	main_test_bpf();
 	main_test_libcrypto();
@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * aio: measure the native AIO submission and completion paths.
+ *
+ * Every thread sets up its own AIO context and keeps --depth random reads
+ * (or writes) of --bs bytes in flight against the target: io_getevents()
+ * reaps what completed, and io_submit() sends it out again in one batch.
+ * Use a null_blk device or a file on tmpfs as target to measure the
+ * software overhead of the submit and completion paths rather than the
+ * storage itself.
+ *
+ * The throughput is the number of I/Os completed per second, the
+ * latencies are the time spent in io_submit() and the time between the
+ * submission and the reaping of every I/O.
+ */
+
+/* For the CLR_() macros */
+#include <string.h>
+#include <pthread.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/aio_abi.h>
+#include <linux/compiler.h>
+#include <linux/fs.h>
+#include <linux/kernel.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+
+#include "../util/stat.h"
+#include "../util/util.h"
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+#include "latency.h"
+
+#include <err.h>
+
+static unsigned int nthreads = 0;
+static unsigned int nsecs    = 8;
+static unsigned int depth    = 32;
+static const char *bs_str    = "4KB";
+static const char *size_str  = "64MB";
+static const char *target;
+static bool done = false, silent = false, do_write = false, direct = false;
+
+struct timeval start, end, runtime;
+static pthread_mutex_t thread_lock;
+static unsigned int threads_starting;
+static struct stats throughput_stats;
+static pthread_cond_t thread_parent, thread_worker;
+static size_t bs;
+static u64 target_size;
+
+struct worker {
+	int tid;
+	int fd;
+	aio_context_t ctx;
+	struct iocb *iocbs;
+	struct iocb **batch;
+	struct io_event *events;
+	u64 *submit_time;
+	void *buf;
+	unsigned int seed;
+	pthread_t thread;
+	unsigned long ops;
+	struct lat_hist submit_lat;
+	struct lat_hist complete_lat;
+};
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of threads"),
+	OPT_UINTEGER('r', "runtime", &nsecs,    "Specify runtime (in seconds)"),
+	OPT_UINTEGER('q', "depth",   &depth,    "Specify amount of I/Os in flight per thread"),
+	OPT_STRING(  'b', "bs",      &bs_str,   "4KB", "Specify the size of the I/Os"),
+	OPT_STRING(  'f', "file",    &target,   "path", "Specify the target file or block device, a temporary file in /dev/shm by default"),
+	OPT_STRING(  'l', "size",    &size_str, "64MB", "Specify the size of the temporary file"),
+	OPT_BOOLEAN( 'w', "write",   &do_write, "Write instead of read, this destroys the content of the target"),
+	OPT_BOOLEAN( 'D', "direct",  &direct,   "Open the target with O_DIRECT"),
+	OPT_BOOLEAN( 's', "silent",  &silent,   "Silent mode: do not display data/details"),
+	OPT_END()
+};
+
+static const char * const bench_aio_submit_usage[] = {
+	"perf bench aio submit <options>",
+	NULL
+};
+
+static inline int io_setup(unsigned int nr, aio_context_t *ctx)
+{
+	return syscall(__NR_io_setup, nr, ctx);
+}
+
+static inline int io_destroy(aio_context_t ctx)
+{
+	return syscall(__NR_io_destroy, ctx);
+}
+
+static inline int io_submit(aio_context_t ctx, long nr, struct iocb **iocbs)
+{
+	return syscall(__NR_io_submit, ctx, nr, iocbs);
+}
+
+static inline int io_getevents(aio_context_t ctx, long min_nr, long nr,
+			       struct io_event *events, struct timespec *timeout)
+{
+	return syscall(__NR_io_getevents, ctx, min_nr, nr, events, timeout);
+}
+
+static void prep_iocb(struct worker *w, unsigned int slot)
+{
+	struct iocb *iocb = &w->iocbs[slot];
+	u64 nr_blocks = target_size / bs;
+
+	memset(iocb, 0, sizeof(*iocb));
+	iocb->aio_data = slot;
+	iocb->aio_lio_opcode = do_write ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+	iocb->aio_fildes = w->fd;
+	iocb->aio_buf = (unsigned long)w->buf + slot * bs;
+	iocb->aio_nbytes = bs;
+	iocb->aio_offset = (rand_r(&w->seed) % nr_blocks) * bs;
+}
+
+static void submit(struct worker *w, unsigned int nr)
+{
+	unsigned int i, off = 0;
+	u64 t0;
+	int ret;
+
+	while (off < nr) {
+		t0 = lat_now_ns();
+		for (i = off; i < nr; i++)
+			w->submit_time[w->batch[i]->aio_data] = t0;
+
+		ret = io_submit(w->ctx, nr - off, &w->batch[off]);
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EINTR)
+				continue;
+			err(EXIT_FAILURE, "io_submit");
+		}
+
+		lat_hist__add(&w->submit_lat, lat_now_ns() - t0);
+		off += ret;
+	}
+}
+
+static void *workerfn(void *arg)
+{
+	struct worker *w = (struct worker *) arg;
+	unsigned long ops = 0; /* avoid cacheline bouncing */
+	unsigned int i, inflight;
+	u64 now;
+	int n;
+
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+
+	for (i = 0; i < depth; i++) {
+		prep_iocb(w, i);
+		w->batch[i] = &w->iocbs[i];
+	}
+	submit(w, depth);
+	inflight = depth;
+
+	while (inflight) {
+		n = io_getevents(w->ctx, 1, depth, w->events, NULL);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			err(EXIT_FAILURE, "io_getevents");
+		}
+
+		now = lat_now_ns();
+		for (i = 0; i < (unsigned int)n; i++) {
+			unsigned int slot = w->events[i].data;
+
+			if ((long)w->events[i].res != (long)bs)
+				errx(EXIT_FAILURE, "I/O error: %lld",
+				     (long long)w->events[i].res);
+
+			lat_hist__add(&w->complete_lat, now - w->submit_time[slot]);
+			prep_iocb(w, slot);
+			w->batch[i] = &w->iocbs[slot];
+		}
+
+		ops += n;
+		inflight -= n;
+
+		/* let the I/Os in flight drain once done */
+		if (!done) {
+			submit(w, n);
+			inflight += n;
+		}
+	}
+
+	w->ops = ops;
+	return NULL;
+}
+
+static void toggle_done(int sig __maybe_unused,
+			siginfo_t *info __maybe_unused,
+			void *uc __maybe_unused)
+{
+	/* inform all threads that we're done for the day */
+	done = true;
+	gettimeofday(&end, NULL);
+	timersub(&end, &start, &runtime);
+}
+
+static int open_target(void)
+{
+	int flags = (do_write ? O_RDWR : O_RDONLY) | (direct ? O_DIRECT : 0);
+	struct stat st;
+	int fd;
+
+	fd = open(target, flags);
+	if (fd < 0)
+		err(EXIT_FAILURE, "open %s", target);
+
+	if (target_size)
+		return fd;
+
+	if (fstat(fd, &st))
+		err(EXIT_FAILURE, "fstat");
+
+	if (S_ISBLK(st.st_mode)) {
+		if (ioctl(fd, BLKGETSIZE64, &target_size))
+			err(EXIT_FAILURE, "BLKGETSIZE64");
+	} else {
+		target_size = st.st_size;
+	}
+
+	if (target_size < bs)
+		errx(EXIT_FAILURE, "%s is smaller than a single I/O", target);
+
+	return fd;
+}
+
+static char *create_target(void)
+{
+	char *path = strdup("/dev/shm/perf-bench-aio.XXXXXX");
+	s64 size;
+	int fd;
+
+	if (!path)
+		err(EXIT_FAILURE, "strdup");
+
+	size = perf_atoll((char *)size_str);
+	if (size < (s64)bs)
+		errx(EXIT_FAILURE, "Invalid size:%s", size_str);
+
+	fd = mkstemp(path);
+	if (fd < 0)
+		err(EXIT_FAILURE, "mkstemp");
+
+	if (ftruncate(fd, size))
+		err(EXIT_FAILURE, "ftruncate");
+	close(fd);
+
+	target = path;
+	return path;
+}
+
+static void setup_worker(struct worker *w)
+{
+	w->fd = open_target();
+	w->seed = w->tid + 1;
+
+	if (io_setup(depth, &w->ctx))
+		err(EXIT_FAILURE, "io_setup");
+
+	w->iocbs = calloc(depth, sizeof(*w->iocbs));
+	w->batch = calloc(depth, sizeof(*w->batch));
+	w->events = calloc(depth, sizeof(*w->events));
+	w->submit_time = calloc(depth, sizeof(*w->submit_time));
+	if (!w->iocbs || !w->batch || !w->events || !w->submit_time)
+		err(EXIT_FAILURE, "calloc");
+
+	if (posix_memalign(&w->buf, page_size, depth * bs))
+		err(EXIT_FAILURE, "posix_memalign");
+	memset(w->buf, 0, depth * bs);
+}
+
+static void cleanup_worker(struct worker *w)
+{
+	io_destroy(w->ctx);
+	close(w->fd);
+	free(w->buf);
+	free(w->submit_time);
+	free(w->events);
+	free(w->batch);
+	free(w->iocbs);
+}
+
+static void print_summary(struct lat_hist *submit_lat,
+			  struct lat_hist *complete_lat)
+{
+	unsigned long avg = avg_stats(&throughput_stats);
+	double stddev = stddev_stats(&throughput_stats);
+
+	printf("%sAveraged %ld IOPS (+- %.2f%%), total secs = %d\n",
+	       !silent ? "\n" : "", avg, rel_stddev_stats(stddev, avg),
+	       (int) runtime.tv_sec);
+	lat_hist__print(submit_lat, "io_submit ");
+	lat_hist__print(complete_lat, "Completion ");
+}
+
+int bench_aio_submit(int argc, const char **argv)
+{
+	int ret = 0;
+	cpu_set_t cpu;
+	struct sigaction act;
+	unsigned int i, ncpus;
+	pthread_attr_t thread_attr;
+	struct worker *worker = NULL;
+	struct lat_hist *submit_lat, *complete_lat;
+	char *tmp = NULL;
+	s64 size;
+
+	argc = parse_options(argc, argv, options, bench_aio_submit_usage, 0);
+	if (argc || !depth) {
+		usage_with_options(bench_aio_submit_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	size = perf_atoll((char *)bs_str);
+	if (size <= 0 || (direct && size % 512)) {
+		fprintf(stderr, "Invalid I/O size:%s\n", bs_str);
+		return 1;
+	}
+	bs = size;
+
+	if (!target)
+		tmp = create_target();
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	sigfillset(&act.sa_mask);
+	act.sa_sigaction = toggle_done;
+	sigaction(SIGINT, &act, NULL);
+
+	if (!nthreads) /* default to the number of CPUs */
+		nthreads = ncpus;
+
+	worker = calloc(nthreads, sizeof(*worker));
+	submit_lat = calloc(1, sizeof(*submit_lat));
+	complete_lat = calloc(1, sizeof(*complete_lat));
+	if (!worker || !submit_lat || !complete_lat)
+		err(EXIT_FAILURE, "calloc");
+
+	init_stats(&throughput_stats);
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads;
+	pthread_attr_init(&thread_attr);
+	for (i = 0; i < nthreads; i++) {
+		worker[i].tid = i;
+		setup_worker(&worker[i]);
+
+		CPU_ZERO(&cpu);
+		CPU_SET(i % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&worker[i].thread, &thread_attr, workerfn,
+				     (void *)(struct worker *) &worker[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+	pthread_attr_destroy(&thread_attr);
+
+	printf("Run summary [PID %d]: %d threads doing %srandom %s of %zu bytes on %s, %d in flight each, for %d secs.\n\n",
+	       getpid(), nthreads, direct ? "O_DIRECT " : "",
+	       do_write ? "writes" : "reads", bs, target, depth, nsecs);
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	sleep(nsecs);
+	toggle_done(0, NULL, NULL);
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(worker[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	/* cleanup & report results */
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		unsigned long t = worker[i].ops / (runtime.tv_sec ?: 1);
+
+		update_stats(&throughput_stats, t);
+		lat_hist__merge(submit_lat, &worker[i].submit_lat);
+		lat_hist__merge(complete_lat, &worker[i].complete_lat);
+		if (!silent)
+			printf("[thread %2d] ctx: %#lx [ %ld IOPS ]\n",
+			       worker[i].tid, (unsigned long)worker[i].ctx, t);
+
+		cleanup_worker(&worker[i]);
+	}
+
+	print_summary(submit_lat, complete_lat);
+
+	if (tmp) {
+		unlink(tmp);
+		free(tmp);
+	}
+	free(complete_lat);
+	free(submit_lat);
+	free(worker);
+	return ret;
+}
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * epoll-ctl: measure epoll_ctl() under contention.
+ *
+ * Every thread owns a batch of eventfds and keeps adding them to an epoll
+ * instance, modifying and removing them. The eventfds of all the threads
+ * are spread over --instances epoll instances, the fewer of them, the
+ * more the threads contend on ep->mtx and on the rbtree of an instance.
+ */
+
+/* For the CLR_() macros */
+#include <string.h>
+#include <pthread.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+
+#include "../util/stat.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+#include "latency.h"
+
+#include <err.h>
+
+static unsigned int nthreads = 0;
+static unsigned int nsecs    = 8;
+/* amount of eventfds per thread */
+static unsigned int nfds     = 64;
+static unsigned int nepolls  = 1;
+static bool done = false, silent = false;
+
+struct timeval start, end, runtime;
+static pthread_mutex_t thread_lock;
+static unsigned int threads_starting;
+static struct stats throughput_stats[3];
+static pthread_cond_t thread_parent, thread_worker;
+static int *epollfds;
+
+enum {
+	OP_EPOLL_ADD,
+	OP_EPOLL_MOD,
+	OP_EPOLL_DEL,
+	EPOLL_NR_OPS,
+};
+
+static const char *op_names[EPOLL_NR_OPS] = {
+	[OP_EPOLL_ADD] = "ADD",
+	[OP_EPOLL_MOD] = "MOD",
+	[OP_EPOLL_DEL] = "DEL",
+};
+
+static const int op_cmds[EPOLL_NR_OPS] = {
+	[OP_EPOLL_ADD] = EPOLL_CTL_ADD,
+	[OP_EPOLL_MOD] = EPOLL_CTL_MOD,
+	[OP_EPOLL_DEL] = EPOLL_CTL_DEL,
+};
+
+struct worker {
+	int tid;
+	int *fds;
+	pthread_t thread;
+	unsigned long ops[EPOLL_NR_OPS];
+	struct lat_hist lat[EPOLL_NR_OPS];
+};
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads",   &nthreads, "Specify amount of threads"),
+	OPT_UINTEGER('r', "runtime",   &nsecs,    "Specify runtime (in seconds)"),
+	OPT_UINTEGER('f', "nfds",      &nfds,     "Specify amount of file descriptors per thread"),
+	OPT_UINTEGER('e', "instances", &nepolls,  "Specify amount of epoll instances"),
+	OPT_BOOLEAN( 's', "silent",    &silent,   "Silent mode: do not display data/details"),
+	OPT_END()
+};
+
+static const char * const bench_epoll_ctl_usage[] = {
+	"perf bench epoll ctl <options>",
+	NULL
+};
+
+static void do_epoll_op(struct worker *w, int op, int fd)
+{
+	int epollfd = epollfds[fd % nepolls];
+	struct epoll_event ev = {
+		.events = op == OP_EPOLL_MOD ? EPOLLOUT : EPOLLIN,
+		.data.fd = fd,
+	};
+	u64 t0 = lat_now_ns();
+
+	if (epoll_ctl(epollfd, op_cmds[op], fd, &ev))
+		err(EXIT_FAILURE, "epoll_ctl %s", op_names[op]);
+
+	lat_hist__add(&w->lat[op], lat_now_ns() - t0);
+	w->ops[op]++;
+}
+
+static void *workerfn(void *arg)
+{
+	struct worker *w = (struct worker *) arg;
+	unsigned int i;
+	int op;
+
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+
+	/* a batch of ADDs, then of MODs, then of DELs */
+	do {
+		for (op = 0; op < EPOLL_NR_OPS; op++) {
+			for (i = 0; i < nfds; i++)
+				do_epoll_op(w, op, w->fds[i]);
+		}
+	} while (!done);
+
+	return NULL;
+}
+
+static void toggle_done(int sig __maybe_unused,
+			siginfo_t *info __maybe_unused,
+			void *uc __maybe_unused)
+{
+	/* inform all threads that we're done for the day */
+	done = true;
+	gettimeofday(&end, NULL);
+	timersub(&end, &start, &runtime);
+}
+
+static void print_summary(struct lat_hist *lat)
+{
+	int op;
+
+	for (op = 0; op < EPOLL_NR_OPS; op++) {
+		unsigned long avg = avg_stats(&throughput_stats[op]);
+		double stddev = stddev_stats(&throughput_stats[op]);
+		char prefix[16];
+
+		printf("%s%s: Averaged %ld operations/sec (+- %.2f%%), total secs = %d\n",
+		       !silent && !op ? "\n" : "", op_names[op], avg,
+		       rel_stddev_stats(stddev, avg), (int) runtime.tv_sec);
+
+		snprintf(prefix, sizeof(prefix), "%s: ", op_names[op]);
+		lat_hist__print(&lat[op], prefix);
+	}
+}
+
+int bench_epoll_ctl(int argc, const char **argv)
+{
+	int ret = 0;
+	cpu_set_t cpu;
+	struct sigaction act;
+	unsigned int i, j, ncpus;
+	pthread_attr_t thread_attr;
+	struct worker *worker = NULL;
+	struct lat_hist *lat;
+	int op;
+
+	argc = parse_options(argc, argv, options, bench_epoll_ctl_usage, 0);
+	if (argc || !nfds || !nepolls) {
+		usage_with_options(bench_epoll_ctl_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	sigfillset(&act.sa_mask);
+	act.sa_sigaction = toggle_done;
+	sigaction(SIGINT, &act, NULL);
+
+	if (!nthreads) /* default to the number of CPUs */
+		nthreads = ncpus;
+
+	worker = calloc(nthreads, sizeof(*worker));
+	epollfds = calloc(nepolls, sizeof(*epollfds));
+	lat = calloc(EPOLL_NR_OPS, sizeof(*lat));
+	if (!worker || !epollfds || !lat)
+		err(EXIT_FAILURE, "calloc");
+
+	for (i = 0; i < nepolls; i++) {
+		epollfds[i] = epoll_create1(0);
+		if (epollfds[i] < 0)
+			err(EXIT_FAILURE, "epoll_create1");
+	}
+
+	printf("Run summary [PID %d]: %d threads doing epoll_ctl ops on %d fds each, over %d epoll instances, for %d secs.\n\n",
+	       getpid(), nthreads, nfds, nepolls, nsecs);
+
+	for (op = 0; op < EPOLL_NR_OPS; op++)
+		init_stats(&throughput_stats[op]);
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads;
+	pthread_attr_init(&thread_attr);
+	for (i = 0; i < nthreads; i++) {
+		worker[i].tid = i;
+		worker[i].fds = calloc(nfds, sizeof(*worker[i].fds));
+		if (!worker[i].fds)
+			err(EXIT_FAILURE, "calloc");
+
+		for (j = 0; j < nfds; j++) {
+			worker[i].fds[j] = eventfd(0, EFD_NONBLOCK);
+			if (worker[i].fds[j] < 0)
+				err(EXIT_FAILURE, "eventfd");
+		}
+
+		CPU_ZERO(&cpu);
+		CPU_SET(i % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&worker[i].thread, &thread_attr, workerfn,
+				     (void *)(struct worker *) &worker[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+	pthread_attr_destroy(&thread_attr);
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	sleep(nsecs);
+	toggle_done(0, NULL, NULL);
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(worker[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	/* cleanup & report results */
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		unsigned long t[EPOLL_NR_OPS];
+
+		for (op = 0; op < EPOLL_NR_OPS; op++) {
+			t[op] = worker[i].ops[op] / (runtime.tv_sec ?: 1);
+			update_stats(&throughput_stats[op], t[op]);
+			lat_hist__merge(&lat[op], &worker[i].lat[op]);
+		}
+
+		if (!silent)
+			printf("[thread %2d] fdmap: %p ... %p [ add: %ld ops/sec; mod: %ld ops/sec; del: %ld ops/sec ]\n",
+			       worker[i].tid, &worker[i].fds[0],
+			       &worker[i].fds[nfds - 1],
+			       t[OP_EPOLL_ADD], t[OP_EPOLL_MOD], t[OP_EPOLL_DEL]);
+
+		for (j = 0; j < nfds; j++)
+			close(worker[i].fds[j]);
+		free(worker[i].fds);
+	}
+
+	for (i = 0; i < nepolls; i++)
+		close(epollfds[i]);
+
+	print_summary(lat);
+
+	free(lat);
+	free(epollfds);
+	free(worker);
+	return ret;
+}
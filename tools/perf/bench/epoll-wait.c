@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * epoll-wait: measure the epoll wakeup path.
+ *
+ * A set of waiter threads, each of them owning a batch of eventfds, blocks
+ * in epoll_wait() while a set of writer threads keeps signalling the
+ * eventfds. By default every waiter has its own epoll instance, with
+ * --shared all the eventfds are added to a single instance all the
+ * waiters sleep on, which stresses the wait queue and ep->lock instead.
+ *
+ * The throughput is the number of events each waiter consumed per second,
+ * the latency is the time spent in an epoll_wait() call which returned
+ * events, that is the sleep plus the wakeup.
+ */
+
+/* For the CLR_() macros */
+#include <string.h>
+#include <pthread.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+
+#include "../util/stat.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+#include "latency.h"
+
+#include <err.h>
+
+#define EPOLL_WAIT_MAXEVENTS	64
+
+static unsigned int nthreads = 0;
+static unsigned int nwriters = 1;
+static unsigned int nsecs    = 8;
+/* amount of eventfds per waiter */
+static unsigned int nfds     = 64;
+static bool shared = false, edge = false, done = false, silent = false;
+
+struct timeval start, end, runtime;
+static pthread_mutex_t thread_lock;
+static unsigned int threads_starting;
+static struct stats throughput_stats;
+static pthread_cond_t thread_parent, thread_worker;
+static int shared_epollfd = -1;
+static int *fds;
+
+struct worker {
+	int tid;
+	int epollfd;
+	int *fds;
+	pthread_t thread;
+	unsigned long ops;
+	struct lat_hist lat;
+};
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of waiter threads"),
+	OPT_UINTEGER('w', "writers", &nwriters, "Specify amount of writer threads"),
+	OPT_UINTEGER('r', "runtime", &nsecs,    "Specify runtime (in seconds)"),
+	OPT_UINTEGER('f', "nfds",    &nfds,     "Specify amount of file descriptors per waiter"),
+	OPT_BOOLEAN( 'S', "shared",  &shared,   "Use a single epoll instance for all the waiters"),
+	OPT_BOOLEAN( 'E', "edge",    &edge,     "Use edge-triggered events instead of level-triggered"),
+	OPT_BOOLEAN( 's', "silent",  &silent,   "Silent mode: do not display data/details"),
+	OPT_END()
+};
+
+static const char * const bench_epoll_wait_usage[] = {
+	"perf bench epoll wait <options>",
+	NULL
+};
+
+static void wait_for_start(void)
+{
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+}
+
+static void *waiterfn(void *arg)
+{
+	struct worker *w = (struct worker *) arg;
+	struct epoll_event events[EPOLL_WAIT_MAXEVENTS];
+	unsigned long ops = 0; /* avoid cacheline bouncing */
+	int i, n;
+	u64 t0;
+
+	wait_for_start();
+
+	do {
+		t0 = lat_now_ns();
+		/* don't sleep forever once the writers are gone */
+		n = epoll_wait(w->epollfd, events, EPOLL_WAIT_MAXEVENTS, 100);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			err(EXIT_FAILURE, "epoll_wait");
+		}
+		if (!n)
+			continue;
+
+		lat_hist__add(&w->lat, lat_now_ns() - t0);
+
+		for (i = 0; i < n; i++) {
+			eventfd_t val;
+
+			/*
+			 * With a shared instance another waiter may have
+			 * drained the counter already.
+			 */
+			if (eventfd_read(events[i].data.fd, &val) && errno != EAGAIN)
+				err(EXIT_FAILURE, "eventfd_read");
+			ops++;
+		}
+	} while (!done);
+
+	w->ops = ops;
+	return NULL;
+}
+
+static void *writerfn(void *arg)
+{
+	unsigned long tid = (unsigned long) arg;
+	unsigned int i, total = nthreads * nfds;
+
+	wait_for_start();
+
+	do {
+		for (i = tid; i < total && !done; i += nwriters) {
+			if (eventfd_write(fds[i], 1))
+				err(EXIT_FAILURE, "eventfd_write");
+		}
+	} while (!done);
+
+	return NULL;
+}
+
+static void toggle_done(int sig __maybe_unused,
+			siginfo_t *info __maybe_unused,
+			void *uc __maybe_unused)
+{
+	/* inform all threads that we're done for the day */
+	done = true;
+	gettimeofday(&end, NULL);
+	timersub(&end, &start, &runtime);
+}
+
+static void setup_fds(struct worker *w)
+{
+	unsigned int i;
+
+	w->epollfd = shared ? shared_epollfd : epoll_create1(0);
+	if (w->epollfd < 0)
+		err(EXIT_FAILURE, "epoll_create1");
+
+	w->fds = &fds[w->tid * nfds];
+
+	for (i = 0; i < nfds; i++) {
+		struct epoll_event ev = {
+			.events = EPOLLIN | (edge ? EPOLLET : 0),
+		};
+
+		w->fds[i] = eventfd(0, EFD_NONBLOCK);
+		if (w->fds[i] < 0)
+			err(EXIT_FAILURE, "eventfd");
+
+		ev.data.fd = w->fds[i];
+		if (epoll_ctl(w->epollfd, EPOLL_CTL_ADD, w->fds[i], &ev))
+			err(EXIT_FAILURE, "epoll_ctl");
+	}
+}
+
+static void print_summary(struct lat_hist *lat)
+{
+	unsigned long avg = avg_stats(&throughput_stats);
+	double stddev = stddev_stats(&throughput_stats);
+
+	printf("%sAveraged %ld operations/sec (+- %.2f%%), total secs = %d\n",
+	       !silent ? "\n" : "", avg, rel_stddev_stats(stddev, avg),
+	       (int) runtime.tv_sec);
+	lat_hist__print(lat, "Wakeup ");
+}
+
+int bench_epoll_wait(int argc, const char **argv)
+{
+	int ret = 0;
+	cpu_set_t cpu;
+	struct sigaction act;
+	unsigned int i, ncpus;
+	pthread_attr_t thread_attr;
+	struct worker *worker = NULL;
+	pthread_t *writer = NULL;
+	struct lat_hist *lat;
+
+	argc = parse_options(argc, argv, options, bench_epoll_wait_usage, 0);
+	if (argc) {
+		usage_with_options(bench_epoll_wait_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	sigfillset(&act.sa_mask);
+	act.sa_sigaction = toggle_done;
+	sigaction(SIGINT, &act, NULL);
+
+	if (!nthreads) /* default to the number of CPUs, minus the writers */
+		nthreads = ncpus > nwriters ? ncpus - nwriters : 1;
+	if (!nwriters || !nfds) {
+		usage_with_options(bench_epoll_wait_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	worker = calloc(nthreads, sizeof(*worker));
+	writer = calloc(nwriters, sizeof(*writer));
+	fds = calloc(nthreads * nfds, sizeof(*fds));
+	lat = calloc(1, sizeof(*lat));
+	if (!worker || !writer || !fds || !lat)
+		err(EXIT_FAILURE, "calloc");
+
+	if (shared) {
+		shared_epollfd = epoll_create1(0);
+		if (shared_epollfd < 0)
+			err(EXIT_FAILURE, "epoll_create1");
+	}
+
+	printf("Run summary [PID %d]: %d waiters on %s epoll %s with %d fds each, %d writers, for %d secs.\n\n",
+	       getpid(), nthreads, shared ? "a shared" : "per thread",
+	       edge ? "(edge-triggered)" : "(level-triggered)", nfds,
+	       nwriters, nsecs);
+
+	init_stats(&throughput_stats);
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads + nwriters;
+	pthread_attr_init(&thread_attr);
+	for (i = 0; i < nthreads; i++) {
+		worker[i].tid = i;
+		setup_fds(&worker[i]);
+
+		CPU_ZERO(&cpu);
+		CPU_SET(i % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&worker[i].thread, &thread_attr, waiterfn,
+				     (void *)(struct worker *) &worker[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+
+	for (i = 0; i < nwriters; i++) {
+		CPU_ZERO(&cpu);
+		CPU_SET((nthreads + i) % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&writer[i], &thread_attr, writerfn,
+				     (void *)(unsigned long) i);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+	pthread_attr_destroy(&thread_attr);
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	sleep(nsecs);
+	toggle_done(0, NULL, NULL);
+
+	for (i = 0; i < nwriters; i++) {
+		ret = pthread_join(writer[i], NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(worker[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	/* cleanup & report results */
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		unsigned long t = worker[i].ops / (runtime.tv_sec ?: 1);
+		unsigned int j;
+
+		update_stats(&throughput_stats, t);
+		lat_hist__merge(lat, &worker[i].lat);
+		if (!silent)
+			printf("[thread %2d] fdmap: %p ... %p [ %ld ops/sec ]\n",
+			       worker[i].tid, &worker[i].fds[0],
+			       &worker[i].fds[nfds - 1], t);
+
+		for (j = 0; j < nfds; j++)
+			close(worker[i].fds[j]);
+		if (!shared)
+			close(worker[i].epollfd);
+	}
+
+	if (shared)
+		close(shared_epollfd);
+
+	print_summary(lat);
+
+	free(lat);
+	free(fds);
+	free(writer);
+	free(worker);
+	return ret;
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Latency percentiles for the benchmarks which measure single operations.
+ */
+#include <stdio.h>
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+
+#include "latency.h"
+
+static unsigned int lat_hist__index(u64 ns)
+{
+	unsigned int shift;
+
+	if (ns < LAT_HIST_SUB)
+		return ns;
+
+	shift = fls64(ns) - 1 - LAT_HIST_SUB_BITS;
+	return (shift + 1) * LAT_HIST_SUB + ((ns >> shift) & (LAT_HIST_SUB - 1));
+}
+
+/* largest value accounted in bucket @idx */
+static u64 lat_hist__value(unsigned int idx)
+{
+	unsigned int shift;
+
+	if (idx < LAT_HIST_SUB)
+		return idx;
+
+	shift = idx / LAT_HIST_SUB - 1;
+	return ((u64)(LAT_HIST_SUB + idx % LAT_HIST_SUB + 1) << shift) - 1;
+}
+
+void lat_hist__add(struct lat_hist *hist, u64 ns)
+{
+	hist->buckets[lat_hist__index(ns)]++;
+	hist->nr++;
+	if (ns > hist->max)
+		hist->max = ns;
+}
+
+void lat_hist__merge(struct lat_hist *dst, struct lat_hist *src)
+{
+	unsigned int i;
+
+	for (i = 0; i < LAT_HIST_BUCKETS; i++)
+		dst->buckets[i] += src->buckets[i];
+
+	dst->nr += src->nr;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+/* @pct in [0, 100], the result is rounded up to the end of its bucket */
+u64 lat_hist__percentile(struct lat_hist *hist, double pct)
+{
+	u64 target, sum = 0;
+	unsigned int i;
+
+	if (!hist->nr)
+		return 0;
+
+	target = hist->nr * pct / 100;
+	if (target >= hist->nr)
+		return hist->max;
+
+	for (i = 0; i < LAT_HIST_BUCKETS; i++) {
+		sum += hist->buckets[i];
+		if (sum > target)
+			return min(lat_hist__value(i), hist->max);
+	}
+
+	return hist->max;
+}
+
+void lat_hist__print(struct lat_hist *hist, const char *prefix)
+{
+	printf("%slatency (usecs): p50: %.2f  p90: %.2f  p99: %.2f  p99.9: %.2f  max: %.2f\n",
+	       prefix,
+	       lat_hist__percentile(hist, 50) / 1000.0,
+	       lat_hist__percentile(hist, 90) / 1000.0,
+	       lat_hist__percentile(hist, 99) / 1000.0,
+	       lat_hist__percentile(hist, 99.9) / 1000.0,
+	       hist->max / 1000.0);
+}
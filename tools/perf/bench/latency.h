@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef BENCH_LATENCY_H
+#define BENCH_LATENCY_H
+
+#include <time.h>
+#include <linux/types.h>
+
+/*
+ * Log-linear latency histogram: every power of two is split into
+ * LAT_HIST_SUB linear buckets, which bounds the error of a percentile to
+ * 1/LAT_HIST_SUB of its value whatever the range of the samples is.
+ */
+#define LAT_HIST_SUB_BITS	3
+#define LAT_HIST_SUB		(1 << LAT_HIST_SUB_BITS)
+#define LAT_HIST_BUCKETS	(64 * LAT_HIST_SUB)
+
+struct lat_hist {
+	u64	nr;
+	u64	max;
+	u64	buckets[LAT_HIST_BUCKETS];
+};
+
+static inline u64 lat_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void lat_hist__add(struct lat_hist *hist, u64 ns);
+void lat_hist__merge(struct lat_hist *dst, struct lat_hist *src);
+u64 lat_hist__percentile(struct lat_hist *hist, double pct);
+void lat_hist__print(struct lat_hist *hist, const char *prefix);
+
+#endif /* BENCH_LATENCY_H */
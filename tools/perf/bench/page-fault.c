@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * page-fault: measure the scalability of the page fault path.
+ *
+ * Every thread maps its own region, anonymous or backed by a file, and
+ * keeps faulting its pages in by touching them, then zapping them with
+ * MADV_DONTNEED. All the threads share the same mm, so the faults take
+ * mmap_sem for read, while the optional --mappers threads take it for
+ * write in a tight mmap()/munmap() loop.
+ *
+ * The throughput is the number of faults per second, the latency is the
+ * time taken by the store which triggered the fault.
+ */
+
+/* For the CLR_() macros */
+#include <string.h>
+#include <pthread.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+#include "../util/stat.h"
+#include "../util/util.h"
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+#include "latency.h"
+
+#include <err.h>
+
+static unsigned int nthreads = 0;
+static unsigned int nmappers = 0;
+static unsigned int nsecs    = 8;
+/* size of the region of each thread */
+static const char *size_str  = "64MB";
+static const char *dir;
+static bool done = false, silent = false, shared = false, thp = false;
+
+struct timeval start, end, runtime;
+static pthread_mutex_t thread_lock;
+static unsigned int threads_starting;
+static struct stats throughput_stats;
+static pthread_cond_t thread_parent, thread_worker;
+static size_t region_size;
+static unsigned long mapper_ops;
+
+struct worker {
+	int tid;
+	int fd;
+	char *region;
+	pthread_t thread;
+	unsigned long ops;
+	struct lat_hist lat;
+};
+
+static const struct option options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of faulting threads"),
+	OPT_UINTEGER('m', "mappers", &nmappers, "Specify amount of threads doing mmap/munmap concurrently"),
+	OPT_UINTEGER('r', "runtime", &nsecs,    "Specify runtime (in seconds)"),
+	OPT_STRING(  'l', "size",    &size_str, "64MB", "Specify the size of the region of each thread"),
+	OPT_STRING(  'd', "dir",     &dir,      "path",  "Fault in pages of files created in this directory instead of anonymous memory"),
+	OPT_BOOLEAN( 'S', "shared",  &shared,   "Use MAP_SHARED mappings instead of MAP_PRIVATE ones"),
+	OPT_BOOLEAN( 'H', "thp",     &thp,      "Allow transparent huge pages on the anonymous regions, only the first touch of a huge page faults"),
+	OPT_BOOLEAN( 's', "silent",  &silent,   "Silent mode: do not display data/details"),
+	OPT_END()
+};
+
+static const char * const bench_mm_page_fault_usage[] = {
+	"perf bench mm page-fault <options>",
+	NULL
+};
+
+static void wait_for_start(void)
+{
+	pthread_mutex_lock(&thread_lock);
+	threads_starting--;
+	if (!threads_starting)
+		pthread_cond_signal(&thread_parent);
+	pthread_cond_wait(&thread_worker, &thread_lock);
+	pthread_mutex_unlock(&thread_lock);
+}
+
+static void *workerfn(void *arg)
+{
+	struct worker *w = (struct worker *) arg;
+	unsigned long ops = 0; /* avoid cacheline bouncing */
+	size_t off;
+	u64 t0;
+
+	wait_for_start();
+
+	do {
+		for (off = 0; off < region_size && !done; off += page_size, ops++) {
+			t0 = lat_now_ns();
+			WRITE_ONCE(w->region[off], 1);
+			lat_hist__add(&w->lat, lat_now_ns() - t0);
+		}
+
+		if (madvise(w->region, region_size, MADV_DONTNEED))
+			err(EXIT_FAILURE, "madvise");
+	} while (!done);
+
+	w->ops = ops;
+	return NULL;
+}
+
+/* take mmap_sem for write as often as possible */
+static void *mapperfn(void *arg __maybe_unused)
+{
+	unsigned long ops = 0;
+	char *p;
+
+	wait_for_start();
+
+	do {
+		p = mmap(NULL, 4 * page_size, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			err(EXIT_FAILURE, "mmap");
+
+		WRITE_ONCE(p[0], 1);
+		munmap(p, 4 * page_size);
+		ops++;
+	} while (!done);
+
+	__sync_fetch_and_add(&mapper_ops, ops);
+	return NULL;
+}
+
+static void toggle_done(int sig __maybe_unused,
+			siginfo_t *info __maybe_unused,
+			void *uc __maybe_unused)
+{
+	/* inform all threads that we're done for the day */
+	done = true;
+	gettimeofday(&end, NULL);
+	timersub(&end, &start, &runtime);
+}
+
+static void setup_region(struct worker *w)
+{
+	int flags = shared ? MAP_SHARED : MAP_PRIVATE;
+
+	w->fd = -1;
+
+	if (dir) {
+		char path[PATH_MAX];
+
+		snprintf(path, sizeof(path), "%s/perf-bench-page-fault.XXXXXX", dir);
+		w->fd = mkstemp(path);
+		if (w->fd < 0)
+			err(EXIT_FAILURE, "mkstemp");
+		unlink(path);
+
+		if (ftruncate(w->fd, region_size))
+			err(EXIT_FAILURE, "ftruncate");
+	} else {
+		flags |= MAP_ANONYMOUS;
+	}
+
+	w->region = mmap(NULL, region_size, PROT_READ | PROT_WRITE, flags,
+			 w->fd, 0);
+	if (w->region == MAP_FAILED)
+		err(EXIT_FAILURE, "mmap");
+
+	if (!dir)
+		madvise(w->region, region_size, thp ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+}
+
+static void print_summary(struct lat_hist *lat)
+{
+	unsigned long avg = avg_stats(&throughput_stats);
+	double stddev = stddev_stats(&throughput_stats);
+
+	printf("%sAveraged %ld page faults/sec (+- %.2f%%), total secs = %d\n",
+	       !silent ? "\n" : "", avg, rel_stddev_stats(stddev, avg),
+	       (int) runtime.tv_sec);
+	lat_hist__print(lat, "Fault ");
+
+	if (nmappers)
+		printf("mmap/munmap: %ld operations/sec\n",
+		       mapper_ops / (runtime.tv_sec ?: 1));
+}
+
+int bench_mm_page_fault(int argc, const char **argv)
+{
+	int ret = 0;
+	cpu_set_t cpu;
+	struct sigaction act;
+	unsigned int i, ncpus;
+	pthread_attr_t thread_attr;
+	struct worker *worker = NULL;
+	pthread_t *mapper = NULL;
+	struct lat_hist *lat;
+	s64 size;
+
+	argc = parse_options(argc, argv, options, bench_mm_page_fault_usage, 0);
+	if (argc) {
+		usage_with_options(bench_mm_page_fault_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	size = perf_atoll((char *)size_str);
+	if (size <= 0) {
+		fprintf(stderr, "Invalid size:%s\n", size_str);
+		return 1;
+	}
+	region_size = round_up(size, page_size);
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	sigfillset(&act.sa_mask);
+	act.sa_sigaction = toggle_done;
+	sigaction(SIGINT, &act, NULL);
+
+	if (!nthreads) /* default to the number of CPUs */
+		nthreads = ncpus;
+
+	worker = calloc(nthreads, sizeof(*worker));
+	mapper = calloc(nmappers ?: 1, sizeof(*mapper));
+	lat = calloc(1, sizeof(*lat));
+	if (!worker || !mapper || !lat)
+		err(EXIT_FAILURE, "calloc");
+
+	printf("Run summary [PID %d]: %d threads faulting in %s %s %s each, %d mmap/munmap threads, for %d secs.\n\n",
+	       getpid(), nthreads, size_str, shared ? "shared" : "private",
+	       dir ? "file pages" : "anonymous pages", nmappers, nsecs);
+
+	init_stats(&throughput_stats);
+	pthread_mutex_init(&thread_lock, NULL);
+	pthread_cond_init(&thread_parent, NULL);
+	pthread_cond_init(&thread_worker, NULL);
+
+	threads_starting = nthreads + nmappers;
+	pthread_attr_init(&thread_attr);
+	for (i = 0; i < nthreads; i++) {
+		worker[i].tid = i;
+		setup_region(&worker[i]);
+
+		CPU_ZERO(&cpu);
+		CPU_SET(i % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&worker[i].thread, &thread_attr, workerfn,
+				     (void *)(struct worker *) &worker[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+
+	for (i = 0; i < nmappers; i++) {
+		CPU_ZERO(&cpu);
+		CPU_SET((nthreads + i) % ncpus, &cpu);
+
+		ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpu);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_attr_setaffinity_np");
+
+		ret = pthread_create(&mapper[i], &thread_attr, mapperfn, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
+	pthread_attr_destroy(&thread_attr);
+
+	pthread_mutex_lock(&thread_lock);
+	while (threads_starting)
+		pthread_cond_wait(&thread_parent, &thread_lock);
+	gettimeofday(&start, NULL);
+	pthread_cond_broadcast(&thread_worker);
+	pthread_mutex_unlock(&thread_lock);
+
+	sleep(nsecs);
+	toggle_done(0, NULL, NULL);
+
+	for (i = 0; i < nthreads; i++) {
+		ret = pthread_join(worker[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	for (i = 0; i < nmappers; i++) {
+		ret = pthread_join(mapper[i], NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
+
+	/* cleanup & report results */
+	pthread_cond_destroy(&thread_parent);
+	pthread_cond_destroy(&thread_worker);
+	pthread_mutex_destroy(&thread_lock);
+
+	for (i = 0; i < nthreads; i++) {
+		unsigned long t = worker[i].ops / (runtime.tv_sec ?: 1);
+
+		update_stats(&throughput_stats, t);
+		lat_hist__merge(lat, &worker[i].lat);
+		if (!silent)
+			printf("[thread %2d] region: %p ... %p [ %ld faults/sec ]\n",
+			       worker[i].tid, worker[i].region,
+			       worker[i].region + region_size - 1, t);
+
+		munmap(worker[i].region, region_size);
+		if (worker[i].fd >= 0)
+			close(worker[i].fd);
+	}
+
+	print_summary(lat);
+
+	free(lat);
+	free(mapper);
+	free(worker);
+	return ret;
+}
@@ -4,12 +4,17 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <unistd.h>
 #include <string.h>
+#include <stdlib.h>
+#include <dirent.h>
 
 #include "data.h"
 #include "util.h"
 #include "debug.h"
+#include "asm/bug.h"
 
 #ifndef O_CLOEXEC
 #ifdef __sparc__
@@ -51,24 +56,29 @@ static int check_backup(struct perf_data_file *file)
 		char oldname[PATH_MAX];
 		snprintf(oldname, sizeof(oldname), "%s.old",
 			 file->path);
-		unlink(oldname);
+
+		if (!stat(oldname, &st) && S_ISDIR(st.st_mode))
+			rm_rf(oldname);
+		else
+			unlink(oldname);
+
 		rename(file->path, oldname);
 	}
 
 	return 0;
 }
 
-static int open_file_read(struct perf_data_file *file)
+static int open_file_read(struct perf_data_file *file, const char *path)
 {
 	struct stat st;
 	int fd;
 	char sbuf[STRERR_BUFSIZE];
 
-	fd = open(file->path, O_RDONLY);
+	fd = open(path, O_RDONLY);
 	if (fd < 0) {
 		int err = errno;
 
-		pr_err("failed to open %s: %s", file->path,
+		pr_err("failed to open %s: %s", path,
 			str_error_r(err, sbuf, sizeof(sbuf)));
 		if (err == ENOENT && !strcmp(file->path, "perf.data"))
 			pr_err("  (try 'perf record' first)");
@@ -81,13 +91,13 @@ static int open_file_read(struct perf_data_file *file)
 
 	if (!file->force && st.st_uid && (st.st_uid != geteuid())) {
 		pr_err("File %s not owned by current user or root (use -f to override)\n",
-		       file->path);
+		       path);
 		goto out_close;
 	}
 
 	if (!st.st_size) {
 		pr_info("zero-sized file (%s), nothing to do!\n",
-			file->path);
+			path);
 		goto out_close;
 	}
 
@@ -99,7 +109,7 @@ static int open_file_read(struct perf_data_file *file)
 	return -1;
 }
 
-static int open_file_write(struct perf_data_file *file)
+static int open_file_write(struct perf_data_file *file, const char *path)
 {
 	int fd;
 	char sbuf[STRERR_BUFSIZE];
@@ -107,11 +117,17 @@ static int open_file_write(struct perf_data_file *file)
 	if (check_backup(file))
 		return -1;
 
-	fd = open(file->path, O_CREAT|O_RDWR|O_TRUNC|O_CLOEXEC,
+	if (file->is_dir && mkdir(file->path, S_IRWXU) < 0) {
+		pr_err("failed to create directory %s : %s\n", file->path,
+			str_error_r(errno, sbuf, sizeof(sbuf)));
+		return -1;
+	}
+
+	fd = open(path, O_CREAT|O_RDWR|O_TRUNC|O_CLOEXEC,
 		  S_IRUSR|S_IWUSR);
 
 	if (fd < 0)
-		pr_err("failed to open %s : %s\n", file->path,
+		pr_err("failed to open %s : %s\n", path,
 			str_error_r(errno, sbuf, sizeof(sbuf)));
 
 	return fd;
@@ -119,10 +135,17 @@ static int open_file_write(struct perf_data_file *file)
 
 static int open_file(struct perf_data_file *file)
 {
+	char path[PATH_MAX];
+	const char *name = file->path;
 	int fd;
 
+	if (file->is_dir) {
+		snprintf(path, sizeof(path), "%s/data", file->path);
+		name = path;
+	}
+
 	fd = perf_data_file__is_read(file) ?
-	     open_file_read(file) : open_file_write(file);
+	     open_file_read(file, name) : open_file_write(file, name);
 
 	file->fd = fd;
 	return fd < 0 ? -1 : 0;
@@ -130,17 +153,26 @@ static int open_file(struct perf_data_file *file)
 
 int perf_data_file__open(struct perf_data_file *file)
 {
+	struct stat st;
+
 	if (check_pipe(file))
 		return 0;
 
 	if (!file->path)
 		file->path = "perf.data";
 
+	if (perf_data_file__is_read(file) &&
+	    !stat(file->path, &st) && S_ISDIR(st.st_mode))
+		file->is_dir = true;
+
 	return open_file(file);
 }
 
 void perf_data_file__close(struct perf_data_file *file)
 {
+	if (file->is_dir)
+		perf_data_file__close_dir(file);
+
 	close(file->fd);
 }
 
@@ -159,7 +191,7 @@ int perf_data_file__switch(struct perf_data_file *file,
 
 	if (check_pipe(file))
 		return -EINVAL;
-	if (perf_data_file__is_read(file))
+	if (perf_data_file__is_read(file) || file->is_dir)
 		return -EINVAL;
 
 	if (asprintf(&new_filepath, "%s.%s", file->path, postfix) < 0)
@@ -190,3 +222,156 @@ out:
 	free(new_filepath);
 	return ret;
 }
+
+void perf_data_file__close_dir(struct perf_data_file *file)
+{
+	int i;
+
+	for (i = 0; i < file->dir.nr; i++) {
+		struct perf_data_file *f = &file->dir.files[i];
+
+		if (f->fd >= 0)
+			close(f->fd);
+		free((char *)f->path);
+	}
+
+	zfree(&file->dir.files);
+	file->dir.nr = 0;
+}
+
+/*
+ * Open one data.<N> file per writer thread, to be called once the
+ * directory has been opened for writing.
+ */
+int perf_data_file__create_dir(struct perf_data_file *file, int nr)
+{
+	struct perf_data_file *files;
+	int i;
+
+	if (WARN_ON(!file->is_dir || !perf_data_file__is_write(file)))
+		return -EINVAL;
+
+	files = zalloc(nr * sizeof(*files));
+	if (!files)
+		return -ENOMEM;
+
+	for (i = 0; i < nr; i++)
+		files[i].fd = -1;
+
+	file->dir.version = PERF_DIR_VERSION;
+	file->dir.files   = files;
+	file->dir.nr      = nr;
+
+	for (i = 0; i < nr; i++) {
+		struct perf_data_file *f = &files[i];
+		char *path;
+
+		if (asprintf(&path, "%s/data.%d", file->path, i) < 0)
+			goto out_err;
+
+		f->path = path;
+		f->mode = PERF_DATA_MODE_WRITE;
+
+		if (open_file(f))
+			goto out_err;
+	}
+
+	return 0;
+
+out_err:
+	perf_data_file__close_dir(file);
+	return -1;
+}
+
+static int data_file__index(const char *name)
+{
+	char *end;
+	long idx;
+
+	if (strncmp(name, "data.", 5))
+		return -1;
+
+	idx = strtol(name + 5, &end, 10);
+	if (*end || end == name + 5 || idx < 0 || idx > INT_MAX)
+		return -1;
+
+	return idx;
+}
+
+static int data_file__cmp(const void *a, const void *b)
+{
+	const struct perf_data_file *fa = a, *fb = b;
+	int ia = data_file__index(strrchr(fa->path, '/') + 1);
+	int ib = data_file__index(strrchr(fb->path, '/') + 1);
+
+	return ia - ib;
+}
+
+/*
+ * Open the data.<N> files of a directory opened for reading, the header
+ * must have been read already so that ->dir.version is known. Empty files
+ * (threads which got no events) are skipped.
+ */
+int perf_data_file__open_dir(struct perf_data_file *file)
+{
+	struct perf_data_file *files = NULL;
+	struct dirent *dent;
+	int nr = 0, i, ret = -1;
+	DIR *dir;
+
+	if (!file->is_dir)
+		return 0;
+
+	if (file->dir.version != PERF_DIR_VERSION) {
+		pr_err("unsupported directory format version %" PRIu64 " in %s\n",
+		       file->dir.version, file->path);
+		return -1;
+	}
+
+	dir = opendir(file->path);
+	if (!dir)
+		return -errno;
+
+	while ((dent = readdir(dir)) != NULL) {
+		struct perf_data_file *f;
+		char path[PATH_MAX];
+		struct stat st;
+
+		if (data_file__index(dent->d_name) < 0)
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s", file->path, dent->d_name);
+		if (stat(path, &st) || !S_ISREG(st.st_mode) || !st.st_size)
+			continue;
+
+		f = realloc(files, (nr + 1) * sizeof(*files));
+		if (!f)
+			goto out_err;
+		files = f;
+
+		f = &files[nr++];
+		memset(f, 0, sizeof(*f));
+		f->fd    = -1;
+		f->mode  = PERF_DATA_MODE_READ;
+		f->force = file->force;
+		f->path  = strdup(path);
+		if (!f->path)
+			goto out_err;
+	}
+
+	qsort(files, nr, sizeof(*files), data_file__cmp);
+
+	for (i = 0; i < nr; i++) {
+		if (open_file(&files[i]))
+			goto out_err;
+	}
+
+	ret = 0;
+out_err:
+	closedir(dir);
+	file->dir.files = files;
+	file->dir.nr    = nr;
+	if (ret)
+		perf_data_file__close_dir(file);
+	return ret;
+}
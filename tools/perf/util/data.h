@@ -3,19 +3,37 @@
 #define __PERF_DATA_H
 
 #include <stdbool.h>
+#include <linux/types.h>
 
 enum perf_data_mode {
 	PERF_DATA_MODE_WRITE,
 	PERF_DATA_MODE_READ,
 };
 
+enum perf_dir_version {
+	PERF_DIR_VERSION	= 1,
+};
+
+/*
+ * A directory output keeps the header and the events of the main writer
+ * in <path>/data, and the events of each extra writer thread in its own
+ * <path>/data.<N> file, listed in @dir. Set @is_dir before opening to
+ * write one, it is detected when reading.
+ */
 struct perf_data_file {
 	const char		*path;
 	int			 fd;
 	bool			 is_pipe;
+	bool			 is_dir;
 	bool			 force;
 	unsigned long		 size;
 	enum perf_data_mode	 mode;
+
+	struct {
+		u64			 version;
+		struct perf_data_file	*files;
+		int			 nr;
+	} dir;
 };
 
 static inline bool perf_data_file__is_read(struct perf_data_file *file)
@@ -33,6 +51,11 @@ static inline int perf_data_file__is_pipe(struct perf_data_file *file)
 	return file->is_pipe;
 }
 
+static inline bool perf_data_file__is_dir(struct perf_data_file *file)
+{
+	return file->is_dir;
+}
+
 static inline int perf_data_file__fd(struct perf_data_file *file)
 {
 	return file->fd;
@@ -57,4 +80,8 @@ ssize_t perf_data_file__write(struct perf_data_file *file,
 int perf_data_file__switch(struct perf_data_file *file,
 			   const char *postfix,
 			   size_t pos, bool at_exit);
+
+int perf_data_file__create_dir(struct perf_data_file *file, int nr);
+int perf_data_file__open_dir(struct perf_data_file *file);
+void perf_data_file__close_dir(struct perf_data_file *file);
 #endif /* __PERF_DATA_H */
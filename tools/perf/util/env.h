@@ -54,6 +54,17 @@ struct perf_env {
 	struct cpu_cache_level	*caches;
 	int			 caches_cnt;
 	struct numa_node	*numa_nodes;
+	u32			 comp_type;
+	u32			 comp_ver;
+	u32			 comp_level;
+	u32			 comp_ratio;
+	u32			 comp_mmap_len;
+};
+
+enum perf_compress_type {
+	PERF_COMP_NONE = 0,
+	PERF_COMP_ZSTD,
+	PERF_COMP_MAX
 };
 
 extern struct perf_env perf_env;
@@ -237,6 +237,7 @@ int ordered_events__flush(struct ordered_events *oe, enum oe_flush how)
 		"FINAL",
 		"ROUND",
 		"HALF ",
+		"TIME ",
 	};
 	int err;
 
@@ -266,6 +267,7 @@ int ordered_events__flush(struct ordered_events *oe, enum oe_flush how)
 	}
 
 	case OE_FLUSH__ROUND:
+	case OE_FLUSH__TIME:
 	case OE_FLUSH__NONE:
 	default:
 		break;
@@ -291,6 +293,16 @@ int ordered_events__flush(struct ordered_events *oe, enum oe_flush how)
 	return err;
 }
 
+/*
+ * Deliver the events up to @timestamp, for readers that know the bound of
+ * the events still to come better than the rounds of a single stream.
+ */
+int ordered_events__flush_time(struct ordered_events *oe, u64 timestamp)
+{
+	oe->next_flush = timestamp;
+	return ordered_events__flush(oe, OE_FLUSH__TIME);
+}
+
 void ordered_events__init(struct ordered_events *oe, ordered_events__deliver_t deliver)
 {
 	INIT_LIST_HEAD(&oe->events);
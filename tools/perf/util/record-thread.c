@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Threaded trace writing for perf record
+ *
+ * With a single reader, draining the per-cpu ring buffers and writing
+ * them out does not scale with the number of cpus: on big machines the
+ * buffers overflow and events get lost. The mmaps of the evlist are split
+ * between a pool of threads, each of them polls its own event fds, drains
+ * its ring buffers and writes the events, optionally zstd compressed,
+ * to its own data.<N> file of a directory output.
+ *
+ * The thread files only hold event records: the header, the attributes
+ * and the synthesized events still go to the main data file, written by
+ * the caller. Each pass over the ring buffers ends with a round, which
+ * perf_session uses to interleave the data.<N> files when reading them.
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+
+#include "record-thread.h"
+#include "evlist.h"
+#include "data.h"
+#include "debug.h"
+#include "header.h"
+#include "session.h"
+#include "util.h"
+#include "asm/bug.h"
+
+static size_t process_comp_header(void *record, size_t increment)
+{
+	struct compressed_event *event = record;
+	size_t size = sizeof(*event);
+
+	if (increment) {
+		event->header.size += increment;
+		return increment;
+	}
+
+	event->header.type = PERF_RECORD_COMPRESSED;
+	event->header.size = size;
+	event->header.misc = 0;
+
+	return size;
+}
+
+static int record_thread__write(struct record_thread *thread,
+				void *buf, size_t size)
+{
+	thread->bytes_transferred += size;
+
+	if (thread->threads->comp_level) {
+		size = zstd_compress_stream_to_records(&thread->zstd_data,
+				thread->comp_buf, thread->comp_buf_size,
+				buf, size,
+				PERF_SAMPLE_MAX_SIZE - sizeof(struct compressed_event) - 1,
+				process_comp_header);
+		if (!size)
+			return -1;
+		buf = thread->comp_buf;
+	}
+
+	if (perf_data_file__write(thread->file, buf, size) < 0) {
+		pr_err("failed to write perf data, error: %m\n");
+		return -1;
+	}
+
+	thread->bytes_written += size;
+	return 0;
+}
+
+static int record_thread__mmap_read(struct record_thread *thread,
+				    struct perf_mmap *md)
+{
+	u64 head = perf_mmap__read_head(md);
+	u64 old = md->prev;
+	unsigned char *data = md->base + page_size;
+	unsigned long size;
+	void *buf;
+
+	if (old == head)
+		return 0;
+
+	size = head - old;
+	if (size > (unsigned long)(md->mask) + 1) {
+		WARN_ONCE(1, "failed to keep up with mmap data. (warn only once)\n");
+
+		md->prev = head;
+		perf_mmap__consume(md, false);
+		return 0;
+	}
+
+	if ((old & md->mask) + size != (head & md->mask)) {
+		buf = &data[old & md->mask];
+		size = md->mask + 1 - (old & md->mask);
+		old += size;
+
+		if (record_thread__write(thread, buf, size) < 0)
+			return -1;
+	}
+
+	buf = &data[old & md->mask];
+	size = head - old;
+	old += size;
+
+	if (record_thread__write(thread, buf, size) < 0)
+		return -1;
+
+	md->prev = old;
+	perf_mmap__consume(md, false);
+	return 0;
+}
+
+static int record_thread__mmap_read_all(struct record_thread *thread)
+{
+	int i;
+
+	for (i = 0; i < thread->nr_mmaps; i++) {
+		struct perf_mmap *md = thread->mmaps[i];
+
+		if (md->base && record_thread__mmap_read(thread, md) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Ends the round of a pass that drained events. It is written as is, even
+ * when compressing, for perf_session to find it without decompressing.
+ */
+static int record_thread__finished_round(struct record_thread *thread)
+{
+	struct perf_event_header round = {
+		.type = PERF_RECORD_FINISHED_ROUND,
+		.size = sizeof(round),
+	};
+
+	if (perf_data_file__write(thread->file, &round, sizeof(round)) < 0) {
+		pr_err("failed to write perf data, error: %m\n");
+		return -1;
+	}
+
+	thread->bytes_written += sizeof(round);
+	return 0;
+}
+
+static int record_thread__poll(struct record_thread *thread)
+{
+	int i;
+
+	if (poll(thread->pollfd, thread->nr_mmaps + 1, -1) < 0)
+		return errno == EINTR ? 0 : -errno;
+
+	/* stop polling the fds of the events which went away */
+	for (i = 0; i < thread->nr_mmaps; i++) {
+		if (thread->pollfd[i].revents & (POLLERR | POLLHUP))
+			thread->pollfd[i].fd = -1;
+	}
+
+	return 0;
+}
+
+static void *record_thread__fn(void *arg)
+{
+	struct record_thread *thread = arg;
+	struct record_threads *threads = thread->threads;
+	int err = 0;
+
+	while (!err) {
+		u64 transferred = thread->bytes_transferred;
+		bool done = READ_ONCE(threads->done);
+
+		/* one last pass once asked to stop, to drain the buffers */
+		err = record_thread__mmap_read_all(thread);
+		if (!err && transferred != thread->bytes_transferred)
+			err = record_thread__finished_round(thread);
+		if (err || done)
+			break;
+
+		if (transferred == thread->bytes_transferred)
+			err = record_thread__poll(thread);
+	}
+
+	thread->err = err;
+	return NULL;
+}
+
+static int record_thread__init(struct record_thread *thread,
+			       struct record_threads *threads,
+			       struct perf_data_file *file)
+{
+	struct perf_evlist *evlist = threads->evlist;
+	int i, idx = thread - threads->thread;
+
+	thread->threads = threads;
+	thread->file = file;
+
+	thread->nr_mmaps = DIV_ROUND_UP(evlist->nr_mmaps - idx, threads->nr);
+	thread->mmaps = calloc(thread->nr_mmaps, sizeof(*thread->mmaps));
+	thread->pollfd = calloc(thread->nr_mmaps + 1, sizeof(*thread->pollfd));
+	if (!thread->mmaps || !thread->pollfd)
+		return -ENOMEM;
+
+	for (i = 0; i < thread->nr_mmaps; i++) {
+		struct perf_mmap *md = &evlist->mmap[idx + i * threads->nr];
+
+		thread->mmaps[i] = md;
+		thread->pollfd[i].fd = md->base ? md->fd : -1;
+		thread->pollfd[i].events = POLLIN;
+	}
+
+	thread->pollfd[i].fd = threads->wakeup[0];
+	thread->pollfd[i].events = POLLIN;
+
+	if (!threads->comp_level)
+		return 0;
+
+	if (zstd_init(&thread->zstd_data, threads->comp_level) < 0)
+		return -EINVAL;
+
+	/* room for an incompressible ring buffer and the record headers */
+	thread->comp_buf_size = 2 * evlist->mmap_len;
+	thread->comp_buf = malloc(thread->comp_buf_size);
+	if (!thread->comp_buf)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static void record_thread__exit(struct record_thread *thread)
+{
+	zstd_fini(&thread->zstd_data);
+	zfree(&thread->comp_buf);
+	zfree(&thread->pollfd);
+	zfree(&thread->mmaps);
+}
+
+/*
+ * Split the forward ring buffers of @evlist, which must be mmapped
+ * already, between @nr threads writing to the directory @file. A
+ * @comp_level above zero enables zstd compression at that level.
+ */
+struct record_threads *record_threads__new(struct perf_evlist *evlist,
+					   struct perf_data_file *file,
+					   int nr, int comp_level)
+{
+	struct record_threads *threads;
+	int i;
+
+	if (evlist->overwrite || !evlist->mmap || !perf_data_file__is_dir(file)) {
+		pr_err("threaded writing needs forward ring buffers and a directory output\n");
+		return NULL;
+	}
+
+#ifndef HAVE_ZSTD_SUPPORT
+	if (comp_level) {
+		pr_err("perf is built without zstd support, can't compress\n");
+		return NULL;
+	}
+#endif
+
+	if (nr > evlist->nr_mmaps)
+		nr = evlist->nr_mmaps;
+	if (nr <= 0)
+		return NULL;
+
+	threads = zalloc(sizeof(*threads));
+	if (!threads)
+		return NULL;
+
+	threads->evlist = evlist;
+	threads->comp_level = comp_level;
+	threads->wakeup[0] = threads->wakeup[1] = -1;
+
+	threads->thread = calloc(nr, sizeof(*threads->thread));
+	if (!threads->thread)
+		goto out_free;
+	threads->nr = nr;
+
+	if (pipe(threads->wakeup) < 0) {
+		pr_err("failed to create the wakeup pipe: %m\n");
+		goto out_delete;
+	}
+
+	if (perf_data_file__create_dir(file, nr))
+		goto out_delete;
+
+	for (i = 0; i < nr; i++) {
+		if (record_thread__init(&threads->thread[i], threads,
+					&file->dir.files[i]))
+			goto out_delete;
+	}
+
+	return threads;
+
+out_free:
+	free(threads);
+	return NULL;
+out_delete:
+	record_threads__delete(threads);
+	return NULL;
+}
+
+void record_threads__delete(struct record_threads *threads)
+{
+	int i;
+
+	if (!threads)
+		return;
+
+	if (threads->started)
+		record_threads__stop(threads);
+
+	for (i = 0; i < threads->nr; i++)
+		record_thread__exit(&threads->thread[i]);
+
+	if (threads->wakeup[0] >= 0) {
+		close(threads->wakeup[0]);
+		close(threads->wakeup[1]);
+	}
+
+	free(threads->thread);
+	free(threads);
+}
+
+int record_threads__start(struct record_threads *threads)
+{
+	sigset_t full, old;
+	int i, err = 0;
+
+	/* signals are for the main thread, which asks the others to stop */
+	sigfillset(&full);
+	pthread_sigmask(SIG_SETMASK, &full, &old);
+
+	for (i = 0; i < threads->nr; i++) {
+		struct record_thread *thread = &threads->thread[i];
+
+		err = pthread_create(&thread->tid, NULL, record_thread__fn, thread);
+		if (err) {
+			pr_err("failed to start record thread %d: %s\n",
+			       i, strerror(err));
+			break;
+		}
+	}
+
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	if (err) {
+		WRITE_ONCE(threads->done, true);
+		if (write(threads->wakeup[1], "", 1) < 0)
+			pr_debug("failed to wake record threads up\n");
+
+		while (--i >= 0)
+			pthread_join(threads->thread[i].tid, NULL);
+		return -err;
+	}
+
+	threads->started = true;
+	return 0;
+}
+
+/*
+ * Ask the threads to drain their ring buffers one last time and wait for
+ * them. Returns the first error a thread ran into.
+ */
+int record_threads__stop(struct record_threads *threads)
+{
+	int i, err = 0;
+
+	if (!threads->started)
+		return 0;
+
+	WRITE_ONCE(threads->done, true);
+	if (write(threads->wakeup[1], "", 1) < 0)
+		pr_debug("failed to wake record threads up\n");
+
+	for (i = 0; i < threads->nr; i++) {
+		struct record_thread *thread = &threads->thread[i];
+
+		pthread_join(thread->tid, NULL);
+		if (thread->err && !err)
+			err = thread->err;
+	}
+
+	threads->started = false;
+	return err;
+}
+
+void record_threads__stats(struct record_threads *threads,
+			   u64 *transferred, u64 *written)
+{
+	int i;
+
+	*transferred = *written = 0;
+
+	for (i = 0; i < threads->nr; i++) {
+		*transferred += threads->thread[i].bytes_transferred;
+		*written += threads->thread[i].bytes_written;
+	}
+}
+
+/*
+ * Mark the output as a directory, and record the compression parameters
+ * perf_session needs to size its decompression buffers.
+ */
+void record_threads__setup_header(struct record_threads *threads,
+				  struct perf_session *session)
+{
+	struct perf_env *env = &session->header.env;
+	u64 transferred, written;
+
+	perf_header__set_feat(&session->header, HEADER_DIR_FORMAT);
+
+	if (!threads->comp_level)
+		return;
+
+	record_threads__stats(threads, &transferred, &written);
+
+#ifdef HAVE_ZSTD_SUPPORT
+	env->comp_ver = ZSTD_versionNumber();
+#endif
+	env->comp_type = PERF_COMP_ZSTD;
+	env->comp_level = threads->comp_level;
+	env->comp_ratio = written ? (transferred + written / 2) / written : 0;
+	env->comp_mmap_len = threads->evlist->mmap_len;
+
+	perf_header__set_feat(&session->header, HEADER_COMPRESSED);
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __PERF_RECORD_THREAD_H
+#define __PERF_RECORD_THREAD_H
+
+#include <pthread.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <linux/types.h>
+#include "compress.h"
+
+struct perf_evlist;
+struct perf_mmap;
+struct perf_data_file;
+struct perf_session;
+struct record_threads;
+
+/**
+ * struct record_thread - one reader of the ring buffers
+ *
+ * @mmaps - the ring buffers owned by this thread
+ * @pollfd - the event fds of @mmaps, followed by the wakeup pipe
+ * @file - the data.<N> file of the directory this thread writes to
+ * @bytes_transferred - bytes read from the ring buffers
+ * @bytes_written - bytes written to @file, after compression
+ */
+struct record_thread {
+	pthread_t		 tid;
+	struct record_threads	*threads;
+	struct perf_mmap	**mmaps;
+	int			 nr_mmaps;
+	struct pollfd		*pollfd;
+	struct perf_data_file	*file;
+	struct zstd_data	 zstd_data;
+	void			*comp_buf;
+	size_t			 comp_buf_size;
+	u64			 bytes_transferred;
+	u64			 bytes_written;
+	int			 err;
+};
+
+struct record_threads {
+	struct perf_evlist	*evlist;
+	struct record_thread	*thread;
+	int			 nr;
+	int			 comp_level;
+	int			 wakeup[2];
+	bool			 started;
+	bool			 done;
+};
+
+struct record_threads *record_threads__new(struct perf_evlist *evlist,
+					   struct perf_data_file *file,
+					   int nr, int comp_level);
+void record_threads__delete(struct record_threads *threads);
+
+int record_threads__start(struct record_threads *threads);
+int record_threads__stop(struct record_threads *threads);
+
+void record_threads__stats(struct record_threads *threads,
+			   u64 *transferred, u64 *written);
+void record_threads__setup_header(struct record_threads *threads,
+				  struct perf_session *session);
+
+#endif /* __PERF_RECORD_THREAD_H */
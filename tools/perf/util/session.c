@@ -31,6 +31,149 @@ static int perf_session__deliver_event(struct perf_session *session,
 				       struct perf_tool *tool,
 				       u64 file_offset);
 
+static s64 perf_session__process_event(struct perf_session *session,
+				       union perf_event *event, u64 file_offset);
+
+#ifdef HAVE_ZSTD_SUPPORT
+static int perf_session__process_decomp_events(struct perf_session *session,
+					       struct decomp *decomp)
+{
+	union perf_event *event;
+	u64 size;
+	s64 skip;
+
+	while (decomp->head + sizeof(event->header) <= decomp->size) {
+		event = (union perf_event *)(decomp->data + decomp->head);
+
+		if (session->header.needs_swap)
+			perf_event_header__bswap(&event->header);
+
+		size = event->header.size;
+
+		/* split event, completed by the next record */
+		if (decomp->head + size > decomp->size) {
+			if (session->header.needs_swap)
+				perf_event_header__bswap(&event->header);
+			break;
+		}
+
+		if (size < sizeof(struct perf_event_header) ||
+		    (skip = perf_session__process_event(session, event,
+							decomp->file_pos)) < 0) {
+			pr_err("%#" PRIx64 " [%#x]: failed to process compressed type: %d\n",
+			       decomp->file_pos + decomp->head, event->header.size,
+			       event->header.type);
+			return -EINVAL;
+		}
+
+		decomp->head += size + skip;
+	}
+
+	return 0;
+}
+
+static int perf_session__process_compressed_event(struct perf_session *session,
+						  union perf_event *event,
+						  u64 file_offset)
+{
+	struct decomp *decomp, *decomp_last = session->decomp_last;
+	size_t decomp_size, src_size, mmap_len;
+	u64 decomp_len = session->header.env.comp_mmap_len;
+	u64 decomp_last_rem = 0;
+	void *src;
+
+	if (!decomp_len) {
+		pr_err("Compressed record without compression parameters\n");
+		return -1;
+	}
+
+	if (decomp_last) {
+		decomp_last_rem = decomp_last->size - decomp_last->head;
+		decomp_len += decomp_last_rem;
+	}
+
+	mmap_len = sizeof(struct decomp) + decomp_len;
+	decomp = mmap(NULL, mmap_len, PROT_READ|PROT_WRITE,
+		      MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+	if (decomp == MAP_FAILED) {
+		pr_err("Couldn't allocate memory for decompression\n");
+		return -1;
+	}
+
+	decomp->next = NULL;
+	decomp->file_pos = file_offset;
+	decomp->mmap_len = mmap_len;
+	decomp->head = 0;
+	decomp->size = 0;
+
+	if (decomp_last_rem) {
+		memcpy(decomp->data, decomp_last->data + decomp_last->head,
+		       decomp_last_rem);
+		decomp->size = decomp_last_rem;
+		decomp_last->head = decomp_last->size;
+	}
+
+	src = (void *)event + sizeof(struct compressed_event);
+	src_size = event->pack.header.size - sizeof(struct compressed_event);
+
+	decomp_size = zstd_decompress_stream(session->active_zstd, src, src_size,
+					     decomp->data + decomp_last_rem,
+					     decomp_len - decomp_last_rem);
+	if (!decomp_size) {
+		munmap(decomp, mmap_len);
+		pr_err("Couldn't decompress data\n");
+		return -1;
+	}
+
+	decomp->size += decomp_size;
+
+	if (session->decomp == NULL)
+		session->decomp = decomp;
+	else
+		session->decomp_last->next = decomp;
+	session->decomp_last = decomp;
+
+	pr_debug("decomp (B): %zu to %zu\n", src_size, decomp_size);
+
+	return perf_session__process_decomp_events(session, decomp);
+}
+
+/*
+ * Every writer has its own compression stream and only ends a round
+ * between two complete events, nothing is left over when moving on to
+ * another data file unless the previous one was truncated.
+ */
+static void perf_session__reset_decomp(struct perf_session *session)
+{
+	struct decomp *decomp = session->decomp_last;
+
+	if (decomp && decomp->head != decomp->size) {
+		pr_warning("%" PRIu64 " bytes of truncated compressed data dropped\n",
+			   decomp->size - decomp->head);
+		decomp->head = decomp->size;
+	}
+}
+#else /* !HAVE_ZSTD_SUPPORT */
+static void perf_session__reset_decomp(struct perf_session *session __maybe_unused)
+{
+}
+#endif
+
+static void perf_session__release_decomp_events(struct perf_session *session)
+{
+	struct decomp *next, *decomp;
+
+	next = session->decomp;
+	while (next) {
+		decomp = next;
+		next = decomp->next;
+		munmap(decomp, decomp->mmap_len);
+	}
+
+	session->decomp = NULL;
+	session->decomp_last = NULL;
+}
+
 static int perf_session__open(struct perf_session *session)
 {
 	struct perf_data_file *file = session->file;
@@ -142,9 +285,16 @@ struct perf_session *perf_session__new(struct perf_data_file *file,
 		session->file = file;
 
 		if (perf_data_file__is_read(file)) {
+			if (zstd_init(&session->zstd_data, 0) < 0)
+				pr_warning("Decompression initialization failed, reported data may be incomplete\n");
+			session->active_zstd = &session->zstd_data;
+
 			if (perf_session__open(session) < 0)
 				goto out_close;
 
+			if (perf_data_file__open_dir(file))
+				goto out_close;
+
 			/*
 			 * set session attributes that are present in perf.data
 			 * but not in pipe-mode.
@@ -204,6 +354,8 @@ void perf_session__delete(struct perf_session *session)
 	machines__exit(&session->machines);
 	if (session->file)
 		perf_data_file__close(session->file);
+	perf_session__release_decomp_events(session);
+	zstd_fini(&session->zstd_data);
 	free(session);
 }
 
@@ -296,6 +448,22 @@ static s64 process_event_auxtrace_stub(struct perf_tool *tool __maybe_unused,
 	return event->auxtrace.size;
 }
 
+#ifndef HAVE_ZSTD_SUPPORT
+static int perf_session__process_compressed_event_stub(struct perf_session *session __maybe_unused,
+						       union perf_event *event __maybe_unused,
+						       u64 file_offset __maybe_unused)
+{
+	static bool warned;
+
+	dump_printf(": unhandled!\n");
+	if (!warned) {
+		pr_warning("Compressed records are skipped, perf is built without zstd support\n");
+		warned = true;
+	}
+	return 0;
+}
+#endif
+
 static int process_event_op2_stub(struct perf_tool *tool __maybe_unused,
 				  union perf_event *event __maybe_unused,
 				  struct perf_session *session __maybe_unused)
@@ -433,6 +601,13 @@ void perf_tool__fill_defaults(struct perf_tool *tool)
 		tool->time_conv = process_event_op2_stub;
 	if (tool->feature == NULL)
 		tool->feature = process_event_op2_stub;
+	if (tool->compressed == NULL) {
+#ifdef HAVE_ZSTD_SUPPORT
+		tool->compressed = perf_session__process_compressed_event;
+#else
+		tool->compressed = perf_session__process_compressed_event_stub;
+#endif
+	}
 }
 
 static void swap_sample_id_all(union perf_event *event, void *data)
@@ -875,7 +1050,13 @@ static int process_finished_round(struct perf_tool *tool __maybe_unused,
 int perf_session__queue_event(struct perf_session *s, union perf_event *event,
 			      struct perf_sample *sample, u64 file_offset)
 {
-	return ordered_events__queue(&s->ordered_events, event, sample, file_offset);
+	int ret = ordered_events__queue(&s->ordered_events, event, sample, file_offset);
+
+	/* bounds the flushes of a directory, see __perf_session__process_dir_events() */
+	if (!ret && sample->time > s->queued_max_ts)
+		s->queued_max_ts = sample->time;
+
+	return ret;
 }
 
 static void callchain__lbr_callstack_printf(struct perf_sample *sample)
@@ -1406,6 +1587,8 @@ static s64 perf_session__process_user_event(struct perf_session *session,
 		return tool->time_conv(tool, event, session);
 	case PERF_RECORD_HEADER_FEATURE:
 		return tool->feature(tool, event, session);
+	case PERF_RECORD_COMPRESSED:
+		return tool->compressed(session, event, file_offset);
 	default:
 		return -EINVAL;
 	}
@@ -1823,42 +2006,71 @@ fetch_mmaped_event(struct perf_session *session,
 #define NUM_MMAPS 128
 #endif
 
-static int __perf_session__process_events(struct perf_session *session,
-					  u64 data_offset, u64 data_size,
-					  u64 file_size)
-{
-	struct ordered_events *oe = &session->ordered_events;
-	struct perf_tool *tool = session->tool;
-	int fd = perf_data_file__fd(session->file);
-	u64 head, page_offset, file_offset, file_pos, size;
-	int err, mmap_prot, mmap_flags, map_idx = 0;
-	size_t	mmap_size;
-	char *buf, *mmaps[NUM_MMAPS];
-	union perf_event *event;
-	struct ui_progress prog;
-	s64 skip;
+/*
+ * A data file being read: the main one, or one of the data.<N> files of a
+ * directory, which are written concurrently and read round by round.
+ *
+ * @mmaps - the windows of the file mapped so far, the queued events
+ *	    point into them
+ * @file_offset - offset in the file of the current window
+ * @head - position of the next event in the current window
+ * @max_ts - highest timestamp queued from this file so far
+ * @round_ts - @max_ts when the last round of this file ended
+ * @limit - no event older than this is expected from this file anymore
+ */
+struct reader {
+	int			 fd;
+	u64			 file_size;
+	u64			 file_offset;
+	u64			 head;
+	size_t			 mmap_size;
+	char			*mmaps[NUM_MMAPS];
+	char			*mmap_cur;
+	int			 mmap_idx;
+	u64			 max_ts;
+	u64			 round_ts;
+	u64			 limit;
+	bool			 done;
+	struct zstd_data	 zstd_data;
+};
 
-	perf_tool__fill_defaults(tool);
+enum {
+	READER_EOF,
+	READER_ROUND,
+};
 
-	page_offset = page_size * (data_offset / page_size);
-	file_offset = page_offset;
-	head = data_offset - page_offset;
+static void reader__init(struct reader *rd, struct perf_session *session,
+			 int fd, u64 data_offset, u64 data_size,
+			 u64 file_size)
+{
+	u64 page_offset = page_size * (data_offset / page_size);
 
-	if (data_size == 0)
-		goto out;
+	memset(rd, 0, sizeof(*rd));
+
+	rd->fd = fd;
+	rd->file_offset = page_offset;
+	rd->head = data_offset - page_offset;
+	rd->done = data_size == 0;
 
 	if (data_offset + data_size < file_size)
 		file_size = data_offset + data_size;
+	rd->file_size = file_size;
 
-	ui_progress__init(&prog, file_size, "Processing events...");
-
-	mmap_size = MMAP_SIZE;
-	if (mmap_size > file_size) {
-		mmap_size = file_size;
-		session->one_mmap = true;
+	/*
+	 * perf_session__peek_event() only knows about the main file, don't
+	 * let it look into one of the files of a directory.
+	 */
+	rd->mmap_size = MMAP_SIZE;
+	if (rd->mmap_size > file_size) {
+		rd->mmap_size = file_size;
+		session->one_mmap = !perf_data_file__is_dir(session->file);
 	}
+}
 
-	memset(mmaps, 0, sizeof(mmaps));
+static int reader__mmap(struct reader *rd, struct perf_session *session)
+{
+	int mmap_prot, mmap_flags;
+	char *buf;
 
 	mmap_prot  = PROT_READ;
 	mmap_flags = MAP_SHARED;
@@ -1867,62 +2079,208 @@ static int __perf_session__process_events(struct perf_session *session,
 		mmap_prot  |= PROT_WRITE;
 		mmap_flags = MAP_PRIVATE;
 	}
-remap:
-	buf = mmap(NULL, mmap_size, mmap_prot, mmap_flags, fd,
-		   file_offset);
+
+	buf = mmap(NULL, rd->mmap_size, mmap_prot, mmap_flags, rd->fd,
+		   rd->file_offset);
 	if (buf == MAP_FAILED) {
 		pr_err("failed to mmap file\n");
-		err = -errno;
-		goto out_err;
+		return -errno;
 	}
-	mmaps[map_idx] = buf;
-	map_idx = (map_idx + 1) & (ARRAY_SIZE(mmaps) - 1);
-	file_pos = file_offset + head;
+	rd->mmaps[rd->mmap_idx] = rd->mmap_cur = buf;
+	rd->mmap_idx = (rd->mmap_idx + 1) & (ARRAY_SIZE(rd->mmaps) - 1);
 	if (session->one_mmap) {
 		session->one_mmap_addr = buf;
-		session->one_mmap_offset = file_offset;
+		session->one_mmap_offset = rd->file_offset;
 	}
 
+	return 0;
+}
+
+/*
+ * Process the events of @rd up to the end of the file or, with @rounds,
+ * up to the end of its current round, leaving the choice of the file to
+ * read on to the caller.
+ */
+static int reader__process_events(struct reader *rd,
+				  struct perf_session *session,
+				  struct ui_progress *prog, bool rounds)
+{
+	u64 page_offset, file_pos, size;
+	union perf_event *event;
+	s64 skip;
+	int err;
+
+	if (rd->done)
+		return READER_EOF;
+
+	if (!rd->mmap_cur) {
+		err = reader__mmap(rd, session);
+		if (err)
+			return err;
+	}
 more:
-	event = fetch_mmaped_event(session, head, mmap_size, buf);
+	event = fetch_mmaped_event(session, rd->head, rd->mmap_size,
+				   rd->mmap_cur);
 	if (!event) {
-		if (mmaps[map_idx]) {
-			munmap(mmaps[map_idx], mmap_size);
-			mmaps[map_idx] = NULL;
+		if (rd->mmaps[rd->mmap_idx]) {
+			munmap(rd->mmaps[rd->mmap_idx], rd->mmap_size);
+			rd->mmaps[rd->mmap_idx] = NULL;
 		}
 
-		page_offset = page_size * (head / page_size);
-		file_offset += page_offset;
-		head -= page_offset;
-		goto remap;
+		page_offset = page_size * (rd->head / page_size);
+		rd->file_offset += page_offset;
+		rd->head -= page_offset;
+
+		err = reader__mmap(rd, session);
+		if (err)
+			return err;
+		goto more;
 	}
 
 	size = event->header.size;
+	file_pos = rd->file_offset + rd->head;
+
+	if (rounds && size == sizeof(struct perf_event_header) &&
+	    event->header.type == PERF_RECORD_FINISHED_ROUND) {
+		rd->head += size;
+		ui_progress__update(prog, size);
+		rd->done = file_pos + size >= rd->file_size;
+		return READER_ROUND;
+	}
 
 	if (size < sizeof(struct perf_event_header) ||
 	    (skip = perf_session__process_event(session, event, file_pos)) < 0) {
 		pr_err("%#" PRIx64 " [%#x]: failed to process type: %d\n",
-		       file_offset + head, event->header.size,
-		       event->header.type);
-		err = -EINVAL;
-		goto out_err;
+		       file_pos, event->header.size, event->header.type);
+		return -EINVAL;
 	}
 
 	if (skip)
 		size += skip;
 
-	head += size;
+	rd->head += size;
 	file_pos += size;
 
-	ui_progress__update(&prog, size);
+	ui_progress__update(prog, size);
 
 	if (session_done())
-		goto out;
+		return READER_EOF;
 
-	if (file_pos < file_size)
+	if (file_pos < rd->file_size)
 		goto more;
 
-out:
+	rd->done = true;
+	return READER_EOF;
+}
+
+/*
+ * The data.<N> files of a directory are written concurrently by the
+ * threads of perf record, each of them ending a round after every pass
+ * over its ring buffers. As with a single file, the events of a file that
+ * come after the end of one of its rounds are not older than the events
+ * queued before the end of the previous one. Always read on the file with
+ * the lowest such bound and deliver the queued events up to it, so that
+ * about a round of each file stays queued rather than the whole trace.
+ */
+static int __perf_session__process_dir_events(struct perf_session *session,
+					      struct reader *main_rd)
+{
+	struct ordered_events *oe = &session->ordered_events;
+	struct perf_data_file *file = session->file;
+	int i, nr = file->dir.nr + 1, err = 0;
+	struct ui_progress prog;
+	struct reader *rd;
+	u64 total_size;
+
+	rd = calloc(nr, sizeof(*rd));
+	if (!rd)
+		return -ENOMEM;
+
+	rd[0] = *main_rd;
+	total_size = rd[0].file_size;
+
+	for (i = 1; i < nr; i++) {
+		struct perf_data_file *f = &file->dir.files[i - 1];
+
+		reader__init(&rd[i], session, perf_data_file__fd(f),
+			     0, f->size, f->size);
+		total_size += f->size;
+	}
+
+	for (i = 0; i < nr; i++) {
+		if (zstd_init(&rd[i].zstd_data, 0) < 0)
+			pr_warning("Decompression initialization failed, reported data may be incomplete\n");
+	}
+
+	ui_progress__init(&prog, total_size, "Processing events...");
+
+	while (!session_done()) {
+		struct reader *next = NULL;
+
+		for (i = 0; i < nr; i++) {
+			if (!rd[i].done && (!next || rd[i].limit < next->limit))
+				next = &rd[i];
+		}
+		if (!next)
+			break;
+
+		err = ordered_events__flush_time(oe, next->limit);
+		if (err)
+			break;
+
+		perf_session__reset_decomp(session);
+		session->active_zstd = &next->zstd_data;
+		session->queued_max_ts = next->max_ts;
+
+		err = reader__process_events(next, session, &prog, true);
+		if (err < 0)
+			break;
+
+		next->max_ts = session->queued_max_ts;
+		if (err == READER_ROUND) {
+			next->limit = next->round_ts;
+			next->round_ts = next->max_ts;
+		}
+		err = 0;
+	}
+
+	ui_progress__finish();
+
+	perf_session__reset_decomp(session);
+	session->active_zstd = &session->zstd_data;
+	for (i = 0; i < nr; i++)
+		zstd_fini(&rd[i].zstd_data);
+	free(rd);
+
+	return err;
+}
+
+static int __perf_session__process_events(struct perf_session *session,
+					  u64 data_offset, u64 data_size,
+					  u64 file_size)
+{
+	struct ordered_events *oe = &session->ordered_events;
+	struct perf_data_file *file = session->file;
+	struct perf_tool *tool = session->tool;
+	struct ui_progress prog;
+	struct reader rd;
+	int err;
+
+	perf_tool__fill_defaults(tool);
+
+	reader__init(&rd, session, perf_data_file__fd(file),
+		     data_offset, data_size, file_size);
+
+	if (perf_data_file__is_dir(file)) {
+		err = __perf_session__process_dir_events(session, &rd);
+	} else {
+		ui_progress__init(&prog, rd.file_size, "Processing events...");
+		err = reader__process_events(&rd, session, &prog, false);
+		ui_progress__finish();
+	}
+	if (err < 0)
+		goto out_err;
+
 	/* do the final flush for ordered samples */
 	err = ordered_events__flush(oe, OE_FLUSH__FINAL);
 	if (err)
@@ -1932,7 +2290,6 @@ out:
 		goto out_err;
 	err = perf_session__flush_thread_stacks(session);
 out_err:
-	ui_progress__finish();
 	perf_session__warn_about_errors(session);
 	/*
 	 * We may switching perf.data output, make ordered_events
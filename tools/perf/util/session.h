@@ -8,6 +8,7 @@
 #include "machine.h"
 #include "data.h"
 #include "ordered-events.h"
+#include "compress.h"
 #include <linux/kernel.h>
 #include <linux/rbtree.h>
 #include <linux/perf_event.h>
@@ -35,6 +36,27 @@ struct perf_session {
 	struct ordered_events	ordered_events;
 	struct perf_data_file	*file;
 	struct perf_tool	*tool;
+	struct zstd_data	zstd_data;
+	struct zstd_data	*active_zstd;
+	struct decomp		*decomp;
+	struct decomp		*decomp_last;
+	u64			queued_max_ts;
+};
+
+/*
+ * Decompressed content of a PERF_RECORD_COMPRESSED record. The buffers
+ * are kept until the session is deleted as the ordered events queue
+ * points into them. An event split between two records is moved to the
+ * start of the next buffer, hence @head may be below @size once all the
+ * complete events have been processed.
+ */
+struct decomp {
+	struct decomp	*next;
+	u64		 file_pos;
+	u64		 mmap_len;
+	u64		 head;
+	u64		 size;
+	char		 data[];
 };
 
 struct perf_tool;
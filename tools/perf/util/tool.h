@@ -35,6 +35,9 @@ typedef int (*event_oe)(struct perf_tool *tool, union perf_event *event,
 typedef s64 (*event_op3)(struct perf_tool *tool, union perf_event *event,
 			 struct perf_session *session);
 
+typedef int (*event_op4)(struct perf_session *session, union perf_event *event,
+			 u64 data);
+
 enum show_feature_header {
 	SHOW_FEAT_NO_HEADER = 0,
 	SHOW_FEAT_HEADER,
@@ -73,6 +76,7 @@ struct perf_tool {
 			stat_round,
 			feature;
 	event_op3	auxtrace;
+	event_op4	compressed;
 	bool		ordered_events;
 	bool		ordering_requires_timestamps;
 	bool		namespace_events;
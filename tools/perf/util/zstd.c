@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include <string.h>
+
+#include "util/compress.h"
+#include "util/debug.h"
+
+int zstd_init(struct zstd_data *data, int level)
+{
+	size_t ret;
+
+	data->dstream = ZSTD_createDStream();
+	if (data->dstream == NULL) {
+		pr_err("Couldn't create decompression stream.\n");
+		return -1;
+	}
+
+	ret = ZSTD_initDStream(data->dstream);
+	if (ZSTD_isError(ret)) {
+		pr_err("Failed to initialize decompression stream: %s\n",
+		       ZSTD_getErrorName(ret));
+		return -1;
+	}
+
+	if (!level)
+		return 0;
+
+	data->cstream = ZSTD_createCStream();
+	if (data->cstream == NULL) {
+		pr_err("Couldn't create compression stream.\n");
+		return -1;
+	}
+
+	ret = ZSTD_initCStream(data->cstream, level);
+	if (ZSTD_isError(ret)) {
+		pr_err("Failed to initialize compression stream: %s\n",
+		       ZSTD_getErrorName(ret));
+		return -1;
+	}
+
+	return 0;
+}
+
+int zstd_fini(struct zstd_data *data)
+{
+	if (data->dstream) {
+		ZSTD_freeDStream(data->dstream);
+		data->dstream = NULL;
+	}
+
+	if (data->cstream) {
+		ZSTD_freeCStream(data->cstream);
+		data->cstream = NULL;
+	}
+
+	return 0;
+}
+
+/*
+ * Compress @src into a sequence of records in @dst, each of them carrying
+ * at most @max_record_size bytes of compressed payload. process_header()
+ * is called with a zero increment to reserve the header of a new record
+ * and returns its size, then with the payload size to complete it.
+ *
+ * The stream is flushed after every record so the reader can decompress
+ * records one by one, however an event may still be split between two
+ * consecutive records.
+ *
+ * Returns the number of bytes used in @dst, 0 on error.
+ */
+size_t zstd_compress_stream_to_records(struct zstd_data *data,
+				void *dst, size_t dst_size,
+				void *src, size_t src_size, size_t max_record_size,
+				size_t process_header(void *record, size_t increment))
+{
+	ZSTD_inBuffer input = { src, src_size, 0 };
+	ZSTD_outBuffer output;
+	size_t ret = 0, size, compressed = 0;
+	void *record;
+
+	/* keep going while there is input left or data pending in the stream */
+	while (input.pos < input.size || ret) {
+		record = dst;
+		size = process_header(record, 0);
+		if (size >= dst_size) {
+			pr_err("No space left to compress %zu bytes\n", src_size);
+			return 0;
+		}
+		compressed += size;
+		dst += size;
+		dst_size -= size;
+
+		output = (ZSTD_outBuffer){ dst, (dst_size > max_record_size) ?
+						max_record_size : dst_size, 0 };
+		ret = ZSTD_compressStream(data->cstream, &output, &input);
+		if (!ZSTD_isError(ret))
+			ret = ZSTD_flushStream(data->cstream, &output);
+		if (ZSTD_isError(ret)) {
+			pr_err("Failed to compress %zu bytes: %s\n",
+			       src_size, ZSTD_getErrorName(ret));
+			return 0;
+		}
+
+		size = output.pos;
+		process_header(record, size);
+		compressed += size;
+		dst += size;
+		dst_size -= size;
+	}
+
+	return compressed;
+}
+
+/*
+ * Returns the number of decompressed bytes stored in @dst, 0 on error or
+ * when @dst is too small to hold the whole record.
+ */
+size_t zstd_decompress_stream(struct zstd_data *data,
+			      void *src, size_t src_size,
+			      void *dst, size_t dst_size)
+{
+	ZSTD_inBuffer input = { src, src_size, 0 };
+	ZSTD_outBuffer output = { dst, dst_size, 0 };
+	size_t ret;
+
+	while (input.pos < input.size) {
+		if (output.pos == output.size) {
+			pr_err("No space left to decompress %zu bytes\n",
+			       src_size);
+			return 0;
+		}
+
+		ret = ZSTD_decompressStream(data->dstream, &output, &input);
+		if (ZSTD_isError(ret)) {
+			pr_err("Failed to decompress %zu bytes: %s\n",
+			       src_size, ZSTD_getErrorName(ret));
+			return 0;
+		}
+	}
+
+	return output.pos;
+}
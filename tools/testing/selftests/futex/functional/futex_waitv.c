@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * futex_waitv() test: wait on a vector of futexes and check that the index
+ * of the woken one is reported, that a mismatching value fails the whole
+ * call with EWOULDBLOCK, that invalid waiters are rejected and that the
+ * absolute timeout fires. A process-private futex hash is installed with
+ * PR_FUTEX_HASH first, so the private waiters exercise that table.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/prctl.h>
+#include "futextest.h"
+#include "futex2test.h"
+#include "logging.h"
+
+#define TEST_NAME "futex-waitv"
+#define NR_FUTEXES 30
+#define WAKE_IDX (NR_FUTEXES - 1)
+
+static struct futex_waitv waitv[NR_FUTEXES];
+static futex_t futexes[NR_FUTEXES];
+static long timeout_ns = 100000000;	/* 100ms default timeout */
+
+void usage(char *prog)
+{
+	printf("Usage: %s\n", prog);
+	printf("  -c	Use color\n");
+	printf("  -h	Display this help message\n");
+	printf("  -v L	Verbosity level: %d=QUIET %d=CRITICAL %d=INFO\n",
+	       VQUIET, VCRITICAL, VINFO);
+}
+
+static void init_waitv(unsigned int flags)
+{
+	int i;
+
+	for (i = 0; i < NR_FUTEXES; i++) {
+		futexes[i] = 0;
+		waitv[i].uaddr = (uintptr_t)&futexes[i];
+		waitv[i].val = 0;
+		waitv[i].flags = FUTEX_32 | flags;
+		waitv[i].__reserved = 0;
+	}
+}
+
+static void abs_timeout(struct timespec *to)
+{
+	clock_gettime(CLOCK_MONOTONIC, to);
+	to->tv_nsec += timeout_ns;
+	if (to->tv_nsec >= 1000000000) {
+		to->tv_sec++;
+		to->tv_nsec -= 1000000000;
+	}
+}
+
+static void *waiterfn(void *arg)
+{
+	struct timespec to;
+	long res;
+
+	/* Wait long enough for the main thread to issue the wake */
+	clock_gettime(CLOCK_MONOTONIC, &to);
+	to.tv_sec++;
+
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_MONOTONIC);
+	*(long *)arg = res < 0 ? -errno : res;
+
+	return NULL;
+}
+
+static int test_wake(const char *desc, unsigned int flags)
+{
+	pthread_t waiter;
+	long res = -1;
+
+	init_waitv(flags);
+
+	if (pthread_create(&waiter, NULL, waiterfn, &res)) {
+		error("pthread_create failed\n", errno);
+		return RET_ERROR;
+	}
+
+	usleep(10000);
+
+	info("Waking up futex %d (%s)\n", WAKE_IDX, desc);
+	futex_wake(&futexes[WAKE_IDX], 1, flags);
+	pthread_join(waiter, NULL);
+
+	if (res != WAKE_IDX) {
+		fail("%s: futex_waitv returned %ld, expected %d\n",
+		     desc, res, WAKE_IDX);
+		return RET_FAIL;
+	}
+	return RET_PASS;
+}
+
+static int test_wouldblock(void)
+{
+	struct timespec to;
+	int res;
+
+	init_waitv(FUTEX_PRIVATE_FLAG);
+	waitv[NR_FUTEXES / 2].val = 1;
+	abs_timeout(&to);
+
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_MONOTONIC);
+	if (!res || errno != EWOULDBLOCK) {
+		fail("futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+	return RET_PASS;
+}
+
+static int test_timeout(void)
+{
+	struct timespec to;
+	int res;
+
+	init_waitv(FUTEX_PRIVATE_FLAG);
+	abs_timeout(&to);
+
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_MONOTONIC);
+	if (!res || errno != ETIMEDOUT) {
+		fail("futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+	return RET_PASS;
+}
+
+static int test_einval(void)
+{
+	struct timespec to;
+	int res;
+
+	abs_timeout(&to);
+
+	/* Missing FUTEX_32 */
+	init_waitv(FUTEX_PRIVATE_FLAG);
+	waitv[0].flags = FUTEX_PRIVATE_FLAG;
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_MONOTONIC);
+	if (!res || errno != EINVAL) {
+		fail("unsized waiter: futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+
+	/* Unaligned address */
+	init_waitv(FUTEX_PRIVATE_FLAG);
+	waitv[0].uaddr = (uintptr_t)&futexes[0] + 1;
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_MONOTONIC);
+	if (!res || errno != EINVAL) {
+		fail("unaligned waiter: futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+
+	/* Too many waiters */
+	init_waitv(FUTEX_PRIVATE_FLAG);
+	res = futex_waitv(waitv, FUTEX_WAITV_MAX + 1, 0, &to, CLOCK_MONOTONIC);
+	if (!res || errno != EINVAL) {
+		fail("oversized vector: futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+
+	/* Unsupported clock */
+	res = futex_waitv(waitv, NR_FUTEXES, 0, &to, CLOCK_TAI);
+	if (!res || errno != EINVAL) {
+		fail("bad clock: futex_waitv returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+
+	return RET_PASS;
+}
+
+static int test_private_hash(void)
+{
+	int res;
+
+	/* Only allowed while the process is single threaded */
+	res = prctl(PR_FUTEX_HASH, PR_FUTEX_HASH_SET_SLOTS, 16, 0, 0);
+	if (res) {
+		fail("PR_FUTEX_HASH_SET_SLOTS failed: %s\n", strerror(errno));
+		return RET_FAIL;
+	}
+
+	res = prctl(PR_FUTEX_HASH, PR_FUTEX_HASH_GET_SLOTS, 0, 0, 0);
+	if (res != 16) {
+		fail("PR_FUTEX_HASH_GET_SLOTS returned %d, expected 16\n", res);
+		return RET_FAIL;
+	}
+
+	res = prctl(PR_FUTEX_HASH, PR_FUTEX_HASH_SET_SLOTS, 16, 0, 0);
+	if (!res || errno != EBUSY) {
+		fail("second PR_FUTEX_HASH_SET_SLOTS returned: %d %s\n",
+		     res ? errno : res, res ? strerror(errno) : "");
+		return RET_FAIL;
+	}
+
+	return RET_PASS;
+}
+
+int main(int argc, char *argv[])
+{
+	int res, ret = RET_PASS;
+	int c;
+
+	while ((c = getopt(argc, argv, "chv:")) != -1) {
+		switch (c) {
+		case 'c':
+			log_color(1);
+			break;
+		case 'h':
+			usage(basename(argv[0]));
+			exit(0);
+		case 'v':
+			log_verbosity(atoi(optarg));
+			break;
+		default:
+			usage(basename(argv[0]));
+			exit(1);
+		}
+	}
+
+	ksft_print_header();
+	ksft_print_msg("%s: Test FUTEX_WAITV\n", basename(argv[0]));
+
+	if (futex_waitv(NULL, 0, 0, NULL, 0) && errno == ENOSYS)
+		ksft_exit_skip("futex_waitv() not supported\n");
+
+	/* The private hash can only be installed before any thread exists */
+	res = test_private_hash();
+	ret = res ? res : ret;
+
+	res = test_wake("private", FUTEX_PRIVATE_FLAG);
+	ret = res ? res : ret;
+
+	res = test_wake("shared", 0);
+	ret = res ? res : ret;
+
+	res = test_wouldblock();
+	ret = res ? res : ret;
+
+	res = test_timeout();
+	ret = res ? res : ret;
+
+	res = test_einval();
+	ret = res ? res : ret;
+
+	print_result(TEST_NAME, ret);
+	return ret;
+}
@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Ring-buffer memory mapping tests
+ *
+ * Maps per_cpu/cpu0/trace_pipe_raw, writes markers from CPU 0 and
+ * checks that they can be consumed through the meta-page and the
+ * TRACE_MMAP_IOCTL_GET_READER ioctl. Also checks that the mapping
+ * stays read-only.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include <linux/trace_mmap.h>
+
+#define TRACEFS_ROOT	"/sys/kernel/debug/tracing"
+
+static int write_file(const char *name, const char *val)
+{
+	char path[256];
+	int fd, ret;
+
+	snprintf(path, sizeof(path), "%s/%s", TRACEFS_ROOT, name);
+	fd = open(path, O_WRONLY | O_TRUNC);
+	if (fd < 0)
+		return -errno;
+
+	ret = write(fd, val, strlen(val));
+	ret = ret < 0 ? -errno : 0;
+	close(fd);
+
+	return ret;
+}
+
+#define fail(fmt, ...)						\
+	do {							\
+		fprintf(stderr, "FAIL: " fmt "\n", ##__VA_ARGS__);	\
+		exit(1);					\
+	} while (0)
+
+static sigjmp_buf fault_jmp;
+static volatile sig_atomic_t fault_code;
+
+static void fault_handler(int sig, siginfo_t *info, void *ctx)
+{
+	fault_code = info->si_code;
+	siglongjmp(fault_jmp, 1);
+}
+
+/* Returns the si_code of the fault taken by the write, or 0 if none */
+static int try_write(volatile unsigned char *addr)
+{
+	struct sigaction sa = {
+		.sa_sigaction	= fault_handler,
+		.sa_flags	= SA_SIGINFO,
+	};
+	struct sigaction old;
+
+	sigaction(SIGSEGV, &sa, &old);
+	fault_code = 0;
+	if (!sigsetjmp(fault_jmp, 1))
+		*addr = ~*addr;
+	sigaction(SIGSEGV, &old, NULL);
+
+	return fault_code;
+}
+
+int main(int argc, char **argv)
+{
+	struct trace_buffer_meta *meta;
+	long page_size = sysconf(_SC_PAGESIZE);
+	unsigned int nr_subbufs, i;
+	cpu_set_t cpu_mask;
+	void *data, *map;
+	size_t data_len;
+	int fd, rw_fd;
+
+	if (getuid() != 0) {
+		printf("SKIP: must be run as root\n");
+		return 4;
+	}
+
+	CPU_ZERO(&cpu_mask);
+	CPU_SET(0, &cpu_mask);
+	if (sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask))
+		fail("sched_setaffinity: %s", strerror(errno));
+
+	fd = open(TRACEFS_ROOT "/per_cpu/cpu0/trace_pipe_raw",
+		  O_RDONLY | O_NONBLOCK);
+	if (fd < 0) {
+		printf("SKIP: can't open trace_pipe_raw: %s\n", strerror(errno));
+		return 4;
+	}
+
+	write_file("tracing_on", "0");
+	write_file("trace", "");
+
+	meta = mmap(NULL, page_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (meta == MAP_FAILED) {
+		if (errno == ENODEV || errno == EINVAL) {
+			printf("SKIP: ring-buffer mapping not supported\n");
+			return 4;
+		}
+		fail("mmap meta-page: %s", strerror(errno));
+	}
+
+	if (meta->meta_struct_len < sizeof(*meta) ||
+	    meta->meta_page_size != page_size ||
+	    meta->subbuf_size != page_size)
+		fail("unexpected meta-page layout");
+
+	nr_subbufs = meta->nr_subbufs;
+	if (nr_subbufs < 3)
+		fail("too few sub-buffers: %u", nr_subbufs);
+
+	/* The buffer must not be writable, nor resizable while mapped */
+	map = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map != MAP_FAILED)
+		fail("writable mapping allowed");
+
+	/* Even through a writable file, where only the kernel can refuse it */
+	rw_fd = open(TRACEFS_ROOT "/per_cpu/cpu0/trace_pipe_raw",
+		     O_RDWR | O_NONBLOCK);
+	if (rw_fd >= 0) {
+		map = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			   rw_fd, 0);
+		if (map != MAP_FAILED)
+			fail("writable mapping allowed on a read-write file");
+		if (errno != EPERM)
+			fail("writable mapping: expected EPERM, got %s",
+			     strerror(errno));
+		close(rw_fd);
+	}
+
+	/* The read-only mapping can't be upgraded, nor written through */
+	if (!mprotect(meta, page_size, PROT_READ | PROT_WRITE))
+		fail("meta-page made writable with mprotect()");
+	if (errno != EACCES)
+		fail("mprotect: expected EACCES, got %s", strerror(errno));
+
+	if (try_write((volatile unsigned char *)&meta->nr_subbufs) !=
+	    SEGV_ACCERR)
+		fail("write to the meta-page did not fault");
+	if (meta->nr_subbufs != nr_subbufs)
+		fail("meta-page modified through the mapping");
+	if (write_file("per_cpu/cpu0/buffer_size_kb", "4096") != -EBUSY)
+		fail("mapped buffer was resized");
+
+	/* Mapping beyond the last sub-buffer must fail */
+	map = mmap(NULL, page_size, PROT_READ, MAP_SHARED, fd,
+		   (nr_subbufs + 1) * page_size);
+	if (map != MAP_FAILED)
+		fail("out of bounds mapping allowed");
+
+	data_len = nr_subbufs * page_size;
+	data = mmap(NULL, data_len, PROT_READ, MAP_SHARED, fd, page_size);
+	if (data == MAP_FAILED)
+		fail("mmap sub-buffers: %s", strerror(errno));
+
+	write_file("tracing_on", "1");
+	for (i = 0; i < 16; i++)
+		write_file("trace_marker", "map_test");
+	write_file("tracing_on", "0");
+
+	if (ioctl(fd, TRACE_MMAP_IOCTL_GET_READER))
+		fail("TRACE_MMAP_IOCTL_GET_READER: %s", strerror(errno));
+
+	if (meta->reader.id >= nr_subbufs)
+		fail("invalid reader id %u", meta->reader.id);
+	if (!meta->entries || meta->read != meta->entries)
+		fail("markers not consumed: entries=%llu read=%llu",
+		     (unsigned long long)meta->entries,
+		     (unsigned long long)meta->read);
+	if (!meta->reader.read || meta->reader.read > page_size)
+		fail("invalid reader position %u", meta->reader.read);
+
+	/* Nothing left: the reader must not move */
+	i = meta->reader.id;
+	if (ioctl(fd, TRACE_MMAP_IOCTL_GET_READER))
+		fail("TRACE_MMAP_IOCTL_GET_READER: %s", strerror(errno));
+	if (meta->reader.id != i)
+		fail("reader moved on an empty buffer");
+
+	/* A moved mapping must stay usable and be released only once */
+	map = mmap(NULL, page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+		   -1, 0);
+	if (map == MAP_FAILED)
+		fail("mmap: %s", strerror(errno));
+	map = mremap(meta, page_size, page_size, MREMAP_MAYMOVE | MREMAP_FIXED,
+		     map);
+	if (map == MAP_FAILED)
+		fail("mremap meta-page: %s", strerror(errno));
+	meta = map;
+	if (meta->nr_subbufs != nr_subbufs)
+		fail("moved meta-page mismatch");
+
+	munmap(data, data_len);
+	munmap(meta, page_size);
+	close(fd);
+
+	write_file("trace", "");
+
+	printf("PASS\n");
+	return 0;
+}